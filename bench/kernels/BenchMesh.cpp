@@ -0,0 +1,61 @@
+/*
+  Copyright (C) 2016
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Benchmark.hpp"
+#include "Systems.hpp"
+#include "interaction/CoulombKSpaceP3M.hpp"
+#include "integrator/LatticeBoltzmann.hpp"
+#include "integrator/LBInitPopUniform.hpp"
+
+namespace espressopp {
+  namespace bench {
+
+    // charge assignment to the mesh and its forward transform
+    static void p3mChargeAssignment(State &state) {
+      LJSystem lj(state.getSize(), true);
+      // about one mesh point per unit length, even
+      Int3D mesh;
+      for (int i = 0; i < 3; ++i) mesh[i] = std::max(8, 2 * int(0.5 * lj.L + 0.5));
+      interaction::CoulombKSpaceP3M p3m(lj.system, 1.0, 1.0, mesh, 5, lj.rc, 200192);
+      while (state.keepRunning()) {
+        p3m.common_part(lj.storage->getRealCells());
+      }
+      state.setItemsPerIteration(lj.nLocal());
+    }
+    ESPP_BENCHMARK("CoulombKSpaceP3M::common_part", p3mChargeAssignment);
+
+    // D3Q19 with unit spacing in the box of a system at unit density, so
+    // there are about as many lattice sites as particles; collideStream()
+    // does not couple to the particles
+    static void latticeBoltzmannCollideStream(State &state) {
+      LJSystem lj(state.getSize(), false, 1.0);
+      shared_ptr< integrator::LatticeBoltzmann > lb = make_shared< integrator::LatticeBoltzmann >(
+        lj.system, lj.nodeGrid, 1.0, 1.0, 3, 19);
+      integrator::LBInitPopUniform init(lj.system, lb);
+      init.createDenVel(1.0, Real3D(0.0));
+      while (state.keepRunning()) {
+        lb->collideStream();
+      }
+      Int3D sites = lb->getNi();
+      state.setItemsPerIteration(real(sites[0]) * sites[1] * sites[2] / mpiWorld->size());
+    }
+    ESPP_BENCHMARK("LatticeBoltzmann::collideStream", latticeBoltzmannCollideStream);
+  }
+}
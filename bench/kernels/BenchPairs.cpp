@@ -0,0 +1,72 @@
+/*
+  Copyright (C) 2016
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Benchmark.hpp"
+#include "Systems.hpp"
+#include "VerletList.hpp"
+#include "FixedPairList.hpp"
+#include "interaction/LennardJones.hpp"
+#include "interaction/FENE.hpp"
+#include "interaction/VerletListInteractionTemplate.hpp"
+#include "interaction/FixedPairListInteractionTemplate.hpp"
+
+namespace espressopp {
+  namespace bench {
+
+    static void verletListRebuild(State &state) {
+      LJSystem lj(state.getSize());
+      shared_ptr< VerletList > vl = make_shared< VerletList >(lj.system, lj.rc, true);
+      while (state.keepRunning()) {
+        vl->rebuild();
+      }
+      state.setItemsPerIteration(lj.nLocal());
+    }
+    ESPP_BENCHMARK("VerletList::rebuild", verletListRebuild);
+
+    static void verletListLennardJones(State &state) {
+      LJSystem lj(state.getSize());
+      shared_ptr< VerletList > vl = make_shared< VerletList >(lj.system, lj.rc, true);
+      interaction::VerletListInteractionTemplate< interaction::LennardJones > lennardJones(vl);
+      lennardJones.setPotential(0, 0, interaction::LennardJones(1.0, 1.0, lj.rc));
+      while (state.keepRunning()) {
+        lennardJones.addForces();
+      }
+      // pairs per second
+      state.setItemsPerIteration(vl->localSize());
+    }
+    ESPP_BENCHMARK("VerletListInteractionTemplate<LennardJones>::addForces", verletListLennardJones);
+
+    static void fixedPairListFENE(State &state) {
+      LJSystem lj(state.getSize());
+      // chains along the lattice rows
+      shared_ptr< FixedPairList > bonds = make_shared< FixedPairList >(lj.storage);
+      for (longint id = 0; id < lj.n; ++id) {
+        if (lj.hasSuccessor(id)) bonds->add(id, id + 1);
+      }
+      shared_ptr< interaction::FENE > fene = make_shared< interaction::FENE >(30.0, 0.0, 1.5, 1.5);
+      interaction::FixedPairListInteractionTemplate< interaction::FENE > interaction(lj.system, bonds, fene);
+      while (state.keepRunning()) {
+        interaction.addForces();
+      }
+      state.setItemsPerIteration(bonds->size());
+    }
+    ESPP_BENCHMARK("FixedPairListInteractionTemplate<FENE>::addForces", fixedPairListFENE);
+  }
+}
@@ -0,0 +1,73 @@
+/*
+  Copyright (C) 2016
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Benchmark.hpp"
+#include "Systems.hpp"
+#include "iterator/CellListIterator.hpp"
+
+namespace espressopp {
+  namespace bench {
+
+    static longint countParticles(CellList &cells) {
+      longint n = 0;
+      for (CellList::Iterator it(cells); it.isValid(); ++it) n += (*it)->particles.size();
+      return n;
+    }
+
+    static void decomposeRealParticles(State &state) {
+      LJSystem lj(state.getSize());
+      CellList &realCells = lj.storage->getRealCells();
+      // a shift of a fraction of a cell, alternating in sign, moves a part
+      // of the particles to other cells and processes in every iteration
+      Real3D shift(0.37 * lj.a, 0.23 * lj.a, 0.11 * lj.a);
+      while (state.keepRunning()) {
+        state.pauseTiming();
+        for (iterator::CellListIterator cit(realCells); !cit.isDone(); ++cit) {
+          cit->position() += shift;
+        }
+        shift *= -1.0;
+        state.resumeTiming();
+        lj.storage->decomposeRealParticles();
+      }
+      state.setItemsPerIteration(lj.nLocal());
+    }
+    ESPP_BENCHMARK("DomainDecomposition::decomposeRealParticles", decomposeRealParticles);
+
+    // with one process per axis the ghosts are copied, otherwise packed,
+    // sent and unpacked
+    static void updateGhosts(State &state) {
+      LJSystem lj(state.getSize());
+      while (state.keepRunning()) {
+        lj.storage->updateGhosts();
+      }
+      state.setItemsPerIteration(countParticles(lj.storage->getGhostCells()));
+    }
+    ESPP_BENCHMARK("DomainDecomposition::updateGhosts", updateGhosts);
+
+    static void collectGhostForces(State &state) {
+      LJSystem lj(state.getSize());
+      while (state.keepRunning()) {
+        lj.storage->collectGhostForces();
+      }
+      state.setItemsPerIteration(countParticles(lj.storage->getGhostCells()));
+    }
+    ESPP_BENCHMARK("DomainDecomposition::collectGhostForces", collectGhostForces);
+  }
+}
@@ -0,0 +1,219 @@
+/*
+  Copyright (C) 2016
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Benchmark.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include "mpi.hpp"
+#include "main/espressopp_common.hpp"
+#include "esutil/Threads.hpp"
+
+namespace espressopp {
+  namespace bench {
+
+    std::vector< Benchmark > &registry() {
+      static std::vector< Benchmark > benchmarks;
+      return benchmarks;
+    }
+
+    namespace {
+      struct Options {
+        std::string filter;
+        std::vector< longint > sizes;
+        real minTime;
+        int repetitions;
+        std::string out;
+        bool list;
+      };
+
+      struct Result {
+        std::string name;
+        long iterations;
+        // seconds per iteration, slowest process; per repetition
+        std::vector< real > times;
+        double itemsPerIteration;
+      };
+
+      bool startsWith(const std::string &s, const char *prefix) {
+        return s.compare(0, std::strlen(prefix), prefix) == 0;
+      }
+
+      Options parse(int argc, char **argv) {
+        Options o;
+        o.minTime = 0.5;
+        o.repetitions = 3;
+        o.list = false;
+        for (int i = 1; i < argc; ++i) {
+          std::string a(argv[i]);
+          std::string v = a.substr(a.find('=') + 1);
+          if (startsWith(a, "--filter=")) o.filter = v;
+          else if (startsWith(a, "--min-time=")) o.minTime = std::atof(v.c_str());
+          else if (startsWith(a, "--repetitions=")) o.repetitions = std::max(1, std::atoi(v.c_str()));
+          else if (startsWith(a, "--out=")) o.out = v;
+          else if (a == "--list") o.list = true;
+          else if (startsWith(a, "--sizes=")) {
+            std::istringstream s(v);
+            std::string item;
+            while (std::getline(s, item, ',')) o.sizes.push_back(std::atol(item.c_str()));
+          }
+          else {
+            throw std::runtime_error("unknown option " + a + "\n"
+              "usage: espp_bench [--filter=substring] [--sizes=n1,n2,...] [--min-time=s]\n"
+              "                  [--repetitions=n] [--out=results.json] [--list]");
+          }
+        }
+        if (o.sizes.empty()) {
+          o.sizes.push_back(4000);
+          o.sizes.push_back(32000);
+        }
+        return o;
+      }
+
+      // time per iteration on the slowest process
+      real runOnce(const Benchmark &b, longint size, long iterations, State &state) {
+        state = State(size, iterations);
+        b.function(state);
+        real t = state.getElapsed(), tMax;
+        mpi::all_reduce(*mpiWorld, t, tMax, boost::mpi::maximum< real >());
+        return tMax;
+      }
+
+      Result run(const Benchmark &b, longint size, const Options &o) {
+        State state(size, 1);
+        long iterations = 1;
+        real t = runOnce(b, size, iterations, state);
+        // grow the iterations until the loop takes the minimum time
+        while (t < o.minTime && iterations < 1000000000L) {
+          real factor = (t > 0.0) ? 1.4 * o.minTime / t : 10.0;
+          factor = std::min(std::max(factor, 2.0), 10.0);
+          iterations = long(iterations * factor);
+          t = runOnce(b, size, iterations, state);
+        }
+
+        Result r;
+        std::ostringstream name;
+        name << b.name << "/" << size;
+        r.name = name.str();
+        r.iterations = iterations;
+        r.times.push_back(t / iterations);
+        for (int k = 1; k < o.repetitions; ++k) {
+          r.times.push_back(runOnce(b, size, iterations, state) / iterations);
+        }
+        double items = state.getItemsPerIteration(), itemsSum;
+        mpi::all_reduce(*mpiWorld, items, itemsSum, std::plus< double >());
+        r.itemsPerIteration = itemsSum;
+        return r;
+      }
+
+      real median(std::vector< real > v) {
+        std::sort(v.begin(), v.end());
+        size_t n = v.size();
+        return (n % 2) ? v[n / 2] : 0.5 * (v[n / 2 - 1] + v[n / 2]);
+      }
+
+      void writeJSON(const std::string &filename, const std::vector< Result > &results) {
+        std::ofstream out(filename.c_str());
+        if (!out) throw std::runtime_error("cannot open " + filename);
+        char date[64];
+        std::time_t now = std::time(0);
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+        // the layout of Google Benchmark, so that its tools can read it
+        out.precision(10);
+        out << "{\n  \"context\": {\n"
+            << "    \"date\": \"" << date << "\",\n"
+            << "    \"executable\": \"espp_bench\",\n"
+            << "    \"mpi_ranks\": " << mpiWorld->size() << ",\n"
+            << "    \"threads_per_rank\": " << esutil::Threads::getNumThreads() << "\n"
+            << "  },\n  \"benchmarks\": [";
+        for (size_t i = 0; i < results.size(); ++i) {
+          const Result &r = results[i];
+          real t = median(r.times);
+          out << (i ? ",\n" : "\n")
+              << "    {\n"
+              << "      \"name\": \"" << r.name << "\",\n"
+              << "      \"run_type\": \"iteration\",\n"
+              << "      \"repetitions\": " << r.times.size() << ",\n"
+              << "      \"iterations\": " << r.iterations << ",\n"
+              << "      \"real_time\": " << 1e9 * t << ",\n"
+              << "      \"cpu_time\": " << 1e9 * t << ",\n"
+              << "      \"real_time_min\": " << 1e9 * *std::min_element(r.times.begin(), r.times.end()) << ",\n"
+              << "      \"time_unit\": \"ns\",\n"
+              << "      \"items_per_second\": " << (t > 0.0 ? r.itemsPerIteration / t : 0.0) << "\n"
+              << "    }";
+        }
+        out << "\n  ]\n}\n";
+      }
+    }
+
+    int main(int argc, char **argv) {
+      Options o = parse(argc, argv);
+      const bool root = mpiWorld->rank() == 0;
+      std::vector< Benchmark > &benchmarks = registry();
+
+      if (o.list) {
+        if (root) {
+          for (size_t i = 0; i < benchmarks.size(); ++i) std::cout << benchmarks[i].name << "\n";
+        }
+        return 0;
+      }
+
+      if (root) {
+        std::printf("%-50s %14s %14s %12s %14s\n", "benchmark", "time/iter [us]", "min [us]",
+                    "iterations", "items/s");
+      }
+      std::vector< Result > results;
+      for (size_t i = 0; i < benchmarks.size(); ++i) {
+        if (benchmarks[i].name.find(o.filter) == std::string::npos) continue;
+        for (size_t k = 0; k < o.sizes.size(); ++k) {
+          Result r = run(benchmarks[i], o.sizes[k], o);
+          real t = median(r.times);
+          if (root) {
+            std::printf("%-50s %14.3f %14.3f %12ld %14.4g\n", r.name.c_str(), 1e6 * t,
+                        1e6 * *std::min_element(r.times.begin(), r.times.end()),
+                        r.iterations, t > 0.0 ? r.itemsPerIteration / t : 0.0);
+            std::fflush(stdout);
+          }
+          results.push_back(r);
+        }
+      }
+      if (root && !o.out.empty()) writeJSON(o.out, results);
+      return 0;
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  initMPIEnv(argc, argv);
+  int ret = 1;
+  try {
+    ret = espressopp::bench::main(argc, argv);
+  } catch (std::exception &e) {
+    std::cerr << e.what() << std::endl;
+  }
+  finalizeMPIEnv();
+  return ret;
+}
@@ -0,0 +1,102 @@
+/*
+  Copyright (C) 2016
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _BENCH_BENCHMARK_HPP
+#define _BENCH_BENCHMARK_HPP
+
+#include <mpi.h>
+#include <string>
+#include <vector>
+#include "types.hpp"
+
+namespace espressopp {
+  namespace bench {
+
+    /** Passed to a benchmark function. The function sets up its system,
+        then runs the kernel in
+
+          while (state.keepRunning()) { ... }
+
+        Only the loop is timed; the runner chooses the number of
+        iterations so that the loop takes at least the minimum time on
+        the slowest process. All processes run the same iterations, so
+        kernels may communicate.
+    */
+    class State {
+    public:
+      State(longint _size, long _maxIterations)
+        : size(_size), maxIterations(_maxIterations), iteration(0),
+          elapsed(0.0), start(0.0), items(0.0) {}
+
+      /** number of particles (all processes) the system should have */
+      longint getSize() const { return size; }
+
+      bool keepRunning() {
+        if (iteration == 0) start = MPI_Wtime();
+        if (iteration < maxIterations) {
+          ++iteration;
+          return true;
+        }
+        elapsed += MPI_Wtime() - start;
+        return false;
+      }
+
+      /** exclude work of an iteration from the time, e.g. a reset */
+      void pauseTiming() { elapsed += MPI_Wtime() - start; }
+      void resumeTiming() { start = MPI_Wtime(); }
+
+      /** items (particles, pairs, sites) of this process per iteration */
+      void setItemsPerIteration(double n) { items = n; }
+
+      long getIterations() const { return iteration; }
+      real getElapsed() const { return elapsed; }
+      double getItemsPerIteration() const { return items; }
+
+    private:
+      longint size;
+      long maxIterations, iteration;
+      double elapsed, start;
+      double items;
+    };
+
+    typedef void (*Function)(State &state);
+
+    struct Benchmark {
+      std::string name;
+      Function function;
+    };
+
+    /** all registered benchmarks, in the order of registration */
+    std::vector< Benchmark > &registry();
+
+    struct Registration {
+      Registration(const char *name, Function function) {
+        Benchmark b = { name, function };
+        registry().push_back(b);
+      }
+    };
+  }
+}
+
+/** Register function as a benchmark called name. */
+#define ESPP_BENCHMARK(name, function) \
+  static espressopp::bench::Registration function##_registration(name, function)
+
+#endif
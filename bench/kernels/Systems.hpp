@@ -0,0 +1,108 @@
+/*
+  Copyright (C) 2016
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _BENCH_SYSTEMS_HPP
+#define _BENCH_SYSTEMS_HPP
+
+#include <algorithm>
+#include <cmath>
+#include "types.hpp"
+#include "mpi.hpp"
+#include "System.hpp"
+#include "Particle.hpp"
+#include "esutil/RNG.hpp"
+#include "bc/OrthorhombicBC.hpp"
+#include "storage/DomainDecomposition.hpp"
+
+namespace espressopp {
+  namespace bench {
+
+    /** DomainDecomposition that makes the steps of decompose() public */
+    class BenchStorage : public storage::DomainDecomposition {
+    public:
+      BenchStorage(shared_ptr< System > system, const Int3D &nodeGrid, const Int3D &cellGrid)
+        : storage::DomainDecomposition(system, nodeGrid, cellGrid) {}
+
+      using storage::DomainDecomposition::decomposeRealParticles;
+    };
+
+    /** A Lennard-Jones liquid of n particles at the given density on all
+        processes: a simple cubic lattice with 10% random displacements,
+        so that consecutive ids are lattice neighbors along z. With
+        charged, the charges alternate between +1 and -1. Every process
+        generates the same positions and keeps its own. */
+    struct LJSystem {
+      shared_ptr< System > system;
+      shared_ptr< BenchStorage > storage;
+      Int3D nodeGrid, cellGrid;
+      real L, rc, skin, a;
+      longint n, nSide;
+
+      LJSystem(longint _n, bool charged = false, real density = 0.8442,
+               real _rc = 2.5, real _skin = 0.3)
+        : rc(_rc), skin(_skin), n(_n)
+      {
+        L = std::pow(n / density, 1.0 / 3.0);
+        nSide = longint(std::ceil(std::pow(real(n), 1.0 / 3.0) - 1e-9));
+        a = L / nSide;
+
+        // processes per axis as the storage unit tests choose them
+        int nodes = mpiWorld->size();
+        for (int i = 0; i < 3; ++i) {
+          if (nodes % 3 == 0) { nodes /= 3; nodeGrid[i] = 3; }
+          else if (nodes % 2 == 0) { nodes /= 2; nodeGrid[i] = 2; }
+          else { nodeGrid[i] = nodes; nodes = 1; }
+        }
+        for (int i = 0; i < 3; ++i) {
+          cellGrid[i] = std::max(1, int(L / (nodeGrid[i] * (rc + skin))));
+        }
+
+        system = make_shared< System >();
+        system->rng = make_shared< esutil::RNG >();
+        system->bc = make_shared< bc::OrthorhombicBC >(system->rng, Real3D(L));
+        storage = make_shared< BenchStorage >(system, nodeGrid, cellGrid);
+        system->storage = storage;
+        system->setSkin(skin);
+
+        esutil::RNG &rng = *system->rng;
+        for (longint id = 0; id < n; ++id) {
+          longint i = id / (nSide * nSide), j = (id / nSide) % nSide, k = id % nSide;
+          Real3D pos((i + 0.5 + 0.1 * (rng() - 0.5)) * a,
+                     (j + 0.5 + 0.1 * (rng() - 0.5)) * a,
+                     (k + 0.5 + 0.1 * (rng() - 0.5)) * a);
+          Particle *p = storage->addParticle(id, pos);
+          if (p) {
+            p->mass() = 1.0;
+            p->type() = 0;
+            if (charged) p->q() = (id % 2) ? -1.0 : 1.0;
+          }
+        }
+        storage->decompose();
+      }
+
+      longint nLocal() const { return storage->getNRealParticles(); }
+
+      /** true if id + 1 follows id on the same lattice row */
+      bool hasSuccessor(longint id) const { return (id + 1) % nSide != 0 && id + 1 < n; }
+    };
+  }
+}
+
+#endif
@@ -0,0 +1,67 @@
+#!/usr/bin/env python2
+#  Copyright (C) 2016
+#      Max Planck Institute for Polymer Research
+#  
+#  This file is part of ESPResSo++.
+#  
+#  ESPResSo++ is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#  
+#  ESPResSo++ is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#  
+#  You should have received a copy of the GNU General Public License
+#  along with this program.  If not, see <http://www.gnu.org/licenses/>. 
+
+"""Compare two result files of espp_bench.
+
+Prints the relative change of the time per iteration of every benchmark
+found in both files and exits with 1 if one of them is slower than the
+reference by more than the threshold.
+"""
+
+import argparse
+import json
+import sys
+
+def load(filename):
+    with open(filename) as f:
+        data = json.load(f)
+    return dict((b['name'], b) for b in data['benchmarks'])
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('reference', help='results of the reference build')
+    parser.add_argument('current', help='results to check')
+    parser.add_argument('--threshold', type=float, default=0.1,
+                        help='allowed relative slowdown (default 0.1)')
+    args = parser.parse_args()
+
+    ref = load(args.reference)
+    cur = load(args.current)
+    regressions = []
+    print '%-60s %14s %14s %9s' % ('benchmark', 'reference', 'current', 'change')
+    for name in sorted(set(ref) & set(cur)):
+        t0 = ref[name]['real_time']
+        t1 = cur[name]['real_time']
+        change = (t1 - t0) / t0 if t0 > 0 else 0.0
+        flag = ''
+        if change > args.threshold:
+            flag = '  SLOWER'
+            regressions.append(name)
+        print '%-60s %12.1f%s %12.1f%s %+8.1f%%%s' % (name, t0, ref[name]['time_unit'],
+                                                     t1, cur[name]['time_unit'], 100 * change, flag)
+    for name in sorted(set(ref) ^ set(cur)):
+        print '%-60s only in %s' % (name, args.reference if name in ref else args.current)
+
+    if regressions:
+        print '%d benchmark(s) slower by more than %.0f%%' % (len(regressions), 100 * args.threshold)
+        return 1
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -60,8 +60,10 @@ namespace espressopp {
       // take as default the static buffer to avoid dynamic allocation
 
       capacity  = BUFFER_SIZE; 
+      ownCapacity = BUFFER_SIZE;
       usedSize  = 0;
       buf       = staticBuf;
+      extBuf    = 0;
 
       pos = 0;  // set buffer position to the start
     }
@@ -72,6 +74,31 @@ namespace espressopp {
       pos      = 0;
     }
 
+    /** Use the external memory mem, holding size bytes of data and room
+        for capacity bytes, instead of the own buffer until detach(),
+        e.g. a segment of a shared memory window. If an OutBuffer runs
+        out of room, the data moves to its own buffer and isAttached()
+        becomes false. */
+    void attach(char *mem, int size, int _capacity)
+    {
+      extBuf   = mem;
+      buf      = mem;
+      capacity = _capacity;
+      usedSize = size;
+      pos      = 0;
+    }
+
+    /** Go back to the own buffer, which is then empty. */
+    void detach()
+    {
+      extBuf   = 0;
+      buf      = dynBuf ? dynBuf.get() : staticBuf;
+      capacity = ownCapacity;
+      reset();
+    }
+
+    bool isAttached() const { return extBuf != 0 && buf == extBuf; }
+
   protected:
 
     static LOG4ESPP_DECL_LOGGER(logger);
@@ -84,7 +111,10 @@ namespace espressopp {
 
     boost::scoped_array<char> dynBuf;  //!< dynamic buffer, auto freed
 
+    char* extBuf;  //!< external memory while attached, else 0
+
     int  capacity;  //!< allocated size of the buffer
+    int  ownCapacity;  //!< allocated size of the own buffer
     int  usedSize;   //!< used size of the buffer
     int  pos;        //!< current buffer position
 
@@ -92,6 +122,7 @@ namespace espressopp {
     {
        // fprintf(stderr, "realloc buffer from %d to capacity %d, used size = %d\n", capacity, size, usedSize);
        capacity = size;
+       ownCapacity = size;
        char* newBuf = new char[capacity];
        for (int i = 0; i < usedSize; i++) newBuf[i] = buf[i];
        dynBuf.reset(newBuf);
@@ -226,6 +257,18 @@ namespace espressopp {
       return req;
     }
 
+    /** Post the receive of a message whose size msgSize is known in
+        advance, without probing for it, so that it can make progress
+        before the caller waits for it. */
+    mpi::request irecv(longint sender, int tag, int msgSize) {
+      reset();
+      if (msgSize > capacity) {
+        allocate(msgSize);
+      }
+      usedSize = msgSize;
+      return comm.irecv(sender, tag, buf, msgSize);
+    }
+
   };
 
   class OutBuffer : public Buffer {
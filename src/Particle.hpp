@@ -36,6 +36,8 @@
 #include "Real3D.hpp"
 #include "Int3D.hpp"
 #include <map>
+#include <cstring>
+#include <boost/cstdint.hpp>
 
 namespace espressopp {
 
@@ -419,6 +421,59 @@ namespace espressopp {
       ghost() = 1;
     }
 
+    /** size of the state packed by packState() */
+    static size_t stateSize() {
+      return 2 * sizeof(boost::int64_t) + 6 * sizeof(boost::int32_t) + 14 * sizeof(double);
+    }
+
+    /** copy properties, position, momentum and image, but not the force,
+        to dst field by field, without the padding of the structs and in
+        fixed widths; returns the end of the copied data */
+    char *packState(char *dst) const {
+      dst = packField(dst, (boost::int64_t)p.id);
+      dst = packField(dst, (boost::int64_t)p.type);
+      dst = packField(dst, (double)p.mass);
+      dst = packField(dst, (double)p.q);
+      dst = packField(dst, (double)p.lambda);
+      dst = packField(dst, (double)p.drift);
+      dst = packField(dst, (double)p.lambdaDeriv);
+      dst = packField(dst, (boost::int32_t)p.state);
+      dst = packField(dst, (boost::int32_t)p.res_id);
+      dst = packField(dst, (boost::int32_t)p.incr_state);
+      for (int d = 0; d < 3; ++d) dst = packField(dst, (double)r.p[d]);
+      dst = packField(dst, (double)r.radius);
+      dst = packField(dst, (double)r.extVar);
+      for (int d = 0; d < 3; ++d) dst = packField(dst, (double)m.v[d]);
+      dst = packField(dst, (double)m.vradius);
+      for (int d = 0; d < 3; ++d) dst = packField(dst, (boost::int32_t)l.i[d]);
+      return dst;
+    }
+
+    /** inverse of packState() */
+    const char *unpackState(const char *src) {
+      boost::int64_t i64;
+      boost::int32_t i32;
+      double x;
+      src = unpackField(src, i64); p.id = i64;
+      src = unpackField(src, i64); p.type = i64;
+      src = unpackField(src, x); p.mass = x;
+      src = unpackField(src, x); p.q = x;
+      src = unpackField(src, x); p.lambda = x;
+      src = unpackField(src, x); p.drift = x;
+      src = unpackField(src, x); p.lambdaDeriv = x;
+      src = unpackField(src, i32); p.state = i32;
+      src = unpackField(src, i32); p.res_id = i32;
+      src = unpackField(src, i32); p.incr_state = i32;
+      p.change_flag = 0;
+      for (int d = 0; d < 3; ++d) { src = unpackField(src, x); r.p[d] = x; }
+      src = unpackField(src, x); r.radius = x;
+      src = unpackField(src, x); r.extVar = x;
+      for (int d = 0; d < 3; ++d) { src = unpackField(src, x); m.v[d] = x; }
+      src = unpackField(src, x); m.vradius = x;
+      for (int d = 0; d < 3; ++d) { src = unpackField(src, i32); l.i[d] = i32; }
+      return src;
+    }
+
     bool operator<(Particle other) const {
       return p.id < other.id();
     }
@@ -447,6 +502,18 @@ namespace espressopp {
     ParticleLocal l;
     ParticleForce f;
 
+    template< typename T >
+    static char *packField(char *dst, T value) {
+      std::memcpy(dst, &value, sizeof(T));
+      return dst + sizeof(T);
+    }
+
+    template< typename T >
+    static const char *unpackField(const char *src, T &value) {
+      std::memcpy(&value, src, sizeof(T));
+      return src + sizeof(T);
+    }
+
     friend class boost::serialization::access;
     template< class Archive >
     void serialize(Archive &ar, const unsigned int version)
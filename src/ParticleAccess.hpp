@@ -32,6 +32,12 @@ namespace espressopp {
     virtual ~ParticleAccess() {}
 
     virtual void perform_action() = 0;
+
+    /** The observables (interaction::Interaction::ENERGY, VIRIAL,
+        VIRIAL_TENSOR) perform_action() reads from the interactions;
+        ExtAnalyze asks the integrator to accumulate them in the force
+        pass of the analysed steps. */
+    virtual int getRequiredObservables() { return 0; }
     
     static void registerPython();
   };
@@ -29,6 +29,7 @@
 #include "mpi.hpp"
 #include "esutil/Error.hpp"
 
+#include <algorithm>
 #include <limits>
 
 #include <mpi4py/mpi4py.h>
@@ -139,6 +140,27 @@ namespace espressopp {
 	return shortRangeInteractions.size();
   }
 
+  void System::requestRunObservables(int which)
+  {
+    if (which) runObservableRequests.push_back(which);
+  }
+
+  void System::releaseRunObservables(int which)
+  {
+    std::vector< int >::iterator it =
+      std::find(runObservableRequests.begin(), runObservableRequests.end(), which);
+    if (it != runObservableRequests.end()) runObservableRequests.erase(it);
+  }
+
+  int System::getRunObservables() const
+  {
+    int which = 0;
+    for (size_t i = 0; i < runObservableRequests.size(); ++i) {
+      which |= runObservableRequests[i];
+    }
+    return which;
+  }
+
   /* If one wants overload scaleVolume it should be done here as well:
    * - Storage
    * - BC
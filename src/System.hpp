@@ -29,6 +29,7 @@
 #include "boost/enable_shared_from_this.hpp"
 #include "interaction/Interaction.hpp"
 #include "types.hpp"
+#include <vector>
 
 namespace espressopp {
 
@@ -73,8 +74,23 @@ namespace espressopp {
     void removeInteraction(int i);
     shared_ptr< interaction::Interaction > getInteraction(int i);
     int getNumberOfInteractions();
+
+    /** Request the observables which (interaction::Interaction::ENERGY,
+        VIRIAL, VIRIAL_TENSOR) after every run: the integrator lets the
+        interactions accumulate them in the force pass of the last step,
+        so that analysis after the run does not walk the lists again.
+        Several requests are combined. */
+    void requestRunObservables(int which);
+    /** withdraw a request made with requestRunObservables() */
+    void releaseRunObservables(int which);
+    /** the observables requested after every run */
+    int getRunObservables() const;
+
     static void registerPython();
 
+  private:
+    std::vector< int > runObservableRequests;
+
   };
 }
 #endif
@@ -31,10 +31,19 @@
 #include "storage/Storage.hpp"
 #include "bc/BC.hpp"
 #include "iterator/CellListAllPairsIterator.hpp"
+#include "esutil/Profiler.hpp"
+#include <algorithm>
 
 namespace espressopp {
 using namespace espressopp::iterator;
 
+namespace {
+  // pairs of two real particles do not need the ghost positions
+  inline bool isInteriorPair(const espressopp::ParticlePair& pair) {
+    return !pair.first->ghost() && !pair.second->ghost();
+  }
+}
+
 LOG4ESPP_LOGGER(DynamicExcludeList::theLogger, "DynamicExcludeList");
 
 DynamicExcludeList::DynamicExcludeList(shared_ptr<integrator::MDIntegrator> integrator):
@@ -208,6 +217,11 @@ void DynamicExcludeList::registerPython() {
     cutVerlet = cut + system -> getSkin();
     cutsq = cutVerlet * cutVerlet;
     builds = 0;
+    pairsChecked = 0;
+    timeRebuild_ = 0.0;
+    compact = false;
+    pairsMaterialized = false;
+    nInterior = 0;
 
     exList = boost::make_shared<ExcludeList>();
     isDynamicExList = false;
@@ -231,6 +245,11 @@ void DynamicExcludeList::registerPython() {
     cutVerlet = cut + system -> getSkin();
     cutsq = cutVerlet * cutVerlet;
     builds = 0;
+    pairsChecked = 0;
+    timeRebuild_ = 0.0;
+    compact = false;
+    pairsMaterialized = false;
+    nInterior = 0;
 
     exList = dynamicExList_->getExList();
 
@@ -277,19 +296,30 @@ void DynamicExcludeList::registerPython() {
   
   void VerletList::rebuild()
   {
+    esutil::Profiler::Scope profile("verletListRebuild");
     real time0 = wallTimer.getElapsedTime();
     cutVerlet = cut + getSystem() -> getSkin();
     cutsq = cutVerlet * cutVerlet;
     
     vlPairs.clear();
 
+    if (compact) {
+      rebuildCompact();
+      builds++;
+      LOG4ESPP_DEBUG(theLogger, "rebuilt compact VerletList (count=" << builds << "), cutsq = " << cutsq
+                   << " local size = " << nbIndices.size());
+      timeRebuild_ += wallTimer.getElapsedTime() - time0;
+      return;
+    }
+
     // add particles to adress zone
     CellList cl = getSystem()->storage->getRealCells();
     LOG4ESPP_DEBUG(theLogger, "local cell list size = " << cl.size());
-    for (CellListAllPairsIterator it(cl); it.isValid(); ++it) {
+    for (CellListAllPairsIterator it(cl); it.isValid(); ++it, ++pairsChecked) {
       checkPair(*it->first, *it->second);
       LOG4ESPP_DEBUG(theLogger, "checking particles " << it->first->id() << " and " << it->second->id());
     }
+    partitionPairs();
     
     builds++;
     LOG4ESPP_DEBUG(theLogger, "rebuilt VerletList (count=" << builds << "), cutsq = " << cutsq
@@ -298,6 +328,106 @@ void DynamicExcludeList::registerPython() {
   }
   
 
+  /*-------------------------------------------------------------*/
+
+  void VerletList::rebuildCompact()
+  {
+    storage::Storage& storage = *getSystem()->storage;
+    storage::ParticleArrays& pa = storage.getParticleArrays();
+    pa.ensureContents();
+
+    nbOffsets.clear();
+    nbIndices.clear();
+    pairsMaterialized = false;
+    nbOffsets.reserve(pa.getNReal() + 1);
+
+    if (pa.size() == 0) {
+      nbOffsets.push_back(0);
+      return;
+    }
+
+    const bool checkExclusions = !exList->empty();
+    const Cell *firstCell = storage.getFirstCell();
+
+    // the rows of the list are filled in array order, i.e. cell by cell
+    // in the order in which the arrays store the real cells
+    CellList& realCells = pa.getRealCells();
+    for (CellList::Iterator cit(realCells); cit.isValid(); ++cit) {
+      Cell *cell = *cit;
+      longint cellIdx = cell - firstCell;
+      int end = pa.cellEnd(cellIdx);
+
+      for (int i = pa.cellBegin(cellIdx); i < end; ++i) {
+        nbOffsets.push_back(nbIndices.size());
+        // same pairs as CellListAllPairsIterator: first within the cell,
+        // then with the neighbor cells
+        checkNeighbors(pa, i, i + 1, end, checkExclusions);
+        for (NeighborCellList::Iterator ncit(cell->neighborCells); ncit.isValid(); ++ncit) {
+          if (ncit->useForAllPairs) continue;
+          longint ncellIdx = ncit->cell - firstCell;
+          checkNeighbors(pa, i, pa.cellBegin(ncellIdx), pa.cellEnd(ncellIdx), checkExclusions);
+        }
+      }
+    }
+    nbOffsets.push_back(nbIndices.size());
+  }
+
+  inline void VerletList::checkNeighbors(storage::ParticleArrays& pa, int i,
+                                         int jbegin, int jend, bool checkExclusions)
+  {
+    const real xi = pa.x[i], yi = pa.y[i], zi = pa.z[i];
+    pairsChecked += std::max(jend - jbegin, 0);
+    for (int j = jbegin; j < jend; ++j) {
+      real dx = xi - pa.x[j];
+      real dy = yi - pa.y[j];
+      real dz = zi - pa.z[j];
+      if (dx*dx + dy*dy + dz*dz > cutsq) continue;
+      if (checkExclusions &&
+          exList->count(std::make_pair(pa.getParticle(i).id(), pa.getParticle(j).id())) == 1) continue;
+      nbIndices.push_back(j);
+    }
+  }
+
+  void VerletList::materializePairs()
+  {
+    storage::ParticleArrays& pa = getParticleArrays();
+    vlPairs.clear();
+    vlPairs.reserve(nbIndices.size());
+    int nRows = nbOffsets.size() - 1;
+    for (int i = 0; i < nRows; ++i) {
+      Particle& p1 = pa.getParticle(i);
+      for (int k = nbOffsets[i]; k < nbOffsets[i+1]; ++k) {
+        vlPairs.add(p1, pa.getParticle(nbIndices[k]));
+      }
+    }
+    partitionPairs();
+    pairsMaterialized = true;
+  }
+
+  void VerletList::partitionPairs()
+  {
+    nInterior = std::stable_partition(vlPairs.begin(), vlPairs.end(), isInteriorPair)
+              - vlPairs.begin();
+  }
+
+  void VerletList::setCompact(bool _compact)
+  {
+    if (_compact == compact) return;
+    compact = _compact;
+    if (compact) {
+      getSystem()->storage->setParticleArraysEnabled(true);
+    } else {
+      std::vector<int>().swap(nbOffsets);
+      std::vector<int>().swap(nbIndices);
+    }
+    rebuild();
+  }
+
+  storage::ParticleArrays& VerletList::getParticleArrays()
+  {
+    return getSystem()->storage->getParticleArrays();
+  }
+
   /*-------------------------------------------------------------*/
   
   void VerletList::checkPair(Particle& pt1, Particle& pt2)
@@ -334,16 +464,17 @@ void DynamicExcludeList::registerPython() {
 
   int VerletList::localSize() const
   {
-    System& system = getSystemRef();
+    if (compact) return nbIndices.size();
     return vlPairs.size();
   }
 
   python::tuple VerletList::getPair(int i) {
-	  if (i <= 0 || i > vlPairs.size()) {
+	  PairList& pairs = getPairs();
+	  if (i <= 0 || i > pairs.size()) {
 	    std::cout << "ERROR VerletList pair " << i << " does not exists" << std::endl;
 	    return python::make_tuple();
 	  } else {
-	    return python::make_tuple(vlPairs[i-1].first->id(), vlPairs[i-1].second->id());
+	    return python::make_tuple(pairs[i-1].first->id(), pairs[i-1].second->id());
 	  }
   }
 
@@ -401,6 +532,8 @@ void DynamicExcludeList::registerPython() {
       .def(init<shared_ptr<System>, real, shared_ptr<DynamicExcludeList>, bool>())
       .add_property("system", &SystemAccess::getSystem)
       .add_property("builds", &VerletList::getBuilds, &VerletList::setBuilds)
+      .add_property("pairsChecked", &VerletList::getPairsChecked)
+      .add_property("compact", &VerletList::isCompact, &VerletList::setCompact)
       .def("totalSize", &VerletList::totalSize)
       .def("localSize", &VerletList::localSize)
       .def("getPair", &VerletList::getPair)
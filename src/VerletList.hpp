@@ -37,6 +37,7 @@
 #include "FixedPairList.hpp"
 #include "FixedTripleList.hpp"
 #include "FixedQuadrupleList.hpp"
+#include "storage/ParticleArrays.hpp"
 
 namespace espressopp {
 typedef boost::unordered_set<std::pair<longint, longint> > ExcludeList;
@@ -100,10 +101,38 @@ class DynamicExcludeList {
 
     ~VerletList();
 
+    /** Get the pairs of the list. In compact mode the pairs are
+        generated from the neighbour index arrays on first access
+        after a rebuild. */
     PairList& getPairs() {
+      if (compact && !pairsMaterialized) materializePairs();
       return vlPairs;
     }
 
+    /** Get the number of interior pairs. The pairs of two real particles
+        come first in getPairs(); they can be computed before the ghost
+        positions are up to date. */
+    int getNumInteriorPairs() {
+      if (compact && !pairsMaterialized) materializePairs();
+      return nInterior;
+    }
+
+    /** Switch between the pair list of particle pointers and the compact
+        neighbour layout. The compact layout stores, for every real
+        particle, a contiguous range of 32-bit indices into the
+        storage's ParticleArrays (CSR format, ordered by cells). Enabling
+        it also enables the particle arrays of the storage. */
+    void setCompact(bool _compact);
+    bool isCompact() const { return compact; }
+
+    /** CSR row offsets of the compact layout: the neighbours of the real
+        particle with array index i are
+        getNeighborIndices()[getNeighborOffsets()[i] .. getNeighborOffsets()[i+1]). */
+    const std::vector<int>& getNeighborOffsets() const { return nbOffsets; }
+    const std::vector<int>& getNeighborIndices() const { return nbIndices; }
+
+    storage::ParticleArrays& getParticleArrays();
+
     python::tuple getPair(int i);
     
     real getVerletCutoff(); // returns cutoff + skin
@@ -130,12 +159,18 @@ class DynamicExcludeList {
 
     longint excludeListSize() const;
 
+    /** the excluded pairs, both (pid1, pid2) and (pid2, pid1) */
+    shared_ptr<ExcludeList> getExcludeList() { return exList; }
+
     /** Get the number of times the Verlet list has been rebuilt */
     int getBuilds() const { return builds; }
 
     /** Set the number of times the Verlet list has been rebuilt */
     void setBuilds(int _builds) { builds = _builds; }
 
+    /** Get the number of distances computed in all rebuilds */
+    long getPairsChecked() const { return pairsChecked; }
+
     /** Register this class so it can be used from Python. */
     static void registerPython();
 
@@ -145,7 +180,17 @@ class DynamicExcludeList {
   protected:
 
     void checkPair(Particle &pt1, Particle &pt2);
+    void rebuildCompact();
+    void checkNeighbors(storage::ParticleArrays& pa, int i,
+                        int jbegin, int jend, bool checkExclusions);
+    void materializePairs();
+    void partitionPairs();
     PairList vlPairs;
+    int nInterior;
+    bool compact;
+    bool pairsMaterialized;
+    std::vector<int> nbOffsets;
+    std::vector<int> nbIndices;
     shared_ptr<ExcludeList> exList; // exclusion list
     shared_ptr<DynamicExcludeList> dynamicExcludeList;
     bool isDynamicExList;
@@ -155,6 +200,7 @@ class DynamicExcludeList {
     real cutVerlet;
     
     int builds;
+    long pairsChecked;
     boost::signals2::connection connectionResort;
 
     /** timers */
@@ -168,6 +214,7 @@ class DynamicExcludeList {
 
     void resetTimers() {
       timeRebuild_ = 0.0;
+      pairsChecked = 0;
       wallTimer.reset();
     }
 
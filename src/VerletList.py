@@ -53,6 +53,32 @@ espressopp.VerletList
 
 		:rtype: returns global number of pairs
 
+.. attribute:: espressopp.VerletList.compact
+
+		If True, the list is stored in a compact neighbour layout
+		(32-bit particle indices per real particle) instead of a list
+		of particle pointer pairs. This halves the memory of the list
+		and lets the force loops keep the data of the first particle
+		local. Enabling it also enables the particle arrays of the
+		storage. For the potentials with a batched kernel (e.g.
+		LennardJones, Morse, Tabulated, CoulombTruncated), the
+		force loop then reads positions, charges and types from the
+		particle arrays only. Default is False.
+
+		>>> vl = espressopp.VerletList(system, cutoff=rc)
+		>>> vl.compact = True
+
+.. attribute:: espressopp.VerletList.builds
+
+		Number of times the list has been rebuilt.
+
+.. attribute:: espressopp.VerletList.pairsChecked
+
+		Number of distances computed in the rebuilds on this process.
+		Together with builds and the timeRebuild entry of get_timers()
+		it shows how much the rebuilds cost, e.g. when tuning the skin
+		or VelocityVerlet.pairDisplacementResort.
+
 
 *********************************
 **espressopp.DynamicExcludeList**
@@ -219,7 +245,7 @@ if pmi.isController:
     __metaclass__ = pmi.Proxy
     pmiproxydefs = dict(
       cls = 'espressopp.VerletListLocal',
-      pmiproperty = [ 'builds' ],
+      pmiproperty = [ 'builds', 'compact', 'pairsChecked' ],
       pmicall = [ 'totalSize', 'exclude', 'connect', 'disconnect', 'getVerletCutoff', 'setVerletCutoff' ],
       pmiinvoke = [ 'getAllPairs', 'get_timers', 'excludeListSize' ]
     )
@@ -23,6 +23,7 @@
 #include "Autocorrelation.hpp"
 #include "iterator/CellListIterator.hpp"
 #include "esutil/Error.hpp"
+#include "esutil/Correlator.hpp"
 #include "mpi.h"
 
 using namespace std;
@@ -68,98 +69,26 @@ namespace espressopp {
       
       System& system = getSystemRef();
       
-      int n_nodes = system.comm -> size();
-      int this_node = system.comm -> rank();
-
-      // TODO it could be a problem if   n_nodes > total_num !!!
-      unsigned int num_m[n_nodes];
-      unsigned int num_mH[n_nodes];
+      python::list pyli;
       
-      if(this_node == 0){
-        
-        // it is 1+2+3+...+M
-        double local_num = ( (double)M * (double)(M + 1) / 2.0) / (double)n_nodes + 1.0;
-        
-        for(int i=0; i<n_nodes; i++){
-          double max_num = (i+1) * local_num;
-          
-          unsigned int m_max = (unsigned int) ( ( sqrt(1.0+8.0*max_num) - 1.0 )/2. );
-          
-          unsigned int lastNum = (i==0) ? 0 : num_mH[i-1];
-          
-          if(m_max-lastNum==0)
-            num_mH[i] = num_mH[i-1] + 1;
-          else
-            num_mH[i] = m_max;
-          
-          if(num_mH[i] > M) num_mH[i] = M;
+      // all processes hold the same values; the FFT over all time origins
+      // is O(M log M), so rank 0 does it alone
+      if(system.comm->rank() == 0 && M > 0){
+        esutil::FFTCorrelator correlator(M);
+        vector<real> series(M);
+        vector<real> Z(M, 0.0);
+        for(int d=0; d<3; d++){
+          for(size_t n=0; n<M; n++) series[n] = valueList[n][d];
+          correlator.addAutocorrelation(&series[0], &Z[0]);
         }
         
-        for(int i=0; i<n_nodes-1; i++)
-          num_m[i] = M - num_mH[n_nodes-2-i];
-        num_m[n_nodes-1] = M;
-      }
-
-      boost::mpi::broadcast(*system.comm, num_m, n_nodes, 0);
-      
-      // now num_m[i], i - cpu number, is a number of series in "for" statement for each cpu
-      
-      unsigned int min_m = (this_node==0) ? 0 : num_m[this_node-1];
-      unsigned int max_m = num_m[this_node];
-
-      real* Z;
-      Z = new real[M];
-      
-      cout<< "calculating autocorrelation.." << endl;
-      int perc=0;
-      real denom = 100.0 / (real)(max_m-min_m);
-      for(unsigned int m=min_m; m<max_m; m++){
-        Z[m] = 0.0;
-        for(unsigned int n=0; n<M-m; n++){
-          Z[m] += getValue(n + m) *  getValue(n);
-        }
+        real coef = 3.0; // only if value is Real3D
         
-        /*
-         * additional calculations slow down routine but from the other hand
-         * it helps to monitor progress
-         */
-        if(system.comm->rank()==0){
-          perc = (int)(m*denom);
-          if(perc%5==0){
-            cout<<"calculation progress (autocorrelation): "<< perc << " %\r" <<flush;
-          }
+        for(size_t m=0; m<M; m++){
+          pyli.append( Z[m] / ( (real)(M-m)*coef ) );
         }
       }
       
-      if(system.comm->rank()==0)
-        cout<<"calculation progress (autocorrelation): 100 %" <<endl;
-      
-      real coef = 3.0; // only if value is Real3D
-      
-      for(unsigned int m=min_m; m<max_m; m++){
-        Z[m] /= ( (real)(M-m)*coef );
-      }
-      
-      // TODO probably could be done nicer. gather doesn't work with different length of array
-      unsigned long int MM = M * n_nodes;
-      real* totZ = new real[MM];
-      boost::mpi::gather(*system.comm, Z, M, totZ, 0);
-      
-      python::list pyli;
-      
-      if(this_node == 0){
-        int count = 0;
-        for(int m=0; m<M; m++){
-          if( m >= num_m[count] ) count ++;
-          pyli.append( totZ[M*count + m] );
-        }
-      }
-      
-      delete [] Z;
-      Z = NULL;
-      delete [] totZ;
-      totZ = NULL;
-      
       return pyli;
     }
     
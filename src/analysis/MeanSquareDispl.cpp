@@ -21,6 +21,7 @@
 */
 
 #include "MeanSquareDispl.hpp"
+#include "esutil/Correlator.hpp"
 //#include <algorithm> //for std::sort
 using namespace std;
 //using namespace espressopp;
@@ -81,27 +82,30 @@ namespace espressopp {
         centerOfMassList.push_back( posCOM_sum / mass_sum );
       }
       
-      // MSD calculation
-      int perc=0, perc1=0;
-      real denom = 100.0 / (real)M;
+      // MSD calculation, all time origins at once via FFT
       for(int m=0; m<M; m++){
-        
         totZ[m] = 0.0;
         Z[m] = 0.0;
-        for(int n=0; n<M-m; n++){
-          for (vector<longint>::iterator itr=localIDs.begin(); itr!=localIDs.end(); ++itr) {
-            size_t i = *itr;
-            
-            Real3D pos1 = getConf(n + m)->getCoordinates(i); // - centerOfMassList[n+m];
-            Real3D pos2 = getConf(n)->getCoordinates(i); //     - centerOfMassList[n];
-            Real3D delta = pos2 - pos1;
-            Z[m] += delta.sqr();
+      }
+      if(M > 0){
+        esutil::FFTCorrelator correlator(M);
+        vector<real> series[3];
+        for(int d=0; d<3; d++) series[d].resize(M);
+        int perc=0, count=0;
+        real denom = 100.0 / (real)std::max<size_t>(localIDs.size(), 1);
+        for (vector<longint>::iterator itr=localIDs.begin(); itr!=localIDs.end(); ++itr) {
+          size_t i = *itr;
+          for(int n=0; n<M; n++){
+            Real3D pos = getConf(n)->getCoordinates(i);
+            for(int d=0; d<3; d++) series[d][n] = pos[d];
           }
-        }
-        if(print_progress && system.comm->rank()==0){
-          perc = (int)(m*denom);
-          if(perc%5==0){
-            cout<<"calculation progress (mean square displacement): "<< perc << " %\r"<<flush;
+          for(int d=0; d<3; d++) correlator.addSquareDisplacement(&series[d][0], Z);
+
+          if(print_progress && system.comm->rank()==0){
+            perc = (int)((count++)*denom);
+            if(perc%5==0){
+              cout<<"calculation progress (mean square displacement): "<< perc << " %\r"<<flush;
+            }
           }
         }
       }
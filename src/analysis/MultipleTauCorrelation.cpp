@@ -0,0 +1,182 @@
+/*
+  Copyright (C) 2016
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "python.hpp"
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include "MultipleTauCorrelation.hpp"
+#include "PressureTensor.hpp"
+#include "storage/Storage.hpp"
+#include "iterator/CellListIterator.hpp"
+#include "bc/BC.hpp"
+#include "esutil/Error.hpp"
+
+namespace espressopp {
+  namespace analysis {
+
+    using namespace iterator;
+
+    LOG4ESPP_LOGGER(MultipleTauCorrelation::logger, "MultipleTauCorrelation");
+
+    MultipleTauCorrelation::MultipleTauCorrelation(shared_ptr< System > system,
+                                                   std::string _key, int _p, int _m)
+      : ParticleAccess(system), key(_key), p(_p), m(_m), nTotal(0)
+    {
+      if (key != "unfolded" && key != "velocity" && key != "stress")
+        throw std::invalid_argument("MultipleTauCorrelation: key must be unfolded, velocity or stress");
+      // checks p and m
+      esutil::MultipleTauCorrelator check(0, p, m, esutil::MultipleTauCorrelator::PRODUCT);
+    }
+
+    void MultipleTauCorrelation::reset() {
+      correlator.reset();
+      slotOfId.clear();
+      nTotal = 0;
+    }
+
+    void MultipleTauCorrelation::collectParticleValues(std::vector< real >& values) {
+      System &system = getSystemRef();
+      mpi::communicator &comm = *system.comm;
+      const int nprocs = comm.size();
+      esutil::Error err(system.comm);
+
+      // records of (id, value[3]) for the process keeping the series
+      Real3D L = system.bc->getBoxL();
+      std::vector< std::vector< real > > send(nprocs);
+      CellList realCells = system.storage->getRealCells();
+      for (CellListIterator cit(realCells); !cit.isDone(); ++cit) {
+        Real3D v;
+        if (key == "velocity") {
+          v = cit->velocity();
+        } else {
+          const Real3D &pos = cit->position();
+          const Int3D &img = cit->image();
+          for (int d = 0; d < 3; ++d) v[d] = pos[d] + img[d] * L[d];
+        }
+        std::vector< real > &buf = send[cit->id() % nprocs];
+        buf.push_back(cit->id());
+        buf.push_back(v[0]);
+        buf.push_back(v[1]);
+        buf.push_back(v[2]);
+      }
+
+      std::vector< int > sendCnt(nprocs), sendDsp(nprocs), recvCnt(nprocs), recvDsp(nprocs);
+      for (int r = 0; r < nprocs; ++r) sendCnt[r] = send[r].size();
+      MPI_Alltoall(&sendCnt[0], 1, MPI_INT, &recvCnt[0], 1, MPI_INT, comm);
+      int nSend = 0, nRecv = 0;
+      for (int r = 0; r < nprocs; ++r) {
+        sendDsp[r] = nSend; nSend += sendCnt[r];
+        recvDsp[r] = nRecv; nRecv += recvCnt[r];
+      }
+      std::vector< real > sendBuf(nSend + 1), recvBuf(nRecv + 1);
+      for (int r = 0; r < nprocs; ++r) {
+        std::copy(send[r].begin(), send[r].end(), sendBuf.begin() + sendDsp[r]);
+      }
+      MPI_Alltoallv(&sendBuf[0], &sendCnt[0], &sendDsp[0], MPI_DOUBLE,
+                    &recvBuf[0], &recvCnt[0], &recvDsp[0], MPI_DOUBLE, comm);
+
+      const int nRecords = nRecv / 4;
+      if (!correlator) {
+        // the first sample fixes the particles, in the order of their ids
+        std::vector< longint > ids(nRecords);
+        for (int k = 0; k < nRecords; ++k) ids[k] = (longint)recvBuf[4*k];
+        std::sort(ids.begin(), ids.end());
+        for (int k = 0; k < nRecords; ++k) slotOfId[ids[k]] = k;
+      } else if (nRecords != (int)slotOfId.size()) {
+        std::stringstream msg;
+        msg << "MultipleTauCorrelation: the number of particles has changed";
+        err.setException(msg.str());
+      }
+      err.checkException();
+
+      values.assign(3 * slotOfId.size(), 0.0);
+      for (int k = 0; k < nRecords; ++k) {
+        boost::unordered_map< longint, int >::const_iterator it =
+          slotOfId.find((longint)recvBuf[4*k]);
+        if (it == slotOfId.end()) {
+          std::stringstream msg;
+          msg << "MultipleTauCorrelation: unknown particle " << (longint)recvBuf[4*k];
+          err.setException(msg.str());
+          continue;
+        }
+        for (int d = 0; d < 3; ++d) values[3*it->second + d] = recvBuf[4*k + 1 + d];
+      }
+      err.checkException();
+    }
+
+    void MultipleTauCorrelation::sample() {
+      System &system = getSystemRef();
+      std::vector< real > values;
+      if (key == "stress") {
+        Tensor prt = PressureTensor(getSystem()).computeRaw();
+        if (system.comm->rank() == 0) {
+          values.push_back(prt[3]);
+          values.push_back(prt[4]);
+          values.push_back(prt[5]);
+        }
+      } else {
+        collectParticleValues(values);
+      }
+
+      if (!correlator) {
+        esutil::MultipleTauCorrelator::Mode mode = (key == "unfolded")
+          ? esutil::MultipleTauCorrelator::SQUARE_DIFFERENCE
+          : esutil::MultipleTauCorrelator::PRODUCT;
+        correlator.reset(new esutil::MultipleTauCorrelator(values.size(), p, m, mode));
+        longint nLocal = (key == "stress") ? values.size() : values.size() / 3;
+        mpi::all_reduce(*system.comm, nLocal, nTotal, std::plus< longint >());
+      }
+      correlator->add(values.empty() ? 0 : &values[0]);
+    }
+
+    python::list MultipleTauCorrelation::compute() {
+      python::list ret;
+      if (!correlator) return ret;
+
+      std::vector< long > lags;
+      std::vector< real > sums, counts;
+      correlator->getResult(lags, sums, counts);
+
+      // all processes have seen the same samples and have the same lags
+      std::vector< real > total(sums.size());
+      if (!sums.empty()) {
+        mpi::all_reduce(*getSystem()->comm, &sums[0], sums.size(), &total[0], std::plus< real >());
+      }
+      for (size_t i = 0; i < lags.size(); ++i) {
+        ret.append(python::make_tuple(lags[i], total[i] / (counts[i] * nTotal)));
+      }
+      return ret;
+    }
+
+    void MultipleTauCorrelation::registerPython() {
+      using namespace espressopp::python;
+      class_< MultipleTauCorrelation, bases< ParticleAccess >, boost::noncopyable >
+        ("analysis_MultipleTauCorrelation",
+         init< shared_ptr< System >, std::string, int, int >())
+        .add_property("key", &MultipleTauCorrelation::getKey)
+        .add_property("num_samples", &MultipleTauCorrelation::getNumSamples)
+        .def("sample", &MultipleTauCorrelation::sample)
+        .def("reset", &MultipleTauCorrelation::reset)
+        .def("compute", &MultipleTauCorrelation::compute)
+      ;
+    }
+  }
+}
@@ -0,0 +1,82 @@
+/*
+  Copyright (C) 2016
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ESPP_CLASS
+#ifndef _ANALYSIS_MULTIPLETAUCORRELATION_HPP
+#define _ANALYSIS_MULTIPLETAUCORRELATION_HPP
+
+#include "types.hpp"
+#include "ParticleAccess.hpp"
+#include "esutil/Correlator.hpp"
+#include "log4espp.hpp"
+#include <boost/scoped_ptr.hpp>
+#include <boost/unordered_map.hpp>
+#include <string>
+#include <vector>
+
+namespace espressopp {
+  namespace analysis {
+
+    /** Time correlation functions computed on the fly with a
+        multiple-tau correlator, without storing configurations.
+
+        key "unfolded": mean square displacement <|r(t) - r(0)|^2>,
+        key "velocity": velocity autocorrelation <v(0) . v(t)>,
+        key "stress":   autocorrelation of the off-diagonal pressure
+                        tensor components, averaged over xy, xz and yz.
+
+        The particle series are kept on a fixed process per particle
+        (id modulo the number of processes), every sample sends the
+        values there. The set of particles must not change.
+    */
+    class MultipleTauCorrelation : public ParticleAccess {
+    public:
+      MultipleTauCorrelation(shared_ptr< System > system, std::string key, int p, int m);
+      ~MultipleTauCorrelation() {}
+
+      void perform_action() { sample(); }
+
+      /// add the current configuration. Collective.
+      void sample();
+      void reset();
+      /// (lag in samples, correlation) for all lags. Collective.
+      python::list compute();
+
+      std::string getKey() const { return key; }
+      long getNumSamples() const { return correlator ? correlator->getNumSamples() : 0; }
+
+      static void registerPython();
+
+    private:
+      void collectParticleValues(std::vector< real >& values);
+
+      std::string key;
+      int p, m;
+      boost::scoped_ptr< esutil::MultipleTauCorrelator > correlator;
+      // slots of the particles whose series are kept here
+      boost::unordered_map< longint, int > slotOfId;
+      longint nTotal; // number of correlated objects over all processes
+
+      static LOG4ESPP_DECL_LOGGER(logger);
+    };
+  }
+}
+
+#endif
@@ -0,0 +1,103 @@
+#  Copyright (C) 2016
+#      Max Planck Institute for Polymer Research
+#  
+#  This file is part of ESPResSo++.
+#  
+#  ESPResSo++ is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#  
+#  ESPResSo++ is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#  
+#  You should have received a copy of the GNU General Public License
+#  along with this program.  If not, see <http://www.gnu.org/licenses/>. 
+
+
+
+r"""
+******************************************
+espressopp.analysis.MultipleTauCorrelation
+******************************************
+
+Time correlation functions computed on the fly with a multiple-tau
+correlator, so that long runs do not need to keep configurations in
+memory. Lags 0 .. p-1 (in samples) are exact, longer lags are computed
+from block averages of m, m^2, ... samples; the memory per particle grows
+only with the logarithm of the run length.
+
+* key 'unfolded': mean square displacement <|r(t) - r(0)|^2>
+* key 'velocity': velocity autocorrelation <v(0) . v(t)>
+* key 'stress': autocorrelation of the off-diagonal components of the
+  pressure tensor, averaged over xy, xz and yz (for the viscosity)
+
+>>> msd = espressopp.analysis.MultipleTauCorrelation(system, 'unfolded')
+>>> ext = espressopp.integrator.ExtAnalyze(msd, interval=10)
+>>> integrator.addExtension(ext)
+>>> integrator.run(1000000)
+>>> for lag, value in msd.compute():
+>>>     print lag * 10 * integrator.dt, value
+
+For stored configurations the classes MeanSquareDispl,
+VelocityAutocorrelation and Autocorrelation compute the exact correlations
+over all time origins with FFTs.
+
+.. function:: espressopp.analysis.MultipleTauCorrelation(system, key, p, m)
+
+		:param system: the system
+		:param key: (default: 'unfolded') 'unfolded', 'velocity' or 'stress'
+		:param p: (default: 16) number of lags per level, a multiple of m
+		:param m: (default: 2) averaging factor between the levels
+		:type system: espressopp.System
+		:type key: str
+		:type p: int
+		:type m: int
+
+.. function:: espressopp.analysis.MultipleTauCorrelation.sample()
+
+		Add the current state of the system.
+
+.. function:: espressopp.analysis.MultipleTauCorrelation.compute()
+
+		:rtype: list of (lag in samples, correlation) tuples
+
+.. function:: espressopp.analysis.MultipleTauCorrelation.reset()
+
+		Forget all samples.
+"""
+
+from espressopp.esutil import cxxinit
+from espressopp import pmi
+
+from espressopp.ParticleAccess import *
+from _espressopp import analysis_MultipleTauCorrelation
+
+class MultipleTauCorrelationLocal(ParticleAccessLocal, analysis_MultipleTauCorrelation):
+
+    def __init__(self, system, key='unfolded', p=16, m=2):
+        if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+            cxxinit(self, analysis_MultipleTauCorrelation, system, key, p, m)
+
+    def sample(self):
+        if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+            self.cxxclass.sample(self)
+
+    def reset(self):
+        if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+            self.cxxclass.reset(self)
+
+    def compute(self):
+        if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+            return self.cxxclass.compute(self)
+
+if pmi.isController:
+    class MultipleTauCorrelation(ParticleAccess):
+        __metaclass__ = pmi.Proxy
+        pmiproxydefs = dict(
+            cls =  'espressopp.analysis.MultipleTauCorrelationLocal',
+            pmicall = [ 'sample', 'reset', 'compute' ],
+            pmiproperty = [ 'key', 'num_samples' ]
+            )
@@ -29,6 +29,22 @@ namespace espressopp {
 
     LOG4ESPP_LOGGER(Observable::logger, "Observable");
 
+    Observable::~Observable() {
+      if (runObservables) {
+        try {
+          getSystemRef().releaseRunObservables(runObservables);
+        } catch (std::runtime_error&) {
+          // the system is gone, and with it the request
+        }
+      }
+    }
+
+    void Observable::useRunObservables() const {
+      if (runObservables) return;
+      runObservables = getRequiredObservables();
+      getSystemRef().requestRunObservables(runObservables);
+    }
+
     python::list Observable::compute_real_vector_python() {
       python::list ret;
       compute_real_vector();
@@ -46,8 +46,13 @@ namespace espressopp {
       Observable(shared_ptr< System > system) : SystemAccess(system) {
         result_type = old_format;
         observable_type = OTHER;
+        runObservables = 0;
       };
-      virtual ~Observable() {};
+      virtual ~Observable();
+
+      /** The observables (interaction::Interaction::ENERGY, VIRIAL,
+          VIRIAL_TENSOR) the computation reads from the interactions. */
+      virtual int getRequiredObservables() const { return 0; }
 
     public:
       /** for compatibilty with old compute function only, will be deleted soon */
@@ -77,6 +82,12 @@ namespace espressopp {
       static void registerPython();
 
      protected:
+      /** Called by compute methods that read the interactions: from the
+          first call on, the integrator accumulates the required
+          observables in the last step of every run, so the computations
+          after a run take them from the interactions' cache. */
+      void useRunObservables() const;
+
       result_types result_type;
       ObservableTypes observable_type;
       std::vector< real > result_real_vector;
@@ -85,6 +96,9 @@ namespace espressopp {
 
       static LOG4ESPP_DECL_LOGGER(logger);
 
+     private:
+      mutable int runObservables;  //!< observables requested from the system
+
     };
   }
 }
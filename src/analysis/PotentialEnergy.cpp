@@ -28,6 +28,7 @@ namespace espressopp {
 namespace analysis {
 
 real PotentialEnergy::compute_real() const {
+  useRunObservables();
   if (compute_global_)
     return interaction_->computeEnergy();
   else if (compute_at_)
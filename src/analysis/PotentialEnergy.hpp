@@ -46,6 +46,10 @@ class PotentialEnergy : public Observable {
   }
   ~PotentialEnergy() {}
   real compute_real() const;
+  // only the total energy is accumulated in the force pass
+  int getRequiredObservables() const {
+    return compute_global_ ? interaction::Interaction::ENERGY : 0;
+  }
 
   static void registerPython();
  private:
@@ -34,6 +34,10 @@ The object that computes potential energy of different interactions.
                 if set to `AT` then compute only atomitic part of potential energy.
             :type compute_method: str
 
+Once the total energy has been computed, the Verlet list and fixed pair
+interactions sum it up in the force computation of the last step of
+every run, so computing it right after a run does not walk the lists
+again.
 """
 
 from espressopp.esutil import cxxinit
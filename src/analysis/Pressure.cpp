@@ -43,6 +43,7 @@ namespace espressopp {
     real Pressure::compute() const {
 
       System& system = getSystemRef();
+      useRunObservables();
       mpi::communicator communic = *system.comm;
 
       // determine volume of the box
@@ -26,6 +26,7 @@
 
 #include "types.hpp"
 #include "Observable.hpp"
+#include "interaction/Interaction.hpp"
 
 namespace espressopp {
   namespace analysis {
@@ -36,6 +37,7 @@ namespace espressopp {
       ~Pressure() {}
       virtual real compute() const;
       real compute_real() const;
+      int getRequiredObservables() const { return interaction::Interaction::VIRIAL; }
 
       static void registerPython();
     };
@@ -28,6 +28,11 @@ espressopp.analysis.Pressure
 
 		:param system:
 		:type system:
+
+Once the pressure has been computed, the Verlet list and fixed pair
+interactions sum up their virials in the force computation of the last
+step of every run, so computing it right after a run does not walk the
+lists again.
 """
 from espressopp.esutil import cxxinit
 from espressopp import pmi
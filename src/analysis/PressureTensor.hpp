@@ -46,6 +46,8 @@ namespace espressopp {
       PressureTensor(shared_ptr< System > system) : AnalysisBaseTemplate< Tensor >(system) {}
       virtual ~PressureTensor() {}
 
+      int getRequiredObservables() { return interaction::Interaction::VIRIAL_TENSOR; }
+
       Tensor computeRaw() {
         System& system = getSystemRef();
 
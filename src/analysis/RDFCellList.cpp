@@ -0,0 +1,330 @@
+/*
+  Copyright (C) 2016
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "python.hpp"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include "RDFCellList.hpp"
+#include "storage/DomainDecomposition.hpp"
+#include "iterator/CellListIterator.hpp"
+#include "iterator/CellListAllPairsIterator.hpp"
+#include "bc/BC.hpp"
+
+namespace espressopp {
+  namespace analysis {
+
+    using namespace iterator;
+
+    LOG4ESPP_LOGGER(RDFCellList::logger, "RDFCellList");
+
+    RDFCellList::RDFCellList(shared_ptr< System > system, real _rmax, int _nbins)
+      : AnalysisBaseTemplate< std::vector< real > >(system), rmax(_rmax), nbins(_nbins)
+    {
+      if (rmax <= 0.0 || nbins <= 0)
+        throw std::invalid_argument("RDFCellList: rmax and nbins must be positive");
+      reset();
+    }
+
+    RDFCellList::RDFCellList(shared_ptr< System > system, shared_ptr< VerletList > vl,
+                             real _rmax, int _nbins)
+      : AnalysisBaseTemplate< std::vector< real > >(system), verletList(vl),
+        rmax(_rmax), nbins(_nbins)
+    {
+      if (rmax <= 0.0 || nbins <= 0)
+        throw std::invalid_argument("RDFCellList: rmax and nbins must be positive");
+      reset();
+    }
+
+    void RDFCellList::setRMax(real _rmax) {
+      if (_rmax <= 0.0)
+        throw std::invalid_argument("RDFCellList: rmax must be positive");
+      rmax = _rmax;
+      reset();
+    }
+
+    void RDFCellList::setNBins(int _nbins) {
+      if (_nbins <= 0)
+        throw std::invalid_argument("RDFCellList: nbins must be positive");
+      nbins = _nbins;
+      reset();
+    }
+
+    void RDFCellList::histogramVerletList(std::vector< real > &hist) {
+      const real rmax2 = rmax * rmax;
+      const real invdr = nbins / rmax;
+      PairList &pairs = verletList->getPairs();
+      for (PairList::Iterator it(pairs); it.isValid(); ++it) {
+        real d2 = (it->first->position() - it->second->position()).sqr();
+        if (d2 < rmax2) hist[(int)(sqrt(d2) * invdr)] += 1.0;
+      }
+    }
+
+    void RDFCellList::histogramStorageCells(std::vector< real > &hist) {
+      const real rmax2 = rmax * rmax;
+      const real invdr = nbins / rmax;
+      CellList realCells = getSystemRef().storage->getRealCells();
+      for (CellListAllPairsIterator it(realCells); it.isValid(); ++it) {
+        real d2 = (it->first->position() - it->second->position()).sqr();
+        if (d2 < rmax2) hist[(int)(sqrt(d2) * invdr)] += 1.0;
+      }
+    }
+
+    void RDFCellList::histogramHalo(std::vector< real > &hist) {
+      System &system = getSystemRef();
+      shared_ptr< storage::DomainDecomposition > dd =
+        dynamic_pointer_cast< storage::DomainDecomposition >(system.storage);
+      const storage::NodeGrid &nodeGrid = dd->getNodeGrid();
+      mpi::communicator &comm = *system.comm;
+      const int nprocs = comm.size();
+      const int myrank = comm.rank();
+
+      Real3D L = system.bc->getBoxL();
+      // real particles may have left the domain by up to half the skin
+      real margin = rmax + system.getSkin();
+
+      // domains of all processes
+      real myBox[6];
+      for (int d = 0; d < 3; ++d) {
+        myBox[d] = nodeGrid.getMyLeft(d);
+        myBox[3 + d] = nodeGrid.getMyRight(d);
+      }
+      std::vector< real > boxes;
+      mpi::all_gather(comm, myBox, 6, boxes);
+
+      // periodic images of the local particles near the other domains; a
+      // process also gets the shifted images of its own particles
+      std::vector< Real3D > local;
+      CellList realCells = system.storage->getRealCells();
+      for (CellListIterator cit(realCells); !cit.isDone(); ++cit) {
+        local.push_back(cit->position());
+      }
+
+      std::vector< std::vector< real > > send(nprocs);
+      for (int r = 0; r < nprocs; ++r) {
+        const real *lo = &boxes[6*r];
+        const real *hi = &boxes[6*r + 3];
+        for (size_t i = 0; i < local.size(); ++i) {
+          for (int sx = -1; sx <= 1; ++sx) {
+            real x = local[i][0] + sx * L[0];
+            if (x < lo[0] - margin || x >= hi[0] + margin) continue;
+            for (int sy = -1; sy <= 1; ++sy) {
+              real y = local[i][1] + sy * L[1];
+              if (y < lo[1] - margin || y >= hi[1] + margin) continue;
+              for (int sz = -1; sz <= 1; ++sz) {
+                real z = local[i][2] + sz * L[2];
+                if (z < lo[2] - margin || z >= hi[2] + margin) continue;
+                if (r == myrank && sx == 0 && sy == 0 && sz == 0) continue;
+                send[r].push_back(x);
+                send[r].push_back(y);
+                send[r].push_back(z);
+              }
+            }
+          }
+        }
+      }
+
+      std::vector< int > sendCnt(nprocs), sendDsp(nprocs), recvCnt(nprocs), recvDsp(nprocs);
+      for (int r = 0; r < nprocs; ++r) sendCnt[r] = send[r].size();
+      MPI_Alltoall(&sendCnt[0], 1, MPI_INT, &recvCnt[0], 1, MPI_INT, comm);
+      int nSend = 0, nRecv = 0;
+      for (int r = 0; r < nprocs; ++r) {
+        sendDsp[r] = nSend; nSend += sendCnt[r];
+        recvDsp[r] = nRecv; nRecv += recvCnt[r];
+      }
+      std::vector< real > sendBuf(nSend + 1), recvBuf(nRecv + 1);
+      for (int r = 0; r < nprocs; ++r) {
+        std::copy(send[r].begin(), send[r].end(), sendBuf.begin() + sendDsp[r]);
+      }
+      MPI_Alltoallv(&sendBuf[0], &sendCnt[0], &sendDsp[0], MPI_DOUBLE,
+                    &recvBuf[0], &recvCnt[0], &recvDsp[0], MPI_DOUBLE, comm);
+
+      // the local particles first, then the halo
+      const int nLocal = local.size();
+      std::vector< Real3D > &pos = local;
+      for (int k = 0; k < nRecv; k += 3) {
+        pos.push_back(Real3D(recvBuf[k], recvBuf[k+1], recvBuf[k+2]));
+      }
+      const int nTotal = pos.size();
+
+      // linked cells of size >= rmax over the domain plus the margin,
+      // coarsened if there would be far more cells than particles
+      real lo[3];
+      int nc[3];
+      real invSize[3];
+      for (int d = 0; d < 3; ++d) {
+        lo[d] = myBox[d] - margin;
+        nc[d] = std::max(1, (int)((myBox[3+d] - myBox[d] + 2*margin) / rmax));
+      }
+      while ((long)nc[0]*nc[1]*nc[2] > 2L*nTotal + 27) {
+        int d = std::max_element(nc, nc + 3) - nc;
+        nc[d] = std::max(1, nc[d] / 2);
+      }
+      for (int d = 0; d < 3; ++d) {
+        invSize[d] = nc[d] / (myBox[3+d] - myBox[d] + 2*margin);
+      }
+
+      std::vector< int > cellOf(nTotal), head(nc[0]*nc[1]*nc[2], -1), next(nTotal);
+      for (int i = 0; i < nTotal; ++i) {
+        int c[3];
+        for (int d = 0; d < 3; ++d) {
+          c[d] = std::min(nc[d] - 1, std::max(0, (int)((pos[i][d] - lo[d]) * invSize[d])));
+        }
+        cellOf[i] = (c[0]*nc[1] + c[1])*nc[2] + c[2];
+        next[i] = head[cellOf[i]];
+        head[cellOf[i]] = i;
+      }
+
+      // ordered pairs of a local particle with any other particle; every
+      // pair is seen by the processes of both particles, so counts 1/2
+      const real rmax2 = rmax * rmax;
+      const real invdr = nbins / rmax;
+      for (int i = 0; i < nLocal; ++i) {
+        int c0 = cellOf[i] / (nc[1]*nc[2]);
+        int c1 = (cellOf[i] / nc[2]) % nc[1];
+        int c2 = cellOf[i] % nc[2];
+        for (int a = std::max(0, c0 - 1); a <= std::min(nc[0] - 1, c0 + 1); ++a) {
+          for (int b = std::max(0, c1 - 1); b <= std::min(nc[1] - 1, c1 + 1); ++b) {
+            for (int c = std::max(0, c2 - 1); c <= std::min(nc[2] - 1, c2 + 1); ++c) {
+              for (int j = head[(a*nc[1] + b)*nc[2] + c]; j >= 0; j = next[j]) {
+                if (j == i) continue;
+                real d2 = (pos[i] - pos[j]).sqr();
+                if (d2 < rmax2) hist[(int)(sqrt(d2) * invdr)] += 0.5;
+              }
+            }
+          }
+        }
+      }
+
+      LOG4ESPP_DEBUG(logger, "binned " << nLocal << " particles with a halo of "
+                     << nTotal - nLocal << " images");
+    }
+
+    std::vector< real > RDFCellList::computeRaw() {
+      System &system = getSystemRef();
+      Real3D L = system.bc->getBoxL();
+      if (2.0 * rmax > std::min(L[0], std::min(L[1], L[2]))) {
+        std::stringstream msg;
+        msg << "RDFCellList: rmax " << rmax << " exceeds half the box length";
+        throw std::runtime_error(msg.str());
+      }
+
+      shared_ptr< storage::DomainDecomposition > dd =
+        dynamic_pointer_cast< storage::DomainDecomposition >(system.storage);
+      if (!dd)
+        throw std::runtime_error("RDFCellList needs a DomainDecomposition storage");
+
+      // pairs within the cell size minus the skin are always in neighbour cells
+      const CellGrid &cellGrid = dd->getCellGrid();
+      real cellReach = std::min(cellGrid.getCellSize(0),
+                                std::min(cellGrid.getCellSize(1), cellGrid.getCellSize(2)))
+                     - system.getSkin();
+
+      // the Verlet list misses the excluded pairs, use it only without
+      // exclusions (decided together, the halo path communicates)
+      bool useVerletList = false;
+      if (verletList && rmax <= verletList->getVerletCutoff() - system.getSkin()) {
+        bool noExclusions = verletList->excludeListSize() == 0;
+        mpi::all_reduce(*system.comm, noExclusions, useVerletList, std::logical_and< bool >());
+      }
+
+      std::vector< real > hist(nbins, 0.0);
+      if (useVerletList) {
+        histogramVerletList(hist);
+      } else if (rmax <= cellReach) {
+        histogramStorageCells(hist);
+      } else {
+        histogramHalo(hist);
+      }
+
+      std::vector< real > total(nbins, 0.0);
+      mpi::all_reduce(*system.comm, &hist[0], nbins, &total[0], std::plus< real >());
+
+      longint nLocal = 0, n = 0;
+      CellList realCells = system.storage->getRealCells();
+      for (CellList::Iterator it(realCells); it.isValid(); ++it) {
+        nLocal += (*it)->particles.size();
+      }
+      mpi::all_reduce(*system.comm, nLocal, n, std::plus< longint >());
+
+      // normalise by the pair count of an ideal gas in the shells
+      real idealPairs = 0.5 * n * (n - 1) / (L[0] * L[1] * L[2]);
+      real dr = rmax / nbins;
+      for (int i = 0; i < nbins; ++i) {
+        real rlo = i * dr, rhi = (i + 1) * dr;
+        real shell = 4.0 / 3.0 * M_PI * (rhi*rhi*rhi - rlo*rlo*rlo);
+        total[i] = idealPairs > 0.0 ? total[i] / (idealPairs * shell) : 0.0;
+      }
+      return total;
+    }
+
+    python::list RDFCellList::compute() {
+      std::vector< real > res = computeRaw();
+      python::list ret;
+      for (int i = 0; i < nbins; ++i) ret.append(res[i]);
+      return ret;
+    }
+
+    python::list RDFCellList::getAverageValue() {
+      python::list ret;
+      for (int i = 0; i < nbins; ++i) {
+        ret.append(nMeasurements > 0 ? newAverage[i] : 0.0);
+      }
+      return ret;
+    }
+
+    python::list RDFCellList::getRadii() const {
+      python::list ret;
+      real dr = rmax / nbins;
+      for (int i = 0; i < nbins; ++i) ret.append((i + 0.5) * dr);
+      return ret;
+    }
+
+    void RDFCellList::resetAverage() {
+      newAverage.assign(nbins, 0.0);
+      lastAverage.assign(nbins, 0.0);
+      newVariance.assign(nbins, 0.0);
+      lastVariance.assign(nbins, 0.0);
+    }
+
+    void RDFCellList::updateAverage(std::vector< real > res) {
+      if (nMeasurements == 1) {
+        newAverage = res;
+      } else if (nMeasurements > 1) {
+        for (int i = 0; i < nbins; ++i) {
+          newAverage[i] = lastAverage[i] + (res[i] - lastAverage[i]) / nMeasurements;
+        }
+      }
+      lastAverage = newAverage;
+    }
+
+    void RDFCellList::registerPython() {
+      using namespace espressopp::python;
+      class_< RDFCellList, bases< AnalysisBase > >
+        ("analysis_RDFCellList", init< shared_ptr< System >, real, int >())
+        .def(init< shared_ptr< System >, shared_ptr< VerletList >, real, int >())
+        .add_property("rmax", &RDFCellList::getRMax, &RDFCellList::setRMax)
+        .add_property("nbins", &RDFCellList::getNBins, &RDFCellList::setNBins)
+        .def("getRadii", &RDFCellList::getRadii)
+      ;
+    }
+  }
+}
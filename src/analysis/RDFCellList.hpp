@@ -0,0 +1,86 @@
+/*
+  Copyright (C) 2016
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ESPP_CLASS
+#ifndef _ANALYSIS_RDFCELLLIST_HPP
+#define _ANALYSIS_RDFCELLLIST_HPP
+
+#include "types.hpp"
+#include "AnalysisBase.hpp"
+#include "VerletList.hpp"
+#include <vector>
+
+namespace espressopp {
+  namespace analysis {
+
+    /** Domain parallel radial distribution function.
+
+        Every process bins the pairs of its own real particles, only the
+        histograms are reduced. The pairs are found, depending on rmax,
+
+        - in the Verlet list, if one is given, rmax <= its cutoff and
+          it has no exclusions, which would be missing from the RDF,
+        - with the cells and ghost layer of the storage, if rmax fits
+          into a storage cell,
+        - otherwise with a private linked-cell grid over the local domain
+          extended by rmax, after the periodic images of all particles
+          within rmax of a domain have been sent to its process.
+
+        rmax must not exceed half the smallest box length.
+    */
+    class RDFCellList : public AnalysisBaseTemplate< std::vector< real > > {
+    public:
+      static void registerPython();
+
+      RDFCellList(shared_ptr< System > system, real rmax, int nbins);
+      RDFCellList(shared_ptr< System > system, shared_ptr< VerletList > vl,
+                  real rmax, int nbins);
+      virtual ~RDFCellList() {}
+
+      std::vector< real > computeRaw();
+      python::list compute();
+      python::list getAverageValue();
+      void resetAverage();
+      void updateAverage(std::vector< real > res);
+
+      /// centres of the bins
+      python::list getRadii() const;
+
+      real getRMax() const { return rmax; }
+      void setRMax(real _rmax);
+      int getNBins() const { return nbins; }
+      void setNBins(int _nbins);
+
+    private:
+      // local histogram of the pair distances, each pair counted once globally
+      void histogramVerletList(std::vector< real > &hist);
+      void histogramStorageCells(std::vector< real > &hist);
+      void histogramHalo(std::vector< real > &hist);
+
+      shared_ptr< VerletList > verletList;
+      real rmax;
+      int nbins;
+
+      static LOG4ESPP_DECL_LOGGER(logger);
+    };
+  }
+}
+
+#endif
@@ -0,0 +1,100 @@
+#  Copyright (C) 2016
+#      Max Planck Institute for Polymer Research
+#  
+#  This file is part of ESPResSo++.
+#  
+#  ESPResSo++ is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#  
+#  ESPResSo++ is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#  
+#  You should have received a copy of the GNU General Public License
+#  along with this program.  If not, see <http://www.gnu.org/licenses/>. 
+
+
+
+r"""
+*******************************
+espressopp.analysis.RDFCellList
+*******************************
+
+Radial distribution function computed in parallel on the domains of the
+storage: every process bins the pairs of its own particles and only the
+histograms are reduced, so it can be sampled during a run.
+
+The pairs are taken from the given Verlet list if rmax does not exceed its
+cutoff and the list has no exclusions (the excluded pairs would be
+missing), from the cells of the storage if rmax fits into a cell, and
+otherwise from a
+private cell grid after the particles within rmax of every domain have
+been exchanged. rmax must not exceed half the smallest box length.
+
+>>> rdf = espressopp.analysis.RDFCellList(system, rmax=2.5, nbins=100, vl=verletlist)
+>>> ext = espressopp.integrator.ExtAnalyze(rdf, interval=500)
+>>> integrator.addExtension(ext)
+>>> integrator.run(100000)
+>>> for r, g in zip(rdf.getRadii(), rdf.getAverageValue()):
+>>>     print r, g
+
+.. function:: espressopp.analysis.RDFCellList(system, rmax, nbins, vl)
+
+		:param system: the system
+		:param rmax: largest distance
+		:param nbins: number of bins between 0 and rmax
+		:param vl: (default: None) Verlet list to take the pairs from
+		:type system: espressopp.System
+		:type rmax: real
+		:type nbins: int
+		:type vl: espressopp.VerletList
+
+.. function:: espressopp.analysis.RDFCellList.compute()
+
+		g(r) of the current configuration.
+
+		:rtype: list of nbins values
+
+.. function:: espressopp.analysis.RDFCellList.getAverageValue()
+
+		g(r) averaged over all measurements since the last reset.
+
+		:rtype: list of nbins values
+
+.. function:: espressopp.analysis.RDFCellList.getRadii()
+
+		The centres of the bins.
+
+		:rtype: list of nbins values
+"""
+
+from espressopp.esutil import cxxinit
+from espressopp import pmi
+
+from espressopp.analysis.AnalysisBase import *
+from _espressopp import analysis_RDFCellList
+
+class RDFCellListLocal(AnalysisBaseLocal, analysis_RDFCellList):
+
+    def __init__(self, system, rmax, nbins, vl=None):
+        if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+            if vl is None:
+                cxxinit(self, analysis_RDFCellList, system, rmax, nbins)
+            else:
+                cxxinit(self, analysis_RDFCellList, system, vl, rmax, nbins)
+
+    def getRadii(self):
+        if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+            return self.cxxclass.getRadii(self)
+
+if pmi.isController:
+    class RDFCellList(AnalysisBase):
+        __metaclass__ = pmi.Proxy
+        pmiproxydefs = dict(
+            cls =  'espressopp.analysis.RDFCellListLocal',
+            pmiproperty = [ 'rmax', 'nbins' ],
+            pmicall = [ 'getRadii' ]
+            )
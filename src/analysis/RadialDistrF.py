@@ -24,6 +24,10 @@ r"""
 espressopp.analysis.RadialDistrF
 ********************************
 
+Radial distribution function up to half the box length from all pairs of
+particles; every process gets a copy of the whole configuration. For large
+systems, or to sample during a run, use RDFCellList.
+
 
 .. function:: espressopp.analysis.RadialDistrF(system)
 
@@ -30,6 +30,7 @@
 #include <vector>
 #include "types.hpp"
 #include "integrator/MDIntegrator.hpp"
+#include "interaction/Interaction.hpp"
 #include "ParticleAccess.hpp"
 #include "Temperature.hpp"
 #include "NPart.hpp"
@@ -128,6 +129,8 @@ class SystemMonitor : public ParticleAccess {
 
   void perform_action();
   void info();
+  // the observables may read any of them
+  int getRequiredObservables() { return interaction::Interaction::ALL_OBSERVABLES; }
 
   static void registerPython();
 
@@ -21,6 +21,7 @@
 */
 
 #include "VelocityAutocorrelation.hpp"
+#include "esutil/Correlator.hpp"
 
 using namespace std;
 //using namespace espressopp;
@@ -52,27 +53,30 @@ namespace espressopp {
         }
       }
  
-      int perc=0;
-      real denom = 100.0 / (real)M;
+      // all time origins at once via FFT
       for(int m=0; m<M; m++){
         totZ[m] = 0.0;
         Z[m] = 0.0;
-        for(int n=0; n<M-m; n++){
-          for (vector<longint>::iterator itr=localIDs.begin(); itr!=localIDs.end(); ++itr) {
-            size_t i = *itr;
-            Real3D vel1 = getConf(n + m)->getCoordinates(i);
-            Real3D vel2 = getConf(n)->getCoordinates(i);
-            Z[m] += vel1 * vel2;
+      }
+      if(M > 0){
+        esutil::FFTCorrelator correlator(M);
+        vector<real> series[3];
+        for(int d=0; d<3; d++) series[d].resize(M);
+        int perc=0, count=0;
+        real denom = 100.0 / (real)std::max<size_t>(localIDs.size(), 1);
+        for (vector<longint>::iterator itr=localIDs.begin(); itr!=localIDs.end(); ++itr) {
+          size_t i = *itr;
+          for(int n=0; n<M; n++){
+            Real3D vel = getConf(n)->getCoordinates(i);
+            for(int d=0; d<3; d++) series[d][n] = vel[d];
           }
-        }
-        /*
-         * additional calculations slow down routine but from the other hand
-         * it helps to monitor progress
-         */
-        if(print_progress && system.comm->rank()==0){
-          perc = (int)(m*denom);
-          if(perc%5==0){
-            cout<<"calculation progress (velocity autocorrelation): "<< perc << " %\r"<<flush;
+          for(int d=0; d<3; d++) correlator.addAutocorrelation(&series[d][0], Z);
+
+          if(print_progress && system.comm->rank()==0){
+            perc = (int)((count++)*denom);
+            if(perc%5==0){
+              cout<<"calculation progress (velocity autocorrelation): "<< perc << " %\r"<<flush;
+            }
           }
         }
       }
@@ -51,7 +51,9 @@ from espressopp.analysis.VelocityAutocorrelation import *
 from espressopp.analysis.MeanSquareDispl import *
 from espressopp.analysis.MeanSquareInternalDist import *
 from espressopp.analysis.Autocorrelation import *
+from espressopp.analysis.MultipleTauCorrelation import *
 from espressopp.analysis.RadialDistrF import *
+from espressopp.analysis.RDFCellList import *
 from espressopp.analysis.StaticStructF import *
 from espressopp.analysis.RDFatomistic import *
 from espressopp.analysis.Energy import *
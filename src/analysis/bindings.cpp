@@ -45,7 +45,9 @@
 #include "MeanSquareDispl.hpp"
 #include "MeanSquareInternalDist.hpp"
 #include "Autocorrelation.hpp"
+#include "MultipleTauCorrelation.hpp"
 #include "RadialDistrF.hpp"
+#include "RDFCellList.hpp"
 #include "StaticStructF.hpp"
 #include "RDFatomistic.hpp"
 #include "Viscosity.hpp"
@@ -112,6 +114,7 @@ namespace espressopp {
       MeanSquareDispl::registerPython();
       MeanSquareInternalDist::registerPython();
       RadialDistrF::registerPython();
+      RDFCellList::registerPython();
       StaticStructF::registerPython();
       RDFatomistic::registerPython();
       XDensity::registerPython();
@@ -122,6 +125,7 @@ namespace espressopp {
       ParticleRadiusDistribution::registerPython();
 
       Autocorrelation::registerPython();
+      MultipleTauCorrelation::registerPython();
       Viscosity::registerPython();
 
       LBOutput::registerPython();
@@ -0,0 +1,88 @@
+/*
+  Copyright (C) 2016
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _ESUTIL_ALIGNEDALLOCATOR_HPP
+#define _ESUTIL_ALIGNEDALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace espressopp {
+  namespace esutil {
+
+    /** \brief STL allocator returning memory aligned to \p Alignment bytes.
+
+        Used for the flat arrays that are streamed by the vectorised
+        kernels, so that every array starts on a cache line.
+
+        \par Example:
+        \code
+        std::vector< real, AlignedAllocator< real > > x(n);
+        \endcode
+    */
+    template < class T, std::size_t Alignment = 64 >
+    class AlignedAllocator {
+    public:
+      typedef T value_type;
+      typedef T* pointer;
+      typedef const T* const_pointer;
+      typedef T& reference;
+      typedef const T& const_reference;
+      typedef std::size_t size_type;
+      typedef std::ptrdiff_t difference_type;
+
+      template < class U >
+      struct rebind { typedef AlignedAllocator< U, Alignment > other; };
+
+      AlignedAllocator() {}
+      template < class U >
+      AlignedAllocator(const AlignedAllocator< U, Alignment > &) {}
+
+      pointer allocate(size_type n, const void * = 0) {
+        if (n == 0) return 0;
+        void *ptr = 0;
+        if (posix_memalign(&ptr, Alignment, n * sizeof(T)) != 0)
+          throw std::bad_alloc();
+        return static_cast< pointer >(ptr);
+      }
+
+      void deallocate(pointer p, size_type) { free(p); }
+
+      size_type max_size() const { return size_type(-1) / sizeof(T); }
+
+      template < class U, class... Args >
+      void construct(U *p, Args&&... args) {
+        ::new((void *)p) U(static_cast< Args&& >(args)...);
+      }
+      template < class U >
+      void destroy(U *p) { p->~U(); }
+    };
+
+    template < class T, class U, std::size_t A >
+    inline bool operator==(const AlignedAllocator< T, A > &,
+                           const AlignedAllocator< U, A > &) { return true; }
+    template < class T, class U, std::size_t A >
+    inline bool operator!=(const AlignedAllocator< T, A > &,
+                           const AlignedAllocator< U, A > &) { return false; }
+  }
+}
+
+#endif
@@ -330,6 +330,17 @@ namespace espressopp {
       reference at(const Vector& pos)
       { return at(pos[0], pos[1]); }
 
+      /** \brief Returns the element at position \p i x \p j, or the
+	  prototype if the element doesn't exist.
+
+	  Unlike at(), this never modifies the Array2D, so it can be
+	  used by several threads at the same time.
+      */
+      const_reference get(size_type i, size_type j) const {
+        if (i >= size_n() || j >= size_m()) return prototype;
+        return Super::operator()(i, j);
+      }
+
     private:
       value_type prototype;
     };
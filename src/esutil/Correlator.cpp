@@ -0,0 +1,159 @@
+/*
+  Copyright (C) 2016
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Correlator.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace espressopp {
+  namespace esutil {
+
+    MultipleTauCorrelator::MultipleTauCorrelator(int _nSeries, int _p, int _m, Mode _mode)
+      : nSeries(_nSeries), p(_p), m(_m), mode(_mode), nSamples(0)
+    {
+      if (nSeries < 0 || m < 2 || p < m || p % m != 0)
+        throw std::invalid_argument("MultipleTauCorrelator: need m >= 2 and p a multiple of m");
+    }
+
+    void MultipleTauCorrelator::reset() {
+      levels.clear();
+      nSamples = 0;
+    }
+
+    void MultipleTauCorrelator::add(const real *values) {
+      ++nSamples;
+      push(0, values);
+    }
+
+    void MultipleTauCorrelator::push(size_t k, const real *values) {
+      if (k == levels.size()) {
+        Level level;
+        level.buffer.assign((size_t)p*nSeries, 0.0);
+        level.accum.assign(nSeries, 0.0);
+        level.head = p - 1;
+        level.stored = 0;
+        level.nAccum = 0;
+        level.sum.assign(p, 0.0);
+        level.count.assign(p, 0.0);
+        levels.push_back(level);
+      }
+
+      Level &L = levels[k];
+      L.head = (L.head + 1) % p;
+      if (L.stored < p) ++L.stored;
+      real *x0 = nSeries > 0 ? &L.buffer[(size_t)L.head*nSeries] : 0;
+      std::copy(values, values + nSeries, x0);
+
+      // lags below p/m are covered more accurately by the level below
+      int jmin = (k == 0) ? 0 : p / m;
+      for (int j = jmin; j < L.stored; ++j) {
+        const real *xj = nSeries > 0 ? &L.buffer[(size_t)((L.head - j + p) % p)*nSeries] : 0;
+        real s = 0.0;
+        if (mode == PRODUCT) {
+          for (int i = 0; i < nSeries; ++i) s += x0[i] * xj[i];
+        } else {
+          for (int i = 0; i < nSeries; ++i) {
+            real d = x0[i] - xj[i];
+            s += d * d;
+          }
+        }
+        L.sum[j] += s;
+        L.count[j] += 1.0;
+      }
+
+      for (int i = 0; i < nSeries; ++i) L.accum[i] += values[i];
+      if (++L.nAccum == m) {
+        std::vector< real > avg(L.accum);
+        for (int i = 0; i < nSeries; ++i) avg[i] /= m;
+        std::fill(L.accum.begin(), L.accum.end(), 0.0);
+        L.nAccum = 0;
+        // L may be invalidated when the next level is created
+        push(k + 1, avg.empty() ? 0 : &avg[0]);
+      }
+    }
+
+    void MultipleTauCorrelator::getResult(std::vector< long >& lags, std::vector< real >& sums,
+                                          std::vector< real >& counts) const {
+      lags.clear(); sums.clear(); counts.clear();
+      long blockLength = 1;
+      for (size_t k = 0; k < levels.size(); ++k) {
+        const Level &L = levels[k];
+        for (int j = (k == 0) ? 0 : p / m; j < p; ++j) {
+          if (L.count[j] > 0.0) {
+            lags.push_back(j * blockLength);
+            sums.push_back(L.sum[j]);
+            counts.push_back(L.count[j]);
+          }
+        }
+        blockLength *= m;
+      }
+    }
+
+    FFTCorrelator::FFTCorrelator(int _M)
+      : M(_M), N(1), corr(_M), prefix(_M + 1), shifted(_M)
+    {
+      if (M < 1)
+        throw std::invalid_argument("FFTCorrelator: series must not be empty");
+      // zero padding to at least 2M avoids the periodic wrap around
+      while (N < 2*M) N *= 2;
+      in = static_cast< real* >(fftw_malloc(N * sizeof(real)));
+      out = static_cast< fftw_complex* >(fftw_malloc((N/2 + 1) * sizeof(fftw_complex)));
+      planFwd = fftw_plan_dft_r2c_1d(N, in, out, FFTW_ESTIMATE);
+      planBwd = fftw_plan_dft_c2r_1d(N, out, in, FFTW_ESTIMATE);
+    }
+
+    FFTCorrelator::~FFTCorrelator() {
+      fftw_destroy_plan(planFwd);
+      fftw_destroy_plan(planBwd);
+      fftw_free(in);
+      fftw_free(out);
+    }
+
+    void FFTCorrelator::correlate(const real *x) {
+      std::copy(x, x + M, in);
+      std::fill(in + M, in + N, 0.0);
+      fftw_execute(planFwd);
+      for (int k = 0; k <= N/2; ++k) {
+        out[k][0] = out[k][0]*out[k][0] + out[k][1]*out[k][1];
+        out[k][1] = 0.0;
+      }
+      fftw_execute(planBwd);
+      real invN = 1.0 / N;
+      for (int t = 0; t < M; ++t) corr[t] = in[t] * invN;
+    }
+
+    void FFTCorrelator::addAutocorrelation(const real *x, real *sums) {
+      correlate(x);
+      for (int t = 0; t < M; ++t) sums[t] += corr[t];
+    }
+
+    void FFTCorrelator::addSquareDisplacement(const real *x, real *sums) {
+      // relative to the first value, to limit cancellation for large x
+      for (int n = 0; n < M; ++n) shifted[n] = x[n] - x[0];
+      correlate(&shifted[0]);
+      // sum_n x[n]^2 + x[n+t]^2 over the M-t time origins from prefix sums
+      prefix[0] = 0.0;
+      for (int n = 0; n < M; ++n) prefix[n+1] = prefix[n] + shifted[n]*shifted[n];
+      for (int t = 0; t < M; ++t) {
+        sums[t] += prefix[M-t] + (prefix[M] - prefix[t]) - 2.0 * corr[t];
+      }
+    }
+  }
+}
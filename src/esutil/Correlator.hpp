@@ -0,0 +1,117 @@
+/*
+  Copyright (C) 2016
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _ESUTIL_CORRELATOR_HPP
+#define _ESUTIL_CORRELATOR_HPP
+
+#include <vector>
+#include <fftw3.h>
+
+#include "types.hpp"
+
+namespace espressopp {
+  namespace esutil {
+
+    /** Time correlations of many scalar series on the fly.
+
+        Multiple-tau correlator (Ramirez et al., J. Chem. Phys. 133,
+        154103 (2010)): level 0 keeps the last p samples, level k the
+        last p averages of m^k consecutive samples. Lags 0 .. p-1 are
+        computed exactly, lag j*m^k (j = p/m .. p-1) at level k from the
+        block averages. Memory is O(p log T) per series and a sample costs
+        O(p) per series on average.
+
+        Levels are created as the number of samples grows, so
+        correlators that have seen the same number of samples have the
+        same lags, whatever the number of series is.
+    */
+    class MultipleTauCorrelator {
+    public:
+      enum Mode {
+        PRODUCT,          // <x(t) x(t+tau)>
+        SQUARE_DIFFERENCE // <(x(t+tau) - x(t))^2>
+      };
+
+      MultipleTauCorrelator(int nSeries, int p, int m, Mode mode);
+
+      /// add one sample of all series
+      void add(const real *values);
+      void reset();
+
+      int getNumSeries() const { return nSeries; }
+      long getNumSamples() const { return nSamples; }
+
+      /** Lags (in samples) with at least one contribution, the sum of
+          the correlations over all series and the number of time
+          origins per lag. */
+      void getResult(std::vector< long >& lags, std::vector< real >& sums,
+                     std::vector< real >& counts) const;
+
+    private:
+      struct Level {
+        std::vector< real > buffer; // p samples of all series, ring
+        std::vector< real > accum;  // sum of the samples for the next level
+        int head;                   // slot of the newest sample
+        int stored;
+        int nAccum;
+        std::vector< real > sum;    // per lag j
+        std::vector< real > count;
+      };
+
+      void push(size_t k, const real *values);
+
+      int nSeries, p, m;
+      Mode mode;
+      long nSamples;
+      std::vector< Level > levels;
+    };
+
+    /** Exact time correlations of series of length M in O(M log M),
+        via zero padded real FFTs. The plans are created once. */
+    class FFTCorrelator {
+    public:
+      explicit FFTCorrelator(int M);
+      ~FFTCorrelator();
+
+      int getLength() const { return M; }
+
+      /// sums[t] += sum_n x[n] x[n+t], t = 0 .. M-1
+      void addAutocorrelation(const real *x, real *sums);
+      /// sums[t] += sum_n (x[n+t] - x[n])^2, t = 0 .. M-1
+      void addSquareDisplacement(const real *x, real *sums);
+
+    private:
+      /// corr[t] = sum_n x[n] x[n+t]
+      void correlate(const real *x);
+
+      int M, N;
+      real *in;
+      fftw_complex *out;
+      fftw_plan planFwd, planBwd;
+      std::vector< real > corr, prefix, shifted;
+
+      // not copyable, owns the plans
+      FFTCorrelator(const FFTCorrelator&);
+      FFTCorrelator& operator=(const FFTCorrelator&);
+    };
+  }
+}
+
+#endif
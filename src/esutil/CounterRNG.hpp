@@ -0,0 +1,160 @@
+/*
+  Copyright (C) 2016
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ESPP_CLASS
+#ifndef _ESUTIL_COUNTERRNG_HPP
+#define _ESUTIL_COUNTERRNG_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <boost/cstdint.hpp>
+#include "types.hpp"
+
+namespace espressopp {
+  namespace esutil {
+
+    /** Counter based random number generator Philox4x32-10,
+        J. K. Salmon et al., "Parallel random numbers: as easy as 1, 2, 3",
+        SC11 (2011).
+
+        The random numbers are a function of the seed (the key) and of a
+        counter made of a stream number, the step and one or two particle
+        ids. They do not depend on the number of processes, on the order
+        in which the particles are visited or on any state, so noise can
+        be generated for any particle in any order, and batches of
+        counters are independent of each other and vectorize.
+
+        Each counter gives 4 numbers. Users of the generator pick their
+        own stream so that they do not share noise. Only the lower 32
+        bits of the step and of the ids are used.
+    */
+    class CounterRNG {
+    public:
+      typedef boost::uint32_t uint32;
+      typedef boost::uint64_t uint64;
+
+      /** streams of the users of the generator */
+      enum Stream {
+        LANGEVIN = 1,
+        DPD = 2,
+        DPD_TRANSVERSE = 3,
+        /** seeds of the system RNG derived by io::Checkpoint */
+        CHECKPOINT = 4,
+        /** or'ed to the stream for the forces computed again when
+            a run starts (see heatUp() of the thermostats) */
+        RECALC = 0x100
+      };
+
+      CounterRNG(long _seed = 12345) { seed(_seed); }
+
+      void seed(long _seed) {
+        seed_ = _seed;
+        key[0] = uint32(uint64(_seed));
+        key[1] = uint32(uint64(_seed) >> 32);
+      }
+
+      long get_seed() const { return seed_; }
+
+      /** the 4 raw 32 bit words for the counter (id1, id2, step, stream) */
+      void raw(uint32 stream, long long step, longint id1, longint id2, uint32 out[4]) const {
+        uint32 ctr[4] = { uint32(id1), uint32(id2), uint32(step), stream };
+        philox(ctr, key, out);
+      }
+
+      /** 4 uniformly distributed numbers in (0, 1) */
+      void uniform4(uint32 stream, long long step, longint id1, longint id2, real out[4]) const {
+        uint32 r[4];
+        raw(stream, step, id1, id2, r);
+        for (int i = 0; i < 4; ++i) out[i] = toUniform(r[i]);
+      }
+
+      /** 4 normally distributed numbers with mean 0 and variance 1 */
+      void normal4(uint32 stream, long long step, longint id1, longint id2, real out[4]) const {
+        real u[4];
+        uniform4(stream, step, id1, id2, u);
+        boxMuller(u, out);
+      }
+
+      /** 4 uniform numbers in (0, 1) for each of the n counters
+          (ids[i], id2), written to out[4*i] .. out[4*i + 3]. */
+      void uniform(uint32 stream, long long step, const longint *ids, longint id2,
+                   std::size_t n, real *out) const {
+        const uint32 s = uint32(step), i2 = uint32(id2);
+        for (std::size_t i = 0; i < n; ++i) {
+          uint32 ctr[4] = { uint32(ids[i]), i2, s, stream };
+          uint32 r[4];
+          philox(ctr, key, r);
+          for (int j = 0; j < 4; ++j) out[4*i + j] = toUniform(r[j]);
+        }
+      }
+
+      /** same as uniform(), but normally distributed */
+      void normal(uint32 stream, long long step, const longint *ids, longint id2,
+                  std::size_t n, real *out) const {
+        uniform(stream, step, ids, id2, n, out);
+        for (std::size_t i = 0; i < n; ++i) boxMuller(out + 4*i, out + 4*i);
+      }
+
+      static void registerPython();
+
+    private:
+      long seed_;
+      uint32 key[2];
+
+      static real toUniform(uint32 x) {
+        // (x + 1/2) 2^-32, never 0 or 1
+        return (real(x) + 0.5) * (1.0 / 4294967296.0);
+      }
+
+      // in place is allowed
+      static void boxMuller(const real u[4], real n[4]) {
+        const real twoPi = 6.283185307179586;
+        const real r0 = std::sqrt(-2.0 * std::log(u[0])), a0 = twoPi * u[1];
+        const real r1 = std::sqrt(-2.0 * std::log(u[2])), a1 = twoPi * u[3];
+        n[0] = r0 * std::cos(a0);
+        n[1] = r0 * std::sin(a0);
+        n[2] = r1 * std::cos(a1);
+        n[3] = r1 * std::sin(a1);
+      }
+
+      static void philox(const uint32 ctr[4], const uint32 k[2], uint32 out[4]) {
+        const uint32 M0 = 0xD2511F53u, M1 = 0xCD9E8D57u;
+        const uint32 W0 = 0x9E3779B9u, W1 = 0xBB67AE85u;
+        uint32 c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3];
+        uint32 k0 = k[0], k1 = k[1];
+        for (int round = 0; round < 10; ++round) {
+          const uint64 p0 = uint64(M0) * c0;
+          const uint64 p1 = uint64(M1) * c2;
+          const uint32 n0 = uint32(p1 >> 32) ^ c1 ^ k0;
+          const uint32 n2 = uint32(p0 >> 32) ^ c3 ^ k1;
+          c1 = uint32(p1);
+          c3 = uint32(p0);
+          c0 = n0;
+          c2 = n2;
+          k0 += W0;
+          k1 += W1;
+        }
+        out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+      }
+    };
+  }
+}
+
+#endif
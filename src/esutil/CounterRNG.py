@@ -0,0 +1,70 @@
+#  Copyright (C) 2016
+#      Max Planck Institute for Polymer Research
+#  
+#  This file is part of ESPResSo++.
+#  
+#  ESPResSo++ is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#  
+#  ESPResSo++ is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#  
+#  You should have received a copy of the GNU General Public License
+#  along with this program.  If not, see <http://www.gnu.org/licenses/>. 
+
+
+
+r"""
+****************************
+espressopp.esutil.CounterRNG
+****************************
+
+Counter based random number generator (Philox4x32-10). The numbers are a
+function of the seed and of the counter (stream, step, id1, id2) only, so
+they are the same for any number of processes and any particle order.
+The thermostats use it with the seed of the system RNG.
+
+Each call returns a tuple of 4 numbers.
+
+.. function:: espressopp.esutil.CounterRNG(seed)
+
+		:param seed: (default: 12345)
+		:type seed: int
+
+.. function:: espressopp.esutil.CounterRNG.uniform(stream, step, id1, id2)
+
+		4 uniform numbers in (0, 1)
+
+.. function:: espressopp.esutil.CounterRNG.normal(stream, step, id1, id2)
+
+		4 normal numbers with mean 0 and variance 1
+
+.. function:: espressopp.esutil.CounterRNG.raw(stream, step, id1, id2)
+
+		the 4 raw 32 bit words
+
+Example:
+
+>>> rng = espressopp.esutil.CounterRNG(42)
+>>> u = rng.uniform(1, 100, 7, 0)
+"""
+from espressopp import pmi
+
+from _espressopp import esutil_CounterRNG
+
+class CounterRNGLocal(esutil_CounterRNG):
+    pass
+
+if pmi.isController:
+    class CounterRNG(object):
+        __metaclass__ = pmi.Proxy
+        'Counter based random number generator.'
+        pmiproxydefs = dict(
+            cls = 'espressopp.esutil.CounterRNGLocal',
+            localcall = [ 'raw', 'uniform', 'normal', 'get_seed' ],
+            pmicall = [ 'seed' ]
+            )
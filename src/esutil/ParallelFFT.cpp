@@ -0,0 +1,405 @@
+/*
+  Copyright (C) 2016
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ParallelFFT.hpp"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+
+namespace espressopp {
+  namespace esutil {
+
+    LOG4ESPP_LOGGER(ParallelFFT::logger, "ParallelFFT");
+
+    namespace {
+      // periodic wrap of a mesh index into [0, m)
+      inline int wrap(int i, int m) {
+        int r = i % m;
+        return r < 0 ? r + m : r;
+      }
+
+      // offsets of a contiguous exclusive prefix sum
+      inline void displacements(const std::vector<int>& cnt, std::vector<int>& dsp) {
+        dsp.resize(cnt.size());
+        int sum = 0;
+        for (size_t i = 0; i < cnt.size(); ++i) {
+          dsp[i] = sum;
+          sum += cnt[i];
+        }
+      }
+
+      inline int total(const std::vector<int>& cnt) {
+        int sum = 0;
+        for (size_t i = 0; i < cnt.size(); ++i) sum += cnt[i];
+        return sum;
+      }
+    }
+
+    ParallelFFT::ParallelFFT(shared_ptr< mpi::communicator > _comm, const Int3D& _M,
+                             unsigned _planFlags, const std::string& _wisdomFile)
+      : comm(_comm), M(_M), planFlags(_planFlags), wisdomFile(_wisdomFile),
+        rmesh(0), kmesh(0),
+        planR2C(0), planC2R(0), planFwdX(0), planBwdX(0)
+    {
+      if (M[0] < 1 || M[1] < 1 || M[2] < 1) {
+        throw std::runtime_error("ParallelFFT: mesh size has to be positive");
+      }
+
+      rank = comm->rank();
+      nprocs = comm->size();
+      nkz = M[2]/2 + 1;
+      nzPad = 2*nkz;
+
+      x0.resize(nprocs); nx.resize(nprocs);
+      y0.resize(nprocs); ny.resize(nprocs);
+      xOwner.resize(M[0]);
+      for (int r = 0; r < nprocs; ++r) {
+        x0[r] = (r*M[0])/nprocs;
+        nx[r] = ((r+1)*M[0])/nprocs - x0[r];
+        y0[r] = (r*M[1])/nprocs;
+        ny[r] = ((r+1)*M[1])/nprocs - y0[r];
+        for (int x = x0[r]; x < x0[r] + nx[r]; ++x) xOwner[x] = r;
+      }
+
+      long rsize = std::max(1L, (long)nx[rank]*M[1]*nzPad);
+      long ksize = std::max(1L, getLocalKSize());
+      rmesh = static_cast<real*>(fftw_malloc(rsize*sizeof(real)));
+      kmesh = static_cast<dcomplex*>(fftw_malloc(ksize*sizeof(dcomplex)));
+
+      // transpose x-slabs <-> ky-slabs, counted in reals
+      transSendCnt.resize(nprocs);
+      transRecvCnt.resize(nprocs);
+      for (int r = 0; r < nprocs; ++r) {
+        transSendCnt[r] = 2*nx[rank]*ny[r]*nkz;
+        transRecvCnt[r] = 2*nx[r]*ny[rank]*nkz;
+      }
+      displacements(transSendCnt, transSendDsp);
+      displacements(transRecvCnt, transRecvDsp);
+
+      brickLo.resize(nprocs, Int3D(0));
+      brickN.resize(nprocs, Int3D(0));
+      brickSendCnt.assign(nprocs, 0);
+      brickRecvCnt.assign(nprocs, 0);
+      displacements(brickSendCnt, brickSendDsp);
+      displacements(brickRecvCnt, brickRecvDsp);
+
+      if (!wisdomFile.empty()) importWisdom();
+      createPlans();
+      if (!wisdomFile.empty()) exportWisdom();
+
+      // measuring planners overwrite the arrays
+      std::fill(rmesh, rmesh + rsize, 0.0);
+      std::fill(kmesh, kmesh + ksize, dcomplex(0.0));
+
+      LOG4ESPP_INFO(logger, "mesh " << M[0] << "x" << M[1] << "x" << M[2]
+                    << ", local x-planes " << x0[rank] << "+" << nx[rank]
+                    << ", local ky-planes " << y0[rank] << "+" << ny[rank]);
+    }
+
+    ParallelFFT::~ParallelFFT() {
+      destroyPlans();
+      fftw_free(rmesh);
+      fftw_free(kmesh);
+    }
+
+    unsigned ParallelFFT::planFlagsFromString(const std::string& rigor) {
+      if (rigor == "estimate") return FFTW_ESTIMATE;
+      if (rigor == "measure") return FFTW_MEASURE;
+      if (rigor == "patient") return FFTW_PATIENT;
+      if (rigor == "exhaustive") return FFTW_EXHAUSTIVE;
+      throw std::invalid_argument("ParallelFFT: unknown planner rigor " + rigor);
+    }
+
+    std::string ParallelFFT::planFlagsToString(unsigned flags) {
+      if (flags & FFTW_ESTIMATE) return "estimate";
+      if (flags & FFTW_EXHAUSTIVE) return "exhaustive";
+      if (flags & FFTW_PATIENT) return "patient";
+      return "measure";
+    }
+
+    void ParallelFFT::importWisdom() {
+      std::string wisdom;
+      if (rank == 0) {
+        std::ifstream in(wisdomFile.c_str());
+        if (in) {
+          std::stringstream buf;
+          buf << in.rdbuf();
+          wisdom = buf.str();
+        }
+      }
+      mpi::broadcast(*comm, wisdom, 0);
+      if (!wisdom.empty() && !fftw_import_wisdom_from_string(wisdom.c_str())) {
+        LOG4ESPP_WARN(logger, "could not import FFTW wisdom from " << wisdomFile);
+      }
+    }
+
+    void ParallelFFT::exportWisdom() {
+      // the processes plan different local transforms, collect all of them
+      char *str = fftw_export_wisdom_to_string();
+      std::string wisdom(str ? str : "");
+      if (str) fftw_free(str);
+
+      std::vector<std::string> all;
+      mpi::gather(*comm, wisdom, all, 0);
+      if (rank == 0) {
+        for (int r = 1; r < nprocs; ++r) {
+          if (!all[r].empty()) fftw_import_wisdom_from_string(all[r].c_str());
+        }
+        if (!fftw_export_wisdom_to_filename(wisdomFile.c_str())) {
+          LOG4ESPP_WARN(logger, "could not write FFTW wisdom to " << wisdomFile);
+        }
+      }
+    }
+
+    void ParallelFFT::createPlans() {
+      fftw_complex *cmesh = reinterpret_cast<fftw_complex*>(rmesh);
+      fftw_complex *kdata = reinterpret_cast<fftw_complex*>(kmesh);
+
+      if (nx[rank] > 0) {
+        int n[2] = { M[1], M[2] };
+        int rembed[2] = { M[1], nzPad };
+        int cembed[2] = { M[1], nkz };
+        planR2C = fftw_plan_many_dft_r2c(2, n, nx[rank],
+                                         rmesh, rembed, 1, M[1]*nzPad,
+                                         cmesh, cembed, 1, M[1]*nkz, planFlags);
+        planC2R = fftw_plan_many_dft_c2r(2, n, nx[rank],
+                                         cmesh, cembed, 1, M[1]*nkz,
+                                         rmesh, rembed, 1, M[1]*nzPad, planFlags);
+      }
+      if (ny[rank] > 0) {
+        int n[1] = { M[0] };
+        planFwdX = fftw_plan_many_dft(1, n, ny[rank]*nkz,
+                                      kdata, NULL, 1, M[0],
+                                      kdata, NULL, 1, M[0], FFTW_FORWARD, planFlags);
+        planBwdX = fftw_plan_many_dft(1, n, ny[rank]*nkz,
+                                      kdata, NULL, 1, M[0],
+                                      kdata, NULL, 1, M[0], FFTW_BACKWARD, planFlags);
+      }
+    }
+
+    void ParallelFFT::destroyPlans() {
+      if (planR2C) fftw_destroy_plan(planR2C);
+      if (planC2R) fftw_destroy_plan(planC2R);
+      if (planFwdX) fftw_destroy_plan(planFwdX);
+      if (planBwdX) fftw_destroy_plan(planBwdX);
+      planR2C = planC2R = planFwdX = planBwdX = 0;
+    }
+
+    void ParallelFFT::forward() {
+      if (planR2C) fftw_execute(planR2C);
+      transposeForward();
+      if (planFwdX) fftw_execute(planFwdX);
+    }
+
+    void ParallelFFT::backward() {
+      if (planBwdX) fftw_execute(planBwdX);
+      transposeBackward();
+      if (planC2R) fftw_execute(planC2R);
+    }
+
+    void ParallelFFT::transposeForward() {
+      const dcomplex *cmesh = reinterpret_cast<const dcomplex*>(rmesh);
+      sendBuf.resize(std::max(1, total(transSendCnt)));
+      recvBuf.resize(std::max(1, total(transRecvCnt)));
+
+      int pos = 0;
+      for (int r = 0; r < nprocs; ++r) {
+        for (int xl = 0; xl < nx[rank]; ++xl) {
+          for (int y = y0[r]; y < y0[r] + ny[r]; ++y) {
+            const dcomplex *row = cmesh + (xl*M[1] + y)*nkz;
+            for (int kz = 0; kz < nkz; ++kz) {
+              sendBuf[pos++] = row[kz].real();
+              sendBuf[pos++] = row[kz].imag();
+            }
+          }
+        }
+      }
+
+      MPI_Alltoallv(&sendBuf[0], &transSendCnt[0], &transSendDsp[0], mpi::get_mpi_datatype<real>(),
+                    &recvBuf[0], &transRecvCnt[0], &transRecvDsp[0], mpi::get_mpi_datatype<real>(),
+                    *comm);
+
+      pos = 0;
+      for (int s = 0; s < nprocs; ++s) {
+        for (int xl = 0; xl < nx[s]; ++xl) {
+          int x = x0[s] + xl;
+          for (int yl = 0; yl < ny[rank]; ++yl) {
+            for (int kz = 0; kz < nkz; ++kz) {
+              kspace(yl, kz, x) = dcomplex(recvBuf[pos], recvBuf[pos+1]);
+              pos += 2;
+            }
+          }
+        }
+      }
+    }
+
+    void ParallelFFT::transposeBackward() {
+      dcomplex *cmesh = reinterpret_cast<dcomplex*>(rmesh);
+      // the backward exchange is the mirror image of the forward one
+      sendBuf.resize(std::max(1, total(transRecvCnt)));
+      recvBuf.resize(std::max(1, total(transSendCnt)));
+
+      int pos = 0;
+      for (int r = 0; r < nprocs; ++r) {
+        for (int xl = 0; xl < nx[r]; ++xl) {
+          int x = x0[r] + xl;
+          for (int yl = 0; yl < ny[rank]; ++yl) {
+            for (int kz = 0; kz < nkz; ++kz) {
+              const dcomplex &c = kspace(yl, kz, x);
+              sendBuf[pos++] = c.real();
+              sendBuf[pos++] = c.imag();
+            }
+          }
+        }
+      }
+
+      MPI_Alltoallv(&sendBuf[0], &transRecvCnt[0], &transRecvDsp[0], mpi::get_mpi_datatype<real>(),
+                    &recvBuf[0], &transSendCnt[0], &transSendDsp[0], mpi::get_mpi_datatype<real>(),
+                    *comm);
+
+      pos = 0;
+      for (int s = 0; s < nprocs; ++s) {
+        for (int xl = 0; xl < nx[rank]; ++xl) {
+          for (int y = y0[s]; y < y0[s] + ny[s]; ++y) {
+            dcomplex *row = cmesh + (xl*M[1] + y)*nkz;
+            for (int kz = 0; kz < nkz; ++kz) {
+              row[kz] = dcomplex(recvBuf[pos], recvBuf[pos+1]);
+              pos += 2;
+            }
+          }
+        }
+      }
+    }
+
+    void ParallelFFT::setBrick(const Int3D& lo, const Int3D& n) {
+      int mine[6] = { lo[0], lo[1], lo[2], n[0], n[1], n[2] };
+      std::vector<int> all;
+      mpi::all_gather(*comm, mine, 6, all);
+
+      for (int r = 0; r < nprocs; ++r) {
+        brickLo[r] = Int3D(all[6*r], all[6*r+1], all[6*r+2]);
+        brickN[r] = Int3D(all[6*r+3], all[6*r+4], all[6*r+5]);
+      }
+
+      // every x-plane of a brick goes to the owner of its slab
+      brickSendCnt.assign(nprocs, 0);
+      brickRecvCnt.assign(nprocs, 0);
+      for (int i = 0; i < brickN[rank][0]; ++i) {
+        int owner = xOwner[wrap(brickLo[rank][0] + i, M[0])];
+        brickSendCnt[owner] += brickN[rank][1]*brickN[rank][2];
+      }
+      for (int s = 0; s < nprocs; ++s) {
+        for (int i = 0; i < brickN[s][0]; ++i) {
+          if (xOwner[wrap(brickLo[s][0] + i, M[0])] == rank) {
+            brickRecvCnt[s] += brickN[s][1]*brickN[s][2];
+          }
+        }
+      }
+      displacements(brickSendCnt, brickSendDsp);
+      displacements(brickRecvCnt, brickRecvDsp);
+    }
+
+    void ParallelFFT::brickToSlab(const std::vector<real>& brick) {
+      const Int3D& lo = brickLo[rank];
+      const Int3D& n = brickN[rank];
+      const int planeSize = n[1]*n[2];
+      sendBuf.resize(std::max(1, total(brickSendCnt)));
+      recvBuf.resize(std::max(1, total(brickRecvCnt)));
+
+      int pos = 0;
+      for (int r = 0; r < nprocs; ++r) {
+        for (int i = 0; i < n[0]; ++i) {
+          if (xOwner[wrap(lo[0] + i, M[0])] != r) continue;
+          std::copy(brick.begin() + brickIndex(i, 0, 0),
+                    brick.begin() + brickIndex(i, 0, 0) + planeSize,
+                    sendBuf.begin() + pos);
+          pos += planeSize;
+        }
+      }
+
+      MPI_Alltoallv(&sendBuf[0], &brickSendCnt[0], &brickSendDsp[0], mpi::get_mpi_datatype<real>(),
+                    &recvBuf[0], &brickRecvCnt[0], &brickRecvDsp[0], mpi::get_mpi_datatype<real>(),
+                    *comm);
+
+      std::fill(rmesh, rmesh + std::max(1L, (long)nx[rank]*M[1]*nzPad), 0.0);
+
+      pos = 0;
+      for (int s = 0; s < nprocs; ++s) {
+        const Int3D& slo = brickLo[s];
+        const Int3D& sn = brickN[s];
+        for (int i = 0; i < sn[0]; ++i) {
+          int x = wrap(slo[0] + i, M[0]);
+          if (xOwner[x] != rank) continue;
+          int xl = x - x0[rank];
+          for (int j = 0; j < sn[1]; ++j) {
+            int y = wrap(slo[1] + j, M[1]);
+            for (int k = 0; k < sn[2]; ++k) {
+              slab(xl, y, wrap(slo[2] + k, M[2])) += recvBuf[pos++];
+            }
+          }
+        }
+      }
+    }
+
+    void ParallelFFT::slabToBrick(std::vector<real>& brick) {
+      // the mirror image of brickToSlab: send and receive counts swap
+      sendBuf.resize(std::max(1, total(brickRecvCnt)));
+      recvBuf.resize(std::max(1, total(brickSendCnt)));
+
+      int pos = 0;
+      for (int r = 0; r < nprocs; ++r) {
+        const Int3D& rlo = brickLo[r];
+        const Int3D& rn = brickN[r];
+        for (int i = 0; i < rn[0]; ++i) {
+          int x = wrap(rlo[0] + i, M[0]);
+          if (xOwner[x] != rank) continue;
+          int xl = x - x0[rank];
+          for (int j = 0; j < rn[1]; ++j) {
+            int y = wrap(rlo[1] + j, M[1]);
+            for (int k = 0; k < rn[2]; ++k) {
+              sendBuf[pos++] = slab(xl, y, wrap(rlo[2] + k, M[2]));
+            }
+          }
+        }
+      }
+
+      MPI_Alltoallv(&sendBuf[0], &brickRecvCnt[0], &brickRecvDsp[0], mpi::get_mpi_datatype<real>(),
+                    &recvBuf[0], &brickSendCnt[0], &brickSendDsp[0], mpi::get_mpi_datatype<real>(),
+                    *comm);
+
+      const Int3D& lo = brickLo[rank];
+      const Int3D& n = brickN[rank];
+      const int planeSize = n[1]*n[2];
+      brick.resize(getBrickSize());
+      pos = 0;
+      for (int s = 0; s < nprocs; ++s) {
+        for (int i = 0; i < n[0]; ++i) {
+          if (xOwner[wrap(lo[0] + i, M[0])] != s) continue;
+          std::copy(recvBuf.begin() + pos, recvBuf.begin() + pos + planeSize,
+                    brick.begin() + brickIndex(i, 0, 0));
+          pos += planeSize;
+        }
+      }
+    }
+  }
+}
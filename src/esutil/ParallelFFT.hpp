@@ -0,0 +1,164 @@
+/*
+  Copyright (C) 2016
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ESPP_CLASS
+#ifndef _ESUTIL_PARALLELFFT_HPP
+#define _ESUTIL_PARALLELFFT_HPP
+
+#include <complex>
+#include <string>
+#include <vector>
+#include <fftw3.h>
+
+#include "types.hpp"
+#include "mpi.hpp"
+#include "Int3D.hpp"
+#include "log4espp.hpp"
+
+namespace espressopp {
+  namespace esutil {
+
+    /** Distributed real-to-complex 3D FFT of a periodic mesh.
+
+        The real mesh of size M[0] x M[1] x M[2] is distributed in slabs
+        along x over all processes of the communicator, the transformed
+        mesh in slabs along ky. The forward transform consists of 2D
+        r2c transforms of the local x-planes, a global transpose
+        (MPI_Alltoallv) and 1D transforms along x; the backward
+        transform reverses these steps. Only the non-redundant half
+        kz = 0 .. M[2]/2 of the spectrum is stored.
+
+        Particle based methods work on a "brick", a local block of the
+        mesh covering the process domain plus the stencil halo, given
+        in unwrapped mesh coordinates. brickToSlab() sums the bricks of
+        all processes into the distributed mesh (periodically wrapped),
+        slabToBrick() fills the bricks from it.
+
+        The FFTW plans are created once in the constructor and reused
+        for all transforms. Transforms are not normalised. With a
+        wisdom file the planner starts from the wisdom stored there and
+        adds what it learned, so that expensive planning rigors
+        (FFTW_MEASURE, FFTW_PATIENT) are paid only once per mesh and
+        number of processes, not in every run.
+    */
+    class ParallelFFT {
+    public:
+      typedef std::complex<real> dcomplex;
+
+      ParallelFFT(shared_ptr< mpi::communicator > comm, const Int3D& M,
+                  unsigned planFlags = FFTW_ESTIMATE,
+                  const std::string& wisdomFile = "");
+      ~ParallelFFT();
+
+      const Int3D& getMesh() const { return M; }
+      unsigned getPlanFlags() const { return planFlags; }
+      const std::string& getWisdomFile() const { return wisdomFile; }
+
+      /// planner rigor from its name: "estimate", "measure", "patient" or "exhaustive"
+      static unsigned planFlagsFromString(const std::string& rigor);
+      static std::string planFlagsToString(unsigned planFlags);
+
+      /// first x-plane and number of x-planes of the local real slab
+      int getLocalX0() const { return x0[rank]; }
+      int getLocalNX() const { return nx[rank]; }
+
+      /// first ky-plane and number of ky-planes of the local spectrum
+      int getLocalKY0() const { return y0[rank]; }
+      int getLocalNKY() const { return ny[rank]; }
+      /// number of stored kz values, M[2]/2 + 1
+      int getNKZ() const { return nkz; }
+
+      /// real mesh value at local plane xl, global y and z
+      real& slab(int xl, int y, int z) { return rmesh[(xl*M[1] + y)*nzPad + z]; }
+
+      /// spectrum at local plane kyl, global kz and kx
+      dcomplex& kspace(int kyl, int kz, int kx) {
+        return kmesh[(kyl*nkz + kz)*M[0] + kx];
+      }
+      /// number of locally stored complex values of the spectrum
+      long getLocalKSize() const { return (long)ny[rank]*nkz*M[0]; }
+      dcomplex *getKSpace() { return kmesh; }
+
+      /// real mesh -> spectrum, the real mesh is overwritten
+      void forward();
+      /// spectrum -> real mesh, the spectrum is overwritten
+      void backward();
+
+      /** Set the local brick [lo, lo+n) in unwrapped mesh coordinates.
+          Collective: all processes must call it with their bricks. */
+      void setBrick(const Int3D& lo, const Int3D& n);
+      const Int3D& getBrickLo() const { return brickLo[rank]; }
+      const Int3D& getBrickN() const { return brickN[rank]; }
+      long getBrickSize() const {
+        const Int3D& n = brickN[rank];
+        return (long)n[0]*n[1]*n[2];
+      }
+      /// linear index of point (i,j,k) relative to the brick origin
+      long brickIndex(int i, int j, int k) const {
+        const Int3D& n = brickN[rank];
+        return ((long)i*n[1] + j)*n[2] + k;
+      }
+
+      /** Sum the bricks of all processes into the real mesh. */
+      void brickToSlab(const std::vector<real>& brick);
+      /** Copy the real mesh into the bricks of all processes. */
+      void slabToBrick(std::vector<real>& brick);
+
+    private:
+      void createPlans();
+      void destroyPlans();
+      /// collective: read the wisdom file on rank 0 and import it everywhere
+      void importWisdom();
+      /// collective: merge the wisdom of all processes on rank 0 and write it
+      void exportWisdom();
+      void transposeForward();
+      void transposeBackward();
+
+      shared_ptr< mpi::communicator > comm;
+      int rank, nprocs;
+
+      Int3D M;
+      unsigned planFlags;
+      std::string wisdomFile;
+      int nkz;     // M[2]/2 + 1
+      int nzPad;   // padded z length of the real mesh, 2*nkz
+
+      // slab decomposition: real mesh along x, spectrum along ky
+      std::vector<int> x0, nx, y0, ny;
+      std::vector<int> xOwner;
+
+      real *rmesh;
+      dcomplex *kmesh;
+
+      fftw_plan planR2C, planC2R, planFwdX, planBwdX;
+
+      // bricks of all processes
+      std::vector<Int3D> brickLo, brickN;
+
+      // counts and displacements (in reals) of the all-to-all exchanges
+      std::vector<int> transSendCnt, transSendDsp, transRecvCnt, transRecvDsp;
+      std::vector<int> brickSendCnt, brickSendDsp, brickRecvCnt, brickRecvDsp;
+      std::vector<real> sendBuf, recvBuf;
+
+      static LOG4ESPP_DECL_LOGGER(logger);
+    };
+  }
+}
+#endif
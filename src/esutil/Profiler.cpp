@@ -0,0 +1,385 @@
+/*
+  Copyright (C) 2016
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "python.hpp"
+#include "Profiler.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <boost/cstdint.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+#include "log4espp.hpp"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace espressopp::python;
+
+namespace espressopp {
+  namespace esutil {
+    namespace Profiler {
+
+      LOG4ESPP_LOGGER(logger, "Profiler");
+
+      namespace detail {
+        bool enabled = false;
+      }
+
+      namespace {
+        // the key of a node, compared without building its name
+        struct Key {
+          const char *name;
+          int index;
+        };
+
+        struct Frame {
+          int node;
+          double start;
+          long long counters[NCOUNTERS];
+        };
+
+        struct Event {
+          int node;
+          double start, duration;
+        };
+
+        std::vector< Node > nodes;
+        std::vector< Key > keys;
+        std::vector< Frame > stack;
+        std::vector< Event > events;
+        bool tracing = false;
+        double origin = 0.0;
+        int counterFd[NCOUNTERS] = { -1, -1, -1 };
+
+        int addNode(const char *name, int index, int parent) {
+          Node n;
+          n.name = name;
+          if (index >= 0) {
+            std::ostringstream s;
+            s << name << "[" << index << "]";
+            n.name = s.str();
+          }
+          n.parent = parent;
+          n.calls = 0;
+          n.time = n.bytes = 0.0;
+          std::fill(n.counters, n.counters + NCOUNTERS, 0);
+          nodes.push_back(n);
+          Key k = { name, index };
+          keys.push_back(k);
+          if (parent >= 0) nodes[parent].children.push_back(nodes.size() - 1);
+          return nodes.size() - 1;
+        }
+
+        void clearTree() {
+          nodes.clear();
+          keys.clear();
+          stack.clear();
+          events.clear();
+          addNode("run", -1, -1);
+          origin = MPI_Wtime();
+        }
+
+        void readCounters(long long values[NCOUNTERS]) {
+          for (int c = 0; c < NCOUNTERS; ++c) {
+            values[c] = 0;
+#ifdef __linux__
+            if (counterFd[c] >= 0 && read(counterFd[c], &values[c], sizeof(long long)) != sizeof(long long)) {
+              values[c] = 0;
+            }
+#endif
+          }
+        }
+
+        void closeCounters() {
+          for (int c = 0; c < NCOUNTERS; ++c) {
+#ifdef __linux__
+            if (counterFd[c] >= 0) close(counterFd[c]);
+#endif
+            counterFd[c] = -1;
+          }
+        }
+
+        void openCounters() {
+#ifdef __linux__
+          const boost::uint64_t config[NCOUNTERS] = {
+            PERF_COUNT_HW_CPU_CYCLES,
+            PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES
+          };
+          for (int c = 0; c < NCOUNTERS; ++c) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = config[c];
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            counterFd[c] = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+            if (counterFd[c] < 0) {
+              LOG4ESPP_WARN(logger, "hardware counter " << c << " is not available");
+              closeCounters();
+              return;
+            }
+          }
+#else
+          LOG4ESPP_WARN(logger, "hardware counters are only supported on Linux");
+#endif
+        }
+      }
+
+      namespace detail {
+        int begin(const char *name, int index) {
+          const int parent = stack.empty() ? 0 : stack.back().node;
+          int node = -1;
+          const std::vector< int > &children = nodes[parent].children;
+          for (size_t i = 0; i < children.size(); ++i) {
+            const Key &k = keys[children[i]];
+            if (k.index == index && (k.name == name || std::strcmp(k.name, name) == 0)) {
+              node = children[i];
+              break;
+            }
+          }
+          if (node < 0) node = addNode(name, index, parent);
+
+          Frame f;
+          f.node = node;
+          readCounters(f.counters);
+          f.start = MPI_Wtime();
+          stack.push_back(f);
+          return node;
+        }
+
+        void end(int node) {
+          const double now = MPI_Wtime();
+          long long counters[NCOUNTERS];
+          readCounters(counters);
+
+          // a scope opened before reset() or enable() has no frame
+          if (stack.empty() || stack.back().node != node) return;
+          const Frame &f = stack.back();
+          Node &n = nodes[node];
+          n.calls += 1;
+          n.time += now - f.start;
+          for (int c = 0; c < NCOUNTERS; ++c) n.counters[c] += counters[c] - f.counters[c];
+          if (tracing && events.size() < maxEvents) {
+            Event e = { node, f.start - origin, now - f.start };
+            events.push_back(e);
+          }
+          stack.pop_back();
+        }
+      }
+
+      void enable(bool counters, bool trace) {
+        closeCounters();
+        if (counters) openCounters();
+        tracing = trace;
+        if (nodes.empty()) clearTree();
+        detail::enabled = true;
+      }
+
+      void disable() {
+        detail::enabled = false;
+        closeCounters();
+        stack.clear();
+      }
+
+      void reset() {
+        clearTree();
+      }
+
+      bool hasCounters() {
+        return counterFd[0] >= 0;
+      }
+
+      void addBytes(double bytes) {
+        if (!detail::enabled || stack.empty()) return;
+        nodes[stack.back().node].bytes += bytes;
+      }
+
+      const std::vector< Node > &getNodes() {
+        if (nodes.empty()) clearTree();
+        return nodes;
+      }
+
+      static std::string path(int node) {
+        std::string p = nodes[node].name;
+        for (int n = nodes[node].parent; n >= 0; n = nodes[n].parent) {
+          p = nodes[n].name + "/" + p;
+        }
+        return p;
+      }
+
+      std::vector< Summary > report(mpi::communicator &comm) {
+        const int nValues = 3 + NCOUNTERS;
+        getNodes();
+
+        // the trees of the processes may differ, so they are matched by path
+        std::vector< std::string > paths(nodes.size());
+        std::vector< double > values(nodes.size() * nValues);
+        for (size_t i = 0; i < nodes.size(); ++i) {
+          paths[i] = path(i);
+          double *v = &values[i * nValues];
+          v[0] = nodes[i].time;
+          v[1] = nodes[i].calls;
+          v[2] = nodes[i].bytes;
+          for (int c = 0; c < NCOUNTERS; ++c) v[3 + c] = nodes[i].counters[c];
+        }
+        // the root holds the time since the last reset
+        values[0] = MPI_Wtime() - origin;
+        values[1] = 1;
+
+        std::vector< std::vector< std::string > > allPaths;
+        std::vector< std::vector< double > > allValues;
+        mpi::gather(comm, paths, allPaths, 0);
+        mpi::gather(comm, values, allValues, 0);
+
+        std::vector< Summary > result;
+        if (comm.rank() != 0) return result;
+
+        // phases in the order of rank 0, then the ones only others have
+        std::vector< std::string > order;
+        for (size_t r = 0; r < allPaths.size(); ++r) {
+          for (size_t i = 0; i < allPaths[r].size(); ++i) {
+            if (std::find(order.begin(), order.end(), allPaths[r][i]) == order.end()) {
+              order.push_back(allPaths[r][i]);
+            }
+          }
+        }
+
+        const int nRanks = comm.size();
+        for (size_t k = 0; k < order.size(); ++k) {
+          Summary s;
+          s.path = order[k];
+          for (int j = 0; j < nValues; ++j) {
+            s.min[j] = 1e300;
+            s.max[j] = -1e300;
+            s.avg[j] = 0.0;
+          }
+          for (int r = 0; r < nRanks; ++r) {
+            // a process that never entered the phase counts with zeros
+            const double zeros[3 + NCOUNTERS] = { 0.0 };
+            const double *v = zeros;
+            std::vector< std::string >::const_iterator it =
+              std::find(allPaths[r].begin(), allPaths[r].end(), s.path);
+            if (it != allPaths[r].end()) v = &allValues[r][(it - allPaths[r].begin()) * nValues];
+            for (int j = 0; j < nValues; ++j) {
+              s.min[j] = std::min(s.min[j], v[j]);
+              s.max[j] = std::max(s.max[j], v[j]);
+              s.avg[j] += v[j] / nRanks;
+            }
+          }
+          result.push_back(s);
+        }
+        return result;
+      }
+
+      static std::string escape(const std::string &s) {
+        std::string e;
+        for (size_t i = 0; i < s.size(); ++i) {
+          if (s[i] == '"' || s[i] == '\\') e += '\\';
+          e += s[i];
+        }
+        return e;
+      }
+
+      void writeChromeTrace(mpi::communicator &comm, const std::string &filename) {
+        getNodes();
+        std::vector< std::string > names(nodes.size());
+        for (size_t i = 0; i < nodes.size(); ++i) names[i] = nodes[i].name;
+        std::vector< double > data(3 * events.size());
+        for (size_t i = 0; i < events.size(); ++i) {
+          data[3*i] = events[i].node;
+          data[3*i + 1] = events[i].start;
+          data[3*i + 2] = events[i].duration;
+        }
+
+        std::vector< std::vector< std::string > > allNames;
+        std::vector< std::vector< double > > allData;
+        mpi::gather(comm, names, allNames, 0);
+        mpi::gather(comm, data, allData, 0);
+        if (comm.rank() != 0) return;
+
+        std::ofstream out(filename.c_str());
+        if (!out) throw std::runtime_error("Profiler: cannot open " + filename);
+        out.precision(15);
+        out << "{\"traceEvents\":[";
+        bool first = true;
+        for (size_t r = 0; r < allData.size(); ++r) {
+          // one row per process
+          out << (first ? "\n" : ",\n")
+              << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << r
+              << ",\"args\":{\"name\":\"rank " << r << "\"}}";
+          first = false;
+          for (size_t i = 0; i + 2 < allData[r].size(); i += 3) {
+            // complete events in microseconds
+            out << ",\n{\"name\":\"" << escape(allNames[r][int(allData[r][i])])
+                << "\",\"ph\":\"X\",\"pid\":" << r << ",\"tid\":0"
+                << ",\"ts\":" << 1e6 * allData[r][i + 1]
+                << ",\"dur\":" << 1e6 * allData[r][i + 2] << "}";
+          }
+        }
+        out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+      }
+
+      /****************************************************
+      ** REGISTRATION WITH PYTHON
+      ****************************************************/
+      static list pyReport() {
+        static const char *columns[3 + NCOUNTERS] = {
+          "time", "calls", "bytes", "cycles", "instructions", "cache_misses"
+        };
+        std::vector< Summary > summaries = report(*mpiWorld);
+        list ret;
+        for (size_t i = 0; i < summaries.size(); ++i) {
+          const Summary &s = summaries[i];
+          dict d;
+          d["path"] = s.path;
+          const int nValues = hasCounters() ? 3 + NCOUNTERS : 3;
+          for (int j = 0; j < nValues; ++j) {
+            d[columns[j]] = make_tuple(s.min[j], s.max[j], s.avg[j]);
+          }
+          ret.append(d);
+        }
+        return ret;
+      }
+
+      static void pyWriteChromeTrace(const std::string &filename) {
+        writeChromeTrace(*mpiWorld, filename);
+      }
+
+      void registerPython() {
+        def("esutil_Profiler_enable", enable);
+        def("esutil_Profiler_disable", disable);
+        def("esutil_Profiler_reset", reset);
+        def("esutil_Profiler_isEnabled", isEnabled);
+        def("esutil_Profiler_hasCounters", hasCounters);
+        def("esutil_Profiler_report", pyReport);
+        def("esutil_Profiler_writeChromeTrace", pyWriteChromeTrace);
+      }
+    }
+  }
+}
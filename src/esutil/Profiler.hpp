@@ -0,0 +1,130 @@
+/*
+  Copyright (C) 2016
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ESPP_CLASS
+#ifndef _ESUTIL_PROFILER_HPP
+#define _ESUTIL_PROFILER_HPP
+
+#include <string>
+#include <vector>
+#include "types.hpp"
+#include "mpi.hpp"
+
+namespace espressopp {
+  namespace esutil {
+
+    /** Hierarchical profiling of the phases of a run.
+
+        A phase is measured by a Profiler::Scope on the stack; scopes
+        opened while another one is open become its children, so the
+        phases form a tree, e.g. run/updateForces/commF/mpi. Per phase
+        the profiler sums the wall time, the number of calls, the bytes
+        sent by the process (see addBytes()) and, if enabled and
+        available, hardware counters (Linux perf events, see Counter).
+
+        The profiler is off by default; a disabled scope costs a single
+        branch. Scopes must only be opened by the master thread.
+
+        report() reduces the tree over all processes to the minimum,
+        maximum and average of every quantity, which exposes load
+        imbalance and time spent waiting in MPI. With tracing enabled,
+        every scope is also recorded as an event (up to maxEvents per
+        process), which writeChromeTrace() stores in the Chrome trace
+        format (chrome://tracing, Perfetto) with one row per process.
+    */
+    namespace Profiler {
+
+      /** hardware counters, measured for the master thread only */
+      enum Counter {
+        CYCLES = 0,
+        INSTRUCTIONS,
+        CACHE_MISSES,  //!< last level cache misses
+        NCOUNTERS
+      };
+
+      /** events recorded at most per process while tracing */
+      const size_t maxEvents = 1000000;
+
+      /** one phase of the tree; node 0 is the root */
+      struct Node {
+        std::string name;
+        int parent;
+        std::vector< int > children;
+        long long calls;
+        double time;
+        double bytes;
+        long long counters[NCOUNTERS];
+      };
+
+      namespace detail {
+        extern bool enabled;
+        int begin(const char *name, int index);
+        void end(int node);
+      }
+
+      inline bool isEnabled() { return detail::enabled; }
+
+      /** Start profiling. counters: read the hardware counters, which
+          may be unavailable (e.g. perf_event_paranoid); trace: record
+          events for writeChromeTrace(). */
+      void enable(bool counters = false, bool trace = false);
+      void disable();
+      /** forget all measurements and events */
+      void reset();
+      /** true if the hardware counters could be opened */
+      bool hasCounters();
+
+      /** Count bytes sent by this process in the innermost open scope. */
+      void addBytes(double bytes);
+
+      /** the tree measured by this process */
+      const std::vector< Node > &getNodes();
+
+      /** Measures the lifetime of the object as a phase. The name must
+          be a string literal or live as long as the profiler; with an
+          index >= 0 the phase is name[index], e.g. per interaction. */
+      class Scope {
+      public:
+        Scope(const char *name, int index = -1)
+          : node(detail::enabled ? detail::begin(name, index) : -1) {}
+        ~Scope() { if (node >= 0) detail::end(node); }
+      private:
+        int node;
+        Scope(const Scope &);
+        Scope &operator=(const Scope &);
+      };
+
+      /** One line of the reduced report: the phase path and min, max
+          and average over the processes of time, calls, bytes and
+          counters. Collective. */
+      struct Summary {
+        std::string path;
+        double min[3 + NCOUNTERS], max[3 + NCOUNTERS], avg[3 + NCOUNTERS];
+      };
+      std::vector< Summary > report(mpi::communicator &comm);
+
+      /** Write the events of all processes to filename on rank 0. Collective. */
+      void writeChromeTrace(mpi::communicator &comm, const std::string &filename);
+
+      void registerPython();
+    }
+  }
+}
+#endif
@@ -0,0 +1,124 @@
+#  Copyright (C) 2016
+#      Max Planck Institute for Polymer Research
+#  
+#  This file is part of ESPResSo++.
+#  
+#  ESPResSo++ is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#  
+#  ESPResSo++ is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#  
+#  You should have received a copy of the GNU General Public License
+#  along with this program.  If not, see <http://www.gnu.org/licenses/>. 
+
+r"""
+**************************
+espressopp.esutil.Profiler
+**************************
+
+Hierarchical profiler of the phases of a run. While enabled, the
+integrator, the storage, the interactions and the signals of the
+extensions measure their phases as a tree, e.g.::
+
+  run/integrate/updateForces/force/interaction[0]
+  run/integrate/updateForces/commF/pack
+  run/integrate/updateForces/commF/mpi
+
+Per phase and process the wall time, the number of calls and the bytes
+sent are summed; optionally also hardware counters (cycles,
+instructions, last level cache misses of the master thread, read
+from Linux perf events). The profiler is off by default and costs a
+branch per phase then.
+
+.. py:method:: espressopp.esutil.profilerEnable(counters=False, trace=False)
+
+		Start profiling on all processes.
+
+		:param counters: read the hardware counters, if the system allows it
+		:type counters: bool
+		:param trace: record every phase as an event for :py:meth:`profilerWriteChromeTrace`
+		:type trace: bool
+
+.. py:method:: espressopp.esutil.profilerDisable()
+
+.. py:method:: espressopp.esutil.profilerReset()
+
+		Forget all measurements and events.
+
+.. py:method:: espressopp.esutil.profilerReport()
+
+		Reduce the measurements over all processes.
+
+		:rtype: list of dicts, one per phase, with the key 'path' and the
+			keys 'time', 'calls', 'bytes' (and with counters 'cycles',
+			'instructions', 'cache_misses') holding (min, max, avg)
+			over the processes. max/avg of the time is the load
+			imbalance of a phase, the time of the 'mpi' phases is
+			mostly waiting for the neighbors.
+
+.. py:method:: espressopp.esutil.profilerWriteChromeTrace(filename)
+
+		Write the recorded events of all processes to a JSON file in the
+		Chrome trace format (chrome://tracing, Perfetto), one row per
+		process. Times are relative to the start of each process'
+		recording.
+
+		:param filename: name of the file
+		:type filename: str
+
+.. py:method:: espressopp.esutil.profilerPrint(report=None)
+
+		Print a report as a table.
+
+>>> espressopp.esutil.profilerEnable(trace=True)
+>>> integrator.run(1000)
+>>> espressopp.esutil.profilerPrint()
+>>> espressopp.esutil.profilerWriteChromeTrace('trace.json')
+"""
+import _espressopp
+from espressopp import pmi
+
+def profilerEnableLocal(counters=False, trace=False):
+    _espressopp.esutil_Profiler_enable(counters, trace)
+
+def profilerDisableLocal():
+    _espressopp.esutil_Profiler_disable()
+
+def profilerResetLocal():
+    _espressopp.esutil_Profiler_reset()
+
+def profilerReportLocal():
+    return _espressopp.esutil_Profiler_report()
+
+def profilerWriteChromeTraceLocal(filename):
+    _espressopp.esutil_Profiler_writeChromeTrace(filename)
+
+def profilerPrint(report=None):
+    if report is None:
+        report = profilerReport()
+    print '%-60s %12s %12s %12s %10s %12s' % ('phase', 'min [s]', 'max [s]', 'avg [s]', 'max/avg', 'bytes avg')
+    for p in report:
+        tmin, tmax, tavg = p['time']
+        imbalance = tmax / tavg if tavg > 0.0 else 1.0
+        print '%-60s %12.6f %12.6f %12.6f %10.3f %12.0f' % (p['path'], tmin, tmax, tavg, imbalance, p['bytes'][2])
+
+if pmi.isController:
+    def profilerEnable(counters=False, trace=False):
+        pmi.call('espressopp.esutil.profilerEnableLocal', counters, trace)
+
+    def profilerDisable():
+        pmi.call('espressopp.esutil.profilerDisableLocal')
+
+    def profilerReset():
+        pmi.call('espressopp.esutil.profilerResetLocal')
+
+    def profilerReport():
+        return pmi.call('espressopp.esutil.profilerReportLocal')
+
+    def profilerWriteChromeTrace(filename):
+        pmi.call('espressopp.esutil.profilerWriteChromeTraceLocal', filename)
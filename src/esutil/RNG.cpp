@@ -24,6 +24,8 @@
 #include "RNG.hpp"
 #include "mpi.hpp"
 #include "types.hpp"
+#include <sstream>
+#include <limits>
 
 using namespace boost;
 
@@ -47,6 +49,28 @@ namespace espressopp {
       return seed_;
     }
 
+    std::string RNG::getState() {
+      // the normal distribution is saved as well: a Box-Muller normal
+      // distribution caches the second variate of each pair together
+      // with its valid flag
+      std::ostringstream out;
+      out.precision(std::numeric_limits< real >::digits10 + 2);
+      out << seed_ << ' ' << *boostRNG
+          << ' ' << normalVariate.distribution();
+      return out.str();
+    }
+
+    void RNG::setState(const std::string &state) {
+      std::istringstream in(state);
+      in >> seed_ >> *boostRNG >> normalVariate.distribution();
+      if (!in) {
+        throw std::runtime_error("RNG: invalid generator state");
+      }
+      // uniform_on_sphere cannot be read back into a Real3D; it keeps no
+      // numbers between calls anyway
+      uniformOnSphereVariate.distribution().reset();
+    }
+
     real RNG::operator()() { 
       variate_generator< RNGType&, uniform_01<> > uni(*boostRNG, uniform_01<>());
       return uni();
@@ -26,6 +26,7 @@
 #include <boost/random.hpp>
 #include "Real3D.hpp"
 #include <vector>
+#include <string>
 
 
 #include "types.hpp"
@@ -48,6 +49,12 @@ namespace espressopp {
 
       /** Gets RNG seed. */
       long get_seed();
+
+      /** the seed and the state of the generator and of the normal
+          distribution of this process as text, e.g. for checkpoints */
+      std::string getState();
+      /** restore the seed and the state saved by getState() */
+      void setState(const std::string &state);
     
       /** returns a uniformly distributed random number between 0 and
 	  1. */
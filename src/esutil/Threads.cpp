@@ -0,0 +1,45 @@
+/*
+  Copyright (C) 2016
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "python.hpp"
+#include "Threads.hpp"
+#include <stdexcept>
+
+using namespace espressopp::python;
+
+namespace espressopp {
+  namespace esutil {
+    namespace Threads {
+      void setNumThreads(int n) {
+        if (n < 1) {
+          throw std::runtime_error("number of threads has to be at least 1");
+        }
+#ifdef _OPENMP
+        omp_set_num_threads(n);
+#endif
+      }
+
+      void registerPython() {
+        def("esutil_Threads_getNumThreads", getNumThreads);
+        def("esutil_Threads_setNumThreads", setNumThreads);
+      }
+    }
+  }
+}
@@ -0,0 +1,50 @@
+/*
+  Copyright (C) 2016
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ESPP_CLASS
+#ifndef _ESUTIL_THREADS_HPP
+#define _ESUTIL_THREADS_HPP
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace espressopp {
+  namespace esutil {
+    namespace Threads {
+      /** Number of threads used by the threaded loops of this process.
+          Always 1 if ESPResSo++ was built without OpenMP. */
+      inline int getNumThreads() {
+#ifdef _OPENMP
+        return omp_get_max_threads();
+#else
+        return 1;
+#endif
+      }
+
+      /** Set the number of threads used by the threaded loops of this
+          process. Ignored without OpenMP. */
+      void setNumThreads(int n);
+
+      void registerPython();
+    }
+  }
+}
+#endif
@@ -0,0 +1,59 @@
+#  Copyright (C) 2016
+#      Max Planck Institute for Polymer Research
+#  
+#  This file is part of ESPResSo++.
+#  
+#  ESPResSo++ is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#  
+#  ESPResSo++ is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#  
+#  You should have received a copy of the GNU General Public License
+#  along with this program.  If not, see <http://www.gnu.org/licenses/>. 
+
+
+r"""
+*************************
+espressopp.esutil.Threads
+*************************
+
+Control the number of threads used by the threaded loops (short-range
+forces) of every MPI process. Without OpenMP support, the number of
+threads is always 1.
+
+Besides the force loops, the integration steps, the force reset and the
+Langevin thermostat (with counter_rng) run over the cells of the storage
+on these threads; idle threads take the next block of cells. The
+all-pairs cell list interactions colour the cells so that concurrent
+cells never update the same particles.
+
+.. py:method:: espressopp.esutil.setNumThreads(n)
+
+		Set the number of threads per MPI process on all processes.
+
+		:param n: number of threads
+		:type n: int
+
+.. py:method:: espressopp.esutil.getNumThreads()
+
+		:rtype: number of threads of the local process
+
+>>> espressopp.esutil.setNumThreads(4)
+"""
+import _espressopp
+from espressopp import pmi
+
+def setNumThreadsLocal(n):
+    _espressopp.esutil_Threads_setNumThreads(n)
+
+def getNumThreads():
+    return _espressopp.esutil_Threads_getNumThreads()
+
+if pmi.isController:
+    def setNumThreads(n):
+        pmi.call('espressopp.esutil.setNumThreadsLocal', n)
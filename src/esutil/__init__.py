@@ -58,11 +58,14 @@ else:
 pmiimport('espressopp.esutil')
 
 from espressopp.esutil.RNG import *
+from espressopp.esutil.CounterRNG import *
 from espressopp.esutil.UniformOnSphere import *
 from espressopp.esutil.NormalVariate import *
 from espressopp.esutil.GammaVariate import *
 
 from espressopp.esutil.Grid import *
+from espressopp.esutil.Threads import *
+from espressopp.esutil.Profiler import *
 
 
 class ExtendBaseClass (type) :
@@ -23,23 +23,29 @@
 #include "bindings.hpp"
 #include "Collectives.hpp"
 #include "RNG.hpp"
+#include "CounterRNG.hpp"
 #include "UniformOnSphere.hpp"
 #include "NormalVariate.hpp"
 #include "GammaVariate.hpp"
 
 #include "Grid.hpp"
 #include "ParticlePairScaling.hpp"
+#include "Threads.hpp"
+#include "Profiler.hpp"
 
 namespace espressopp {
   namespace esutil {
     void registerPython() {
       Collectives::registerPython();
       RNG::registerPython();
+      CounterRNG::registerPython();
       UniformOnSphere::registerPython();
       NormalVariate::registerPython();
       GammaVariate::registerPython();
       Grid::registerPython();
       ParticlePairScaling::registerPython();
+      Threads::registerPython();
+      Profiler::registerPython();
     }
   }
 }
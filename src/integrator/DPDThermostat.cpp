@@ -47,6 +47,8 @@ namespace espressopp {
 
       current_cutoff = verletList->getVerletCutoff() - system->getSkin();
       current_cutoff_sqr = current_cutoff*current_cutoff;
+      counterRNG = false;
+      recalc = 0;
       
       if (!system->rng) {
         throw std::runtime_error("system has no RNG");
@@ -143,7 +145,17 @@ namespace espressopp {
         // standard DPD part
         real veldiff = (p1.velocity() - p2.velocity()) * r;
         real friction = pref1 * omega2 * veldiff;
-        real noise = pref2 * omega * ((*rng)() - 0.5);
+        real noise;
+        if (counterRNG) {
+          // symmetric in the two ids, so the same for either order of the pair
+          real u[4];
+          crng.uniform4(esutil::CounterRNG::DPD | recalc,
+                        integrator->getStep(),
+                        std::min(p1.id(), p2.id()), std::max(p1.id(), p2.id()), u);
+          noise = pref2 * omega * (u[0] - 0.5);
+        } else {
+          noise = pref2 * omega * ((*rng)() - 0.5);
+        }
 
         Real3D f = (noise - friction) * r;
         p1.force() += f;
@@ -162,7 +174,18 @@ namespace espressopp {
 		if (tgamma > 0.0) {
 		  real distinv = omega;
 
-		  Real3D noisevec((*rng)() - 0.5, (*rng)() - 0.5, (*rng)() - 0.5);
+		  Real3D noisevec;
+		  if (counterRNG) {
+		    // the force on p1 changes its sign with the order of the pair
+		    real u[4];
+		    crng.uniform4(esutil::CounterRNG::DPD_TRANSVERSE | recalc,
+		                  integrator->getStep(),
+		                  std::min(p1.id(), p2.id()), std::max(p1.id(), p2.id()), u);
+		    real sign = (p1.id() < p2.id()) ? 1.0 : -1.0;
+		    noisevec = sign * Real3D(u[0] - 0.5, u[1] - 0.5, u[2] - 0.5);
+		  } else {
+		    noisevec = Real3D((*rng)() - 0.5, (*rng)() - 0.5, (*rng)() - 0.5);
+		  }
 
 		  // damping, random force
 		  Real3D f_damp(0.0, 0.0, 0.0), f_rand(0.0, 0.0, 0.0);
@@ -209,6 +232,7 @@ namespace espressopp {
       pref2 = sqrt(24.0 * temperature * gamma/timestep);
       pref3 = tgamma;
       pref4 = sqrt(24.0 * temperature * tgamma);
+      crng.seed(rng->get_seed());
     }
 
     /** very nasty: if we recalculate force when leaving/reentering the integrator,
@@ -227,6 +251,8 @@ namespace espressopp {
     	pref2       *= sqrt(3.0);
     	pref4buffer = pref4;
     	pref4       *= sqrt(3.0);
+        // the forces of this step are computed again, with other noise
+        recalc = esutil::CounterRNG::RECALC;
         
     }
 
@@ -238,6 +264,7 @@ namespace espressopp {
         
         pref2 = pref2buffer;
         pref4 = pref4buffer;
+        recalc = 0;
         
     }
 
@@ -254,6 +281,7 @@ namespace espressopp {
         .add_property("gamma", &DPDThermostat::getGamma, &DPDThermostat::setGamma)
         .add_property("tgamma", &DPDThermostat::getTGamma, &DPDThermostat::setTGamma)
         .add_property("temperature", &DPDThermostat::getTemperature, &DPDThermostat::setTemperature)
+        .add_property("counter_rng", &DPDThermostat::getCounterRNG, &DPDThermostat::setCounterRNG)
         ;
     }
   }
@@ -29,6 +29,7 @@
 #include "VerletList.hpp"
 #include "Particle.hpp"
 #include "SystemAccess.hpp"
+#include "esutil/CounterRNG.hpp"
 
 #include "Extension.hpp"
 #include "VelocityVerlet.hpp"
@@ -59,6 +60,12 @@ namespace espressopp {
         void setTemperature(real temperature);
         real getTemperature();
 
+        /** draw the pair noise from the counter based RNG keyed by the step
+            and the ids of the pair instead of the sequential system RNG
+            (default) */
+        void setCounterRNG(bool _counterRNG) { counterRNG = _counterRNG; }
+        bool getCounterRNG() { return counterRNG; }
+
         void initialize();
 
         /** update of forces to thermalize the system */
@@ -101,6 +108,10 @@ namespace espressopp {
         shared_ptr<VerletList> verletList;
         shared_ptr< esutil::RNG > rng;  //!< random number generator used for friction term
 
+        bool counterRNG;          //!< use crng instead of rng
+        esutil::CounterRNG crng;  //!< seeded with the seed of rng in initialize()
+        esutil::CounterRNG::uint32 recalc;  //!< RECALC between heatUp and coolDown, else 0
+
     };
   }
 }
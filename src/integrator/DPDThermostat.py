@@ -31,6 +31,16 @@ espressopp.integrator.DPDThermostat
 		:param vl: 
 		:type system: 
 		:type vl: 
+
+.. attribute:: espressopp.integrator.DPDThermostat.counter_rng
+
+		if True, the pair noise is taken from
+		espressopp.esutil.CounterRNG, keyed by the step and the ids of
+		the pair and seeded with the seed of system.rng, so it is the
+		same for any number of processes. The noise is then a function
+		of integrator.step, so resetting the step replays it; reseed
+		system.rng between such runs. If False (default), it is drawn
+		in sequence from system.rng.
 """
 from espressopp.esutil import cxxinit
 from espressopp import pmi
@@ -53,5 +63,5 @@ if pmi.isController :
         __metaclass__ = pmi.Proxy
         pmiproxydefs = dict(
             cls =  'espressopp.integrator.DPDThermostatLocal',
-            pmiproperty = [ 'gamma', 'tgamma', 'temperature' ]
+            pmiproperty = [ 'gamma', 'tgamma', 'temperature', 'counter_rng' ]
             )
@@ -45,12 +45,17 @@ namespace espressopp {
     }
 
     void ExtAnalyze::disconnect(){
+      if (_aftIntV.connected()) {
+        integrator->releaseObservables(interval, particle_access->getRequiredObservables());
+      }
       _aftIntV.disconnect();
     }
 
     void ExtAnalyze::connect(){
       // connection to end of integrator
       _aftIntV  = integrator->aftIntV.connect(extensionOrder, boost::bind(&ExtAnalyze::perform_action, this));
+      // let the force pass of the analysed steps compute what the analysis reads
+      integrator->requestObservables(interval, particle_access->getRequiredObservables());
     }
 
     //void ExtAnalyze::performMeasurement() {
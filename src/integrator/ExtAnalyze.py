@@ -27,6 +27,10 @@ espressopp.integrator.ExtAnalyze
 This class can be used to execute nearly all analysis objects
 within the main integration loop which allows to automatically
 accumulate time averages (with standard deviation error bars). 
+
+For SystemMonitor and PressureTensor, the Verlet list and fixed pair
+interactions sum up the energies and virials in the force computation
+of the analysed steps, so the analysis does not walk the lists again.
   
 Example Usage:
 
@@ -25,6 +25,7 @@
 #define _INTEGRATOR_EXTENSION_HPP
 
 #include <esutil/Timer.hpp>
+#include <string>
 #include "log4espp.hpp"
 #include "types.hpp"
 #include "SystemAccess.hpp"
@@ -81,6 +82,13 @@ namespace espressopp {
         ExtensionType getType() {return type;}
         void setType(ExtensionType k) {type=k;}
 
+        /** Dynamical state that is not set from the parameters, for
+            checkpoints (see io::Checkpoint). It must be the same on all
+            processes; empty for extensions without such state. */
+        virtual std::string getState() { return std::string(); }
+        /** restore the state returned by getState() */
+        virtual void setState(const std::string &state) {}
+
       protected:
 
         shared_ptr<MDIntegrator> integrator; // this is needed for signal connection
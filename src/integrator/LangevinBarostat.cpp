@@ -35,6 +35,7 @@
 #include "bc/BC.hpp"
 
 #include "mpi.hpp"
+#include <sstream>
 
 namespace espressopp {
 
@@ -115,6 +116,20 @@ namespace espressopp {
       return mass;
     }
     
+    std::string LangevinBarostat::getState(){
+      std::ostringstream out;
+      out.precision(17);
+      out << momentum << ' ' << momentum_mass;
+      return out.str();
+    }
+    void LangevinBarostat::setState(const std::string &state){
+      std::istringstream in(state);
+      in >> momentum >> momentum_mass;
+      if (!in) {
+        throw std::runtime_error("LangevinBarostat: invalid state");
+      }
+    }
+
     // 
     void LangevinBarostat::setMassByFrequency(real freq){
       System& system = getSystemRef();
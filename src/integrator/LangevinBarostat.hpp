@@ -56,6 +56,10 @@ namespace espressopp {
         
         virtual ~LangevinBarostat();
 
+        /** the momentum of the volume variable */
+        std::string getState();
+        void setState(const std::string &state);
+
         /** Register this class so it can be used from Python. */
         static void registerPython();
 
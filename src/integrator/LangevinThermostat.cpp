@@ -21,6 +21,7 @@
 */
 
 #include "python.hpp"
+#include <algorithm>
 #include "LangevinThermostat.hpp"
 
 #include "types.hpp"
@@ -49,6 +50,10 @@ namespace espressopp {
       exclusions.clear();
       has_types = false;
       has_excl = false;
+      counterRNG = false;
+      recalc = 0;
+      noiseStep = -1;
+      noiseCall = 0;
 
       if (!system->rng) {
         throw std::runtime_error("system has no RNG");
@@ -133,16 +138,47 @@ namespace espressopp {
 
       System& system = getSystemRef();
 
-      CellList cells = system.storage->getRealCells();
+      CellList& cells = system.storage->getRealCells();
 
-      for(CellListIterator cit(cells); !cit.isDone(); ++cit) {
+      nextNoiseCall();
 
-        if((!has_excl || exclusions.count(cit->id()) == 0) && (!has_types || valid_type_ids.count(cit->type())))
-        {
-          frictionThermo(*cit);
-        }
+      if (!counterRNG) {
+        for(CellListIterator cit(cells); !cit.isDone(); ++cit) {
+
+          if((!has_excl || exclusions.count(cit->id()) == 0) && (!has_types || valid_type_ids.count(cit->type())))
+          {
+            frictionThermo(*cit);
+          }
 
+        }
+        return;
       }
+
+      // the noise does not depend on the order of the particles, so the
+      // cells are thermalized concurrently; the noise of a cell is
+      // generated in chunks on the stack of the thread
+      const long long step = integrator->getStep();
+      const esutil::CounterRNG::uint32 stream = esutil::CounterRNG::LANGEVIN | recalc;
+      system.storage->getCellTasks().forEachCell(cells, [&](Cell& cell, long) {
+        const size_t chunk = 64;
+        longint ids[chunk];
+        real noise[4 * chunk];
+        ParticleList& particles = cell.particles;
+        for (size_t start = 0; start < particles.size(); start += chunk) {
+          size_t n = std::min(chunk, particles.size() - start);
+          for (size_t i = 0; i < n; ++i) ids[i] = particles[start + i].id();
+          crng.uniform(stream, step, ids, noiseCall, n, noise);
+
+          for (size_t i = 0; i < n; ++i) {
+            Particle& p = particles[start + i];
+            if((!has_excl || exclusions.count(p.id()) == 0) && (!has_types || valid_type_ids.count(p.type())))
+            {
+              const real *r = &noise[4 * i];
+              frictionThermo(p, Real3D(r[0] - 0.5, r[1] - 0.5, r[2] - 0.5));
+            }
+          }
+        }
+      });
     }
 
     // for AdResS
@@ -152,6 +188,8 @@ namespace espressopp {
 
       System& system = getSystemRef();
 
+      nextNoiseCall();
+
       // thermalize AT particles
       ParticleList& adrATparticles = system.storage->getAdrATParticles();
       for (std::vector<Particle>::iterator it = adrATparticles.begin();
@@ -167,11 +205,33 @@ namespace espressopp {
 
     void LangevinThermostat::frictionThermo(Particle& p)
     {
-      real massf = sqrt(p.mass());
-
       // get a random value for each vector component
 
-      Real3D ranval((*rng)() - 0.5, (*rng)() - 0.5, (*rng)() - 0.5);
+      if (counterRNG) {
+        real r[4];
+        crng.uniform4(esutil::CounterRNG::LANGEVIN | recalc, integrator->getStep(), p.id(), noiseCall, r);
+        frictionThermo(p, Real3D(r[0] - 0.5, r[1] - 0.5, r[2] - 0.5));
+      } else {
+        frictionThermo(p, Real3D((*rng)() - 0.5, (*rng)() - 0.5, (*rng)() - 0.5));
+      }
+    }
+
+    void LangevinThermostat::nextNoiseCall()
+    {
+      // e.g. run(0) before run(n) computes the forces of the same step
+      // twice; the second call must not repeat the noise of the first
+      long long step = integrator->getStep();
+      if (step != noiseStep) {
+        noiseStep = step;
+        noiseCall = 0;
+      } else {
+        ++noiseCall;
+      }
+    }
+
+    void LangevinThermostat::frictionThermo(Particle& p, const Real3D& ranval)
+    {
+      real massf = sqrt(p.mass());
 
       p.force() += pref1 * p.velocity() * p.mass() +
                    pref2 * ranval * massf;
@@ -185,6 +245,7 @@ namespace espressopp {
         real timestep = integrator->getTimeStep();
       pref1 = -gamma;
       pref2 = sqrt(24.0 * temperature * gamma / timestep);
+      crng.seed(rng->get_seed());
 
 
       LOG4ESPP_INFO(theLogger, "init, timestep = " << timestep <<
@@ -207,6 +268,8 @@ namespace espressopp {
 
       pref2buffer = pref2;
       pref2       *= sqrt(3.0);
+      // the force of this step is computed again, with other noise
+      recalc = esutil::CounterRNG::RECALC;
     }
 
     /** Opposite to heatUp */
@@ -216,6 +279,7 @@ namespace espressopp {
       LOG4ESPP_INFO(theLogger, "coolDown");
 
       pref2 = pref2buffer;
+      recalc = 0;
     }
 
     /** Add valid type id. */
@@ -249,6 +313,7 @@ namespace espressopp {
         .def("addExclpid", &LangevinThermostat::addExclpid)
         .def("removeExclpid", &LangevinThermostat::removeExclpid)
         .add_property("adress", &LangevinThermostat::getAdress, &LangevinThermostat::setAdress)
+        .add_property("counter_rng", &LangevinThermostat::getCounterRNG, &LangevinThermostat::setCounterRNG)
         .add_property("gamma", &LangevinThermostat::getGamma, &LangevinThermostat::setGamma)
         .add_property("temperature", &LangevinThermostat::getTemperature, &LangevinThermostat::setTemperature)
         ;
@@ -28,6 +28,7 @@
 #include "logging.hpp"
 #include "Particle.hpp"
 #include "SystemAccess.hpp"
+#include "esutil/CounterRNG.hpp"
 
 #include "Extension.hpp"
 #include "VelocityVerlet.hpp"
@@ -58,6 +59,12 @@ namespace espressopp {
         void setAdress(bool _adress);
         bool getAdress();
 
+        /** draw the noise from the counter based RNG keyed by the step, the
+            particle id and the number of the force computation within the
+            step instead of the sequential system RNG (default) */
+        void setCounterRNG(bool _counterRNG) { counterRNG = _counterRNG; }
+        bool getCounterRNG() { return counterRNG; }
+
         void initialize();
 
         /** update of forces to thermalize the system */
@@ -98,6 +105,9 @@ namespace espressopp {
         boost::signals2::connection _initialize_onSetTimeStep;
 
         void frictionThermo(class Particle&);
+        void frictionThermo(class Particle&, const Real3D& ranval);
+        // count the thermalizations within the current step
+        void nextNoiseCall();
 
         // this connects thermalizeAdr
         void enableAdress();
@@ -119,6 +129,13 @@ namespace espressopp {
 
         shared_ptr< esutil::RNG > rng;  //!< random number generator used for friction term
 
+        bool counterRNG;          //!< use crng instead of rng
+        esutil::CounterRNG crng;  //!< seeded with the seed of rng in initialize()
+        esutil::CounterRNG::uint32 recalc;  //!< RECALC between heatUp and coolDown, else 0
+        long long noiseStep;  //!< step of the last thermalization
+        longint noiseCall;    //!< number of the thermalization within noiseStep, second id of the counter
+
+
         /** Logger */
         static LOG4ESPP_DECL_LOGGER(theLogger);
 
@@ -36,6 +36,14 @@ Example:
 >>> # set temperature
 >>> langevin.adress = True
 >>> # set adress (default is False)
+>>> langevin.counter_rng = True
+>>> # noise from espressopp.esutil.CounterRNG, keyed by the step, the
+>>> # particle id and the number of the force computation within the step
+>>> # (e.g. run(0) followed by run(n) computes the forces of a step twice)
+>>> # and seeded with the seed of system.rng, so it is the same for any
+>>> # number of processes (default is False: the noise is drawn in
+>>> # sequence from system.rng). The noise is a function of integrator.step,
+>>> # so resetting the step replays it; reseed system.rng between such runs.
 >>> integrator.addExtension(langevin)
 >>> # add extensions to a previously defined integrator
 
@@ -85,6 +93,6 @@ if pmi.isController :
         __metaclass__ = pmi.Proxy
         pmiproxydefs = dict(
             cls =  'espressopp.integrator.LangevinThermostatLocal',
-            pmiproperty = [ 'gamma', 'temperature', 'adress' ],
+            pmiproperty = [ 'gamma', 'temperature', 'adress', 'counter_rng' ],
             pmicall = ['addExclusions', 'removeExclpid', 'add_valid_type_id', 'remove_valid_type_id', 'add_valid_types']
             )
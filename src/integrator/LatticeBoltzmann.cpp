@@ -78,6 +78,7 @@ namespace espressopp {
 
          /* setup default coupling parameters */
          setDoCoupling(false);                              // no LB to MD coupling
+         setVectorised(true);                               // collide rows of sites
          setNSteps(1);                                      // # MD steps between LB update
          setPrevDumpStep(0);                                // interval between dumping coupl-files
          setProfStep(10000);                                // set default time profiling step
@@ -237,6 +238,9 @@ namespace espressopp {
       void LatticeBoltzmann::setDoCoupling (bool _coupling) {coupling = _coupling;}
       bool LatticeBoltzmann::doCoupling () {return coupling;}
 
+      void LatticeBoltzmann::setVectorised (bool _vectorised) {vectorised = _vectorised;}
+      bool LatticeBoltzmann::getVectorised () {return vectorised;}
+
       void LatticeBoltzmann::setExtForceLoc (Int3D _Ni, Real3D _extForceLoc) {
          return (*lbfor)[_Ni[0]][_Ni[1]][_Ni[2]].setExtForceLoc(_extForceLoc);   }
       Real3D LatticeBoltzmann::getExtForceLoc (Int3D _Ni) {
@@ -264,12 +268,12 @@ namespace espressopp {
 
       /* Setter and getter for access to population values */
       void LatticeBoltzmann::setPops (Int3D _Ni, int _l, real _value) {
-         (*lbfluid)[_Ni[0]][_Ni[1]][_Ni[2]].setF_i(_l, _value);   }
+         lbfluid->setF_i(_Ni[0], _Ni[1], _Ni[2], _l, _value);   }
       real LatticeBoltzmann::getPops (Int3D _Ni, int _l) {
-         return (*lbfluid)[_Ni[0]][_Ni[1]][_Ni[2]].getF_i(_l);   }
+         return lbfluid->getF_i(_Ni[0], _Ni[1], _Ni[2], _l);   }
 
       void LatticeBoltzmann::setGhostFluid (Int3D _Ni, int _l, real _value) {
-         (*ghostlat)[_Ni[0]][_Ni[1]][_Ni[2]].setF_i(_l, _value);   }
+         ghostlat->setF_i(_Ni[0], _Ni[1], _Ni[2], _l, _value);   }
 
       void LatticeBoltzmann::setLBMom (Int3D _Ni, int _l, real _value) {
          (*lbmom)[_Ni[0]][_Ni[1]][_Ni[2]].setMom_i(_l, _value);   }
@@ -304,25 +308,21 @@ namespace espressopp {
       void LatticeBoltzmann::initLatticeSize() {
          Int3D _numSites = getMyNi();
 
+         /* populations are stored in flat lattices */
+         lbfluid = new LBLattice(_numSites, getNumVels());
+         ghostlat = new LBLattice(_numSites, getNumVels());
+
          /* stretch lattices resizing them in 3 dimensions */
-         lbfluid = new lblattice;
-         ghostlat = new lblattice;
          lbmom = new lbmoments;
          lbfor = new lbforces;
 
-         (*lbfluid).resize(_numSites[0]);
-         (*ghostlat).resize(_numSites[0]);
          (*lbmom).resize(_numSites[0]);
          (*lbfor).resize(_numSites[0]);
 
          for (int i = 0; i < _numSites[0]; i++) {
-            (*lbfluid)[i].resize(_numSites[1]);
-            (*ghostlat)[i].resize(_numSites[1]);
             (*lbmom)[i].resize(_numSites[1]);
             (*lbfor)[i].resize(_numSites[1]);
             for (int j = 0; j < _numSites[1]; j++) {
-               (*lbfluid)[i][j].resize(_numSites[2]);
-               (*ghostlat)[i][j].resize(_numSites[2]);
                (*lbmom)[i][j].resize(_numSites[2]);
                (*lbfor)[i][j].resize(_numSites[2]);
             }
@@ -423,16 +423,9 @@ namespace espressopp {
                setPhi(l, sqrt(mu / getInvB(l)));
             }
 
-            // set phi on every lattice site
-            Int3D _Ni = getMyNi();
-            for (int i = 0; i < _Ni[0]; i++) {
-               for (int j = 0; j < _Ni[1]; j++) {
-                  for (int k = 0; k < _Ni[2]; k++) {
-                     for (int l = 0; l < getNumVels(); l++) {
-                        (*lbfluid)[i][j][k].setPhiLoc(l,getPhi(l));
-                     }
-                  }
-               }
+            // set phi used on the lattice sites
+            for (int l = 0; l < getNumVels(); l++) {
+               LBSite::setPhiLoc(l,getPhi(l));
             }
 
             if (_myRank == 0) {
@@ -515,9 +508,6 @@ namespace espressopp {
 
       /* COLLIDE-STREAM STEP */
       void LatticeBoltzmann::collideStream () {
-         int _offset = getHaloSkin();
-         bool _extForce = doExtForce();
-         bool _fluct = doFluct();
          bool _coupling = doCoupling();
          Int3D _myNi = getMyNi();
 
@@ -526,19 +516,22 @@ namespace espressopp {
             copyForcesFromHalo();
          }
 
-         // collision-streaming //
-         real timer = colstream.getElapsedTime();
-         for (int i = _offset; i < _myNi[0]-_offset; i++) {
-            for (int j = _offset; j < _myNi[1]-_offset; j++) {
-               for (int k = _offset; k < _myNi[2]-_offset; k++) {
-                  Real3D _f = (*lbfor)[i][j][k].getExtForceLoc()
-                            + (*lbfor)[i][j][k].getCouplForceLoc();
+         // offsets of the target sites of the populations in the flat lattice //
+         int _numVels = getNumVels();
+         long _shift[LBSite::maxVels];
+         for (int l = 0; l < _numVels; l++) {
+            Real3D _c = getCi(l);
+            _shift[l] = lbfluid->siteIdx((int)_c[0], (int)_c[1], (int)_c[2])
+                      - lbfluid->siteIdx(0, 0, 0);
+         }
 
-                  (*lbfluid)[i][j][k].collision(_fluct, _extForce,
-                                                _coupling, _f, gamma);
-                  streaming (i,j,k);
-               }
-            }
+         // fused collision-streaming: every site is read once from lbfluid,
+         // collided and pushed to its neighbours in ghostlat //
+         real timer = colstream.getElapsedTime();
+         if (vectorised) {
+            collideStreamRows(_shift);
+         } else {
+            collideStreamSites(_shift);
          }
          time_colstr += ( colstream.getElapsedTime() - timer );
 
@@ -549,7 +542,7 @@ namespace espressopp {
 
          /* swapping of the pointers to the lattices */
          timer = swapping.getElapsedTime();
-         lblattice *tmp = lbfluid;
+         LBLattice *tmp = lbfluid;
          lbfluid = ghostlat;
          ghostlat = tmp;
          time_sw += ( swapping.getElapsedTime() - timer );
@@ -574,39 +567,84 @@ namespace espressopp {
 
 /*******************************************************************************************/
 
-      /* STREAMING ALONG THE VELOCITY VECTORS. SERIAL */
-      // periodic boundaries are handled separately in commHalo() //
-      void LatticeBoltzmann::streaming(int _i, int _j, int _k) {
-
-         // assign iterations
-         int _ip = _i + 1; int _im = _i - 1;
-         int _jp = _j + 1; int _jm = _j - 1;
-         int _kp = _k + 1; int _km = _k - 1;
-
-         // do not move the staying populations
-         (*ghostlat)[_i][_j][_k].setF_i(0,(*lbfluid)[_i][_j][_k].getF_i(0));
-
-         // move populations to the nearest neighbors
-         (*ghostlat)[_ip][_j][_k].setF_i(1,(*lbfluid)[_i][_j][_k].getF_i(1));
-         (*ghostlat)[_im][_j][_k].setF_i(2,(*lbfluid)[_i][_j][_k].getF_i(2));
-         (*ghostlat)[_i][_jp][_k].setF_i(3,(*lbfluid)[_i][_j][_k].getF_i(3));
-         (*ghostlat)[_i][_jm][_k].setF_i(4,(*lbfluid)[_i][_j][_k].getF_i(4));
-         (*ghostlat)[_i][_j][_kp].setF_i(5,(*lbfluid)[_i][_j][_k].getF_i(5));
-         (*ghostlat)[_i][_j][_km].setF_i(6,(*lbfluid)[_i][_j][_k].getF_i(6));
-
-         // move populations to the next-to-the-nearest neighbors
-         (*ghostlat)[_ip][_jp][_k].setF_i(7,(*lbfluid)[_i][_j][_k].getF_i(7));
-         (*ghostlat)[_im][_jm][_k].setF_i(8,(*lbfluid)[_i][_j][_k].getF_i(8));
-         (*ghostlat)[_ip][_jm][_k].setF_i(9,(*lbfluid)[_i][_j][_k].getF_i(9));
-         (*ghostlat)[_im][_jp][_k].setF_i(10,(*lbfluid)[_i][_j][_k].getF_i(10));
-         (*ghostlat)[_ip][_j][_kp].setF_i(11,(*lbfluid)[_i][_j][_k].getF_i(11));
-         (*ghostlat)[_im][_j][_km].setF_i(12,(*lbfluid)[_i][_j][_k].getF_i(12));
-         (*ghostlat)[_ip][_j][_km].setF_i(13,(*lbfluid)[_i][_j][_k].getF_i(13));
-         (*ghostlat)[_im][_j][_kp].setF_i(14,(*lbfluid)[_i][_j][_k].getF_i(14));
-         (*ghostlat)[_i][_jp][_kp].setF_i(15,(*lbfluid)[_i][_j][_k].getF_i(15));
-         (*ghostlat)[_i][_jm][_km].setF_i(16,(*lbfluid)[_i][_j][_k].getF_i(16));
-         (*ghostlat)[_i][_jp][_km].setF_i(17,(*lbfluid)[_i][_j][_k].getF_i(17));
-         (*ghostlat)[_i][_jm][_kp].setF_i(18,(*lbfluid)[_i][_j][_k].getF_i(18));
+      /* COLLIDE-STREAM OF ROWS OF SITES: the populations of up to LBRow::maxLen sites along z
+         are loaded with unit stride, collided together and pushed with unit stride */
+      void LatticeBoltzmann::collideStreamRows (const long *_shift) {
+         int _offset = getHaloSkin();
+         bool _extForce = doExtForce();
+         bool _fluct = doFluct();
+         Int3D _myNi = getMyNi();
+         int _numVels = getNumVels();
+
+         long _stride = lbfluid->getStride();
+         const real *_src = lbfluid->pop(0);
+         real *_dst = ghostlat->pop(0);
+         const int _kEnd = _myNi[2] - _offset;
+         LBRow _row;
+         for (int i = _offset; i < _myNi[0]-_offset; i++) {
+            for (int j = _offset; j < _myNi[1]-_offset; j++) {
+               for (int k0 = _offset; k0 < _kEnd; k0 += LBRow::maxLen) {
+                  const int _n = std::min(LBRow::maxLen, _kEnd - k0);
+                  const long _idx = lbfluid->siteIdx(i, j, k0);
+
+                  for (int s = 0; s < _n; s++) {
+                     Real3D _f = (*lbfor)[i][j][k0 + s].getExtForceLoc()
+                               + (*lbfor)[i][j][k0 + s].getCouplForceLoc();
+                     _row.fx[s] = _f[0];
+                     _row.fy[s] = _f[1];
+                     _row.fz[s] = _f[2];
+                  }
+
+                  for (int l = 0; l < _numVels; l++) {
+                     const real *_from = _src + l * _stride + _idx;
+                     for (int s = 0; s < _n; s++) _row.f[l][s] = _from[s];
+                  }
+
+                  _row.collision(_n, _fluct, _extForce, gamma);
+
+                  // periodic boundaries are handled separately in commHalo() //
+                  for (int l = 0; l < _numVels; l++) {
+                     real *_to = _dst + l * _stride + _idx + _shift[l];
+                     for (int s = 0; s < _n; s++) _to[s] = _row.f[l][s];
+                  }
+               }
+            }
+         }
+      }
+
+      /* COLLIDE-STREAM SITE BY SITE */
+      void LatticeBoltzmann::collideStreamSites (const long *_shift) {
+         int _offset = getHaloSkin();
+         bool _extForce = doExtForce();
+         bool _fluct = doFluct();
+         bool _coupling = doCoupling();
+         Int3D _myNi = getMyNi();
+         int _numVels = getNumVels();
+
+         long _stride = lbfluid->getStride();
+         const real *_src = lbfluid->pop(0);
+         real *_dst = ghostlat->pop(0);
+         LBSite _site;
+         for (int i = _offset; i < _myNi[0]-_offset; i++) {
+            for (int j = _offset; j < _myNi[1]-_offset; j++) {
+               long _idx = lbfluid->siteIdx(i, j, _offset);
+               for (int k = _offset; k < _myNi[2]-_offset; k++, _idx++) {
+                  Real3D _f = (*lbfor)[i][j][k].getExtForceLoc()
+                            + (*lbfor)[i][j][k].getCouplForceLoc();
+
+                  for (int l = 0; l < _numVels; l++) {
+                     _site.setF_i(l, _src[l * _stride + _idx]);
+                  }
+
+                  _site.collision(_fluct, _extForce, _coupling, _f, gamma);
+
+                  // periodic boundaries are handled separately in commHalo() //
+                  for (int l = 0; l < _numVels; l++) {
+                     _dst[l * _stride + _idx + _shift[l]] = _site.getF_i(l);
+                  }
+               }
+            }
+         }
       }
 
 /*******************************************************************************************/
@@ -735,8 +773,8 @@ namespace espressopp {
                   real denLoc = 0.;
                   Real3D jLoc = Real3D(0.);
                   for (int l = 0; l < _numVels; l++) {
-                     denLoc += (*lbfluid)[i][j][k].getF_i(l);
-                     jLoc += (*lbfluid)[i][j][k].getF_i(l)*getCi(l);
+                     denLoc += lbfluid->getF_i(i, j, k, l);
+                     jLoc += lbfluid->getF_i(i, j, k, l)*getCi(l);
                   }
                   (*lbmom)[i][j][k].setMom_i(0,denLoc);
                   (*lbmom)[i][j][k].setMom_i(1,jLoc[0]);
@@ -1270,11 +1308,11 @@ namespace espressopp {
          idx = 0;
          for (k=0; k<_myNi[2]; k++) {
             for (j=0; j<_myNi[1]; j++, idx += numPopTransf) {
-               bufToSend[idx] = (*ghostlat)[i][j][k].getF_i(1);
-               bufToSend[idx+1] = (*ghostlat)[i][j][k].getF_i(7);
-               bufToSend[idx+2] = (*ghostlat)[i][j][k].getF_i(9);
-               bufToSend[idx+3] = (*ghostlat)[i][j][k].getF_i(11);
-               bufToSend[idx+4] = (*ghostlat)[i][j][k].getF_i(13);
+               bufToSend[idx] = ghostlat->getF_i(i, j, k, 1);
+               bufToSend[idx+1] = ghostlat->getF_i(i, j, k, 7);
+               bufToSend[idx+2] = ghostlat->getF_i(i, j, k, 9);
+               bufToSend[idx+3] = ghostlat->getF_i(i, j, k, 11);
+               bufToSend[idx+4] = ghostlat->getF_i(i, j, k, 13);
             }
          }
 
@@ -1296,11 +1334,11 @@ namespace espressopp {
          idx = 0;
          for (k=0; k<_myNi[2]; k++) {
             for (j=0; j<_myNi[1]; j++, idx += numPopTransf) {
-               (*ghostlat)[i][j][k].setF_i(1, bufToRecv[idx]);
-               (*ghostlat)[i][j][k].setF_i(7, bufToRecv[idx+1]);
-               (*ghostlat)[i][j][k].setF_i(9, bufToRecv[idx+2]);
-               (*ghostlat)[i][j][k].setF_i(11, bufToRecv[idx+3]);
-               (*ghostlat)[i][j][k].setF_i(13, bufToRecv[idx+4]);
+               ghostlat->setF_i(i, j, k, 1, bufToRecv[idx]);
+               ghostlat->setF_i(i, j, k, 7, bufToRecv[idx+1]);
+               ghostlat->setF_i(i, j, k, 9, bufToRecv[idx+2]);
+               ghostlat->setF_i(i, j, k, 11, bufToRecv[idx+3]);
+               ghostlat->setF_i(i, j, k, 13, bufToRecv[idx+4]);
             }
          }
 
@@ -1313,11 +1351,11 @@ namespace espressopp {
          idx = 0;
          for (k=0; k<_myNi[2]; k++) {
             for (j=0; j<_myNi[1]; j++, idx += numPopTransf) {
-               bufToSend[idx] = (*ghostlat)[i][j][k].getF_i(2);
-               bufToSend[idx+1] = (*ghostlat)[i][j][k].getF_i(8);
-               bufToSend[idx+2] = (*ghostlat)[i][j][k].getF_i(10);
-               bufToSend[idx+3] = (*ghostlat)[i][j][k].getF_i(12);
-               bufToSend[idx+4] = (*ghostlat)[i][j][k].getF_i(14);
+               bufToSend[idx] = ghostlat->getF_i(i, j, k, 2);
+               bufToSend[idx+1] = ghostlat->getF_i(i, j, k, 8);
+               bufToSend[idx+2] = ghostlat->getF_i(i, j, k, 10);
+               bufToSend[idx+3] = ghostlat->getF_i(i, j, k, 12);
+               bufToSend[idx+4] = ghostlat->getF_i(i, j, k, 14);
             }
          }
 
@@ -1339,11 +1377,11 @@ namespace espressopp {
          idx = 0;
          for (k=0; k<_myNi[2]; k++) {
             for (j=0; j<_myNi[1]; j++, idx += numPopTransf) {
-               (*ghostlat)[i][j][k].setF_i(2, bufToRecv[idx]);
-               (*ghostlat)[i][j][k].setF_i(8, bufToRecv[idx+1]);
-               (*ghostlat)[i][j][k].setF_i(10, bufToRecv[idx+2]);
-               (*ghostlat)[i][j][k].setF_i(12, bufToRecv[idx+3]);
-               (*ghostlat)[i][j][k].setF_i(14, bufToRecv[idx+4]);
+               ghostlat->setF_i(i, j, k, 2, bufToRecv[idx]);
+               ghostlat->setF_i(i, j, k, 8, bufToRecv[idx+1]);
+               ghostlat->setF_i(i, j, k, 10, bufToRecv[idx+2]);
+               ghostlat->setF_i(i, j, k, 12, bufToRecv[idx+3]);
+               ghostlat->setF_i(i, j, k, 14, bufToRecv[idx+4]);
             }
          }
 
@@ -1363,11 +1401,11 @@ namespace espressopp {
          idx = 0;
          for (k=0; k<_myNi[2]; k++) {
             for (i=0; i<_myNi[0]; i++, idx += numPopTransf) {
-               bufToSend[idx] = (*ghostlat)[i][j][k].getF_i(3);
-               bufToSend[idx+1] = (*ghostlat)[i][j][k].getF_i(7);
-               bufToSend[idx+2] = (*ghostlat)[i][j][k].getF_i(10);
-               bufToSend[idx+3] = (*ghostlat)[i][j][k].getF_i(15);
-               bufToSend[idx+4] = (*ghostlat)[i][j][k].getF_i(17);
+               bufToSend[idx] = ghostlat->getF_i(i, j, k, 3);
+               bufToSend[idx+1] = ghostlat->getF_i(i, j, k, 7);
+               bufToSend[idx+2] = ghostlat->getF_i(i, j, k, 10);
+               bufToSend[idx+3] = ghostlat->getF_i(i, j, k, 15);
+               bufToSend[idx+4] = ghostlat->getF_i(i, j, k, 17);
             }
          }
 
@@ -1389,11 +1427,11 @@ namespace espressopp {
          idx = 0;
          for (k=0; k<_myNi[2]; k++) {
             for (i=0; i<_myNi[0]; i++, idx += numPopTransf) {
-               (*ghostlat)[i][j][k].setF_i(3, bufToRecv[idx]);
-               (*ghostlat)[i][j][k].setF_i(7, bufToRecv[idx+1]);
-               (*ghostlat)[i][j][k].setF_i(10, bufToRecv[idx+2]);
-               (*ghostlat)[i][j][k].setF_i(15, bufToRecv[idx+3]);
-               (*ghostlat)[i][j][k].setF_i(17, bufToRecv[idx+4]);
+               ghostlat->setF_i(i, j, k, 3, bufToRecv[idx]);
+               ghostlat->setF_i(i, j, k, 7, bufToRecv[idx+1]);
+               ghostlat->setF_i(i, j, k, 10, bufToRecv[idx+2]);
+               ghostlat->setF_i(i, j, k, 15, bufToRecv[idx+3]);
+               ghostlat->setF_i(i, j, k, 17, bufToRecv[idx+4]);
             }
          }
 
@@ -1406,11 +1444,11 @@ namespace espressopp {
          idx = 0;
          for (k=0; k<_myNi[2]; k++) {
             for (i=0; i<_myNi[0]; i++, idx += numPopTransf) {
-               bufToSend[idx] = (*ghostlat)[i][j][k].getF_i(4);
-               bufToSend[idx+1] = (*ghostlat)[i][j][k].getF_i(8);
-               bufToSend[idx+2] = (*ghostlat)[i][j][k].getF_i(9);
-               bufToSend[idx+3] = (*ghostlat)[i][j][k].getF_i(16);
-               bufToSend[idx+4] = (*ghostlat)[i][j][k].getF_i(18);
+               bufToSend[idx] = ghostlat->getF_i(i, j, k, 4);
+               bufToSend[idx+1] = ghostlat->getF_i(i, j, k, 8);
+               bufToSend[idx+2] = ghostlat->getF_i(i, j, k, 9);
+               bufToSend[idx+3] = ghostlat->getF_i(i, j, k, 16);
+               bufToSend[idx+4] = ghostlat->getF_i(i, j, k, 18);
             }
          }
 
@@ -1432,11 +1470,11 @@ namespace espressopp {
          idx = 0;
          for (k=0; k<_myNi[2]; k++) {
             for (i=0; i<_myNi[0]; i++, idx += numPopTransf) {
-               (*ghostlat)[i][j][k].setF_i(4, bufToRecv[idx]);
-               (*ghostlat)[i][j][k].setF_i(8, bufToRecv[idx+1]);
-               (*ghostlat)[i][j][k].setF_i(9, bufToRecv[idx+2]);
-               (*ghostlat)[i][j][k].setF_i(16, bufToRecv[idx+3]);
-               (*ghostlat)[i][j][k].setF_i(18, bufToRecv[idx+4]);
+               ghostlat->setF_i(i, j, k, 4, bufToRecv[idx]);
+               ghostlat->setF_i(i, j, k, 8, bufToRecv[idx+1]);
+               ghostlat->setF_i(i, j, k, 9, bufToRecv[idx+2]);
+               ghostlat->setF_i(i, j, k, 16, bufToRecv[idx+3]);
+               ghostlat->setF_i(i, j, k, 18, bufToRecv[idx+4]);
             }
          }
 
@@ -1456,11 +1494,11 @@ namespace espressopp {
          idx = 0;
          for (j=0; j<_myNi[1]; j++) {
             for (i=0; i<_myNi[0]; i++, idx += numPopTransf) {
-               bufToSend[idx] = (*ghostlat)[i][j][k].getF_i(5);
-               bufToSend[idx+1] = (*ghostlat)[i][j][k].getF_i(11);
-               bufToSend[idx+2] = (*ghostlat)[i][j][k].getF_i(14);
-               bufToSend[idx+3] = (*ghostlat)[i][j][k].getF_i(15);
-               bufToSend[idx+4] = (*ghostlat)[i][j][k].getF_i(18);
+               bufToSend[idx] = ghostlat->getF_i(i, j, k, 5);
+               bufToSend[idx+1] = ghostlat->getF_i(i, j, k, 11);
+               bufToSend[idx+2] = ghostlat->getF_i(i, j, k, 14);
+               bufToSend[idx+3] = ghostlat->getF_i(i, j, k, 15);
+               bufToSend[idx+4] = ghostlat->getF_i(i, j, k, 18);
             }
          }
 
@@ -1482,11 +1520,11 @@ namespace espressopp {
          idx = 0;
          for (j=0; j<_myNi[1]; j++) {
             for (i=0; i<_myNi[0]; i++, idx += numPopTransf) {
-               (*ghostlat)[i][j][k].setF_i(5, bufToRecv[idx]);
-               (*ghostlat)[i][j][k].setF_i(11, bufToRecv[idx+1]);
-               (*ghostlat)[i][j][k].setF_i(14, bufToRecv[idx+2]);
-               (*ghostlat)[i][j][k].setF_i(15, bufToRecv[idx+3]);
-               (*ghostlat)[i][j][k].setF_i(18, bufToRecv[idx+4]);
+               ghostlat->setF_i(i, j, k, 5, bufToRecv[idx]);
+               ghostlat->setF_i(i, j, k, 11, bufToRecv[idx+1]);
+               ghostlat->setF_i(i, j, k, 14, bufToRecv[idx+2]);
+               ghostlat->setF_i(i, j, k, 15, bufToRecv[idx+3]);
+               ghostlat->setF_i(i, j, k, 18, bufToRecv[idx+4]);
             }
          }
 
@@ -1499,11 +1537,11 @@ namespace espressopp {
          idx = 0;
          for (j=0; j<_myNi[1]; j++) {
             for (i=0; i<_myNi[0]; i++, idx += numPopTransf) {
-               bufToSend[idx] = (*ghostlat)[i][j][k].getF_i(6);
-               bufToSend[idx+1] = (*ghostlat)[i][j][k].getF_i(12);
-               bufToSend[idx+2] = (*ghostlat)[i][j][k].getF_i(13);
-               bufToSend[idx+3] = (*ghostlat)[i][j][k].getF_i(16);
-               bufToSend[idx+4] = (*ghostlat)[i][j][k].getF_i(17);
+               bufToSend[idx] = ghostlat->getF_i(i, j, k, 6);
+               bufToSend[idx+1] = ghostlat->getF_i(i, j, k, 12);
+               bufToSend[idx+2] = ghostlat->getF_i(i, j, k, 13);
+               bufToSend[idx+3] = ghostlat->getF_i(i, j, k, 16);
+               bufToSend[idx+4] = ghostlat->getF_i(i, j, k, 17);
             }
          }
 
@@ -1525,11 +1563,11 @@ namespace espressopp {
          idx = 0;
          for (j=0; j<_myNi[1]; j++) {
             for (i=0; i<_myNi[0]; i++, idx += numPopTransf) {
-               (*ghostlat)[i][j][k].setF_i(6, bufToRecv[idx]);
-               (*ghostlat)[i][j][k].setF_i(12, bufToRecv[idx+1]);
-               (*ghostlat)[i][j][k].setF_i(13, bufToRecv[idx+2]);
-               (*ghostlat)[i][j][k].setF_i(16, bufToRecv[idx+3]);
-               (*ghostlat)[i][j][k].setF_i(17, bufToRecv[idx+4]);
+               ghostlat->setF_i(i, j, k, 6, bufToRecv[idx]);
+               ghostlat->setF_i(i, j, k, 12, bufToRecv[idx+1]);
+               ghostlat->setF_i(i, j, k, 13, bufToRecv[idx+2]);
+               ghostlat->setF_i(i, j, k, 16, bufToRecv[idx+3]);
+               ghostlat->setF_i(i, j, k, 17, bufToRecv[idx+4]);
             }
          }
 
@@ -2124,6 +2162,8 @@ namespace espressopp {
          .add_property("nSteps", &LatticeBoltzmann::getNSteps, &LatticeBoltzmann::setNSteps)
          .add_property("profStep", &LatticeBoltzmann::getProfStep, &LatticeBoltzmann::setProfStep)
          .add_property("getMyNi", &LatticeBoltzmann::getMyNi)
+         .add_property("vectorised", &LatticeBoltzmann::getVectorised, &LatticeBoltzmann::setVectorised)
+         .def("getPops", &LatticeBoltzmann::getPops)
          .def("getLBMom", &LatticeBoltzmann::getLBMom)
          .def("setLBMom", &LatticeBoltzmann::setLBMom)
          .def("saveLBConf", &LatticeBoltzmann::saveLBConf)
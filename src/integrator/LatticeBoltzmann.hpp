@@ -32,7 +32,6 @@
 #include "Int3D.hpp"
 #include "LatticeSite.hpp"
 
-typedef std::vector< std::vector< std::vector<espressopp::integrator::LBSite> > > lblattice;
 typedef std::vector< std::vector< std::vector<espressopp::integrator::LBMom> > > lbmoments;
 typedef std::vector< std::vector< std::vector<espressopp::integrator::LBForce> > > lbforces;
 
@@ -148,6 +147,9 @@ namespace espressopp {
          void setDoCoupling (bool _coupling);      // coupling force' flag
          bool doCoupling ();
 
+         void setVectorised (bool _vectorised);    // collide rows of sites (LBRow)
+         bool getVectorised ();
+
          void setExtForceLoc (Int3D _Ni, Real3D _extForceLoc);
          Real3D getExtForceLoc (Int3D _Ni);
          void addExtForceLoc (Int3D _Ni, Real3D _extForceLoc);
@@ -224,9 +226,9 @@ namespace espressopp {
          void calcDenMom ();
          real convMDtoLB (int _opCode);
 
-         void collideStream ();                    // use collide-stream scheme
-
-         void streaming (int _i, int _j, int _k); // streaming along velocities
+         void collideStream ();                    // fused collide-stream over the real sites
+         void collideStreamRows (const long *_shift);   // ... row by row (LBRow)
+         void collideStreamSites (const long *_shift);  // ... site by site (LBSite)
 
          /* MPI FUNCTIONS */
          void findMyNeighbours ();
@@ -275,13 +277,14 @@ namespace espressopp {
          bool extForce;                         // flag for an external force
 
          // LATTICES
-         lblattice *lbfluid;
-         lblattice *ghostlat;
+         LBLattice *lbfluid;
+         LBLattice *ghostlat;
          lbmoments *lbmom;
          lbforces *lbfor;
 
          // COUPLING
          bool coupling;                         // flag for a coupling force
+         bool vectorised;                       // collide rows of sites instead of single sites
          int nSteps;                            // # of MD steps between LB update
          int totNPart;                          // total number of MD particles
          real fricCoeff;                        // friction in LB-MD coupling (LJ-units)
@@ -96,6 +96,13 @@ LB/MD simulations. It is implemented as :py:class:`espressopp.integrator.Extensi
         :param int moment: hydrodynamic moment to set
         :param real value: value to set
     
+    .. py:method:: getPops(node, i)
+
+        Get the population of a specific node
+
+        :param Int3D node: node index
+        :param int i: index of the velocity vector
+
     .. py:method:: saveLBConf()
     
         Dumps LB configuration with separate files for coupling forces, \
@@ -234,6 +241,13 @@ LB/MD simulations. It is implemented as :py:class:`espressopp.integrator.Extensi
         >>> # set profiling frequency
         >>> lb.profStep = 5000
     
+    .. py:data:: bool vectorised
+
+        If True (default), the collision works on rows of lattice sites
+        along *z* with the moments stored per row, so that the compiler
+        vectorises the loops over the sites. False collides site by site.
+        Both give the same populations.
+
     .. py:data:: Int3D getMyNi
             
         Number of real and halo nodes for the CPU
@@ -259,7 +273,7 @@ if pmi.isController :
         __metaclass__ = pmi.Proxy
         pmiproxydefs = dict(
                             cls = 'espressopp.integrator.LatticeBoltzmannLocal',
-                            pmiproperty = ['nodeGrid', 'a', 'tau', 'numDims', 'numVels', 'visc_b', 'visc_s', 'gamma_b', 'gamma_s', 'gamma_odd', 'gamma_even', 'lbTemp', 'fricCoeff', 'nSteps', 'profStep', 'getMyNi'],
-                            pmicall = ["getLBMom","setLBMom","saveLBConf","keepLBDump"]
+                            pmiproperty = ['nodeGrid', 'a', 'tau', 'numDims', 'numVels', 'visc_b', 'visc_s', 'gamma_b', 'gamma_s', 'gamma_odd', 'gamma_even', 'lbTemp', 'fricCoeff', 'nSteps', 'profStep', 'getMyNi', 'vectorised'],
+                            pmicall = ["getLBMom","setLBMom","getPops","saveLBConf","keepLBDump"]
                             )
 
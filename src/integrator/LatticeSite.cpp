@@ -34,24 +34,30 @@ namespace espressopp {
 
   using namespace iterator;
   namespace integrator {
+    LBLattice::LBLattice (Int3D _Ni, int _numVels)
+      : Ni(_Ni), numVels(_numVels) {
+            // pad every population array to a whole number of cache lines
+            const long perLine = 64 / sizeof(real);
+            long numSites = (long)Ni[0] * Ni[1] * Ni[2];
+            stride = (numSites + perLine - 1) / perLine * perLine;
+            f = PopArray(numVels * stride, 0.);
+    }
+
+    LBLattice::~LBLattice() {
+    }
+
+/*******************************************************************************************/
+
     LBSite::LBSite () {
-            f   = std::vector<real>(LatticePar::getNumVelsLoc(), 0.);
+            for (int i = 0; i < maxVels; i++) f[i] = 0.;
     }
 
 /*******************************************************************************************/
 
         /* SET AND GET PART */
-    void LBSite::setF_i (int _i, real _f) { f[_i] = _f;}
-    real LBSite::getF_i (int _i) { return f[_i];}
-
     void LBSite::setPhiLoc (int _i, real _phi) { phiLoc[_i] = _phi;}
     real LBSite::getPhiLoc (int _i) { return phiLoc[_i];}
 
-/*******************************************************************************************/
-
-    /* HELPFUL OPERATIONS WITH POPULATIONS AND MOMENTS */
-    void LBSite::scaleF_i (int _i, real _value) { f[_i] *= _value;}
-
 /*******************************************************************************************/
 
     /* MANAGING STATIC VARIABLES */
@@ -85,16 +91,16 @@ namespace espressopp {
             f11p12, f11m12, f13p14, f13m14, f15p16, f15m16, f17p18, f17m18;
 
             /* shorthand functions for "simplified" notation */
-            f0     =  getF_i(0);
-            f1p2   =  getF_i(1) +  getF_i(2);    f1m2 =  getF_i(1) -  getF_i(2);
-            f3p4   =  getF_i(3) +  getF_i(4);    f3m4 =  getF_i(3) -  getF_i(4);
-            f5p6   =  getF_i(5) +  getF_i(6);    f5m6 =  getF_i(5) -  getF_i(6);
-            f7p8   =  getF_i(7) +  getF_i(8);    f7m8 =  getF_i(7) -  getF_i(8);
-            f9p10  =  getF_i(9) + getF_i(10);   f9m10 =  getF_i(9) - getF_i(10);
-            f11p12 = getF_i(11) + getF_i(12);  f11m12 = getF_i(11) - getF_i(12);
-            f13p14 = getF_i(13) + getF_i(14);  f13m14 = getF_i(13) - getF_i(14);
-            f15p16 = getF_i(15) + getF_i(16);  f15m16 = getF_i(15) - getF_i(16);
-            f17p18 = getF_i(17) + getF_i(18);  f17m18 = getF_i(17) - getF_i(18);
+            f0     =  f[0];
+            f1p2   =  f[1] +  f[2];    f1m2 =  f[1] -  f[2];
+            f3p4   =  f[3] +  f[4];    f3m4 =  f[3] -  f[4];
+            f5p6   =  f[5] +  f[6];    f5m6 =  f[5] -  f[6];
+            f7p8   =  f[7] +  f[8];    f7m8 =  f[7] -  f[8];
+            f9p10  =  f[9] + f[10];   f9m10 =  f[9] - f[10];
+            f11p12 = f[11] + f[12];  f11m12 = f[11] - f[12];
+            f13p14 = f[13] + f[14];  f13m14 = f[13] - f[14];
+            f15p16 = f[15] + f[16];  f15m16 = f[15] - f[16];
+            f17p18 = f[17] + f[18];  f17m18 = f[17] - f[18];
 
             /* mass mode */
             m[0] = f0 + f1p2 + f3p4 + f5p6 + f7p8 + f9p10 + f11p12 + f13p14 + f15p16 + f17p18;
@@ -224,51 +230,49 @@ namespace espressopp {
 /*******************************************************************************************/
 
         void LBSite::btranMomToPop (real *m) {
-            int _numVelsLoc = LatticePar::getNumVelsLoc();
-
             // scale modes with inversed coefficients
-            for (int i = 0; i < _numVelsLoc; i++) {
+            for (int i = 0; i < maxVels; i++) {
                 m[i] *= LatticePar::getInvBLoc(i);
             }
 
-            setF_i(0,m[0] -m[4] +m[16]);
-            setF_i(1,m[0] +m[1] + 2.* (m[5] -m[10] -m[16] -m[17]));
-            setF_i(2,m[0] -m[1] + 2.* (m[5] +m[10] -m[16] -m[17]));
-            setF_i(3,m[0] +m[2] -m[5] +m[6] - 2.* (m[11] +m[16]) +m[17] -m[18]);
-            setF_i(4,m[0] -m[2] -m[5] +m[6] + 2.* (m[11] -m[16]) +m[17] -m[18]);
-            setF_i(5,m[0] +m[3] -m[5] -m[6] - 2.* (m[12] +m[16]) +m[17] +m[18]);
-            setF_i(6,m[0] -m[3] -m[5] -m[6] + 2.* (m[12] -m[16]) +m[17] +m[18]);
-
-            setF_i(7,m[0] +m[1] +m[2] +m[4] +m[5] +m[6] +m[7] +m[10] +m[11]
-                         +m[13] -m[14] +m[16] +m[17] +m[18]);
-            setF_i(8,m[0] -m[1] -m[2] +m[4] +m[5] +m[6] +m[7] -m[10] -m[11]
-                         -m[13] +m[14] +m[16] +m[17] +m[18]);
-            setF_i(9,m[0] +m[1] -m[2] +m[4] +m[5] +m[6] -m[7] +m[10] -m[11]
-                         +m[13] +m[14] +m[16] +m[17] +m[18]);
-            setF_i(10,m[0] -m[1] +m[2] +m[4] +m[5] +m[6] -m[7] -m[10] +m[11]
-                         -m[13] -m[14] +m[16] +m[17] +m[18]);
-
-            setF_i(11,m[0] +m[1] +m[3] +m[4] +m[5] -m[6] +m[8] +m[10] +m[12]
-                         -m[13] +m[15] +m[16] +m[17] -m[18]);
-            setF_i(12,m[0] -m[1] -m[3] +m[4] +m[5] -m[6] +m[8] -m[10] -m[12]
-                         +m[13] -m[15] +m[16] +m[17] -m[18]);
-            setF_i(13,m[0] +m[1] -m[3] +m[4] +m[5] -m[6] -m[8] +m[10] -m[12]
-                         -m[13] -m[15] +m[16] +m[17] -m[18]);
-            setF_i(14,m[0] -m[1] +m[3] +m[4] +m[5] -m[6] -m[8] -m[10] +m[12]
-                         +m[13] +m[15] +m[16] +m[17] -m[18]);
-
-            setF_i(15,m[0] +m[2] +m[3] +m[4] - 2.*m[5] +m[9] +m[11] +m[12]
-                         +m[14] -m[15] +m[16] - 2.*m[17]);
-            setF_i(16,m[0] -m[2] -m[3] +m[4] - 2.*m[5] +m[9] -m[11] -m[12]
-                         -m[14] +m[15] +m[16] - 2.*m[17]);
-            setF_i(17,m[0] +m[2] -m[3] +m[4] - 2.*m[5] -m[9] +m[11] -m[12]
-                         +m[14] +m[15] +m[16] - 2.*m[17]);
-            setF_i(18,m[0] -m[2] +m[3] +m[4] - 2.*m[5] -m[9] -m[11] +m[12]
-                         -m[14] -m[15] +m[16] - 2.*m[17]);
+            f[0] = m[0] -m[4] +m[16];
+            f[1] = m[0] +m[1] + 2.* (m[5] -m[10] -m[16] -m[17]);
+            f[2] = m[0] -m[1] + 2.* (m[5] +m[10] -m[16] -m[17]);
+            f[3] = m[0] +m[2] -m[5] +m[6] - 2.* (m[11] +m[16]) +m[17] -m[18];
+            f[4] = m[0] -m[2] -m[5] +m[6] + 2.* (m[11] -m[16]) +m[17] -m[18];
+            f[5] = m[0] +m[3] -m[5] -m[6] - 2.* (m[12] +m[16]) +m[17] +m[18];
+            f[6] = m[0] -m[3] -m[5] -m[6] + 2.* (m[12] -m[16]) +m[17] +m[18];
+
+            f[7] = m[0] +m[1] +m[2] +m[4] +m[5] +m[6] +m[7] +m[10] +m[11]
+                         +m[13] -m[14] +m[16] +m[17] +m[18];
+            f[8] = m[0] -m[1] -m[2] +m[4] +m[5] +m[6] +m[7] -m[10] -m[11]
+                         -m[13] +m[14] +m[16] +m[17] +m[18];
+            f[9] = m[0] +m[1] -m[2] +m[4] +m[5] +m[6] -m[7] +m[10] -m[11]
+                         +m[13] +m[14] +m[16] +m[17] +m[18];
+            f[10] = m[0] -m[1] +m[2] +m[4] +m[5] +m[6] -m[7] -m[10] +m[11]
+                         -m[13] -m[14] +m[16] +m[17] +m[18];
+
+            f[11] = m[0] +m[1] +m[3] +m[4] +m[5] -m[6] +m[8] +m[10] +m[12]
+                         -m[13] +m[15] +m[16] +m[17] -m[18];
+            f[12] = m[0] -m[1] -m[3] +m[4] +m[5] -m[6] +m[8] -m[10] -m[12]
+                         +m[13] -m[15] +m[16] +m[17] -m[18];
+            f[13] = m[0] +m[1] -m[3] +m[4] +m[5] -m[6] -m[8] +m[10] -m[12]
+                         -m[13] -m[15] +m[16] +m[17] -m[18];
+            f[14] = m[0] -m[1] +m[3] +m[4] +m[5] -m[6] -m[8] -m[10] +m[12]
+                         +m[13] +m[15] +m[16] +m[17] -m[18];
+
+            f[15] = m[0] +m[2] +m[3] +m[4] - 2.*m[5] +m[9] +m[11] +m[12]
+                         +m[14] -m[15] +m[16] - 2.*m[17];
+            f[16] = m[0] -m[2] -m[3] +m[4] - 2.*m[5] +m[9] -m[11] -m[12]
+                         -m[14] +m[15] +m[16] - 2.*m[17];
+            f[17] = m[0] +m[2] -m[3] +m[4] - 2.*m[5] -m[9] +m[11] -m[12]
+                         +m[14] +m[15] +m[16] - 2.*m[17];
+            f[18] = m[0] -m[2] +m[3] +m[4] - 2.*m[5] -m[9] -m[11] +m[12]
+                         -m[14] -m[15] +m[16] - 2.*m[17];
 
             /* scale populations with weights */
-            for (int i = 0; i < _numVelsLoc; i++) {
-                scaleF_i (i, LatticePar::getEqWeightLoc(i));
+            for (int i = 0; i < maxVels; i++) {
+                f[i] *= LatticePar::getEqWeightLoc(i);
             }
         }
 
@@ -277,6 +281,177 @@ namespace espressopp {
     LBSite::~LBSite() {
     }
 
+/*******************************************************************************************/
+
+        /* COLLISION OF A ROW OF SITES: same steps as LBSite::collision, site by site */
+        void LBRow::collision (int _n, bool _fluct, bool _extForce, std::vector<real> &_gamma) {
+            /* local moments, see calcLocalMoments() */
+            for (int s = 0; s < _n; s++) {
+                real f0 = f[0][s];
+                real f1p2   =  f[1][s] +  f[2][s],  f1m2   =  f[1][s] -  f[2][s];
+                real f3p4   =  f[3][s] +  f[4][s],  f3m4   =  f[3][s] -  f[4][s];
+                real f5p6   =  f[5][s] +  f[6][s],  f5m6   =  f[5][s] -  f[6][s];
+                real f7p8   =  f[7][s] +  f[8][s],  f7m8   =  f[7][s] -  f[8][s];
+                real f9p10  =  f[9][s] + f[10][s],  f9m10  =  f[9][s] - f[10][s];
+                real f11p12 = f[11][s] + f[12][s],  f11m12 = f[11][s] - f[12][s];
+                real f13p14 = f[13][s] + f[14][s],  f13m14 = f[13][s] - f[14][s];
+                real f15p16 = f[15][s] + f[16][s],  f15m16 = f[15][s] - f[16][s];
+                real f17p18 = f[17][s] + f[18][s],  f17m18 = f[17][s] - f[18][s];
+
+                m[0][s] = f0 + f1p2 + f3p4 + f5p6 + f7p8 + f9p10 + f11p12 + f13p14 + f15p16 + f17p18;
+
+                m[1][s] = f1m2 +   f7m8 +  f9m10 + f11m12 + f13m14;
+                m[2][s] = f3m4 +   f7m8 -  f9m10 + f15m16 + f17m18;
+                m[3][s] = f5m6 + f11m12 - f13m14 + f15m16 - f17m18;
+
+                m[4][s] = -f0 +   f7p8 + f9p10 + f11p12 + f13p14 + f15p16 + f17p18;
+                m[5][s] = 2.*f1p2 -   f3p4 -  f5p6 +   f7p8 +  f9p10 + f11p12 + f13p14 - 2.* (f15p16 + f17p18);
+                m[6][s] = f3p4 -   f5p6 +  f7p8 +  f9p10 - f11p12 - f13p14;
+                m[7][s] = f7p8 -  f9p10;
+                m[8][s] = f11p12 - f13p14;
+                m[9][s] = f15p16 - f17p18;
+
+                m[10][s] = -2.* f1m2 +   f7m8 +  f9m10 + f11m12 + f13m14;
+                m[11][s] = -2.* f3m4 +   f7m8 -  f9m10 + f15m16 + f17m18;
+                m[12][s] = -2.* f5m6 + f11m12 - f13m14 + f15m16 - f17m18;
+                m[13][s] = f7m8 +  f9m10 - f11m12 - f13m14;
+                m[14][s] = -f7m8 +  f9m10 + f15m16 + f17m18;
+                m[15][s] = f11m12 - f13m14 - f15m16 + f17m18;
+                m[16][s] = f0 - 2.* (f1p2 + f3p4 + f5p6) +   f7p8 +  f9p10
+                + f11p12 + f13p14 + f15p16 + f17p18;
+                m[17][s] = -2.* f1p2 +   f3p4 +   f5p6 +   f7p8 +  f9p10 + f11p12
+                + f13p14 -    2.* (f15p16 + f17p18);
+                m[18][s] = -f3p4 +   f5p6 +   f7p8 +  f9p10 - f11p12 - f13p14;
+            }
+
+            /* relaxation to the equilibrium moments, see relaxMoments() */
+            const real _aLoc = LatticePar::getALoc();
+            const real _invTauLoc = 1. / LatticePar::getTauLoc();
+            const real _g0 = _gamma[0], _g1 = _gamma[1], _g2 = _gamma[2], _g3 = _gamma[3];
+            // no branch in the loop: without forces half the force is 0.
+            const real _half = _extForce ? 0.5 : 0.;
+            for (int s = 0; s < _n; s++) {
+                real j0 = m[1][s] * _aLoc * _invTauLoc + _half * fx[s];
+                real j1 = m[2][s] * _aLoc * _invTauLoc + _half * fy[s];
+                real j2 = m[3][s] * _aLoc * _invTauLoc + _half * fz[s];
+
+                real _invRhoLoc = 1. / m[0][s];
+                real jsqr = j0*j0 + j1*j1 + j2*j2;
+                real pi0 = jsqr*_invRhoLoc;
+                real pi1 = (j0*j0 - j1*j1)*_invRhoLoc;
+                real pi2 = (3.*j0*j0 - jsqr)*_invRhoLoc;
+                real pi3 = j0*j1*_invRhoLoc;
+                real pi4 = j0*j2*_invRhoLoc;
+                real pi5 = j1*j2*_invRhoLoc;
+
+                m[4][s] = pi0 + _g0 * (m[4][s] - pi0);
+
+                m[5][s] = pi1 + _g1 * (m[5][s] - pi1);
+                m[6][s] = pi2 + _g1 * (m[6][s] - pi2);
+                m[7][s] = pi3 + _g1 * (m[7][s] - pi3);
+                m[8][s] = pi4 + _g1 * (m[8][s] - pi4);
+                m[9][s] = pi5 + _g1 * (m[9][s] - pi5);
+
+                m[10][s] *= _g2; m[11][s] *= _g2; m[12][s] *= _g2;
+                m[13][s] *= _g2; m[14][s] *= _g2; m[15][s] *= _g2;
+
+                m[16][s] *= _g3; m[17][s] *= _g3; m[18][s] *= _g3;
+            }
+
+            /* thermal fluctuations, see thermalFluct(); serial to keep the order of the
+               random numbers */
+            if (_fluct) {
+                int _numVelsLoc = LatticePar::getNumVelsLoc();
+                for (int s = 0; s < _n; s++) {
+                    real rootRhoLoc = sqrt(12.*m[0][s]);
+                    for (int l = 4; l < _numVelsLoc; l++) {
+                        m[l][s] += rootRhoLoc*LBSite::getPhiLoc(l)*((*LatticePar::rng)() - 0.5);
+                    }
+                }
+            }
+
+            /* external and coupling forces, see applyForces() */
+            if (_extForce) {
+                const real _gamma_sp = _g1 + 1.;
+                const real _gamma_sph = 0.5 * _gamma_sp;
+                const real _third = (1./3.)*(_g0 - _g1);
+                for (int s = 0; s < _n; s++) {
+                    real _invRho = 1.0 / m[0][s];
+                    real u0 = (0.5 * fx[s] + m[1][s]) * _invRho;
+                    real u1 = (0.5 * fy[s] + m[2][s]) * _invRho;
+                    real u2 = (0.5 * fz[s] + m[3][s]) * _invRho;
+
+                    m[1][s] += fx[s];
+                    m[2][s] += fy[s];
+                    m[3][s] += fz[s];
+
+                    real _secTerm = _third*(u0*fx[s] + u1*fy[s] + u2*fz[s]);
+                    real _sigma0 = _gamma_sp*u0*fx[s] + _secTerm;
+                    real _sigma1 = _gamma_sp*u1*fy[s] + _secTerm;
+                    real _sigma2 = _gamma_sp*u2*fz[s] + _secTerm;
+                    real _sigma3 = _gamma_sph*(u0*fy[s]+u1*fx[s]);
+                    real _sigma4 = _gamma_sph*(u0*fz[s]+u2*fx[s]);
+                    real _sigma5 = _gamma_sph*(u1*fz[s]+u2*fy[s]);
+
+                    m[4][s] += _sigma0+_sigma1+_sigma2;
+                    m[5][s] += 2.*_sigma0-_sigma1-_sigma2;
+                    m[6][s] += _sigma1-_sigma2;
+                    m[7][s] += _sigma3;
+                    m[8][s] += _sigma4;
+                    m[9][s] += _sigma5;
+                }
+            }
+
+            /* back-transformation, see btranMomToPop() */
+            real _invB[LBSite::maxVels], _w[LBSite::maxVels];
+            for (int i = 0; i < LBSite::maxVels; i++) {
+                _invB[i] = LatticePar::getInvBLoc(i);
+                _w[i] = LatticePar::getEqWeightLoc(i);
+            }
+            for (int i = 0; i < LBSite::maxVels; i++) {
+                for (int s = 0; s < _n; s++) m[i][s] *= _invB[i];
+            }
+            for (int s = 0; s < _n; s++) {
+                f[0][s] = m[0][s] -m[4][s] +m[16][s];
+                f[1][s] = m[0][s] +m[1][s] + 2.* (m[5][s] -m[10][s] -m[16][s] -m[17][s]);
+                f[2][s] = m[0][s] -m[1][s] + 2.* (m[5][s] +m[10][s] -m[16][s] -m[17][s]);
+                f[3][s] = m[0][s] +m[2][s] -m[5][s] +m[6][s] - 2.* (m[11][s] +m[16][s]) +m[17][s] -m[18][s];
+                f[4][s] = m[0][s] -m[2][s] -m[5][s] +m[6][s] + 2.* (m[11][s] -m[16][s]) +m[17][s] -m[18][s];
+                f[5][s] = m[0][s] +m[3][s] -m[5][s] -m[6][s] - 2.* (m[12][s] +m[16][s]) +m[17][s] +m[18][s];
+                f[6][s] = m[0][s] -m[3][s] -m[5][s] -m[6][s] + 2.* (m[12][s] -m[16][s]) +m[17][s] +m[18][s];
+
+                f[7][s] = m[0][s] +m[1][s] +m[2][s] +m[4][s] +m[5][s] +m[6][s] +m[7][s] +m[10][s] +m[11][s]
+                             +m[13][s] -m[14][s] +m[16][s] +m[17][s] +m[18][s];
+                f[8][s] = m[0][s] -m[1][s] -m[2][s] +m[4][s] +m[5][s] +m[6][s] +m[7][s] -m[10][s] -m[11][s]
+                             -m[13][s] +m[14][s] +m[16][s] +m[17][s] +m[18][s];
+                f[9][s] = m[0][s] +m[1][s] -m[2][s] +m[4][s] +m[5][s] +m[6][s] -m[7][s] +m[10][s] -m[11][s]
+                             +m[13][s] +m[14][s] +m[16][s] +m[17][s] +m[18][s];
+                f[10][s] = m[0][s] -m[1][s] +m[2][s] +m[4][s] +m[5][s] +m[6][s] -m[7][s] -m[10][s] +m[11][s]
+                             -m[13][s] -m[14][s] +m[16][s] +m[17][s] +m[18][s];
+
+                f[11][s] = m[0][s] +m[1][s] +m[3][s] +m[4][s] +m[5][s] -m[6][s] +m[8][s] +m[10][s] +m[12][s]
+                             -m[13][s] +m[15][s] +m[16][s] +m[17][s] -m[18][s];
+                f[12][s] = m[0][s] -m[1][s] -m[3][s] +m[4][s] +m[5][s] -m[6][s] +m[8][s] -m[10][s] -m[12][s]
+                             +m[13][s] -m[15][s] +m[16][s] +m[17][s] -m[18][s];
+                f[13][s] = m[0][s] +m[1][s] -m[3][s] +m[4][s] +m[5][s] -m[6][s] -m[8][s] +m[10][s] -m[12][s]
+                             -m[13][s] -m[15][s] +m[16][s] +m[17][s] -m[18][s];
+                f[14][s] = m[0][s] -m[1][s] +m[3][s] +m[4][s] +m[5][s] -m[6][s] -m[8][s] -m[10][s] +m[12][s]
+                             +m[13][s] +m[15][s] +m[16][s] +m[17][s] -m[18][s];
+
+                f[15][s] = m[0][s] +m[2][s] +m[3][s] +m[4][s] - 2.*m[5][s] +m[9][s] +m[11][s] +m[12][s]
+                             +m[14][s] -m[15][s] +m[16][s] - 2.*m[17][s];
+                f[16][s] = m[0][s] -m[2][s] -m[3][s] +m[4][s] - 2.*m[5][s] +m[9][s] -m[11][s] -m[12][s]
+                             -m[14][s] +m[15][s] +m[16][s] - 2.*m[17][s];
+                f[17][s] = m[0][s] +m[2][s] -m[3][s] +m[4][s] - 2.*m[5][s] -m[9][s] +m[11][s] -m[12][s]
+                             +m[14][s] +m[15][s] +m[16][s] - 2.*m[17][s];
+                f[18][s] = m[0][s] -m[2][s] +m[3][s] +m[4][s] - 2.*m[5][s] -m[9][s] -m[11][s] +m[12][s]
+                             -m[14][s] -m[15][s] +m[16][s] - 2.*m[17][s];
+            }
+            for (int i = 0; i < LBSite::maxVels; i++) {
+                for (int s = 0; s < _n; s++) f[i][s] *= _w[i];
+            }
+        }
+
 /*******************************************************************************************/
 
     LBMom::LBMom () {
@@ -25,33 +25,83 @@
 #define _INTEGRATOR_LATTICEMODEL_HPP
 
 #include "Real3D.hpp"
+#include "Int3D.hpp"
+#include "esutil/AlignedAllocator.hpp"
 
 namespace espressopp {
    namespace integrator {
+      class LBLattice {
+         /**
+          * \brief Description of the properties of the LBLattice class
+          *
+          * This is a LBLattice class for storing of the populations of all sites of a (local)
+          * lattice, including its halo. All populations live in one contiguous buffer in
+          * population-major order: population l of all sites forms one array, the sites being
+          * ordered as k + Ni[2] * (j + Ni[1] * i). Every population array starts on a cache line.
+          *
+          * The normal lattice and its ghost counterpart are LBLattices. They are defined in
+          * LatticeBoltzmann.*pp files.
+          */
+      public:
+         typedef std::vector< real, esutil::AlignedAllocator< real > > PopArray;
+
+         LBLattice (Int3D _Ni, int _numVels);
+         ~LBLattice ();
+
+         Int3D getNi () const { return Ni;}								// size incl. halo
+         int getNumVels () const { return numVels;}					// number of populations
+         long getStride () const { return stride;}					// distance between populations
+
+         long siteIdx (int _i, int _j, int _k) const {				// index of site (i,j,k)
+            return ((long)_i * Ni[1] + _j) * Ni[2] + _k;
+         }
+
+         void setF_i (int _i, int _j, int _k, int _l, real _f) {	// set f_l on site (i,j,k)
+            f[_l * stride + siteIdx(_i, _j, _k)] = _f;
+         }
+         real getF_i (int _i, int _j, int _k, int _l) const {		// get f_l on site (i,j,k)
+            return f[_l * stride + siteIdx(_i, _j, _k)];
+         }
+
+         real *pop (int _l) { return &f[_l * stride];}				// array of population l
+         const real *pop (int _l) const { return &f[_l * stride];}
+
+      private:
+         Int3D Ni;
+         int numVels;
+         long stride;
+         PopArray f;
+      };
+
+      /*******************************************************************************************/
+
       class LBSite {
          /**
           * \brief Description of the properties of the LBSite class
           *
-          * This is a LBSite class for storing of the populations, ext and coupling forces on the lattice site. Through its methods this class handles everything that happens on the node during collision. It also sets the values to the D3Q19 model-related parameters on EVERY lattice site.
-          *
-          * The normal lattice and its ghost counterpart are based on this LBSite class. They are defined in LatticeBoltzmann.*pp files.
+          * This is a LBSite class holding the populations of a single lattice site while it is
+          * processed. Through its methods this class handles everything that happens on the node
+          * during collision. The populations themselves are stored in an LBLattice; the
+          * collide-stream kernel loads them into an LBSite, collides and writes them back.
           *
           * Please note that by default ESPResSo++ supports only D3Q19 lattice model.
           * However, you can code other lattice models, it should not be difficult.
           */
       public:
+         static const int maxVels = 19;									// D3Q19
+
          LBSite ();
          ~LBSite ();
 
          /* SET AND GET DECLARATION */
-         void setF_i (int _i, real _f);									// set f_i population to _f
-         real getF_i (int _i);												// get f_i population
+         void setF_i (int _i, real _f) { f[_i] = _f;}				// set f_i population to _f
+         real getF_i (int _i) const { return f[_i];}				// get f_i population
 
-         void setPhiLoc (int _i, real _phi);							// set phi value to _phi
-         real getPhiLoc (int _i);											// get phi value
+         static void setPhiLoc (int _i, real _phi);				// set phi value to _phi
+         static real getPhiLoc (int _i);								// get phi value
 
          /* HELPFUL OPERATIONS WITH POPULATIONS AND MOMENTS */
-         void scaleF_i (int _i, real _value);                  // scale population i by _value
+         void scaleF_i (int _i, real _value) { f[_i] *= _value;}	// scale population i by _value
 
          /* FUNCTIONS DECLARATION */
          void collision (bool _fluct, bool _extForce,
@@ -72,12 +122,38 @@ namespace espressopp {
          void btranMomToPop (real *m);										// back-transform moms to pops
 
       private:
-         std::vector<real> f;														// populations on a site
+         real f[maxVels];													// populations on a site
          static std::vector<real> phiLoc;								// local fluct amplitudes
       };
 
       /*******************************************************************************************/
 
+      class LBRow {
+         /**
+          * \brief Description of the properties of the LBRow class
+          *
+          * This is a LBRow class holding the populations of up to maxLen consecutive sites of a
+          * row along z, one array per population. The collide-stream kernel loads a row from
+          * the LBLattice with unit stride, collides all of its sites together and writes them
+          * back. The loops over the sites of a row are independent, so the compiler vectorises
+          * them; the arithmetic per site is the same as in LBSite::collision and the random
+          * numbers for the fluctuations are drawn in the same order.
+          */
+      public:
+         static const int maxLen = 64;									// sites per row
+
+         void collision (int _n, bool _fluct, bool _extForce,
+                         std::vector<real> &_gamma);		  // collide the first _n sites
+
+         real f[LBSite::maxVels][maxLen];							// populations of the sites
+         real fx[maxLen], fy[maxLen], fz[maxLen];				// ext. and coupling forces
+
+      private:
+         real m[LBSite::maxVels][maxLen];							// moments of the sites
+      };
+
+      /*******************************************************************************************/
+
       class LBMom {
          /**
           * \brief Description of the properties of the LBMom class
@@ -0,0 +1,175 @@
+/*
+  Copyright (C) 2016
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "python.hpp"
+#include <algorithm>
+#include <functional>
+#include "LoadBalancer.hpp"
+#include "VelocityVerlet.hpp"
+#include "System.hpp"
+#include "storage/NodeGrid.hpp"
+
+namespace espressopp {
+  namespace integrator {
+
+    LOG4ESPP_LOGGER(LoadBalancer::theLogger, "LoadBalancer");
+
+    LoadBalancer::LoadBalancer(shared_ptr< System > _system, int _interval,
+                               real _threshold, real _damping)
+      : Extension(_system), interval(_interval), threshold(_threshold),
+        damping(_damping), lastForceTime(0.0), imbalance(1.0), nRebalances(0)
+    {
+      LOG4ESPP_INFO(theLogger, "LoadBalancer constructed");
+      domdec = dynamic_pointer_cast< storage::DomainDecomposition >(_system->storage);
+      if (!domdec) {
+        throw std::runtime_error("LoadBalancer needs a DomainDecomposition storage");
+      }
+      type = Extension::all;
+      // after the analysis of the step, which still sees the old domains
+      extensionOrder = Extension::atEnd;
+      resetTimers();
+    }
+
+    void LoadBalancer::disconnect() {
+      _aftIntV.disconnect();
+    }
+
+    void LoadBalancer::connect() {
+      shared_ptr< VelocityVerlet > vv = dynamic_pointer_cast< VelocityVerlet >(integrator);
+      lastForceTime = vv ? vv->getForceTime() : 0.0;
+      _aftIntV = integrator->aftIntV.connect(extensionOrder, boost::bind(&LoadBalancer::perform_action, this));
+    }
+
+    void LoadBalancer::perform_action() {
+      if (interval <= 0 || integrator->getStep() % interval != 0) return;
+      real time0 = wallTimer.getElapsedTime();
+      balance();
+      timeBalance += wallTimer.getElapsedTime() - time0;
+    }
+
+    real LoadBalancer::measureCost() {
+      shared_ptr< VelocityVerlet > vv = dynamic_pointer_cast< VelocityVerlet >(integrator);
+      if (vv) {
+        real t = vv->getForceTime();
+        // the timers may have been reset in between
+        real cost = t >= lastForceTime ? t - lastForceTime : t;
+        lastForceTime = t;
+        return cost;
+      }
+      return getSystemRef().storage->getNRealParticles();
+    }
+
+    void LoadBalancer::balance() {
+      System& system = getSystemRef();
+      mpi::communicator& comm = *system.comm;
+
+      real cost = measureCost();
+      real maxCost, sumCost;
+      mpi::all_reduce(comm, cost, maxCost, mpi::maximum< real >());
+      mpi::all_reduce(comm, cost, sumCost, std::plus< real >());
+      imbalance = sumCost > 0.0 ? maxCost * comm.size() / sumCost : 1.0;
+
+      LOG4ESPP_INFO(theLogger, "step " << integrator->getStep() << ": cost " << cost
+                    << ", imbalance " << imbalance);
+      if (imbalance <= threshold) return;
+
+      const storage::NodeGrid& nodeGrid = domdec->getNodeGrid();
+      real minSize = system.maxCutoff + system.getSkin();
+      std::vector< real > bounds[3];
+      bool changed = false;
+      for (int axis = 0; axis < 3; ++axis) {
+        int n = nodeGrid.getGridSize(axis);
+        bounds[axis] = nodeGrid.getNodeBoundaries(axis);
+        if (n == 1) continue;
+
+        // cost of each slab of nodes along this axis
+        std::vector< real > myCost(n, 0.0), slabCost(n);
+        myCost[nodeGrid.getNodePosition(axis)] = cost;
+        mpi::all_reduce(comm, &myCost[0], n, &slabCost[0], std::plus< real >());
+
+        // rank 0 decides, so all nodes get bitwise identical boundaries
+        bool axisChanged = false;
+        if (comm.rank() == 0) {
+          axisChanged = balanceAxis(bounds[axis], slabCost, minSize);
+        }
+        mpi::broadcast(comm, axisChanged, 0);
+        if (axisChanged) {
+          mpi::broadcast(comm, bounds[axis], 0);
+          changed = true;
+        }
+      }
+
+      if (changed) {
+        domdec->setNodeBoundaries(bounds[0], bounds[1], bounds[2]);
+        ++nRebalances;
+        LOG4ESPP_INFO(theLogger, "node boundaries moved, local box "
+                      << nodeGrid.getMyLeft() << " - " << nodeGrid.getMyRight());
+      }
+    }
+
+    bool LoadBalancer::balanceAxis(std::vector< real >& b, const std::vector< real >& slabCost,
+                                   real minSize) const {
+      const int n = slabCost.size();
+      if (b[n] - b[0] < n * minSize) return false;
+
+      std::vector< real > cum(n + 1, 0.0);
+      for (int i = 0; i < n; ++i) cum[i+1] = cum[i] + slabCost[i];
+      real total = cum[n];
+      if (total <= 0.0) return false;
+
+      // invert the piecewise linear cumulative cost at the equal shares
+      const std::vector< real > old(b);
+      int slab = 0;
+      for (int j = 1; j < n; ++j) {
+        real target = total * j / n;
+        while (slab < n - 1 && cum[slab+1] < target) ++slab;
+        real frac = slabCost[slab] > 0.0 ? (target - cum[slab]) / slabCost[slab] : 0.5;
+        frac = std::min(std::max(frac, 0.0), 1.0);
+        real x = old[slab] + frac * (old[slab+1] - old[slab]);
+        b[j] = old[j] + damping * (x - old[j]);
+      }
+
+      // keep every slab at least minSize wide
+      for (int j = 1; j < n; ++j) b[j] = std::max(b[j], b[j-1] + minSize);
+      for (int j = n - 1; j > 0; --j) b[j] = std::min(b[j], b[j+1] - minSize);
+
+      return b != old;
+    }
+
+    /****************************************************
+    ** REGISTRATION WITH PYTHON
+    ****************************************************/
+    void LoadBalancer::registerPython() {
+      using namespace espressopp::python;
+      class_< LoadBalancer, shared_ptr< LoadBalancer >, bases< Extension > >
+        ("integrator_LoadBalancer", init< shared_ptr< System >, int, real, real >())
+        .add_property("interval", &LoadBalancer::getInterval, &LoadBalancer::setInterval)
+        .add_property("threshold", &LoadBalancer::getThreshold, &LoadBalancer::setThreshold)
+        .add_property("damping", &LoadBalancer::getDamping, &LoadBalancer::setDamping)
+        .add_property("imbalance", &LoadBalancer::getImbalance)
+        .add_property("num_rebalances", &LoadBalancer::getNumRebalances)
+        .def("balance", &LoadBalancer::balance)
+        .def("connect", &LoadBalancer::connect)
+        .def("disconnect", &LoadBalancer::disconnect)
+        ;
+    }
+  }
+}
@@ -0,0 +1,114 @@
+/*
+  Copyright (C) 2016
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+// ESPP_CLASS
+#ifndef _INTEGRATOR_LOADBALANCER_HPP
+#define _INTEGRATOR_LOADBALANCER_HPP
+
+#include <vector>
+#include "types.hpp"
+#include "logging.hpp"
+#include "Extension.hpp"
+#include "boost/signals2.hpp"
+#include "storage/DomainDecomposition.hpp"
+
+namespace espressopp {
+  namespace integrator {
+
+    /** Dynamic load balancing for a DomainDecomposition storage.
+
+        Every interval steps the cost of each node is measured, by
+        default the time the node spent in the force loops since the
+        last balancing step (VelocityVerlet::getForceTime()), otherwise
+        the number of real particles. If the largest cost exceeds the
+        average by more than the threshold factor, the node boundaries
+        are shifted along every axis with more than one node: the cost
+        of each slab of nodes is assumed to be uniformly distributed
+        over its width, and the new boundaries split the cumulative cost
+        into equal parts. The shift is damped and no local box becomes
+        smaller than cutoff + skin. Cells and particles then migrate via
+        DomainDecomposition::setNodeBoundaries().
+    */
+    class LoadBalancer : public Extension {
+      public:
+        LoadBalancer(shared_ptr< System > _system, int _interval,
+                     real _threshold, real _damping);
+        virtual ~LoadBalancer() {};
+
+        void setInterval(int _interval) { interval = _interval; }
+        int getInterval() { return interval; }
+        void setThreshold(real _threshold) { threshold = _threshold; }
+        real getThreshold() { return threshold; }
+        void setDamping(real _damping) { damping = _damping; }
+        real getDamping() { return damping; }
+        /// ratio of the largest to the average node cost at the last balancing step
+        real getImbalance() { return imbalance; }
+        /// number of times the node boundaries have been moved
+        int getNumRebalances() { return nRebalances; }
+
+        /** Measure the cost and move the node boundaries if needed. Collective. */
+        void balance();
+
+        /** Register this class so it can be used from Python. */
+        static void registerPython();
+
+      protected:
+        python::list getTimers() {
+          python::list ret;
+          ret.append(python::make_tuple("timeBalance", timeBalance));
+          return ret;
+        }
+        void resetTimers() {
+          wallTimer.reset();
+          timeBalance = 0.0;
+        }
+
+      private:
+        boost::signals2::connection _aftIntV;
+        void connect();
+        void disconnect();
+        void perform_action();
+
+        /// cost of this node since the last call
+        real measureCost();
+        /** move the boundaries b of one axis according to the costs of its
+            slabs, returns true if they changed */
+        bool balanceAxis(std::vector<real>& b, const std::vector<real>& slabCost,
+                         real minSize) const;
+
+        shared_ptr< storage::DomainDecomposition > domdec;
+        int interval;
+        real threshold;
+        real damping;
+
+        real lastForceTime;
+        real imbalance;
+        int nRebalances;
+
+        real timeBalance;
+
+        /** Logger */
+        static LOG4ESPP_DECL_LOGGER(theLogger);
+    };
+  }
+}
+
+#endif
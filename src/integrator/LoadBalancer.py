@@ -0,0 +1,85 @@
+#  Copyright (C) 2016
+#      Max Planck Institute for Polymer Research
+#  
+#  This file is part of ESPResSo++.
+#  
+#  ESPResSo++ is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#  
+#  ESPResSo++ is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#  
+#  You should have received a copy of the GNU General Public License
+#  along with this program.  If not, see <http://www.gnu.org/licenses/>. 
+
+
+
+r"""
+**********************************
+espressopp.integrator.LoadBalancer
+**********************************
+
+Dynamic load balancing for a :class:`espressopp.storage.DomainDecomposition`.
+Every `interval` steps the time each node spent in the force loops is
+measured (the number of real particles is used for integrators other than
+VelocityVerlet). If the largest cost exceeds the average by more than the
+factor `threshold`, the node boundaries are moved along every axis with
+more than one node so that the slabs of nodes get equal shares of the cost.
+The node grid stays rectilinear; no local box becomes smaller than
+cutoff + skin. Particles migrate to their new nodes right away.
+
+Example Usage:
+
+>>> lb = espressopp.integrator.LoadBalancer(system, interval=500)
+>>> integrator.addExtension(lb)
+>>> integrator.run(10000)
+>>> print lb.imbalance, lb.num_rebalances
+>>> print system.storage.getNodeBoundaries()
+
+.. function:: espressopp.integrator.LoadBalancer(system, interval, threshold, damping)
+
+		:param system: system with a DomainDecomposition storage
+		:param interval: (default: 1000) number of steps between two balancing steps
+		:param threshold: (default: 1.1) move the boundaries only if max/average cost exceeds it
+		:param damping: (default: 0.5) fraction of the computed shift that is applied
+		:type system: espressopp.System
+		:type interval: int
+		:type threshold: real
+		:type damping: real
+
+.. function:: espressopp.integrator.LoadBalancer.balance()
+
+		Measure the cost and move the node boundaries if needed.
+
+.. attribute:: imbalance
+
+		ratio of the largest to the average node cost at the last balancing step
+
+.. attribute:: num_rebalances
+
+		number of times the node boundaries have been moved
+"""
+
+from espressopp.esutil import cxxinit
+from espressopp import pmi
+from espressopp.integrator.Extension import *
+from _espressopp import integrator_LoadBalancer
+
+class LoadBalancerLocal(ExtensionLocal, integrator_LoadBalancer):
+
+    def __init__(self, system, interval=1000, threshold=1.1, damping=0.5):
+        if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+            cxxinit(self, integrator_LoadBalancer, system, interval, threshold, damping)
+
+if pmi.isController :
+    class LoadBalancer(Extension):
+        __metaclass__ = pmi.Proxy
+        pmiproxydefs = dict(
+            cls =  'espressopp.integrator.LoadBalancerLocal',
+            pmiproperty = [ 'interval', 'threshold', 'damping', 'imbalance', 'num_rebalances' ],
+            pmicall = [ 'balance' ]
+            )
@@ -23,6 +23,7 @@
 */
 
 #include <python.hpp>
+#include <algorithm>
 #include "MDIntegrator.hpp"
 #include "System.hpp"
 
@@ -97,6 +98,27 @@ namespace espressopp {
     	return exList[k];
     }
 
+    void MDIntegrator::requestObservables(int interval, int which) {
+      if (interval > 0 && which) {
+        observableRequests.push_back(std::make_pair(interval, which));
+      }
+    }
+
+    void MDIntegrator::releaseObservables(int interval, int which) {
+      std::vector< std::pair<int, int> >::iterator it =
+        std::find(observableRequests.begin(), observableRequests.end(),
+                  std::make_pair(interval, which));
+      if (it != observableRequests.end()) observableRequests.erase(it);
+    }
+
+    int MDIntegrator::getRequestedObservables(long long step) const {
+      int which = 0;
+      for (size_t i = 0; i < observableRequests.size(); ++i) {
+        if (step % observableRequests[i].first == 0) which |= observableRequests[i].second;
+      }
+      return which;
+    }
+
     //////////////////////////////////////////////////
     // REGISTRATION WITH PYTHON
     //////////////////////////////////////////////////
@@ -30,6 +30,8 @@
 #include "SystemAccess.hpp"
 #include "Extension.hpp"
 #include <boost/signals2.hpp>
+#include <utility>
+#include <vector>
 #include "types.hpp"
 #include "esutil/Error.hpp"
 
@@ -81,6 +83,20 @@ namespace espressopp {
 
         int getNumberOfExtensions();
 
+        /** Request the observables which (interaction::Interaction::ENERGY,
+            VIRIAL, VIRIAL_TENSOR) on every step whose number is a
+            multiple of interval once it is done, i.e. when aftIntV is
+            emitted; the interactions then accumulate them in the force
+            pass of that step. Used by extensions that analyse the
+            system; several requests are combined. */
+        void requestObservables(int interval, int which);
+
+        /** withdraw a request made with requestObservables() */
+        void releaseObservables(int interval, int which);
+
+        /** the observables requested for the given step */
+        int getRequestedObservables(long long step) const;
+
         // signals to extend the integrator
         boost::signals2::signal<void ()> runInit; // initialization of run()
         boost::signals2::signal<void ()> recalc1; // inside recalc, before updateForces()
@@ -109,6 +125,9 @@ namespace espressopp {
         /** Integration step */
         long long step;
 
+        /** observables requested by extensions, (interval, which) */
+        std::vector< std::pair<int, int> > observableRequests;
+
         /** Timestep used for integration */
         real dt;
 
@@ -0,0 +1,228 @@
+/*
+  Copyright (C) 2016
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "python.hpp"
+#include <algorithm>
+#include <cmath>
+#include "SkinTuner.hpp"
+#include "System.hpp"
+#include "mpi.hpp"
+#include "bc/BC.hpp"
+#include "storage/DomainDecomposition.hpp"
+
+namespace espressopp {
+  namespace integrator {
+
+    LOG4ESPP_LOGGER(SkinTuner::theLogger, "SkinTuner");
+
+    // golden ratio
+    static const real phi = 0.5 * (1.0 + sqrt(5.0));
+
+    SkinTuner::SkinTuner(shared_ptr< System > _system, real _minSkin, real _maxSkin,
+                         int _sampleSteps, real _precision, int _interval)
+      : Extension(_system), minSkin(_minSkin), maxSkin(_maxSkin),
+        sampleSteps(_sampleSteps), precision(_precision), interval(_interval),
+        tuning(false), probe(PROBE_X1), stepsSampled(0), sampleStart(0.0), nRebuilds(0),
+        stepsSinceTuning(0), nTunings(0)
+    {
+      LOG4ESPP_INFO(theLogger, "SkinTuner constructed");
+      if (!dynamic_pointer_cast< storage::DomainDecomposition >(_system->storage)) {
+        throw std::runtime_error("SkinTuner needs a DomainDecomposition storage");
+      }
+      if (minSkin <= 0.0 || maxSkin <= minSkin) {
+        throw std::invalid_argument("SkinTuner: need 0 < minSkin < maxSkin");
+      }
+      if (sampleSteps < 1 || precision <= 0.0) {
+        throw std::invalid_argument("SkinTuner: sampleSteps and precision must be positive");
+      }
+      type = Extension::all;
+      // the skin changes after everything else of the step is done
+      extensionOrder = Extension::atEnd;
+      resetTimers();
+      tune(minSkin, maxSkin);
+    }
+
+    SkinTuner::~SkinTuner() {
+      disconnect();
+    }
+
+    void SkinTuner::disconnect() {
+      _runInit.disconnect();
+      _aftIntV.disconnect();
+      _particlesChanged.disconnect();
+    }
+
+    void SkinTuner::connect() {
+      _runInit = integrator->runInit.connect(boost::bind(&SkinTuner::restartSample, this));
+      _aftIntV = integrator->aftIntV.connect(extensionOrder, boost::bind(&SkinTuner::perform_action, this));
+      _particlesChanged = getSystemRef().storage->onParticlesChanged.connect(
+          boost::bind(&SkinTuner::countRebuild, this));
+    }
+
+    void SkinTuner::tune(real lo, real hi) {
+      // a cell must not be larger than a local box
+      System& system = getSystemRef();
+      shared_ptr< storage::DomainDecomposition > domdec =
+        dynamic_pointer_cast< storage::DomainDecomposition >(system.storage);
+      // (the smallest one, the load balancer may have moved the boundaries)
+      const storage::NodeGrid& nodeGrid = domdec->getNodeGrid();
+      for (int i = 0; i < 3; ++i) {
+        const std::vector<real>& bounds = nodeGrid.getNodeBoundaries(i);
+        for (size_t j = 0; j + 1 < bounds.size(); ++j) {
+          hi = std::min(hi, bounds[j + 1] - bounds[j] - system.maxCutoff);
+        }
+      }
+      lo = std::min(lo, hi);
+
+      a = lo;
+      b = hi;
+      x1 = b - (b - a) / phi;
+      x2 = a + (b - a) / phi;
+      f1 = f2 = -1.0;
+      if (b - a < precision) {
+        // nothing to search, take the middle
+        candidate = 0.5 * (a + b);
+        probe = PROBE_DONE;
+      } else {
+        candidate = x1;
+        probe = PROBE_X1;
+      }
+      tuning = true;
+      // the first candidate is applied with the next step
+      stepsSampled = -1;
+      LOG4ESPP_INFO(theLogger, "start skin search in [" << a << ", " << b << "]");
+    }
+
+    void SkinTuner::restartSample() {
+      // the time between two runs does not belong to any candidate
+      stepsSampled = (stepsSampled < 0) ? -1 : 0;
+      nRebuilds = 0;
+      sampleStart = wallTimer.getElapsedTime();
+    }
+
+    void SkinTuner::perform_action() {
+      if (!tuning) {
+        if (interval <= 0 || ++stepsSinceTuning < interval) return;
+        real skin = getSystemRef().getSkin();
+        tune(std::max(minSkin, 0.5 * skin), std::min(maxSkin, 1.5 * skin));
+      }
+
+      real time0 = wallTimer.getElapsedTime();
+      if (stepsSampled >= 0 && ++stepsSampled < sampleSteps) return;
+
+      if (stepsSampled >= 0) {
+        // all processes have to take the same decision
+        real elapsed = time0 - sampleStart, maxElapsed;
+        mpi::all_reduce(*getSystemRef().comm, elapsed, maxElapsed, boost::mpi::maximum<real>());
+        Sample s = { candidate, maxElapsed / stepsSampled, real(nRebuilds) / stepsSampled };
+        history.push_back(s);
+        LOG4ESPP_INFO(theLogger, "skin " << s.skin << ": " << s.timePerStep << " s/step, "
+                      << s.rebuildsPerStep << " rebuilds/step");
+        nextCandidate(s.timePerStep);
+      }
+
+      applySkin(candidate);
+      if (probe == PROBE_DONE) {
+        tuning = false;
+        stepsSinceTuning = 0;
+        ++nTunings;
+        LOG4ESPP_INFO(theLogger, "new skin " << candidate);
+      }
+      timeTuning += wallTimer.getElapsedTime() - time0;
+      stepsSampled = 0;
+      nRebuilds = 0;
+      sampleStart = wallTimer.getElapsedTime();
+    }
+
+    void SkinTuner::nextCandidate(real timePerStep) {
+      if (probe == PROBE_X1) f1 = timePerStep;
+      else f2 = timePerStep;
+
+      if (f1 < 0.0) { candidate = x1; probe = PROBE_X1; return; }
+      if (f2 < 0.0) { candidate = x2; probe = PROBE_X2; return; }
+
+      if (b - a < precision) {
+        candidate = (f1 <= f2) ? x1 : x2;
+        probe = PROBE_DONE;
+        return;
+      }
+
+      // keep the bracket with the faster inner point
+      if (f1 > f2) {
+        a = x1;
+        x1 = x2;
+        f1 = f2;
+        x2 = a + (b - a) / phi;
+        f2 = -1.0;
+        candidate = x2;
+        probe = PROBE_X2;
+      } else {
+        b = x2;
+        x2 = x1;
+        f2 = f1;
+        x1 = b - (b - a) / phi;
+        f1 = -1.0;
+        candidate = x1;
+        probe = PROBE_X1;
+      }
+    }
+
+    void SkinTuner::applySkin(real skin) {
+      System& system = getSystemRef();
+      shared_ptr< storage::DomainDecomposition > domdec =
+        dynamic_pointer_cast< storage::DomainDecomposition >(system.storage);
+      system.setSkin(skin);
+
+      // both rebuild the neighbor lists with the new skin
+      if (domdec->getAdjustedCellGrid() != domdec->getInt3DCellGrid()) domdec->cellAdjust();
+      else domdec->decompose();
+    }
+
+    python::list SkinTuner::getHistory() {
+      python::list ret;
+      for (size_t i = 0; i < history.size(); ++i) {
+        ret.append(python::make_tuple(history[i].skin, history[i].timePerStep,
+                                      history[i].rebuildsPerStep));
+      }
+      return ret;
+    }
+
+    /****************************************************
+    ** REGISTRATION WITH PYTHON
+    ****************************************************/
+    void SkinTuner::registerPython() {
+      using namespace espressopp::python;
+      class_< SkinTuner, shared_ptr< SkinTuner >, bases< Extension > >
+        ("integrator_SkinTuner", init< shared_ptr< System >, real, real, int, real, int >())
+        .add_property("minSkin", &SkinTuner::getMinSkin, &SkinTuner::setMinSkin)
+        .add_property("maxSkin", &SkinTuner::getMaxSkin, &SkinTuner::setMaxSkin)
+        .add_property("sampleSteps", &SkinTuner::getSampleSteps, &SkinTuner::setSampleSteps)
+        .add_property("precision", &SkinTuner::getPrecision, &SkinTuner::setPrecision)
+        .add_property("interval", &SkinTuner::getInterval, &SkinTuner::setInterval)
+        .add_property("tuning", &SkinTuner::isTuning)
+        .add_property("num_tunings", &SkinTuner::getNumTunings)
+        .def("tune", &SkinTuner::tune)
+        .def("getHistory", &SkinTuner::getHistory)
+        .def("connect", &SkinTuner::connect)
+        .def("disconnect", &SkinTuner::disconnect)
+        ;
+    }
+  }
+}
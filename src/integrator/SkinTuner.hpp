@@ -0,0 +1,140 @@
+/*
+  Copyright (C) 2016
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ESPP_CLASS
+#ifndef _INTEGRATOR_SKINTUNER_HPP
+#define _INTEGRATOR_SKINTUNER_HPP
+
+#include <vector>
+#include "types.hpp"
+#include "logging.hpp"
+#include "Extension.hpp"
+#include "boost/signals2.hpp"
+
+namespace espressopp {
+  namespace integrator {
+
+    /** Tunes the skin while the simulation runs.
+
+        A small skin makes the neighbor lists short but the rebuilds
+        frequent, a large one the opposite. The tuner measures the wall
+        time per step, which contains both the force loops and the
+        rebuilds, for sampleSteps steps per candidate skin and runs a
+        golden section search in [minSkin, maxSkin] until the interval
+        is smaller than precision. The fastest skin found is kept. The
+        cell grid is adjusted whenever the new skin needs another one.
+
+        If interval > 0 the search is repeated interval steps after the
+        last one ended, in [skin/2, 3*skin/2] (within the bounds), to
+        follow drifts of the density or temperature.
+
+        The integrator reads the skin every step; the skin changes at
+        the end of a step, followed by a resort.
+    */
+    class SkinTuner : public Extension {
+      public:
+        SkinTuner(shared_ptr< System > _system, real _minSkin, real _maxSkin,
+                  int _sampleSteps, real _precision, int _interval);
+        virtual ~SkinTuner();
+
+        void setMinSkin(real _minSkin) { minSkin = _minSkin; }
+        real getMinSkin() { return minSkin; }
+        void setMaxSkin(real _maxSkin) { maxSkin = _maxSkin; }
+        real getMaxSkin() { return maxSkin; }
+        void setSampleSteps(int _sampleSteps) { sampleSteps = _sampleSteps; }
+        int getSampleSteps() { return sampleSteps; }
+        void setPrecision(real _precision) { precision = _precision; }
+        real getPrecision() { return precision; }
+        void setInterval(int _interval) { interval = _interval; }
+        int getInterval() { return interval; }
+        /// true while a search is running
+        bool isTuning() { return tuning; }
+        /// number of completed searches
+        int getNumTunings() { return nTunings; }
+
+        /** Start a new search in [lo, hi] with the next step. */
+        void tune(real lo, real hi);
+
+        /** (skin, time per step, rebuilds per step) of all measured
+            candidates, in the order of the measurements. */
+        python::list getHistory();
+
+        /** Register this class so it can be used from Python. */
+        static void registerPython();
+
+      protected:
+        python::list getTimers() {
+          python::list ret;
+          ret.append(python::make_tuple("timeTuning", timeTuning));
+          return ret;
+        }
+        void resetTimers() {
+          wallTimer.reset();
+          timeTuning = 0.0;
+        }
+
+      private:
+        boost::signals2::connection _runInit, _aftIntV, _particlesChanged;
+        void connect();
+        void disconnect();
+        void perform_action();
+        void restartSample();
+        void countRebuild() { ++nRebuilds; }
+
+        /// next skin of the golden section search after the candidate was measured
+        void nextCandidate(real timePerStep);
+        /// set the skin, adjust the cells and rebuild the lists. Collective.
+        void applySkin(real skin);
+
+        real minSkin, maxSkin;
+        int sampleSteps;
+        real precision;
+        int interval;
+
+        // golden section state: the minimum is bracketed by [a, b],
+        // x1 < x2 are the inner points with the times f1, f2 (< 0: not measured)
+        bool tuning;
+        real a, b, x1, x2, f1, f2;
+        real candidate;
+        // what the candidate is: the inner point being measured, or the
+        // result, which is applied without a measurement
+        enum Probe { PROBE_X1, PROBE_X2, PROBE_DONE } probe;
+
+        // measurement of the current candidate
+        int stepsSampled;
+        real sampleStart;
+        int nRebuilds;
+        int stepsSinceTuning;
+        int nTunings;
+
+        struct Sample {
+          real skin, timePerStep, rebuildsPerStep;
+        };
+        std::vector< Sample > history;
+
+        real timeTuning;
+
+        /** Logger */
+        static LOG4ESPP_DECL_LOGGER(theLogger);
+    };
+  }
+}
+
+#endif
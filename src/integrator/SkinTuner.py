@@ -0,0 +1,101 @@
+#  Copyright (C) 2016
+#      Max Planck Institute for Polymer Research
+#  
+#  This file is part of ESPResSo++.
+#  
+#  ESPResSo++ is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#  
+#  ESPResSo++ is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#  
+#  You should have received a copy of the GNU General Public License
+#  along with this program.  If not, see <http://www.gnu.org/licenses/>. 
+
+
+
+r"""
+*******************************
+espressopp.integrator.SkinTuner
+*******************************
+
+Tunes the skin while the simulation runs. A small skin gives short
+neighbor lists but frequent rebuilds, a large skin the opposite. The
+tuner measures the wall time per step (force loops and rebuilds together)
+for `sampleSteps` steps per candidate skin and narrows [minSkin, maxSkin]
+by a golden section search until it is smaller than `precision`; then
+the fastest skin is kept. The cell grid is adjusted whenever a skin needs
+another one. Unlike :func:`espressopp.tools.decomp.tuneSkin` the search
+happens inside the production run, and with `interval` > 0 it is
+repeated around the current skin to follow changes of the density or
+temperature.
+
+The skin changes at the end of a step, followed by a resort, so the
+first steps of the run are spent with different skins. Only
+VelocityVerlet reads the skin in every step.
+
+Example Usage:
+
+>>> tuner = espressopp.integrator.SkinTuner(system, minSkin=0.1, maxSkin=1.0)
+>>> integrator.addExtension(tuner)
+>>> integrator.run(20000)
+>>> print system.skin, tuner.num_tunings
+>>> for skin, t, rebuilds in tuner.getHistory():
+>>>   print skin, t, rebuilds
+
+.. function:: espressopp.integrator.SkinTuner(system, minSkin, maxSkin, sampleSteps, precision, interval)
+
+		:param system: system with a DomainDecomposition storage
+		:param minSkin: (default: 0.05) smallest skin tried
+		:param maxSkin: (default: 1.0) largest skin tried (at most the local box minus the cutoff)
+		:param sampleSteps: (default: 200) steps measured per candidate, should span several rebuilds
+		:param precision: (default: 0.02) the search stops when the interval is smaller
+		:param interval: (default: 0) steps between the end of a search and the next one, 0: tune once
+		:type system: espressopp.System
+		:type minSkin: real
+		:type maxSkin: real
+		:type sampleSteps: int
+		:type precision: real
+		:type interval: int
+
+.. function:: espressopp.integrator.SkinTuner.tune(lo, hi)
+
+		Start a new search in [lo, hi] with the next step.
+
+.. function:: espressopp.integrator.SkinTuner.getHistory()
+
+		:rtype: list of (skin, seconds per step, rebuilds per step) of the measured candidates
+
+.. attribute:: tuning
+
+		True while a search is running
+
+.. attribute:: num_tunings
+
+		number of completed searches
+"""
+
+from espressopp.esutil import cxxinit
+from espressopp import pmi
+from espressopp.integrator.Extension import *
+from _espressopp import integrator_SkinTuner
+
+class SkinTunerLocal(ExtensionLocal, integrator_SkinTuner):
+
+    def __init__(self, system, minSkin=0.05, maxSkin=1.0, sampleSteps=200, precision=0.02, interval=0):
+        if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+            cxxinit(self, integrator_SkinTuner, system, minSkin, maxSkin, sampleSteps, precision, interval)
+
+if pmi.isController :
+    class SkinTuner(Extension):
+        __metaclass__ = pmi.Proxy
+        pmiproxydefs = dict(
+            cls =  'espressopp.integrator.SkinTunerLocal',
+            pmiproperty = [ 'minSkin', 'maxSkin', 'sampleSteps', 'precision', 'interval',
+                            'tuning', 'num_tunings' ],
+            pmicall = [ 'tune', 'getHistory' ]
+            )
@@ -23,6 +23,7 @@
 */
 
 //#include <iomanip>
+#include <limits>
 #include "python.hpp"
 #include "VelocityVerlet.hpp"
 #include <iomanip>
@@ -32,6 +33,7 @@
 #include "System.hpp"
 #include "storage/Storage.hpp"
 #include "mpi.hpp"
+#include "esutil/Profiler.hpp"
 
 #ifdef VTRACE
 #include "vampirtrace/vt_user.h"
@@ -53,19 +55,97 @@ namespace espressopp {
       LOG4ESPP_INFO(theLogger, "construct VelocityVerlet");
       resortFlag = true;
       maxDist    = 0.0;
+      overlapComm = false;
+      pairDisplacementResort = false;
+      interactionObservables = false;
+      nResortsTotal = 0;
       timeIntegrate.reset();
       resetTimers();
       System& sys = getSystemRef();
+      // observables kept after a run are stale once the particles change
+      if (sys.storage) {
+        connObservables = sys.storage->onParticlesChanged.connect(
+            boost::bind(&VelocityVerlet::invalidateInteractionObservables, this));
+      }
     }
 
     VelocityVerlet::~VelocityVerlet()
     {
       LOG4ESPP_INFO(theLogger, "free VelocityVerlet");
+      connRefPos.disconnect();
+      connObservables.disconnect();
+    }
+
+    void VelocityVerlet::setPairDisplacementResort(bool _pairDisplacementResort)
+    {
+      if (_pairDisplacementResort == pairDisplacementResort) return;
+      pairDisplacementResort = _pairDisplacementResort;
+      if (pairDisplacementResort) {
+        // every resort rebuilds the neighbor lists and renews the reference
+        connRefPos = getSystemRef().storage->onParticlesChanged.connect(
+            boost::bind(&VelocityVerlet::saveReferencePositions, this));
+        // the lists were built for older positions, start from a resort
+        resortFlag = true;
+      } else {
+        connRefPos.disconnect();
+        std::vector<Real3D>().swap(refPos);
+      }
+    }
+
+    void VelocityVerlet::saveReferencePositions()
+    {
+      CellList realCells = getSystemRef().storage->getRealCells();
+      refPos.clear();
+      for (CellListIterator cit(realCells); !cit.isDone(); ++cit) {
+        refPos.push_back(cit->position());
+      }
+    }
+
+    real VelocityVerlet::maxPairDisplacement()
+    {
+      CellList realCells = getSystemRef().storage->getRealCells();
+
+      // two largest displacements of the real particles
+      real d1 = 0.0, d2 = 0.0;
+      size_t n = 0;
+      bool consistent = true;
+      for (CellListIterator cit(realCells); !cit.isDone(); ++cit, ++n) {
+        if (n >= refPos.size()) {
+          consistent = false;
+          break;
+        }
+        real d = (cit->position() - refPos[n]).sqr();
+        if (d > d1) { d2 = d1; d1 = d; }
+        else if (d > d2) d2 = d;
+      }
+      if (n != refPos.size()) consistent = false;
+
+      // any two particles may have come closer, also those that were
+      // further apart than the neighbor cells, so the bound is the sum of
+      // the two largest displacements of all processes
+      const mpi::communicator& comm = *getSystemRef().comm;
+      real local1 = sqrt(d1), local2 = sqrt(d2);
+      // particles added or removed without a resort, the reference is lost
+      if (!consistent) local1 = std::numeric_limits<real>::max();
+      real max1;
+      mpi::all_reduce(comm, local1, max1, boost::mpi::maximum<real>());
+      if (max1 == std::numeric_limits<real>::max()) return max1;
+
+      // the second largest: the process holding the largest one offers
+      // its second, the others their largest. If several processes hold
+      // the largest one, it is also the second largest.
+      int holders, holder = (local1 == max1) ? 1 : 0;
+      mpi::all_reduce(comm, holder, holders, std::plus<int>());
+      if (holders > 1) return 2.0 * max1;
+      real second = holder ? local2 : local1, max2;
+      mpi::all_reduce(comm, second, max2, boost::mpi::maximum<real>());
+      return max1 + max2;
     }
 
     void VelocityVerlet::run(int nsteps)
     {
       VT_TRACER("run");
+      esutil::Profiler::Scope profile("integrate");
       int nResorts = 0;
       real time;
       timeIntegrate.reset();
@@ -84,18 +164,23 @@ namespace espressopp {
       }
 
       time = timeIntegrate.getElapsedTime();
-      // signal
-      runInit();
+      {
+        esutil::Profiler::Scope prof("runInit");
+        // signal
+        runInit();
+      }
       timeRunInitS += timeIntegrate.getElapsedTime() - time;
 
       // Before start make sure that particles are on the right processor
       if (resortFlag) {
         VT_TRACER("resort");
+        esutil::Profiler::Scope prof("resort");
         time = timeIntegrate.getElapsedTime();
         LOG4ESPP_INFO(theLogger, "resort particles");
         storage.decompose();
         maxDist = 0.0;
         resortFlag = false;
+        nResortsTotal++;
         timeResort += timeIntegrate.getElapsedTime();
       }
 
@@ -105,8 +190,11 @@ namespace espressopp {
         LOG4ESPP_INFO(theLogger, "recalc forces before starting main integration loop");
 
         time = timeIntegrate.getElapsedTime();
-        // signal
-        recalc1();
+        {
+          esutil::Profiler::Scope prof("recalc1");
+          // signal
+          recalc1();
+        }
         timeRecalc1S += timeIntegrate.getElapsedTime() - time;
 
         updateForces();
@@ -115,8 +203,11 @@ namespace espressopp {
         }
 
         time = timeIntegrate.getElapsedTime();
-        // signal
-        recalc2();
+        {
+          esutil::Profiler::Scope prof("recalc2");
+          // signal
+          recalc2();
+        }
         timeRecalc2S += timeIntegrate.getElapsedTime() - time;
       }
 
@@ -127,10 +218,16 @@ namespace espressopp {
 
         //saveOldPos(); // save particle positions needed for constraints
         time = timeIntegrate.getElapsedTime();
-        // signal
-        befIntP();
+        {
+          esutil::Profiler::Scope prof("befIntP");
+          // signal
+          befIntP();
+        }
         timeBefIntPS += timeIntegrate.getElapsedTime() - time;
 
+        // observables of the last step are stale once the particles move
+        if (interactionObservables) setInteractionObservables(0);
+
         LOG4ESPP_INFO(theLogger, "updating positions and velocities")
         maxDist += integrate1();
         timeInt1 += timeIntegrate.getElapsedTime() - time;
@@ -142,31 +239,51 @@ namespace espressopp {
         }*/
 
         time = timeIntegrate.getElapsedTime();
-        // signal
-        aftIntP();
+        {
+          esutil::Profiler::Scope prof("aftIntP");
+          // signal
+          aftIntP();
+        }
         timeAftIntPS += timeIntegrate.getElapsedTime() - time;
 
+        // the skin may be changed by extensions (SkinTuner)
+        skinHalf = 0.5 * system.getSkin();
         LOG4ESPP_INFO(theLogger, "maxDist = " << maxDist << ", skin/2 = " << skinHalf);
 
-        if (maxDist > skinHalf) resortFlag = true;
+        if (pairDisplacementResort) {
+          if (maxPairDisplacement() > 2.0 * skinHalf) resortFlag = true;
+        } else if (maxDist > skinHalf) {
+          resortFlag = true;
+        }
 
         if (resortFlag) {
             VT_TRACER("resort1");
+            esutil::Profiler::Scope prof("resort");
             time = timeIntegrate.getElapsedTime();
             LOG4ESPP_INFO(theLogger, "step " << i << ": resort particles");
             storage.decompose();
             maxDist  = 0.0;
             resortFlag = false;
             nResorts ++;
+            nResortsTotal++;
             timeResort += timeIntegrate.getElapsedTime() - time;
         }
 
+        // on analysed steps the force pass also yields the observables,
+        // on the last step those read by the analysis after the run
+        int which = getRequestedObservables(step + 1);
+        if (i == nsteps - 1) which |= system.getRunObservables();
+        if (which) setInteractionObservables(which);
+
         LOG4ESPP_INFO(theLogger, "updating forces")
         updateForces();
 
         timeIntegrate.startMeasure();
-        // signal
-        befIntV();
+        {
+          esutil::Profiler::Scope prof("befIntV");
+          // signal
+          befIntV();
+        }
         timeBefIntVS += timeIntegrate.stopMeasure();
 
         time = timeIntegrate.getElapsedTime();
@@ -174,16 +291,43 @@ namespace espressopp {
         timeInt2 += timeIntegrate.getElapsedTime() - time;
 
         timeIntegrate.startMeasure();
-        // signal
-        aftIntV();
-        aftIntV2();
+        {
+          esutil::Profiler::Scope prof("aftIntV");
+          // signal
+          aftIntV();
+          aftIntV2();
+        }
         timeAftIntVS += timeIntegrate.stopMeasure();
       }
 
+      // keep the observables of the last step for the analysis after the
+      // run; they are dropped when the particles or potentials change
+      if (interactionObservables) {
+        const InteractionList& ilist = system.shortRangeInteractions;
+        for (size_t k = 0; k < ilist.size(); k++) ilist[k]->finishObservables();
+      }
+
       timeRun = timeIntegrate.getElapsedTime();
       LOG4ESPP_INFO(theLogger, "finished run");
     }
 
+    void VelocityVerlet::invalidateInteractionObservables()
+    {
+      const InteractionList& srIL = getSystemRef().shortRangeInteractions;
+      for (size_t i = 0; i < srIL.size(); i++) {
+        srIL[i]->invalidateObservables();
+      }
+    }
+
+    void VelocityVerlet::setInteractionObservables(int which)
+    {
+      const InteractionList& srIL = getSystemRef().shortRangeInteractions;
+      for (size_t i = 0; i < srIL.size(); i++) {
+        srIL[i]->requestObservables(which);
+      }
+      interactionObservables = (which != 0);
+    }
+
     void VelocityVerlet::resetTimers() {
       // Prepare the force comp timers if the size is not valid.
       System& system = getSystemRef();
@@ -196,11 +340,13 @@ namespace espressopp {
         }
       }
 
+      timeForce  = 0.0;
       timeComm1  = 0.0;
       timeComm2  = 0.0;
       timeInt1   = 0.0;
       timeInt2   = 0.0;
       timeResort = 0.0;
+      nResortsTotal = 0;
 
       // Reset signal timers.
       timeRunInitS = 0.0;
@@ -273,44 +419,42 @@ namespace espressopp {
 
     real VelocityVerlet::integrate1()
     {
+      esutil::Profiler::Scope profile("integrate1");
       System& system = getSystemRef();
-      CellList realCells = system.storage->getRealCells();
+      storage::Storage& storage = *system.storage;
+      CellList& realCells = storage.getRealCells();
+
+      LOG4ESPP_INFO(theLogger, "updating first half step of velocities and full step of positions")
+
+      // the cells are updated concurrently; each one keeps its own
+      // maximum, which are reduced afterwards
+      cellMaxSqDist.assign(realCells.size(), 0.0);
+      const real half_dt = 0.5 * dt;
+      storage.getCellTasks().forEachCell(realCells, [&](Cell& cell, long i) {
+        real maxSqDist = 0.0; // maximal square distance a particle moves
+        for (ParticleList::iterator it = cell.particles.begin(),
+               end = cell.particles.end(); it != end; ++it) {
+          real dtfm = half_dt / it->mass();
+
+          // Propagate velocities: v(t+0.5*dt) = v(t) + 0.5*dt * f(t)
+          it->velocity() += dtfm * it->force();
+
+          // Propagate positions (only NVT): p(t + dt) = p(t) + dt * v(t+0.5*dt)
+          Real3D deltaP = it->velocity();
+          deltaP *= dt;
+          it->position() += deltaP;
+          maxSqDist = std::max(maxSqDist, deltaP * deltaP);
+        }
+        cellMaxSqDist[i] = maxSqDist;
+      });
 
-      // loop over all particles of the local cells
       int count = 0;
-      real maxSqDist = 0.0; // maximal square distance a particle moves
-      for(CellListIterator cit(realCells); !cit.isDone(); ++cit) {
-        real sqDist = 0.0;
-        LOG4ESPP_INFO(theLogger, "updating first half step of velocities and full step of positions")
-        LOG4ESPP_DEBUG(theLogger, "Particle " << cit->id() <<
-                ", pos = " << cit->position() <<
-                ", v = " << cit->velocity() <<
-                ", f = " << cit->force());
-
-        /* more precise for DEBUG:
-        printf("Particle %d, pos = %16.12f %16.12f %16.12f, v = %16.12f, %16.12f %16.12f, f = %16.12f %16.12f %16.12f\n",
-            cit->p.id, cit->r.p[0], cit->r.p[1], cit->r.p[2],
-                cit->m.v[0], cit->m.v[1], cit->m.v[2],
-            cit->f.f[0], cit->f.f[1], cit->f.f[2]);
-        */
-
-        real dtfm = 0.5 * dt / cit->mass();
-
-        // Propagate velocities: v(t+0.5*dt) = v(t) + 0.5*dt * f(t)
-        cit->velocity() += dtfm * cit->force();
-
-        // Propagate positions (only NVT): p(t + dt) = p(t) + dt * v(t+0.5*dt) 
-        Real3D deltaP = cit->velocity();
-        
-        deltaP *= dt;
-        cit->position() += deltaP;
-        sqDist += deltaP * deltaP;
-
-        count++;
-
-        maxSqDist = std::max(maxSqDist, sqDist);
+      real maxSqDist = 0.0;
+      for (size_t i = 0; i < realCells.size(); ++i) {
+        count += realCells[i]->particles.size();
+        maxSqDist = std::max(maxSqDist, cellMaxSqDist[i]);
       }
-      
+
       // signal
       inIntP(maxSqDist);
 
@@ -326,17 +470,20 @@ namespace espressopp {
 
     void VelocityVerlet::integrate2()
     {
+      esutil::Profiler::Scope profile("integrate2");
       LOG4ESPP_INFO(theLogger, "updating second half step of velocities")
-      System& system = getSystemRef();
-      CellList realCells = system.storage->getRealCells();
+      storage::Storage& storage = *getSystemRef().storage;
 
       // loop over all particles of the local cells
-      real half_dt = 0.5 * dt; 
-      for(CellListIterator cit(realCells); !cit.isDone(); ++cit) {
-        real dtfm = half_dt / cit->mass();
-        /* Propagate velocities: v(t+0.5*dt) = v(t) + 0.5*dt * f(t) */
-        cit->velocity() += dtfm * cit->force();
-      }
+      const real half_dt = 0.5 * dt;
+      storage.getCellTasks().forEachCell(storage.getRealCells(), [half_dt](Cell& cell, long) {
+        for (ParticleList::iterator it = cell.particles.begin(),
+               end = cell.particles.end(); it != end; ++it) {
+          real dtfm = half_dt / it->mass();
+          /* Propagate velocities: v(t+0.5*dt) = v(t) + 0.5*dt * f(t) */
+          it->velocity() += dtfm * it->force();
+        }
+      });
       
       step++;
     }
@@ -344,14 +491,18 @@ namespace espressopp {
     void VelocityVerlet::calcForces()
     {
       VT_TRACER("forces");
+      esutil::Profiler::Scope profile("force");
 
       LOG4ESPP_INFO(theLogger, "calculate forces");
 
       initForces();
 
       timeIntegrate.startMeasure();
-      // signal
-      aftInitF();
+      {
+        esutil::Profiler::Scope prof("aftInitF");
+        // signal
+        aftInitF();
+      }
       timeAftInitFS += timeIntegrate.stopMeasure();
 
       System& sys = getSystemRef();
@@ -360,6 +511,7 @@ namespace espressopp {
       for (size_t i = 0; i < srIL.size(); i++) {
         LOG4ESPP_INFO(theLogger, "compute forces for srIL " << i << " of " << srIL.size());
         time = timeIntegrate.getElapsedTime();
+        esutil::Profiler::Scope prof("interaction", i);
         srIL[i]->addForces();
         timeForceComp[i] += timeIntegrate.getElapsedTime() - time;
       }
@@ -368,13 +520,24 @@ namespace espressopp {
     void VelocityVerlet::updateForces()
     {
       LOG4ESPP_INFO(theLogger, "update ghosts, calculate forces and collect ghost forces")
+      esutil::Profiler::Scope profile("updateForces");
       real time;
       storage::Storage& storage = *getSystemRef().storage;
+      if (overlapComm) {
+        updateForcesOverlapped();
+        return;
+      }
       time = timeIntegrate.getElapsedTime();
       {
         VT_TRACER("commF");
+        esutil::Profiler::Scope prof("commF");
         storage.updateGhosts();
       }
+      // positions, types or charges may have changed, the kernels working
+      // on the arrays reload them on demand
+      if (storage.getParticleArraysEnabled()) {
+        storage.getParticleArrays().invalidate();
+      }
       timeComm1 += timeIntegrate.getElapsedTime() - time;
       time = timeIntegrate.getElapsedTime();
       calcForces();
@@ -382,13 +545,106 @@ namespace espressopp {
       time = timeIntegrate.getElapsedTime();
       {
         VT_TRACER("commR");
+        esutil::Profiler::Scope prof("commR");
         storage.collectGhostForces();
       }
       timeComm2 += timeIntegrate.getElapsedTime() - time;
 
       timeIntegrate.startMeasure();
-      // signal
-      aftCalcF();
+      {
+        esutil::Profiler::Scope prof("aftCalcF");
+        // signal
+        aftCalcF();
+      }
+      timeAftCalcFS += timeIntegrate.stopMeasure();
+    }
+
+    /* Same as updateForces(), but the forces between real particles are
+       computed while the ghost positions are communicated. The aftInitF
+       signal is emitted once the ghosts are complete, i.e. after the
+       interior forces; extensions connected to it may add forces but
+       must neither reset them nor move particles. */
+    void VelocityVerlet::updateForcesOverlapped()
+    {
+      LOG4ESPP_INFO(theLogger, "update ghosts and calculate forces overlapped, collect ghost forces")
+      esutil::Profiler::Scope profile("updateForces");
+      real time;
+      System& sys = getSystemRef();
+      storage::Storage& storage = *sys.storage;
+      const InteractionList& srIL = sys.shortRangeInteractions;
+
+      time = timeIntegrate.getElapsedTime();
+      {
+        VT_TRACER("commF");
+        esutil::Profiler::Scope prof("commFBegin");
+        storage.updateGhostsBegin();
+      }
+      timeComm1 += timeIntegrate.getElapsedTime() - time;
+
+      // timeForce covers the same work as calcForces() in updateForces():
+      // initForces, aftInitF and the force loops
+      time = timeIntegrate.getElapsedTime();
+      initForces();
+      timeForce += timeIntegrate.getElapsedTime() - time;
+
+      for (size_t i = 0; i < srIL.size(); i++) {
+        time = timeIntegrate.getElapsedTime();
+        esutil::Profiler::Scope prof("interactionInterior", i);
+        srIL[i]->addForcesInterior();
+        storage.progressGhostUpdate();
+        real dt = timeIntegrate.getElapsedTime() - time;
+        timeForceComp[i] += dt;
+        timeForce += dt;
+      }
+
+      time = timeIntegrate.getElapsedTime();
+      {
+        VT_TRACER("commF");
+        esutil::Profiler::Scope prof("commFEnd");
+        storage.updateGhostsEnd();
+      }
+      // positions, types or charges may have changed, the kernels working
+      // on the arrays reload them on demand
+      if (storage.getParticleArraysEnabled()) {
+        storage.getParticleArrays().invalidate();
+      }
+      timeComm1 += timeIntegrate.getElapsedTime() - time;
+
+      timeIntegrate.startMeasure();
+      {
+        esutil::Profiler::Scope prof("aftInitF");
+        // signal
+        aftInitF();
+      }
+      {
+        real dt = timeIntegrate.stopMeasure();
+        timeAftInitFS += dt;
+        timeForce += dt;
+      }
+
+      for (size_t i = 0; i < srIL.size(); i++) {
+        time = timeIntegrate.getElapsedTime();
+        esutil::Profiler::Scope prof("interactionBoundary", i);
+        srIL[i]->addForcesBoundary();
+        real dt = timeIntegrate.getElapsedTime() - time;
+        timeForceComp[i] += dt;
+        timeForce += dt;
+      }
+
+      time = timeIntegrate.getElapsedTime();
+      {
+        VT_TRACER("commR");
+        esutil::Profiler::Scope prof("commR");
+        storage.collectGhostForces();
+      }
+      timeComm2 += timeIntegrate.getElapsedTime() - time;
+
+      timeIntegrate.startMeasure();
+      {
+        esutil::Profiler::Scope prof("aftCalcF");
+        // signal
+        aftCalcF();
+      }
       timeAftCalcFS += timeIntegrate.stopMeasure();
     }
 
@@ -396,15 +652,17 @@ namespace espressopp {
     {
       // forces are initialized for real + ghost particles
 
-      System& system = getSystemRef();
-      CellList localCells = system.storage->getLocalCells();
+      storage::Storage& storage = *getSystemRef().storage;
 
       LOG4ESPP_INFO(theLogger, "init forces for real + ghost particles");
 
-      for(CellListIterator cit(localCells); !cit.isDone(); ++cit) {
-        cit->force() = 0.0;
-        cit->drift() = 0.0;   // Can in principle be commented, when drift is not used.
-      }
+      storage.getCellTasks().forEachCell(storage.getLocalCells(), [](Cell& cell, long) {
+        for (ParticleList::iterator it = cell.particles.begin(),
+               end = cell.particles.end(); it != end; ++it) {
+          it->force() = 0.0;
+          it->drift() = 0.0;   // Can in principle be commented, when drift is not used.
+        }
+      });
     }
 
     void VelocityVerlet::printForces(bool withGhosts)
@@ -460,6 +718,10 @@ namespace espressopp {
         ("integrator_VelocityVerlet", init< shared_ptr<System> >())
         .def("getTimers", &wrapGetTimers)
         .def("resetTimers", &VelocityVerlet::resetTimers)
+        .add_property("overlapComm", &VelocityVerlet::getOverlapComm, &VelocityVerlet::setOverlapComm)
+        .add_property("pairDisplacementResort", &VelocityVerlet::getPairDisplacementResort,
+                      &VelocityVerlet::setPairDisplacementResort)
+        .add_property("resorts", &VelocityVerlet::getNumResorts)
         ;
     }
   }
@@ -30,6 +30,7 @@
 #include "MDIntegrator.hpp"
 #include "esutil/Timer.hpp"
 #include <boost/signals2.hpp>
+#include <vector>
 
 namespace espressopp {
   namespace integrator {
@@ -51,6 +52,30 @@ namespace espressopp {
         /** Clean up all timers.*/
         void resetTimers();
 
+        /** Accumulated time spent in the force loops since the last resetTimers(). */
+        real getForceTime() const { return timeForce; }
+
+        /** Overlap the ghost update with the forces between real
+            particles (see Storage::updateGhostsBegin()). */
+        void setOverlapComm(bool _overlapComm) { overlapComm = _overlapComm; }
+        bool getOverlapComm() const { return overlapComm; }
+
+        /** Decide about the resort from the displacements of the
+            particles since the last resort instead of the sum of the
+            largest moves per step: the neighbor lists stay valid as long
+            as d_i + d_j < skin for all particles i, j, which holds while
+            the two largest displacements add up to less than the skin.
+            Unlike the per step sum this does not grow when different
+            particles make the largest move in different steps. Only
+            the criterion changes, a resort still rebuilds the lists
+            completely. */
+        void setPairDisplacementResort(bool _pairDisplacementResort);
+        bool getPairDisplacementResort() const { return pairDisplacementResort; }
+
+        /** Number of resorts (and neighbor list rebuilds) in the runs
+            since the last resetTimers(). */
+        int getNumResorts() const { return nResortsTotal; }
+
         /** Register this class so it can be used from Python. */
         static void registerPython();
 
@@ -60,6 +85,31 @@ namespace espressopp {
 
         real maxCut;
 
+        bool overlapComm;  //!< compute interior forces during the ghost update
+
+        bool pairDisplacementResort;  //!< resort from the sum of the two largest displacements since the last resort
+        std::vector<Real3D> refPos;  //!< real positions at the last resort, in cell order
+        boost::signals2::connection connRefPos;
+        int nResortsTotal;
+
+        std::vector<real> cellMaxSqDist;  //!< largest move per real cell in integrate1
+
+        bool interactionObservables;  //!< the interactions accumulate or keep observables
+        boost::signals2::connection connObservables;
+
+        /** Ask the interactions to accumulate the observables which in
+            the next force pass, or withdraw the request (which = 0). */
+        void setInteractionObservables(int which);
+        /** Drop the observables the interactions have kept. */
+        void invalidateInteractionObservables();
+
+        /** Save the real positions after the particles have changed. */
+        void saveReferencePositions();
+
+        /** Upper bound of d_i + d_j over all pairs of particles, from the
+            displacements since the last resort. */
+        real maxPairDisplacement();
+
         /** Method updates particle positions and velocities.
             \return maximal square distance a particle has moved.
         */
@@ -73,6 +123,8 @@ namespace espressopp {
 
         void calcForces();
 
+        void updateForcesOverlapped();
+
         void printPositions(bool withGhost);
 
         void printForces(bool withGhost);
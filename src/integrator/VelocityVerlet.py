@@ -29,6 +29,39 @@ espressopp.integrator.VelocityVerlet
 
 		:param system: 
 		:type system: 
+
+.. attribute:: overlapComm
+
+		If True, the ghost positions are communicated while the forces
+		between real particles are computed. The interior pairs are
+		computed first, the pairs involving ghosts after the update has
+		completed. Only a storage.DomainDecompositionNonBlocking actually
+		overlaps the communication; other storages update the ghosts
+		up front. Extensions connected to aftInitF run after the
+		interior forces and must therefore only add forces.
+		Default is False.
+
+.. attribute:: pairDisplacementResort
+
+		If True, the particles are resorted (and the neighbor lists
+		rebuilt) only when the two particles that moved farthest since
+		the last resort together moved more than the skin. Otherwise
+		the largest moves of every step are summed up and compared with
+		half the skin, which grows faster when different particles make
+		the largest move in different steps. This only changes when
+		the resorts happen, every resort still rebuilds the neighbor
+		lists completely. The displacements are tracked per particle,
+		which costs one pass over the positions per step.
+		Default is False.
+
+		>>> integrator.pairDisplacementResort = True
+		>>> integrator.run(1000)
+		>>> print integrator.resorts, vl.builds, vl.pairsChecked
+
+.. attribute:: resorts
+
+		Number of resorts in the runs since the last resetTimers(),
+		read only. The time spent is the timeResort entry of getTimers().
 """
 from espressopp.esutil import cxxinit
 from espressopp import pmi
@@ -47,6 +80,7 @@ if pmi.isController :
         __metaclass__ = pmi.Proxy
         pmiproxydefs = dict(
           cls =  'espressopp.integrator.VelocityVerletLocal',
+          pmiproperty = ['overlapComm', 'pairDisplacementResort', 'resorts'],
           pmicall = ['resetTimers'],
           pmiinvoke = ['getTimers']
         )
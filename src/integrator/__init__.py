@@ -56,6 +56,8 @@ from espressopp.integrator.ExtForce import *
 from espressopp.integrator.ExtVelocity import *
 from espressopp.integrator.CapForce import *
 from espressopp.integrator.ExtAnalyze import *
+from espressopp.integrator.LoadBalancer import *
+from espressopp.integrator.SkinTuner import *
 from espressopp.integrator.Settle import *
 from espressopp.integrator.Rattle import *
 from espressopp.integrator.VelocityVerletOnRadius import *
@@ -56,6 +56,8 @@
 #include "ExtVelocity.hpp"
 #include "CapForce.hpp"
 #include "ExtAnalyze.hpp"
+#include "LoadBalancer.hpp"
+#include "SkinTuner.hpp"
 #include "Settle.hpp"
 #include "Rattle.hpp"
 #include "VelocityVerletOnRadius.hpp"
@@ -109,6 +111,8 @@ namespace espressopp {
       ExtVelocity::registerPython();
       CapForce::registerPython();
       ExtAnalyze::registerPython();
+      LoadBalancer::registerPython();
+      SkinTuner::registerPython();
       Settle::registerPython();
       Rattle::registerPython();
       VelocityVerletOnRadius::registerPython();
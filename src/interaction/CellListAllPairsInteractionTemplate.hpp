@@ -30,6 +30,7 @@
 #include "storage/Storage.hpp"
 #include "esutil/Array2D.hpp"
 #include "iterator/CellListAllPairsIterator.hpp"
+#include "esutil/Threads.hpp"
 
 namespace espressopp {
   namespace interaction {
@@ -61,7 +62,7 @@ namespace espressopp {
       }
 
       Potential &getPotential(int type1, int type2) {
-        return potentialArray(type1, type2);
+        return potentialArray.at(type1, type2);
       }
 
       virtual void addForces();
@@ -78,6 +79,9 @@ namespace espressopp {
       virtual int bondType() { return Nonbonded; }
 
     protected:
+      void addForcesThreaded();
+      void addPairForce(Particle &p1, Particle &p2);
+
       int ntypes;
       esutil::Array2D< Potential, esutil::enlarge > potentialArray;
       shared_ptr< storage::Storage > storage;
@@ -91,10 +95,15 @@ namespace espressopp {
     addForces() {
       LOG4ESPP_INFO(theLogger, "add forces computed for all pairs in the cell lists");
 
+      if (esutil::Threads::getNumThreads() > 1) {
+        addForcesThreaded();
+        return;
+      }
+
       for (iterator::CellListAllPairsIterator it(storage->getRealCells()); it.isValid(); ++it) {
         Particle &p1 = *it->first;
         Particle &p2 = *it->second;
-        const Potential &potential = getPotential(p1.type(), p2.type());
+        const Potential &potential = potentialArray.get(p1.type(), p2.type());
 
         Real3D force(0.0, 0.0, 0.0);
         if(potential._computeForce(force, p1, p2)) {
@@ -104,6 +113,45 @@ namespace espressopp {
       }
     }
 
+    template < typename _Potential > inline void
+    CellListAllPairsInteractionTemplate < _Potential >::
+    addForcesThreaded() {
+      // the pairs of CellListAllPairsIterator, cell by cell; cells of one
+      // colour share no particles, so Newton's third law is applied
+      // directly. The order of the sums is fixed by the colouring.
+      storage->getCellTasks().forEachColouredCell([this](Cell& cell, long) {
+        ParticleList &particles = cell.particles;
+        const size_t n = particles.size();
+        for (size_t i = 0; i < n; ++i) {
+          Particle &p1 = particles[i];
+          for (size_t j = i + 1; j < n; ++j) {
+            addPairForce(p1, particles[j]);
+          }
+        }
+        for (NeighborCellList::Iterator ncit(cell.neighborCells); ncit.isValid(); ++ncit) {
+          if (ncit->useForAllPairs) continue;
+          ParticleList &neighbors = ncit->cell->particles;
+          for (size_t i = 0; i < n; ++i) {
+            Particle &p1 = particles[i];
+            for (size_t j = 0; j < neighbors.size(); ++j) {
+              addPairForce(p1, neighbors[j]);
+            }
+          }
+        }
+      });
+    }
+
+    template < typename _Potential > inline void
+    CellListAllPairsInteractionTemplate < _Potential >::
+    addPairForce(Particle &p1, Particle &p2) {
+      const Potential &potential = potentialArray.get(p1.type(), p2.type());
+      Real3D force(0.0, 0.0, 0.0);
+      if (potential._computeForce(force, p1, p2)) {
+        p1.force() += force;
+        p2.force() -= force;
+      }
+    }
+
     template < typename _Potential > inline real
     CellListAllPairsInteractionTemplate < _Potential >::
     computeEnergy() {
@@ -113,7 +161,7 @@ namespace espressopp {
       for (iterator::CellListAllPairsIterator it(storage->getRealCells()); it.isValid(); ++it) {
         const Particle &p1 = *it->first;
         const Particle &p2 = *it->second;
-        const Potential &potential = getPotential(p1.type(), p2.type());
+        const Potential &potential = potentialArray.get(p1.type(), p2.type());
         e += potential._computeEnergy(p1, p2);
       }
 
@@ -163,7 +211,7 @@ namespace espressopp {
         Particle &p2 = *it->second;
         int type1 = p1.type();
         int type2 = p2.type();
-        const Potential &potential = getPotential(type1, type2);
+        const Potential &potential = potentialArray.get(type1, type2);
 
         Real3D force(0.0, 0.0, 0.0);
         if(potential._computeForce(force, p1, p2)) { 
@@ -188,7 +236,7 @@ namespace espressopp {
            it.isValid(); ++it) {
         const Particle &p1 = *it->first;
         const Particle &p2 = *it->second;
-        const Potential &potential = getPotential(p1.type(), p2.type());
+        const Potential &potential = potentialArray.get(p1.type(), p2.type());
 
         Real3D force(0.0, 0.0, 0.0);
         if(potential._computeForce(force, p1, p2)) {
@@ -219,7 +267,7 @@ namespace espressopp {
         
         if(  (p1pos[2]>=z && p2pos[2]<=z) ||
              (p1pos[2]<=z && p2pos[2]>=z) ){
-          const Potential &potential = getPotential(p1.type(), p2.type());
+          const Potential &potential = potentialArray.get(p1.type(), p2.type());
 
           Real3D force(0.0, 0.0, 0.0);
           if(potential._computeForce(force, p1, p2)) {
@@ -259,7 +307,7 @@ namespace espressopp {
         int maxpos = std::max(position1, position2);
         int minpos = std::min(position1, position2); 
         
-        const Potential &potential = getPotential(p1.type(), p2.type());
+        const Potential &potential = potentialArray.get(p1.type(), p2.type());
 
         Real3D force(0.0, 0.0, 0.0);
         Tensor ww;
@@ -294,7 +342,7 @@ namespace espressopp {
       real cutoff = 0.0;
       for(int i = 0; i < ntypes; i++) {
         for(int j = 0; j < ntypes; j++) {
-          cutoff = std::max(cutoff, getPotential(i, j).getCutoff());
+          cutoff = std::max(cutoff, potentialArray.get(i, j).getCutoff());
         }
       }
       return cutoff;
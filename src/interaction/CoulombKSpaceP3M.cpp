@@ -40,7 +40,9 @@ namespace espressopp {
                      real _rcut,
                      int _interpolation
               ): system(_system), C_pref(_coulomb_prefactor), alpha(_alpha),
-                    M(_M), P(_P), rc(_rcut), interpolation(_interpolation){
+                    M(_M), P(_P), rc(_rcut), interpolation(_interpolation),
+                    fftPlanFlags(FFTW_MEASURE), fftWisdomFile(""),
+                    brickValid(false){
       
       // predefined assigned function coefficients
       af_coef[1][0][0] = 1.0;
@@ -193,9 +195,6 @@ namespace espressopp {
       
       getParticleNumber();
       preset();
-      
-      // first initialize
-      initialize();
         
       // This function calculates the square of all particle charges. It should be called ones,
       // if the total number of particles doesn't change.
@@ -209,19 +208,17 @@ namespace espressopp {
       // make a connection to storage in order to get number of particles
       connectionGetParticleNumber = system->storage->onParticlesChanged.
               connect(boost::bind(&CoulombKSpaceP3M::getParticleNumber, this));
+      connectionInvalidateBrick = system->storage->onParticlesChanged.
+              connect(boost::bind(&CoulombKSpaceP3M::invalidateBrick, this));
       
       // sign a signal in order not to recalculate common part twice
       //recalcCommonPart = system.
     }
     
     CoulombKSpaceP3M::~CoulombKSpaceP3M(){
-      /*
-      delete [] sum;
-      delete [] totsum;
-      sum = NULL;
-      totsum = NULL;
-      */
-      clean_fftw();
+      connectionRecalcKVec.disconnect();
+      connectionGetParticleNumber.disconnect();
+      connectionInvalidateBrick.disconnect();
     }
 
     //////////////////////////////////////////////////
@@ -234,7 +231,11 @@ namespace espressopp {
       ("interaction_CoulombKSpaceP3M", 
               init< shared_ptr<System>, real, real, Int3D, int, real, int >() )
     	.add_property("prefactor", &CoulombKSpaceP3M::getPrefactor, 
-                                   &CoulombKSpaceP3M::setPrefactor);
+                                   &CoulombKSpaceP3M::setPrefactor)
+        .add_property("fft_planning", &CoulombKSpaceP3M::getFFTPlanning,
+                                      &CoulombKSpaceP3M::setFFTPlanning)
+        .add_property("wisdom_file", &CoulombKSpaceP3M::getWisdomFile,
+                                     &CoulombKSpaceP3M::setWisdomFile);
     	//.add_property("alpha", &CoulombKSpaceP3M::getAlpha, &CoulombKSpaceP3M::setAlpha)
     	//.add_property("kmax", &CoulombKSpaceP3M::getKMax, &CoulombKSpaceP3M::setKMax)
       //;
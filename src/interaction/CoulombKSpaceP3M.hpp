@@ -31,6 +31,7 @@
 
 #include "mpi.hpp"
 #include "Potential.hpp"
+#include "esutil/ParallelFFT.hpp"
 #include "CellListAllParticlesInteractionTemplate.hpp"
 #include "iterator/CellListIterator.hpp"
 #include "esutil/Error.hpp"
@@ -60,10 +61,14 @@ namespace espressopp {
      * 
      *  The code is based on M.Deserno's work. Reference in literature
      *  M. Deserno, C.Holm, J.Chem. Phys, 109[18] (1998) 7694
+     *
+     *  The mesh is distributed: every CPU assigns the charges of its real
+     *  particles to a local brick of the mesh (its domain plus the stencil
+     *  halo), the bricks are summed into x-slabs and transformed by a slab
+     *  decomposed r2c FFT (see esutil::ParallelFFT). The influence function
+     *  is only stored for the local part of the spectrum.
      */
     
-    // TODO this version is still under development. not parallel. doesn't work for several
-    // CPUs
     // TODO should be optimized (force, energy and virial calculate the same stuff)
     
     class CoulombKSpaceP3M : public PotentialTemplate< CoulombKSpaceP3M > {
@@ -93,20 +98,29 @@ namespace espressopp {
       
       vector< vector<real> > d_op; 
       
-      //vector< vector< vector<real> > >gf; // influence function
-      vector<real> gf; // influence function
-      
-      //vector< vector< vector< dcomplex > > > QQQ;
-      vector<  dcomplex > QQQ;
-      
-      vector<vector<dcomplex> > phi;
-        
-      // reference points in the lattice, needed for the charge assignment
-      vector<Int3D> g_ca;
-      // mesh contributions of the charged particles
-      vector< vector< real > > q_l;
-      
-      vector< vector< vector< int > > > map_indx;
+      // distributed mesh and its FFT
+      shared_ptr< esutil::ParallelFFT > fft;
+      unsigned fftPlanFlags;     // FFTW planner rigor
+      std::string fftWisdomFile; // FFTW wisdom cache, none if empty
+
+      // influence function of the local part of the spectrum,
+      // in the order of ParallelFFT::kspace(kyl, kz, kx)
+      vector<real> gf;
+
+      // transformed charge mesh of the last common_part() call
+      vector< dcomplex > Qk;
+
+      // charges and field components on the local brick of the mesh
+      vector<real> chargeBrick;
+      vector<real> fieldBrick[3];
+
+      // the brick layout of ParallelFFT is up to date with the decomposition
+      bool brickValid;
+
+      // charge assignment of the real particles in cell order: first stencil
+      // point relative to the brick and P weights per direction
+      vector<Int3D> caBase;
+      vector<real> caWeight;
       
       int nParticles;  // number of particles in system
       Real3D sysL;     // system size
@@ -114,11 +128,6 @@ namespace espressopp {
       
       real af_coef[8][7][7]; // matrix of predefined assigned function coefficients
       
-      // fftw elements
-      fftw_complex *in_array;
-      fftw_plan plan;
-      int MM[3]; // auxiliary array for plan generation
-      
       //real oddeven1, oddeven2; // supporting variables odd/even interpolation order
     public:
       static void registerPython();
@@ -135,28 +144,35 @@ namespace espressopp {
       ~CoulombKSpaceP3M();
       
       // 
+      // (re)initializes everything that depends on the parameters or the box
       void preset(){
         sysL = system -> bc -> getBoxL();
+        brickValid = false;
         MMM = M[0] * M[1] * M[2];
-        for(int i=0; i<3; i++) MM[i] = M[i];
-        
-        // map xpos, ypos and zpos to index = zpos + M[2] * (ypos + M[1] * xpos)
-        map_indx = vector< vector< vector<int> > > (M[0],
-                           vector< vector<int> >   (M[1],
-                                   vector<int>     (M[2], 0) ));
-        for(int i=0; i<M[0]; i++){
-          int mi = M[1] * i;
-          for(int j=0; j<M[1]; j++){
-            int mj = M[2] * (j + mi);
-            for(int k=0; k<M[2]; k++){
-              map_indx[i][j][k] = k + mj;
-            }
-          }
-        }
         
         precalc_interp_caf = vector< vector<real> > (P, vector<real>(2*interpolation+1, 0.0) );
         precalc_interpol_charge_assignment_f();
         
+        // the FFT plans only depend on the mesh, keep them otherwise
+        if (!fft || fft->getMesh() != M || fft->getPlanFlags() != fftPlanFlags
+            || fft->getWisdomFile() != fftWisdomFile) {
+          fft.reset();
+          fft = shared_ptr< esutil::ParallelFFT >(
+                  new esutil::ParallelFFT(system->comm, M, fftPlanFlags, fftWisdomFile));
+        }
+        
+        mesh_shift = vector< vector<real> >(3, vector<real>() );
+        d_op = vector< vector<real> >(3, vector<real>() );
+        for(int i=0;i<3;i++){
+          mesh_shift[i] = vector<real>(M[i], 0.0);
+          d_op[i] = vector<real>(M[i], 0.0);
+        }
+        
+        calc_m_shift();
+        
+        calc_differential_operator();
+        
+        calc_opt_influence_function();
       }
       
 /////////////////////////////////////////////////////////////////////////////////////////
@@ -171,6 +187,18 @@ namespace espressopp {
         preset();
       }
       real getAlpha() const { return alpha; }
+      void setFFTPlanning(std::string rigor) {
+        fftPlanFlags = esutil::ParallelFFT::planFlagsFromString(rigor);
+        preset();
+      }
+      std::string getFFTPlanning() const {
+        return esutil::ParallelFFT::planFlagsToString(fftPlanFlags);
+      }
+      void setWisdomFile(std::string file) {
+        fftWisdomFile = file;
+        preset();
+      }
+      std::string getWisdomFile() const { return fftWisdomFile; }
       void setMesh(Int3D _M) {
       	M = _M;
         preset();
@@ -193,44 +221,14 @@ namespace espressopp {
       int getInterpolation() const { return interpolation; }
 /////////////////////////////////////////////////////////////////////////////////////////
 
-      void initialize(){
-        
-        set_fftw_array();
-        
-        mesh_shift = vector< vector<real> >(3, vector<real>() );
-        d_op = vector< vector<real> >(3, vector<real>() );
-        for(int i=0;i<3;i++){
-          mesh_shift[i] = vector<real>(M[i], 0.0);
-          d_op[i] = vector<real>(M[i], 0.0);
-        }
-        
-        calc_m_shift();
-        
-        calc_differential_operator();
-        
-        gf = vector<real>(MMM, 0.0);
-        
-        calc_opt_influence_function();
-        
-        // -----------------------------------------
-        // charge assignment
-        QQQ = vector<dcomplex>(MMM, 0.0);
-        
-        
-        // TODO check double use in common part
-        g_ca = vector<Int3D>(0, Int3D(0) );
-
-        q_l = vector< vector<real> > (nParticles, vector<real>(MMM, 0.0) );
-        
-        // force specific
-        phi = vector<vector<dcomplex> > (3, vector<dcomplex> (MMM, dcomplex(0.0) ));
-      }
-      
       // get the current particle number on the current node
       // and set the auxiliary arrays
       void getParticleNumber() {
         nParticles = system->storage->getNRealParticles();
       }
+
+      // the local boxes have changed, renew the brick layout at the next use
+      void invalidateBrick() { brickValid = false; }
       
       // it counts the squared charges over all system. It is used for self energy calculations
       void count_charges(CellList realCells){
@@ -273,25 +271,24 @@ namespace espressopp {
         }
       }
 
-      void create_mesh(CellList realCells){
-      }
-      void gen_mesh(CellList realCells){
-      }
-      void assign_charge_for_single_particle(real q, Real3D particle_pos){
-      }
-      
-      // calculates the optimal influence function
+      // calculates the optimal influence function for the local part of the spectrum
       void calc_opt_influence_function(){
         
         real coef  = 2.0 * MMM / (sysL[0]*sysL[1]);
 
+        int ky0 = fft->getLocalKY0();
+        int nky = fft->getLocalNKY();
+        int nkz = fft->getNKZ();
+        gf = vector<real>(fft->getLocalKSize(), 0.0);
+
         real denom;
         Real3D nom, D;
         Int3D i;
-        for ( i[0] = 0; i[0] < M[0]; i[0]++){
-          for ( i[1] = 0; i[1] < M[1]; i[1]++){
-            for ( i[2] = 0; i[2] < M[2]; i[2]++){
-              int indx = map_indx[i[0]][i[1]][i[2]];
+        long indx = 0;
+        for (int kyl = 0; kyl < nky; kyl++){
+          i[1] = ky0 + kyl;
+          for ( i[2] = 0; i[2] < nkz; i[2]++){
+            for ( i[0] = 0; i[0] < M[0]; i[0]++, indx++){
               if ( i == Int3D(0) )
                 gf[ indx ] = 0.0;
               else{
@@ -410,32 +407,30 @@ namespace espressopp {
         return out;
       }
       
-      void set_fftw_array(){
-        in_array = (fftw_complex*) fftw_malloc( MMM * sizeof(fftw_complex));
-      }
-      void set_plan_frw(){
-        plan = fftw_plan_dft(3, MM, in_array, in_array, FFTW_FORWARD, FFTW_ESTIMATE);
-      }
-      void set_plan_bcw(){
-        plan = fftw_plan_dft(3, MM, in_array, in_array, FFTW_BACKWARD, FFTW_ESTIMATE);
-      }
-      void clean_fftw(){
-        fftw_destroy_plan(plan);
-        in_array = NULL;
-        fftw_free(in_array);
-      }
-      
       
       real _computeEnergy(CellList realCells){
         
-        common_part(realCells, 1);
+        common_part(realCells);
         
-        real energy = 0.0;
+        // only kz = 0 .. M[2]/2 is stored, the other half follows from |Q(-k)| = |Q(k)|
+        int nky = fft->getLocalNKY();
+        int nkz = fft->getNKZ();
+        bool evenZ = (M[2] % 2 == 0);
         
-        for (int i=0; i<MMM; i++){
-          energy += gf[i] * norm( QQQ[i] );
+        real node_energy = 0.0;
+        long indx = 0;
+        for (int kyl = 0; kyl < nky; kyl++){
+          for (int kz = 0; kz < nkz; kz++){
+            real w = (kz == 0 || (evenZ && kz == M[2]/2)) ? 1.0 : 2.0;
+            for (int kx = 0; kx < M[0]; kx++, indx++){
+              node_energy += w * gf[indx] * norm( Qk[indx] );
+            }
+          }
         }
         
+        real energy = 0.0;
+        mpi::all_reduce( *system -> comm, node_energy, energy, plus<real>() );
+        
         // TODO sysL[0]?? what about [1] and [2]?
         energy *= ( C_pref * sysL[0] / (4.0*MMM*M_PIl) );
 
@@ -446,13 +441,12 @@ namespace espressopp {
         return energy;
       }
       
-      // TODO get rid of iii at the end
-      void common_part(CellList realCells, int iii){
-        initialize();
+      // assigns the charges of the real particles to the mesh and transforms it
+      void common_part(CellList realCells){
         
         real _2interp = 2.0 * interpolation;
-        // TODO assignshift probably should be [3]
-        int assignshift = M[0]- floor((real)(P-1)/2.0);
+        // the stencil starts this many mesh points below the reference point
+        int assignshift = (P-1)/2;
         
         real  modadd1, modadd2;
         // odd and even interpolation order
@@ -463,104 +457,133 @@ namespace espressopp {
             { modadd1 = 0.0; modadd2 =  0.5;} break;
         }
 
-        g_ca.clear();
-        g_ca = vector<Int3D>(nParticles, Int3D(0) );
-        QQQ.clear();
-        QQQ = vector<dcomplex>(MMM, dcomplex(0.0));
+        // the brick covers the stencils of all particles that may be in this
+        // domain until the next decomposition ...
+        storage::Storage &storage = *system->storage;
+        Int3D lo, hi;
+        if (brickValid) {
+          lo = fft->getBrickLo();
+          hi = lo + fft->getBrickN();
+        } else {
+          real skin = system->getSkin();
+          Real3D left (storage.getLocalBoxXMin(), storage.getLocalBoxYMin(), storage.getLocalBoxZMin());
+          Real3D right(storage.getLocalBoxXMax(), storage.getLocalBoxYMax(), storage.getLocalBoxZMax());
+          for(int i=0; i<3; i++){
+            real scale = M[i] / sysL[i];
+            lo[i] = (int)floor((left[i] - skin) * scale + modadd1 + modadd2) - assignshift;
+            hi[i] = (int)floor((right[i] + skin) * scale + modadd1 + modadd2) - assignshift + P;
+          }
+        }
         
-        Int3D Gi, arg;
+        // ... and is extended if a particle is farther outside
+        Int3D needLo = lo, needHi = hi;
+        caBase.clear();
+        caWeight.clear();
         for(iterator::CellListIterator it(realCells); it.isValid(); ++it){
-          Particle &p = *it;
-          Real3D ppos = p.position();
+          Real3D ppos = it->position();
           
-          Real3D d1;
+          Int3D Gi, arg;
           for(int i=0; i<3; i++){
-            d1[i] = ppos[i] * M[i] / sysL[i] + modadd1;
+            real d1 = ppos[i] * M[i] / sysL[i] + modadd1;
+            Gi[i]  = (int)floor(d1 + modadd2) - assignshift;
+            arg[i] = (int)( (d1 - dround(d1) + 0.5)*_2interp );
+            needLo[i] = std::min(needLo[i], Gi[i]);
+            needHi[i] = std::max(needHi[i], Gi[i] + P);
           }
-          Gi  = Int3D(d1 + modadd2) + assignshift;
-          arg = Int3D( (d1 - dround(d1) + 0.5)*_2interp );
-
-          // specific for force !!!!!!!!
-          g_ca[p.id()] = Gi;
-          
-          // Calculate the mesh based charges
-          real T1,T2,T3;
+          caBase.push_back(Gi);
+          for(int i=0; i<3; i++){
+            for(int j=0; j<P; j++){
+              caWeight.push_back(precalc_interp_caf[j][arg[i]]);
+            }
+          }
+        }
+        
+        // the layout of the bricks is exchanged once per decomposition, or
+        // again by all CPUs if a particle left the brick of one of them
+        bool nodeRenew = !brickValid || needLo != lo || needHi != hi;
+        bool renew;
+        mpi::all_reduce(*system->comm, nodeRenew, renew, std::logical_or<bool>());
+        if (renew) {
+          lo = needLo;
+          hi = needHi;
+          fft->setBrick(lo, hi - lo);
+          brickValid = true;
+        }
+        
+        // Calculate the mesh based charges
+        chargeBrick.assign(fft->getBrickSize(), 0.0);
+        long n = 0;
+        for(iterator::CellListIterator it(realCells); it.isValid(); ++it, ++n){
+          caBase[n] -= lo;
+          const Int3D &b = caBase[n];
+          const real *w = &caWeight[3*P*n];
+          real T1,T2;
           for (int i = 0; i < P; i++) {
-            int xpos = (Gi[0] + i) % M[0];
-            T1 = p.q() * precalc_interp_caf[i][arg[0]];
+            T1 = it->q() * w[i];
             for (int j = 0; j < P; j++) {
-              int ypos = (Gi[1] + j) % M[1];
-              T2 = T1 * precalc_interp_caf[j][arg[1]];
+              T2 = T1 * w[P + j];
+              long indx = fft->brickIndex(b[0] + i, b[1] + j, b[2]);
               for (int k = 0; k < P; k++) {
-                int zpos = (Gi[2] + k) % M[2];
-                T3 = T2 * precalc_interp_caf[k][arg[2]];
-                
-                int indx = map_indx[xpos][ypos][zpos];
-                
-                // specific for force !!!!!!!!
-                q_l[p.id()][indx] = T3;
-                
-                QQQ[indx] += dcomplex(T3, 0.0);
+                chargeBrick[indx + k] += T2 * w[2*P + k];
               }
             }
           }
-
         }
- 
-        in_array = reinterpret_cast<fftw_complex*>( &QQQ[0] );
-        set_plan_frw();
-        fftw_execute(plan);
+        
+        fft->brickToSlab(chargeBrick);
+        fft->forward();
+        Qk.assign(fft->getKSpace(), fft->getKSpace() + fft->getLocalKSize());
       }
 
       // @TODO this function could be void, 
       bool _computeForce(CellList realCells){
 
-        common_part(realCells, 0);
+        common_part(realCells);
         
-        // Calculate the supporting arrays phi_?_??:
-        Int3D i;
-        for ( i[0]=0; i[0]<M[0]; i[0]++){
-          for ( i[1]=0; i[1]<M[1]; i[1]++){
-            for ( i[2]=0; i[2]<M[2]; i[2]++) {  
-              int indx = map_indx[i[0]][i[1]][i[2]];
-              dcomplex phi_aux = gf[indx] * swap_complex( conj( QQQ[indx] ) );
-              
-              for (int ii=0; ii<3; ii++) phi[ii][indx] = d_op[ii][i[ii]] * phi_aux;
+        // Calculate the supporting arrays phi_? and transform them back
+        int ky0 = fft->getLocalKY0();
+        int nky = fft->getLocalNKY();
+        int nkz = fft->getNKZ();
+        for(int l=0; l<3; l++){
+          dcomplex *phi = fft->getKSpace();
+          Int3D i;
+          long indx = 0;
+          for (int kyl = 0; kyl < nky; kyl++){
+            i[1] = ky0 + kyl;
+            for ( i[2] = 0; i[2] < nkz; i[2]++){
+              for ( i[0] = 0; i[0] < M[0]; i[0]++, indx++){
+                phi[indx] = d_op[l][i[l]] * gf[indx] * swap_complex( conj( Qk[indx] ) );
+              }
             }
           }
-        }
-
-        for(int l=0; l<3; l++){
-          in_array = reinterpret_cast<fftw_complex*>( &phi[l][0] );
-          set_plan_bcw();
-          fftw_execute(plan);
+          fft->backward();
+          fft->slabToBrick(fieldBrick[l]);
         }
         
         real C_MMM_inv = C_pref / (real)MMM;
-        for(iterator::CellListIterator it(realCells); it.isValid(); ++it){
+        long n = 0;
+        for(iterator::CellListIterator it(realCells); it.isValid(); ++it, ++n){
           Particle &p = *it;
           
-          int iii = p.id();
+          const Int3D &b = caBase[n];
+          const real *w = &caWeight[3*P*n];
           Real3D ff(0.0);
           for (int i = 0; i < P; i++) {
-            int xpos = (g_ca[iii][0] + i) % M[0];
             for (int j = 0; j < P; j++) {
-              int ypos = (g_ca[iii][1] + j) % M[1];
+              real T2 = w[i] * w[P + j];
+              long indx = fft->brickIndex(b[0] + i, b[1] + j, b[2]);
               for (int k = 0; k < P; k++) {
-                int zpos = (g_ca[iii][2] + k) % M[2];
-                
-                int indx = map_indx[xpos][ypos][zpos];
-                
-                Real3D f_add( phi[0][indx].real(),
-                              phi[1][indx].real(),
-                              phi[2][indx].real());
-
-                ff += C_MMM_inv * q_l[iii][indx]  *  f_add ;
+                real T3 = T2 * w[2*P + k];
+                Real3D f_add( fieldBrick[0][indx + k],
+                              fieldBrick[1][indx + k],
+                              fieldBrick[2][indx + k]);
+
+                ff += T3 * f_add;
               }
             }
           }
 
-          p.force() -= ff;
+          p.force() -= C_MMM_inv * p.q() * ff;
         }
         
         // usual return from espressopp
@@ -722,6 +745,8 @@ namespace espressopp {
       boost::signals2::connection connectionRecalcKVec;
       // --||-- when the particle number is changed
       boost::signals2::connection connectionGetParticleNumber;
+      // make a connection to storage in order to renew the brick layout
+      boost::signals2::connection connectionInvalidateBrick;
       
       //  ???before force calculation???
       //boost::signals2::connection recalcCommonPart;
@@ -66,6 +66,20 @@ Definition:
     *   *ewaldK_pot.kmax*
 
         The property 'kmax' defines the cutoff in `K` space.
+
+    *   *ewaldK_pot.fft_planning*
+
+        The FFTW planner rigor, 'estimate', 'measure' (default), 'patient'
+        or 'exhaustive'. The plans are built once per mesh and reused in
+        every step, so the more expensive planners usually pay off.
+
+    *   *ewaldK_pot.wisdom_file*
+
+        File in which the FFTW wisdom is cached between runs (empty: no
+        cache). It is read before planning and rewritten afterwards.
+
+    >>> ewaldK_pot.fft_planning = 'patient'
+    >>> ewaldK_pot.wisdom_file = 'p3m.wisdom'
         
     The *interaction* is based on the all particles list. It needs the information from Storage_
     and `K` space part of potential.
@@ -149,7 +163,7 @@ if pmi.isController:
   class CoulombKSpaceP3M(Potential):
     pmiproxydefs = dict(
       cls = 'espressopp.interaction.CoulombKSpaceP3MLocal',
-      pmiproperty = ['prefactor']  #, 'alpha', 'kmax'
+      pmiproperty = ['prefactor', 'fft_planning', 'wisdom_file']  #, 'alpha', 'kmax'
     )
 
   class CellListCoulombKSpaceP3M(Interaction):
@@ -0,0 +1,415 @@
+/*
+  Copyright (C) 2016
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "python.hpp"
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include "CoulombKSpaceSPME.hpp"
+#include "CellListAllParticlesInteractionTemplate.hpp"
+#include "iterator/CellListIterator.hpp"
+#include "storage/Storage.hpp"
+#include "bc/BC.hpp"
+#include "esutil/Error.hpp"
+
+namespace espressopp {
+  namespace interaction {
+
+    typedef class CellListAllParticlesInteractionTemplate< CoulombKSpaceSPME >
+    CellListCoulombKSpaceSPME;
+
+    CoulombKSpaceSPME::CoulombKSpaceSPME(shared_ptr< System > _system,
+                                         real _prefactor,
+                                         real _alpha,
+                                         Int3D _M,
+                                         int _P)
+      : system(_system), prefactor(_prefactor), alpha(_alpha), M(_M), P(_P),
+        fftPlanFlags(FFTW_MEASURE), fftWisdomFile(""), brickValid(false),
+        sumQ(0.0), sumQ2(0.0)
+    {
+      preset();
+
+      connectionPreset = system->bc->onBoxDimensionsChanged.
+              connect(boost::bind(&CoulombKSpaceSPME::preset, this));
+      connectionInvalidateBrick = system->storage->onParticlesChanged.
+              connect(boost::bind(&CoulombKSpaceSPME::invalidateBrick, this));
+    }
+
+    CoulombKSpaceSPME::~CoulombKSpaceSPME() {
+      connectionPreset.disconnect();
+      connectionInvalidateBrick.disconnect();
+    }
+
+    void CoulombKSpaceSPME::preset() {
+      if (alpha <= 0.0)
+        throw std::invalid_argument("CoulombKSpaceSPME: alpha must be positive");
+      if (P < 3 || P > 12)
+        throw std::invalid_argument("CoulombKSpaceSPME: the spline order must be between 3 and 12");
+      for (int i = 0; i < 3; i++) {
+        if (M[i] < P) {
+          std::stringstream msg;
+          msg << "CoulombKSpaceSPME: the mesh (" << M << ") must not be smaller "
+              << "than the spline order " << P;
+          throw std::invalid_argument(msg.str());
+        }
+      }
+
+      sysL = system->bc->getBoxL();
+      brickValid = false;
+
+      // the FFT plans only depend on the mesh, keep them otherwise
+      if (!fft || fft->getMesh() != M || fft->getPlanFlags() != fftPlanFlags
+          || fft->getWisdomFile() != fftWisdomFile) {
+        fft.reset();
+        fft = shared_ptr< esutil::ParallelFFT >(
+                new esutil::ParallelFFT(system->comm, M, fftPlanFlags, fftWisdomFile));
+      }
+
+      for (int i = 0; i < 3; i++) calcBSplineModuli(i);
+      calcInfluenceFunction();
+    }
+
+    void CoulombKSpaceSPME::bspline(real w, int P, real *theta, real *dtheta) {
+      // order 2
+      theta[P-1] = 0.0;
+      theta[1] = w;
+      theta[0] = 1.0 - w;
+      // M_n(x) = (x M_{n-1}(x) + (n-x) M_{n-1}(x-1)) / (n-1)
+      for (int n = 3; n < P; n++) {
+        real div = 1.0 / (n - 1);
+        theta[n-1] = div * w * theta[n-2];
+        for (int j = 1; j < n-1; j++) {
+          theta[n-j-1] = div * ((w + j) * theta[n-j-2] + (n - j - w) * theta[n-j-1]);
+        }
+        theta[0] = div * (1.0 - w) * theta[0];
+      }
+      // dM_n(x)/dx = M_{n-1}(x) - M_{n-1}(x-1)
+      dtheta[0] = -theta[0];
+      for (int j = 1; j < P; j++) dtheta[j] = theta[j-1] - theta[j];
+      if (P > 2) {
+        real div = 1.0 / (P - 1);
+        theta[P-1] = div * w * theta[P-2];
+        for (int j = 1; j < P-1; j++) {
+          theta[P-j-1] = div * ((w + j) * theta[P-j-2] + (P - j - w) * theta[P-j-1]);
+        }
+        theta[0] = div * (1.0 - w) * theta[0];
+      }
+    }
+
+    void CoulombKSpaceSPME::calcBSplineModuli(int axis) {
+      const int K = M[axis];
+      std::vector< real > theta(P), dtheta(P);
+      // theta[j] = M_P(P-1-j), i.e. M_P(k+1) = theta[P-2-k]
+      bspline(0.0, P, &theta[0], &dtheta[0]);
+
+      std::vector< real > &mod = bsplineModuli[axis];
+      mod.assign(K, 0.0);
+      for (int m = 0; m < K; m++) {
+        real sc = 0.0, ss = 0.0;
+        for (int k = 0; k <= P-2; k++) {
+          real arg = 2.0 * M_PI * m * k / K;
+          sc += theta[P-2-k] * cos(arg);
+          ss += theta[P-2-k] * sin(arg);
+        }
+        mod[m] = sc*sc + ss*ss;
+      }
+      // odd orders have zeros at the Nyquist frequency, interpolate there
+      for (int m = 0; m < K; m++) {
+        if (mod[m] < 1e-7) mod[m] = 0.5 * (mod[(m-1+K) % K] + mod[(m+1) % K]);
+      }
+    }
+
+    void CoulombKSpaceSPME::calcInfluenceFunction() {
+      int ky0 = fft->getLocalKY0();
+      int nky = fft->getLocalNKY();
+      int nkz = fft->getNKZ();
+      real V = sysL[0] * sysL[1] * sysL[2];
+      real piAlpha2 = M_PI * M_PI / (alpha * alpha);
+
+      gf.assign(fft->getLocalKSize(), 0.0);
+      long indx = 0;
+      Int3D k;
+      for (int kyl = 0; kyl < nky; kyl++) {
+        k[1] = ky0 + kyl;
+        for (k[2] = 0; k[2] < nkz; k[2]++) {
+          for (k[0] = 0; k[0] < M[0]; k[0]++, indx++) {
+            if (k == Int3D(0)) continue;
+            real m2 = 0.0;
+            for (int l = 0; l < 3; l++) {
+              int ml = (k[l] <= M[l]/2) ? k[l] : k[l] - M[l];
+              m2 += (ml / sysL[l]) * (ml / sysL[l]);
+            }
+            real B = bsplineModuli[0][k[0]] * bsplineModuli[1][k[1]] * bsplineModuli[2][k[2]];
+            gf[indx] = exp(-piAlpha2 * m2) / (M_PI * V * m2 * B);
+          }
+        }
+      }
+    }
+
+    void CoulombKSpaceSPME::commonPart(CellList realCells) {
+      // the brick covers the stencils of all particles that may be in this
+      // domain until the next decomposition ...
+      storage::Storage &storage = *system->storage;
+      Int3D lo, hi;
+      if (brickValid) {
+        lo = fft->getBrickLo();
+        hi = lo + fft->getBrickN();
+      } else {
+        real skin = system->getSkin();
+        Real3D left (storage.getLocalBoxXMin(), storage.getLocalBoxYMin(), storage.getLocalBoxZMin());
+        Real3D right(storage.getLocalBoxXMax(), storage.getLocalBoxYMax(), storage.getLocalBoxZMax());
+        for (int i = 0; i < 3; i++) {
+          real scale = M[i] / sysL[i];
+          lo[i] = (int)floor((left[i] - skin) * scale) - P + 1;
+          hi[i] = (int)floor((right[i] + skin) * scale) + 1;
+        }
+      }
+
+      // ... and is extended if a particle is farther outside
+      Int3D needLo = lo, needHi = hi;
+      splBase.clear();
+      splWeight.clear();
+      splDeriv.clear();
+      std::vector< real > theta(P), dtheta(P);
+      // the charges are recounted in every call, they may have changed
+      // since the last decomposition
+      real nodeQ = 0.0, nodeQ2 = 0.0;
+      for (iterator::CellListIterator it(realCells); it.isValid(); ++it) {
+        const Real3D &pos = it->position();
+        nodeQ += it->q();
+        nodeQ2 += it->q() * it->q();
+        Int3D base;
+        for (int i = 0; i < 3; i++) {
+          real u = pos[i] * M[i] / sysL[i];
+          real fl = floor(u);
+          base[i] = (int)fl - P + 1;
+          needLo[i] = std::min(needLo[i], base[i]);
+          needHi[i] = std::max(needHi[i], base[i] + P);
+          bspline(u - fl, P, &theta[0], &dtheta[0]);
+          splWeight.insert(splWeight.end(), theta.begin(), theta.end());
+          splDeriv.insert(splDeriv.end(), dtheta.begin(), dtheta.end());
+        }
+        splBase.push_back(base);
+      }
+
+      // the layout of the bricks is exchanged once per decomposition, or
+      // again by all CPUs if a particle left the brick of one of them;
+      // the sums of the charges travel in the same reduction
+      bool nodeRenew = !brickValid || needLo != lo || needHi != hi;
+      real node[3] = {nodeRenew ? 1.0 : 0.0, nodeQ, nodeQ2};
+      real sum[3];
+      mpi::all_reduce(*system->comm, node, 3, sum, std::plus< real >());
+      sumQ = sum[1];
+      sumQ2 = sum[2];
+      if (sum[0] > 0.0) {
+        lo = needLo;
+        hi = needHi;
+        fft->setBrick(lo, hi - lo);
+        brickValid = true;
+      }
+
+      chargeBrick.assign(fft->getBrickSize(), 0.0);
+      long n = 0;
+      for (iterator::CellListIterator it(realCells); it.isValid(); ++it, ++n) {
+        splBase[n] -= lo;
+        const Int3D &b = splBase[n];
+        const real *w = &splWeight[3*P*n];
+        for (int i = 0; i < P; i++) {
+          real T1 = it->q() * w[i];
+          for (int j = 0; j < P; j++) {
+            real T2 = T1 * w[P + j];
+            long indx = fft->brickIndex(b[0] + i, b[1] + j, b[2]);
+            for (int k = 0; k < P; k++) {
+              chargeBrick[indx + k] += T2 * w[2*P + k];
+            }
+          }
+        }
+      }
+
+      fft->brickToSlab(chargeBrick);
+      fft->forward();
+      Qk.assign(fft->getKSpace(), fft->getKSpace() + fft->getLocalKSize());
+    }
+
+    real CoulombKSpaceSPME::_computeEnergy(CellList realCells) {
+      commonPart(realCells);
+
+      // only kz = 0 .. M[2]/2 is stored, the other half follows from |Q(-k)| = |Q(k)|
+      int nky = fft->getLocalNKY();
+      int nkz = fft->getNKZ();
+      bool evenZ = (M[2] % 2 == 0);
+
+      real node_energy = 0.0;
+      long indx = 0;
+      for (int kyl = 0; kyl < nky; kyl++) {
+        for (int kz = 0; kz < nkz; kz++) {
+          real w = (kz == 0 || (evenZ && kz == M[2]/2)) ? 1.0 : 2.0;
+          for (int kx = 0; kx < M[0]; kx++, indx++) {
+            node_energy += w * gf[indx] * norm(Qk[indx]);
+          }
+        }
+      }
+
+      real energy = 0.0;
+      mpi::all_reduce(*system->comm, node_energy, energy, std::plus< real >());
+
+      real V = sysL[0] * sysL[1] * sysL[2];
+      // self energy and net charge correction
+      return prefactor * (0.5 * energy - sumQ2 * alpha / sqrt(M_PI)
+                          - sumQ * sumQ * M_PI / (2.0 * V * alpha * alpha));
+    }
+
+    bool CoulombKSpaceSPME::_computeForce(CellList realCells) {
+      commonPart(realCells);
+
+      // the potential on the mesh is the convolution of the charges with
+      // the influence function
+      dcomplex *phi = fft->getKSpace();
+      for (long indx = 0; indx < (long)gf.size(); indx++) {
+        phi[indx] = gf[indx] * Qk[indx];
+      }
+      fft->backward();
+      fft->slabToBrick(potentialBrick);
+
+      // F = -dE/dr, with dQ/dr from the spline derivatives
+      Real3D scale(M[0] / sysL[0], M[1] / sysL[1], M[2] / sysL[2]);
+      long n = 0;
+      for (iterator::CellListIterator it(realCells); it.isValid(); ++it, ++n) {
+        Particle &p = *it;
+        const Int3D &b = splBase[n];
+        const real *w = &splWeight[3*P*n];
+        const real *dw = &splDeriv[3*P*n];
+        Real3D ff(0.0);
+        for (int i = 0; i < P; i++) {
+          for (int j = 0; j < P; j++) {
+            long indx = fft->brickIndex(b[0] + i, b[1] + j, b[2]);
+            for (int k = 0; k < P; k++) {
+              real pot = potentialBrick[indx + k];
+              ff[0] += dw[i] * w[P + j] * w[2*P + k] * pot;
+              ff[1] += w[i] * dw[P + j] * w[2*P + k] * pot;
+              ff[2] += w[i] * w[P + j] * dw[2*P + k] * pot;
+            }
+          }
+        }
+        for (int l = 0; l < 3; l++) {
+          p.force()[l] -= prefactor * p.q() * scale[l] * ff[l];
+        }
+      }
+
+      return true;
+    }
+
+    real CoulombKSpaceSPME::_computeVirial(CellList realCells) {
+      Tensor w = _computeVirialTensor(realCells);
+      return w[0] + w[1] + w[2];
+    }
+
+    Tensor CoulombKSpaceSPME::_computeVirialTensor(CellList realCells) {
+      commonPart(realCells);
+
+      int ky0 = fft->getLocalKY0();
+      int nky = fft->getLocalNKY();
+      int nkz = fft->getNKZ();
+      bool evenZ = (M[2] % 2 == 0);
+      real piAlpha2 = M_PI * M_PI / (alpha * alpha);
+
+      // W_ab = sum_m E(m) (delta_ab - 2 (1 + pi^2 m^2/alpha^2) m_a m_b / m^2)
+      real node_w[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+      long indx = 0;
+      Int3D k;
+      for (int kyl = 0; kyl < nky; kyl++) {
+        k[1] = ky0 + kyl;
+        for (k[2] = 0; k[2] < nkz; k[2]++) {
+          real w = (k[2] == 0 || (evenZ && k[2] == M[2]/2)) ? 1.0 : 2.0;
+          for (k[0] = 0; k[0] < M[0]; k[0]++, indx++) {
+            if (gf[indx] == 0.0) continue;
+            Real3D m;
+            for (int l = 0; l < 3; l++) {
+              int ml = (k[l] <= M[l]/2) ? k[l] : k[l] - M[l];
+              m[l] = ml / sysL[l];
+            }
+            real m2 = m.sqr();
+            real e = 0.5 * w * gf[indx] * norm(Qk[indx]);
+            real f = 2.0 * (1.0 + piAlpha2 * m2) / m2;
+            node_w[0] += e * (1.0 - f * m[0] * m[0]);
+            node_w[1] += e * (1.0 - f * m[1] * m[1]);
+            node_w[2] += e * (1.0 - f * m[2] * m[2]);
+            node_w[3] -= e * f * m[0] * m[1];
+            node_w[4] -= e * f * m[0] * m[2];
+            node_w[5] -= e * f * m[1] * m[2];
+          }
+        }
+      }
+
+      real wsum[6];
+      mpi::all_reduce(*system->comm, node_w, 6, wsum, std::plus< real >());
+
+      // the net charge correction scales like 1/V
+      real V = sysL[0] * sysL[1] * sysL[2];
+      real netCharge = -sumQ * sumQ * M_PI / (2.0 * V * alpha * alpha);
+      for (int l = 0; l < 3; l++) wsum[l] += netCharge;
+
+      return prefactor * Tensor(wsum[0], wsum[1], wsum[2], wsum[3], wsum[4], wsum[5]);
+    }
+
+    real CoulombKSpaceSPME::_computeEnergySqrRaw(real distSqr) const {
+      esutil::Error err(system->comm);
+      err.setException("There is no sense to call this function for SPME");
+      return 0.0;
+    }
+
+    bool CoulombKSpaceSPME::_computeForceRaw(Real3D& force, const Real3D& dist, real distSqr) const {
+      esutil::Error err(system->comm);
+      err.setException("There is no sense to call this function for SPME");
+      return false;
+    }
+
+    //////////////////////////////////////////////////
+    // REGISTRATION WITH PYTHON
+    //////////////////////////////////////////////////
+    void CoulombKSpaceSPME::registerPython() {
+      using namespace espressopp::python;
+
+      class_< CoulombKSpaceSPME, bases< Potential > >
+      ("interaction_CoulombKSpaceSPME",
+              init< shared_ptr< System >, real, real, Int3D, int >())
+        .add_property("prefactor", &CoulombKSpaceSPME::getPrefactor,
+                                   &CoulombKSpaceSPME::setPrefactor)
+        .add_property("alpha", &CoulombKSpaceSPME::getAlpha,
+                               &CoulombKSpaceSPME::setAlpha)
+        .add_property("mesh", &CoulombKSpaceSPME::getMesh,
+                              &CoulombKSpaceSPME::setMesh)
+        .add_property("P", &CoulombKSpaceSPME::getP,
+                           &CoulombKSpaceSPME::setP)
+        .add_property("fft_planning", &CoulombKSpaceSPME::getFFTPlanning,
+                                      &CoulombKSpaceSPME::setFFTPlanning)
+        .add_property("wisdom_file", &CoulombKSpaceSPME::getWisdomFile,
+                                     &CoulombKSpaceSPME::setWisdomFile)
+      ;
+
+      class_< CellListCoulombKSpaceSPME, bases< Interaction > >
+        ("interaction_CellListCoulombKSpaceSPME",
+              init< shared_ptr< storage::Storage >,
+                    shared_ptr< CoulombKSpaceSPME > >())
+        .def("getPotential", &CellListCoulombKSpaceSPME::getPotential)
+      ;
+    }
+  }
+}
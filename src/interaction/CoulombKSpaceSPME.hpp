@@ -0,0 +1,168 @@
+/*
+  Copyright (C) 2016
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ESPP_CLASS
+#ifndef _INTERACTION_COULOMBKSPACESPME_HPP
+#define _INTERACTION_COULOMBKSPACESPME_HPP
+
+#include <complex>
+#include <string>
+#include <vector>
+#include <boost/signals2.hpp>
+
+#include "mpi.hpp"
+#include "Potential.hpp"
+#include "esutil/ParallelFFT.hpp"
+#include "CellListAllParticlesInteractionTemplate.hpp"
+
+namespace espressopp {
+  namespace interaction {
+    /** This class provides methods to compute forces, energies and the
+     *  virial of the k space part of the Coulomb interaction with the
+     *  smooth particle mesh Ewald method,
+     *  U. Essmann et al., J. Chem. Phys. 103 (1995) 8577.
+     *
+     *  The charges are spread to the mesh with cardinal B-splines of
+     *  order P, the influence function exp(-pi^2 m^2/alpha^2)/(pi V m^2)
+     *  is divided by the squared moduli of the Euler exponential splines
+     *  and the forces are the analytic gradient of the energy, so only
+     *  one backward transform is needed per force evaluation.
+     *
+     *  The mesh is distributed like in CoulombKSpaceP3M (see
+     *  esutil::ParallelFFT), the cost is O(N P^3 + M log M) instead of
+     *  O(N kmax^3) for CoulombKSpaceEwald.
+     */
+    class CoulombKSpaceSPME : public PotentialTemplate< CoulombKSpaceSPME > {
+    public:
+      static void registerPython();
+
+      CoulombKSpaceSPME(shared_ptr< System > _system,
+                        real _prefactor,
+                        real _alpha,
+                        Int3D _M,
+                        int _P);
+
+      ~CoulombKSpaceSPME();
+
+      // (re)initializes everything that depends on the parameters or the box
+      void preset();
+
+      void setPrefactor(real _prefactor) { prefactor = _prefactor; }
+      real getPrefactor() const { return prefactor; }
+      void setAlpha(real _alpha) {
+        alpha = _alpha;
+        preset();
+      }
+      real getAlpha() const { return alpha; }
+      void setMesh(Int3D _M) {
+        M = _M;
+        preset();
+      }
+      Int3D getMesh() const { return M; }
+      void setP(int _P) {
+        P = _P;
+        preset();
+      }
+      int getP() const { return P; }
+      void setFFTPlanning(std::string rigor) {
+        fftPlanFlags = esutil::ParallelFFT::planFlagsFromString(rigor);
+        preset();
+      }
+      std::string getFFTPlanning() const {
+        return esutil::ParallelFFT::planFlagsToString(fftPlanFlags);
+      }
+      void setWisdomFile(std::string file) {
+        fftWisdomFile = file;
+        preset();
+      }
+      std::string getWisdomFile() const { return fftWisdomFile; }
+
+      real _computeEnergy(CellList realCells);
+      bool _computeForce(CellList realCells);
+      real _computeVirial(CellList realCells);
+      Tensor _computeVirialTensor(CellList realCells);
+
+      real _computeEnergySqrRaw(real distSqr) const;
+      bool _computeForceRaw(Real3D& force, const Real3D& dist, real distSqr) const;
+
+      /** B-spline weights M_P(w + P-1-j), j = 0 .. P-1, of the P mesh
+          points floor(u)-P+1 .. floor(u) for w = u - floor(u), and their
+          derivatives with respect to u. */
+      static void bspline(real w, int P, real *theta, real *dtheta);
+
+    private:
+      typedef std::complex< real > dcomplex;
+
+      // spreads the charges of the real particles to the mesh and transforms it
+      void commonPart(CellList realCells);
+      // squared moduli of the Euler exponential splines along one axis
+      void calcBSplineModuli(int axis);
+      // influence function for the local part of the spectrum
+      void calcInfluenceFunction();
+      // the local boxes have changed, renew the brick layout at the next use
+      void invalidateBrick() { brickValid = false; }
+
+      shared_ptr< System > system;
+
+      real prefactor; // Coulomb prefactor
+      real alpha;     // Ewald splitting parameter
+      Int3D M;        // number of mesh points
+      int P;          // B-spline order
+
+      Real3D sysL;
+      std::vector< real > bsplineModuli[3];
+
+      // distributed mesh and its FFT
+      shared_ptr< esutil::ParallelFFT > fft;
+      unsigned fftPlanFlags;     // FFTW planner rigor
+      std::string fftWisdomFile; // FFTW wisdom cache, none if empty
+      // the brick layout of ParallelFFT is up to date with the decomposition
+      bool brickValid;
+
+      // influence function of the local part of the spectrum,
+      // in the order of ParallelFFT::kspace(kyl, kz, kx)
+      std::vector< real > gf;
+      // transformed charge mesh of the last commonPart() call
+      std::vector< dcomplex > Qk;
+
+      // charges and convolved potential on the local brick of the mesh
+      std::vector< real > chargeBrick;
+      std::vector< real > potentialBrick;
+
+      // spline weights of the real particles in cell order: first mesh
+      // point relative to the brick, P weights and P derivatives per axis
+      std::vector< Int3D > splBase;
+      std::vector< real > splWeight;
+      std::vector< real > splDeriv;
+
+      // sum of the charges and of the squared charges of the last
+      // commonPart() call
+      real sumQ, sumQ2;
+
+      // recalculation of the influence function if the box changes
+      boost::signals2::connection connectionPreset;
+      // renewal of the brick layout if the particles are redistributed
+      boost::signals2::connection connectionInvalidateBrick;
+
+    };
+  }
+}
+
+#endif
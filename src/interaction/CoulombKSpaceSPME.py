@@ -0,0 +1,174 @@
+#  Copyright (C) 2016
+#      Max Planck Institute for Polymer Research
+#
+#  This file is part of ESPResSo++.
+#
+#  ESPResSo++ is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  ESPResSo++ is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+r"""
+****************************************
+espressopp.interaction.CoulombKSpaceSPME
+****************************************
+
+Coulomb potential and interaction Objects (`K` space part)
+
+This is the `K` space part of the Coulomb long range interaction computed
+with the smooth particle mesh Ewald method [Essmann95]_. The charges are
+spread to a mesh with cardinal B-splines of order P, the mesh is
+transformed with a distributed FFT and the forces are the analytic
+gradient of the energy. The cost grows like N*P^3 + M*log(M) instead of
+N*kmax^3 for CoulombKSpaceEwald_, which makes it the choice for large
+systems.
+
+Example:
+
+    >>> spme_pot = espressopp.interaction.CoulombKSpaceSPME(system, coulomb_prefactor, alpha, (32, 32, 32), 4)
+    >>> spme_int = espressopp.interaction.CellListCoulombKSpaceSPME(system.storage, spme_pot)
+    >>> system.addInteraction(spme_int)
+
+**!IMPORTANT** Coulomb interaction needs `R` space part as well CoulombRSpace_,
+with the same alpha.
+
+.. _CoulombRSpace: espressopp.interaction.CoulombRSpace.html
+.. _CoulombKSpaceEwald: espressopp.interaction.CoulombKSpaceEwald.html
+
+Definition:
+
+    It provides potential object *CoulombKSpaceSPME* and interaction object
+    *CellListCoulombKSpaceSPME* based on all particles list.
+
+    The *potential* is based on the system information (System_) and parameters:
+    Coulomb prefactor (coulomb_prefactor), Ewald parameter (alpha), the number
+    of mesh points in each direction (M) and the B-spline order (P). M should
+    be at least P in every direction; the error decreases quickly with P,
+    4 to 6 is usual.
+
+.. _System: espressopp.System.html
+
+    Potential Properties:
+
+    *   *spme_pot.prefactor*
+
+        The property 'prefactor' defines the Coulomb prefactor.
+
+    *   *spme_pot.alpha*
+
+        The property 'alpha' defines the Ewald parameter :math:`\\alpha`.
+
+    *   *spme_pot.mesh*
+
+        The number of mesh points in x, y and z.
+
+    *   *spme_pot.P*
+
+        The order of the B-splines.
+
+    *   *spme_pot.fft_planning*
+
+        The FFTW planner rigor, 'estimate', 'measure' (default), 'patient'
+        or 'exhaustive'.
+
+    *   *spme_pot.wisdom_file*
+
+        File in which the FFTW wisdom is cached between runs (empty: no
+        cache).
+
+    Energy, virial and virial tensor are computed, so the interaction
+    contributes to espressopp.analysis.Pressure and PressureTensor.
+
+    The *interaction* is based on the all particles list. It needs the information from Storage_
+    and `K` space part of potential.
+
+.. _Storage: espressopp.storage.Storage.html
+
+    >>> spme_int = espressopp.interaction.CellListCoulombKSpaceSPME(system.storage, spme_pot)
+
+    Interaction Methods:
+
+    *   *getPotential()*
+
+        Access to the local potential.
+
+Adding the interaction to the system:
+
+    >>> system.addInteraction(spme_int)
+
+.. [Essmann95] U. Essmann, L. Perera, M. L. Berkowitz, T. Darden, H. Lee, L. G. Pedersen,
+   J. Chem. Phys. 103, 8577 (1995)
+
+.. function:: espressopp.interaction.CoulombKSpaceSPME(system, prefactor, alpha, M, P)
+
+		:param system:
+		:param prefactor:
+		:param alpha:
+		:param M:
+		:param P: (default: 4)
+		:type system:
+		:type prefactor: real
+		:type alpha: real
+		:type M: Int3D
+		:type P: int
+
+.. function:: espressopp.interaction.CellListCoulombKSpaceSPME(storage, potential)
+
+		:param storage:
+		:param potential:
+		:type storage:
+		:type potential:
+
+.. function:: espressopp.interaction.CellListCoulombKSpaceSPME.getPotential()
+
+		:rtype:
+"""
+
+
+from espressopp import pmi
+from espressopp.esutil import *
+from espressopp import toInt3DFromVector
+
+from espressopp.interaction.Potential import *
+from espressopp.interaction.Interaction import *
+from _espressopp import interaction_CoulombKSpaceSPME, \
+                      interaction_CellListCoulombKSpaceSPME
+
+class CoulombKSpaceSPMELocal(PotentialLocal, interaction_CoulombKSpaceSPME):
+    def __init__(self, system, prefactor, alpha, M, P = 4):
+
+      if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+        cxxinit(self, interaction_CoulombKSpaceSPME, system, prefactor, alpha, toInt3DFromVector(M), P)
+
+class CellListCoulombKSpaceSPMELocal(InteractionLocal, interaction_CellListCoulombKSpaceSPME):
+    def __init__(self, storage, potential):
+
+      if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+        cxxinit(self, interaction_CellListCoulombKSpaceSPME, storage, potential)
+
+    def getPotential(self):
+      if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+         return self.cxxclass.getPotential(self)
+
+if pmi.isController:
+  class CoulombKSpaceSPME(Potential):
+    pmiproxydefs = dict(
+      cls = 'espressopp.interaction.CoulombKSpaceSPMELocal',
+      pmiproperty = ['prefactor', 'alpha', 'mesh', 'P', 'fft_planning', 'wisdom_file']
+    )
+
+  class CellListCoulombKSpaceSPME(Interaction):
+    __metaclass__ = pmi.Proxy
+    pmiproxydefs = dict(
+      cls =  'espressopp.interaction.CellListCoulombKSpaceSPMELocal',
+      pmicall = ['getPotential']
+    )
@@ -95,6 +95,12 @@ namespace espressopp {
         return true;
       }
 
+      static const bool hasBatchKernel = true;
+      void _computeForceFactors(long n, const real *distSqr, const real *qq,
+                                real *ffactor) const {
+        kernels::forceFactorsCoulombTruncated(n, distSqr, qq, ffactor, prefactor);
+      }
+
       real _computeEnergySqrRaw(real distSqr) const {
         cout << "This function currently doesn't work (_computeEnergySqrRaw(real distSqr) in CoulombTruncated.hpp)" << endl;
         return 0.0;
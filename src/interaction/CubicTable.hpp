@@ -0,0 +1,138 @@
+/*
+  Copyright (C) 2016
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ESPP_CLASS
+#ifndef _INTERACTION_CUBICTABLE_HPP
+#define _INTERACTION_CUBICTABLE_HPP
+
+#include <algorithm>
+#include <vector>
+#include "types.hpp"
+#include "esutil/AlignedAllocator.hpp"
+
+namespace espressopp {
+  namespace interaction {
+
+    /** Energy and force of a tabulated potential as piecewise cubic
+        polynomials on a uniform grid of a variable x: r^2 for pair
+        potentials, so that the force loops need no sqrt, and theta or
+        phi for angles and dihedrals. The grid in r^2 is coarsest at
+        small r, so its size is chosen from the inner end of the table.
+
+        Interval k holds the coefficients of both polynomials in one
+        block of blockSize reals, energy e0..e3 and force f0..f3 in
+        powers of the local coordinate t in [0, 1). A block is one cache
+        line and the table starts on a cache line, so a lookup touches a
+        single line. The index is computed, not searched, and clamped to
+        the table, so x outside [x0, x1] extrapolates the first or last
+        interval; a lookup has no branches and vectorises.
+
+        The table is sampled from any source of energy and force values
+        with Hermite interpolation; the slopes at the grid points are
+        central differences of the source over a quarter interval.
+    */
+    class CubicTable {
+    public:
+      static const int blockSize = 8;
+
+      CubicTable() : x0(0.0), x1(0.0), invdx(0.0), n(0) {}
+
+      /** Sample the source on [_x0, _x1] in _n intervals. Source must
+          provide void operator()(real x, real& energy, real& force) const,
+          valid on the closed interval. */
+      template < class Source >
+      void build(real _x0, real _x1, int _n, const Source& source);
+
+      bool empty() const { return n == 0; }
+      int getNIntervals() const { return n; }
+      real getX0() const { return x0; }
+      real getX1() const { return x1; }
+      real getInvDelta() const { return invdx; }
+      const real* getCoefficients() const { return &coeff[0]; }
+
+      real getEnergy(real x) const {
+        real t;
+        const real *c = block(x, t);
+        return c[0] + t * (c[1] + t * (c[2] + t * c[3]));
+      }
+
+      real getForce(real x) const {
+        real t;
+        const real *c = block(x, t) + 4;
+        return c[0] + t * (c[1] + t * (c[2] + t * c[3]));
+      }
+
+    private:
+      const real *block(real x, real& t) const {
+        real u = (x - x0) * invdx;
+        long k = std::min(std::max(long(u), 0L), long(n - 1));
+        t = u - k;
+        return &coeff[blockSize * k];
+      }
+
+      real x0, x1, invdx;
+      int n;
+      std::vector< real, esutil::AlignedAllocator< real > > coeff;
+    };
+
+    /*********************************************/
+    /* INLINE IMPLEMENTATION                     */
+    /*********************************************/
+    template < class Source >
+    inline void CubicTable::build(real _x0, real _x1, int _n, const Source& source) {
+      x0 = _x0;
+      x1 = _x1;
+      n = _n;
+      const real dx = (x1 - x0) / n;
+      invdx = 1.0 / dx;
+
+      // values and slopes (per unit t) at the n+1 grid points; a step of a
+      // quarter interval keeps the slopes finite next to integrable
+      // singularities of the source, e.g. force/sin(theta) at the ends
+      const real h = 0.25 * dx;
+      std::vector< real > e(n + 1), f(n + 1), de(n + 1), df(n + 1);
+      for (int k = 0; k <= n; ++k) {
+        real x = x0 + k * dx;
+        source(x, e[k], f[k]);
+        real xl = std::max(x - h, x0), xr = std::min(x + h, x1);
+        real el, fl, er, fr;
+        source(xl, el, fl);
+        source(xr, er, fr);
+        de[k] = (er - el) / (xr - xl) * dx;
+        df[k] = (fr - fl) / (xr - xl) * dx;
+      }
+
+      coeff.assign(blockSize * n, 0.0);
+      for (int k = 0; k < n; ++k) {
+        real *c = &coeff[blockSize * k];
+        c[0] = e[k];
+        c[1] = de[k];
+        c[2] = 3.0 * (e[k+1] - e[k]) - 2.0 * de[k] - de[k+1];
+        c[3] = 2.0 * (e[k] - e[k+1]) + de[k] + de[k+1];
+        c[4] = f[k];
+        c[5] = df[k];
+        c[6] = 3.0 * (f[k+1] - f[k]) - 2.0 * df[k] - df[k+1];
+        c[7] = 2.0 * (f[k] - f[k+1]) + df[k] + df[k+1];
+      }
+    }
+  }
+}
+
+#endif
@@ -36,6 +36,7 @@
 #include "SystemAccess.hpp"
 #include "Interaction.hpp"
 #include "types.hpp"
+#include "esutil/Threads.hpp"
 
 namespace espressopp {
   namespace interaction {
@@ -73,6 +74,7 @@ namespace espressopp {
       setPotential(shared_ptr < Potential> _potential) {
         if (_potential) {
           potential = _potential;
+          invalidateObservables();
         } else {
           LOG4ESPP_ERROR(theLogger, "NULL potential");
         }
@@ -96,9 +98,15 @@ namespace espressopp {
       virtual int bondType() { return Pair; }
 
     protected:
+      void addForcesThreaded();
+      void addForcesObserved();
+      template < int which > void addForcesObservedBonds();
+
       int ntypes;
       shared_ptr < FixedPairList > fixedpairList;
       shared_ptr < Potential > potential;
+      // bond forces computed by the threads, applied afterwards in list order
+      std::vector<Real3D> pairForces;
     };
 
     //////////////////////////////////////////////////
@@ -107,6 +115,16 @@ namespace espressopp {
     template < typename _Potential > inline void
     FixedPairListInteractionTemplate < _Potential >::addForces() {
       LOG4ESPP_INFO(_Potential::theLogger, "adding forces of FixedPairList");
+      if (observablesRequested) {
+        beginObserved();
+        addForcesObserved();
+        observablesComputed = observablesRequested;
+        return;
+      }
+      if (esutil::Threads::getNumThreads() > 1) {
+        addForcesThreaded();
+        return;
+      }
       const bc::BC& bc = *getSystemRef().bc;  // boundary conditions
       real ltMaxBondSqr = fixedpairList->getLongtimeMaxBondSqr();
       for (FixedPairList::PairList::Iterator it(*fixedpairList); it.isValid(); ++it) {
@@ -131,12 +149,98 @@ namespace espressopp {
       }
     }
     
+    // the force loop of analysed steps, see VerletListInteractionTemplate
+    template < typename _Potential > inline void
+    FixedPairListInteractionTemplate < _Potential >::addForcesObserved() {
+      switch (observablesRequested & ALL_OBSERVABLES) {
+        case ENERGY:
+          addForcesObservedBonds< ENERGY >(); break;
+        case VIRIAL:
+          addForcesObservedBonds< VIRIAL >(); break;
+        case ENERGY | VIRIAL:
+          addForcesObservedBonds< ENERGY | VIRIAL >(); break;
+        case VIRIAL_TENSOR:
+          addForcesObservedBonds< VIRIAL_TENSOR >(); break;
+        case ENERGY | VIRIAL_TENSOR:
+          addForcesObservedBonds< ENERGY | VIRIAL_TENSOR >(); break;
+        case VIRIAL | VIRIAL_TENSOR:
+          addForcesObservedBonds< VIRIAL | VIRIAL_TENSOR >(); break;
+        default:
+          addForcesObservedBonds< ALL_OBSERVABLES >(); break;
+      }
+    }
+
+    template < typename _Potential >
+    template < int which > inline void
+    FixedPairListInteractionTemplate < _Potential >::addForcesObservedBonds() {
+      typedef PairObservables< which > Sums;
+      Sums sums;
+      const bc::BC& bc = *getSystemRef().bc;  // boundary conditions
+      real ltMaxBondSqr = fixedpairList->getLongtimeMaxBondSqr();
+      for (FixedPairList::PairList::Iterator it(*fixedpairList); it.isValid(); ++it) {
+        Particle &p1 = *it->first;
+        Particle &p2 = *it->second;
+        Real3D dist;
+        bc.getMinimumImageVectorBox(dist, p1.position(), p2.position());
+        Real3D force;
+        real d = dist.sqr();
+        if (d > ltMaxBondSqr) {
+          fixedpairList->setLongtimeMaxBondSqr(d);
+          ltMaxBondSqr = d;
+        }
+        if(potential->_computeForce(force, dist)) {
+          p1.force() += force;
+          p2.force() -= force;
+          if (Sums::withVirial) sums.addVirial(dist, force);
+        }
+        if (Sums::withEnergy) sums.energy += potential->_computeEnergy(dist);
+      }
+      addObserved(sums);
+    }
+
+    template < typename _Potential > inline void
+    FixedPairListInteractionTemplate < _Potential >::addForcesThreaded() {
+      const bc::BC& bc = *getSystemRef().bc;  // boundary conditions
+      FixedPairList &pairs = *fixedpairList;
+      const Potential &pot = *potential;
+      const long n = pairs.size();
+      pairForces.resize(n);
+
+      real ltMaxBondSqr = fixedpairList->getLongtimeMaxBondSqr();
+      real maxBondSqr = ltMaxBondSqr;
+      #pragma omp parallel for schedule(static) reduction(max:maxBondSqr)
+      for (long k = 0; k < n; ++k) {
+        Real3D dist;
+        bc.getMinimumImageVectorBox(dist, pairs[k].first->position(), pairs[k].second->position());
+        real d = dist.sqr();
+        if (d > maxBondSqr) maxBondSqr = d;
+        Real3D force;
+        if (!pot._computeForce(force, dist)) force = 0.0;
+        pairForces[k] = force;
+      }
+      if (maxBondSqr > ltMaxBondSqr) {
+        fixedpairList->setLongtimeMaxBondSqr(maxBondSqr);
+      }
+
+      // add the forces in list order, independent of the number of threads
+      for (long k = 0; k < n; ++k) {
+        pairs[k].first->force() += pairForces[k];
+        pairs[k].second->force() -= pairForces[k];
+      }
+    }
+
     template < typename _Potential > inline real
     FixedPairListInteractionTemplate < _Potential >::
     computeEnergy() {
 
       LOG4ESPP_INFO(theLogger, "compute energy of the FixedPairList pairs");
 
+      if (observablesComputed & ENERGY) {
+        real esum;
+        boost::mpi::all_reduce(*mpiWorld, observedEnergy, esum, std::plus<real>());
+        return esum;
+      }
+
       real e = 0.0;
       const bc::BC& bc = *getSystemRef().bc;  // boundary conditions
       for (FixedPairList::PairList::Iterator it(*fixedpairList);
@@ -267,6 +371,12 @@ namespace espressopp {
     FixedPairListInteractionTemplate < _Potential >::
     computeVirial() {
       LOG4ESPP_INFO(theLogger, "compute the virial for the FixedPair List");
+
+      if (observablesComputed & VIRIAL) {
+        real wsum;
+        boost::mpi::all_reduce(*mpiWorld, observedVirial, wsum, std::plus<real>());
+        return wsum;
+      }
       
       real w = 0.0;
       const bc::BC& bc = *getSystemRef().bc;  // boundary conditions
@@ -292,6 +402,13 @@ namespace espressopp {
     FixedPairListInteractionTemplate < _Potential >::computeVirialTensor(Tensor& w){
       LOG4ESPP_INFO(theLogger, "compute the virial tensor for the FixedPair List");
 
+      if (observablesComputed & VIRIAL_TENSOR) {
+        Tensor wsum(0.0);
+        boost::mpi::all_reduce(*mpiWorld, (double*)&observedVirialTensor, 6, (double*)&wsum, std::plus<double>());
+        w += wsum;
+        return;
+      }
+
       Tensor wlocal(0.0);
       const bc::BC& bc = *getSystemRef().bc;  // boundary conditions
       for (FixedPairList::PairList::Iterator it(*fixedpairList);
@@ -42,6 +42,7 @@ namespace espressopp {
         .def("computeEnergyAA", &Interaction::computeEnergyAA)
         .def("computeEnergyCG", &Interaction::computeEnergyCG)
         .def("computeVirial", &Interaction::computeVirial)
+        .def("getComputedObservables", &Interaction::getComputedObservables)
         .def("bondType", &Interaction::bondType)
       ;
     }
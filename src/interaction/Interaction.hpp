@@ -26,6 +26,8 @@
 
 #include "types.hpp"
 #include "logging.hpp"
+#include "Real3D.hpp"
+#include "Tensor.hpp"
 #include "esutil/ESPPIterator.hpp"
 
 namespace espressopp {
@@ -33,13 +35,63 @@ namespace espressopp {
 
     enum bondTypes {unused, Nonbonded, Single, Pair, Angular, Dihedral};
 
+    template < int which > struct PairObservables;
+
     /** Interaction base class. */
 
     class Interaction {
 
     public:
+      /** Observables a force pass can accumulate, see requestObservables(). */
+      enum Observables {
+        ENERGY = 1,
+        VIRIAL = 2,
+        VIRIAL_TENSOR = 4,
+        ALL_OBSERVABLES = ENERGY | VIRIAL | VIRIAL_TENSOR
+      };
+
+      Interaction() : observablesRequested(0), observablesComputed(0),
+                      observedEnergy(0.0), observedVirial(0.0), observedVirialTensor(0.0) {}
       virtual ~Interaction() {};
       virtual void addForces() = 0;
+
+      /** Ask the next force pass (addForces() or the interior and
+          boundary phases) to also sum up the energy, virial and/or
+          virial tensor of the interactions it visits, so that
+          computeEnergy(), computeVirial() and computeVirialTensor(w)
+          return them without walking the lists again. Used by the
+          integrator on steps that are analysed. The integrator drops
+          the results with requestObservables(0) before the particles
+          move. Interactions that cannot accumulate observables ignore
+          the request. */
+      void requestObservables(int which) {
+        observablesRequested = which;
+        beginObserved();
+      }
+
+      /** Stop accumulating, but keep the results of the last force
+          pass until the next request or invalidateObservables(). Used
+          by the integrator at the end of a run, so that analysis after
+          the run reads the observables of its last step. */
+      void finishObservables() { observablesRequested = 0; }
+
+      /** Drop the results of the last force pass, e.g. because the
+          particles or the potentials have changed. A pending request
+          stays. */
+      void invalidateObservables() { observablesComputed = 0; }
+
+      /** the observables that the last force pass accumulated */
+      int getComputedObservables() const { return observablesComputed; }
+
+      /** Split-phase force computation used to overlap the ghost update
+          with the force loop: addForcesInterior() only touches pairs of
+          real particles and may run while the ghost positions are still
+          being communicated, addForcesBoundary() adds the rest. Together
+          they are equivalent to addForces(). By default everything is
+          computed in the boundary phase. */
+      virtual void addForcesInterior() {}
+      virtual void addForcesBoundary() { addForces(); }
+
       virtual real computeEnergy() = 0;
       virtual real computeEnergyDeriv() = 0;
       virtual real computeEnergyAA() = 0;
@@ -62,8 +114,55 @@ namespace espressopp {
     protected:
       /** Logger */
       static LOG4ESPP_DECL_LOGGER(theLogger);
+
+      /** start the sums of a new force pass */
+      void beginObserved() {
+        observablesComputed = 0;
+        observedEnergy = observedVirial = 0.0;
+        observedVirialTensor = 0.0;
+      }
+
+      /** add the sums of a force pass over (part of) the list */
+      template < int which >
+      void addObserved(const PairObservables< which > &sums);
+
+      // requested and available observables, local sums of this process
+      int observablesRequested;
+      int observablesComputed;
+      real observedEnergy;
+      real observedVirial;
+      Tensor observedVirialTensor;
+    };
+
+    /** Sums of the observables which over the pairs (or bonds) of a
+        force pass. The flags are constants, so the force loops compile
+        to the plain loop plus the requested sums. */
+    template < int which >
+    struct PairObservables {
+      static const bool withEnergy = (which & Interaction::ENERGY) != 0;
+      static const bool withVirial =
+        (which & (Interaction::VIRIAL | Interaction::VIRIAL_TENSOR)) != 0;
+
+      real energy;
+      real virial;
+      Tensor virialTensor;
+
+      PairObservables() : energy(0.0), virial(0.0), virialTensor(0.0) {}
+
+      /** dist is the distance vector r1 - r2 the force was computed for */
+      void addVirial(const Real3D &dist, const Real3D &force) {
+        if (which & Interaction::VIRIAL) virial += dist * force;
+        if (which & Interaction::VIRIAL_TENSOR) virialTensor += Tensor(dist, force);
+      }
     };
 
+    template < int which >
+    inline void Interaction::addObserved(const PairObservables< which > &sums) {
+      if (which & ENERGY) observedEnergy += sums.energy;
+      if (which & VIRIAL) observedVirial += sums.virial;
+      if (which & VIRIAL_TENSOR) observedVirialTensor += sums.virialTensor;
+    }
+
     struct InteractionList
       : public std::vector< shared_ptr< Interaction > > {
       typedef esutil::ESPPIterator< std::vector< Interaction > > Iterator;
@@ -59,6 +59,16 @@ This is an abstract class, only needed to be inherited from.
 .. function:: espressopp.interaction.Interaction.computeVirial()
 
 		:rtype: real
+
+.. function:: espressopp.interaction.Interaction.getComputedObservables()
+
+		The observables (1: energy, 2: virial, 4: virial tensor) that
+		the last force pass has accumulated and that computeEnergy()
+		and computeVirial() return without walking the lists again.
+		They are kept after a run until the particles or potentials
+		change.
+
+		:rtype: int
 """
 from espressopp import pmi
 from _espressopp import interaction_Interaction
@@ -88,6 +98,10 @@ class InteractionLocal(object):
         if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
             return self.cxxclass.computeVirial(self)
 
+    def getComputedObservables(self):
+        if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+            return self.cxxclass.getComputedObservables(self)
+
     def bondType(self):
         if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
             return int(self.cxxclass.bondType(self))
@@ -97,5 +111,5 @@ if pmi.isController :
 
         __metaclass__ = pmi.Proxy
         pmiproxydefs = dict(
-            pmicall = [ "computeEnergy", "computeEnergyDeriv", "computeEnergyAA", "computeEnergyCG", "computeVirial", "bondType" ]
+            pmicall = [ "computeEnergy", "computeEnergyDeriv", "computeEnergyAA", "computeEnergyCG", "computeVirial", "getComputedObservables", "bondType" ]
             )
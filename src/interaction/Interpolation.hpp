@@ -37,6 +37,10 @@ namespace espressopp {
                 virtual real getEnergy(real r) const = 0;
                 virtual real getForce(real r) const = 0;
                 virtual void read(mpi::communicator comm, const char* file) = 0;
+                // range and number of points of the table read
+                virtual real getInner() const = 0;
+                virtual real getOuter() const = 0;
+                virtual int getN() const = 0;
         };//class Interpolation
         
         
@@ -37,6 +37,9 @@ namespace espressopp {
                 void readRaw(mpi::communicator comm, const char* file);
                 real getEnergyRaw(real r) const;
                 real getForceRaw(real r) const;
+                real getInner() const { return inner; }
+                real getOuter() const { return outer; }
+                int getN() const { return N; }
             
             protected:
                 static LOG4ESPP_DECL_LOGGER(theLogger);
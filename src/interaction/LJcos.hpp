@@ -138,6 +138,13 @@ namespace espressopp {
             force = dist * ffactor;
             return true;
          }
+
+         static const bool hasBatchKernel = true;
+         void _computeForceFactors(long n, const real *distSqr, const real *qq,
+                                   real *ffactor) const {
+            kernels::forceFactorsLJcos(n, distSqr, ffactor, auxCoef, ff1, ff2, sqr_r_min,
+                                       alpha_phi, alpha, beta, cutoffSqr);
+         }
       private:
          real phi;
          
@@ -118,6 +118,13 @@ namespace espressopp {
         force = dist * ffactor;
         return true;
       }
+
+      static const bool hasBatchKernel = true;
+      void _computeForceFactors(long n, const real *distSqr, const real *qq,
+                                real *ffactor) const {
+        kernels::forceFactorsLennardJones(n, distSqr, ffactor, ff1, ff2, cutoffSqr);
+      }
+
       static LOG4ESPP_DECL_LOGGER(theLogger);
     };
 
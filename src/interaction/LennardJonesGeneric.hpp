@@ -135,6 +135,13 @@ namespace espressopp {
         return true;
       }
 
+      static const bool hasBatchKernel = true;
+      void _computeForceFactors(long n, const real *distSqr, const real *qq,
+                                real *ffactor) const {
+        kernels::forceFactorsLennardJonesGeneric(n, distSqr, ffactor, epsilon, ff1, ff2,
+                                                 a, b, cutoffSqr);
+      }
+
       static LOG4ESPP_DECL_LOGGER(theLogger);
     };
 
@@ -99,6 +99,12 @@ namespace espressopp {
         force = dist * ffactor;
         return true;
       }
+
+      static const bool hasBatchKernel = true;
+      void _computeForceFactors(long n, const real *distSqr, const real *qq,
+                                real *ffactor) const {
+        kernels::forceFactorsMorse(n, distSqr, ffactor, epsilon, alpha, rMin, cutoffSqr);
+      }
     };
 
     // provide pickle support
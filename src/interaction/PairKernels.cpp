@@ -0,0 +1,162 @@
+/*
+  Copyright (C) 2016
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <algorithm>
+#include <cmath>
+#include "PairKernels.hpp"
+#include "CubicTable.hpp"
+
+/* Clone the kernels for the vector extensions, the dynamic loader picks
+   the best clone for the CPU (GNU ifunc). The loops are written so that
+   they vectorise: no early exits, the cutoff is applied by selecting 0. */
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 6 && \
+    defined(__x86_64__) && defined(__linux__) && !defined(ESPP_NO_TARGET_CLONES)
+#define ESPP_KERNEL __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define ESPP_KERNEL
+#endif
+
+namespace espressopp {
+  namespace interaction {
+    namespace kernels {
+
+      namespace {
+        // blocks for the kernels that need temporaries
+        const long BLOCK = 64;
+      }
+
+      ESPP_KERNEL
+      void forceFactorsLennardJones(long n, const real *__restrict distSqr,
+                                    real *__restrict ffactor,
+                                    real ff1, real ff2, real cutoffSqr) {
+        for (long i = 0; i < n; ++i) {
+          real frac2 = 1.0 / distSqr[i];
+          real frac6 = frac2 * frac2 * frac2;
+          real f = frac6 * (ff1 * frac6 - ff2) * frac2;
+          ffactor[i] = distSqr[i] <= cutoffSqr ? f : 0.0;
+        }
+      }
+
+      ESPP_KERNEL
+      void forceFactorsLennardJonesGeneric(long n, const real *__restrict distSqr,
+                                           real *__restrict ffactor,
+                                           real epsilon, real ff1, real ff2,
+                                           int a, int b, real cutoffSqr) {
+        if (a + 2 < 0 || b + 2 < 0) {
+          for (long i = 0; i < n; ++i) {
+            real invdist = 1.0 / std::sqrt(distSqr[i]);
+            real f = 4.0 * epsilon * (ff1 * std::pow(invdist, a + 2) - ff2 * std::pow(invdist, b + 2));
+            ffactor[i] = distSqr[i] <= cutoffSqr ? f : 0.0;
+          }
+          return;
+        }
+
+        // integer powers by squaring, the exponent loops are uniform over the block
+        real base[BLOCK], powA[BLOCK], powB[BLOCK];
+        for (long i0 = 0; i0 < n; i0 += BLOCK) {
+          const long m = std::min(BLOCK, n - i0);
+          const real *d2 = distSqr + i0;
+          for (long i = 0; i < m; ++i) {
+            base[i] = 1.0 / std::sqrt(d2[i]);
+            powA[i] = 1.0;
+            powB[i] = 1.0;
+          }
+          int ea = a + 2, eb = b + 2;
+          while (ea > 0 || eb > 0) {
+            if (ea & 1) for (long i = 0; i < m; ++i) powA[i] *= base[i];
+            if (eb & 1) for (long i = 0; i < m; ++i) powB[i] *= base[i];
+            ea >>= 1;
+            eb >>= 1;
+            if (ea > 0 || eb > 0) for (long i = 0; i < m; ++i) base[i] *= base[i];
+          }
+          for (long i = 0; i < m; ++i) {
+            real f = 4.0 * epsilon * (ff1 * powA[i] - ff2 * powB[i]);
+            ffactor[i0 + i] = d2[i] <= cutoffSqr ? f : 0.0;
+          }
+        }
+      }
+
+      ESPP_KERNEL
+      void forceFactorsMorse(long n, const real *__restrict distSqr,
+                             real *__restrict ffactor,
+                             real epsilon, real alpha, real rMin, real cutoffSqr) {
+        for (long i = 0; i < n; ++i) {
+          real r = std::sqrt(distSqr[i]);
+          real f = epsilon * (2.0 * alpha * std::exp(-2.0 * alpha * (r - rMin))
+                              - 2.0 * alpha * std::exp(-alpha * (r - rMin))) / r;
+          ffactor[i] = distSqr[i] <= cutoffSqr ? f : 0.0;
+        }
+      }
+
+      ESPP_KERNEL
+      void forceFactorsLJcos(long n, const real *__restrict distSqr,
+                             real *__restrict ffactor,
+                             real auxCoef, real ff1, real ff2, real sqrRMin,
+                             real alphaPhi, real alpha, real beta, real cutoffSqr) {
+        for (long i = 0; i < n; ++i) {
+          real frac2 = auxCoef / distSqr[i];
+          real frac6 = frac2 * frac2 * frac2;
+          real fRep = frac6 * (ff1 * frac6 - ff2) * frac2;
+          real fCos = alphaPhi * std::sin(alpha * distSqr[i] + beta);
+          real f = distSqr[i] <= sqrRMin ? fRep : fCos;
+          ffactor[i] = distSqr[i] <= cutoffSqr ? f : 0.0;
+        }
+      }
+
+      ESPP_KERNEL
+      void forceFactorsCoulombTruncated(long n, const real *__restrict distSqr,
+                                        const real *__restrict qq,
+                                        real *__restrict ffactor, real prefactor) {
+        for (long i = 0; i < n; ++i) {
+          ffactor[i] = prefactor * qq[i] / (std::sqrt(distSqr[i]) * distSqr[i]);
+        }
+      }
+
+      ESPP_KERNEL
+      void forceFactorsReactionField(long n, const real *__restrict distSqr,
+                                     const real *__restrict qq,
+                                     real *__restrict ffactor,
+                                     real prefactor, real B1, real rc2) {
+        for (long i = 0; i < n; ++i) {
+          real r = std::sqrt(distSqr[i]);
+          real f = prefactor * qq[i] * (1.0 / (r * distSqr[i]) + B1);
+          ffactor[i] = distSqr[i] <= rc2 ? f : 0.0;
+        }
+      }
+
+      ESPP_KERNEL
+      void forceFactorsTabulated(long n, const real *__restrict distSqr,
+                                 real *__restrict ffactor,
+                                 const real *__restrict coeff, real x0, real invdx,
+                                 long nIntervals, real cutoffSqr) {
+        const long last = nIntervals - 1;
+        for (long i = 0; i < n; ++i) {
+          real u = (distSqr[i] - x0) * invdx;
+          long k = std::min(std::max(long(u), 0L), last);
+          real t = u - k;
+          const real *c = coeff + CubicTable::blockSize * k + 4;
+          real f = c[0] + t * (c[1] + t * (c[2] + t * c[3]));
+          ffactor[i] = distSqr[i] <= cutoffSqr ? f : 0.0;
+        }
+      }
+    }
+  }
+}
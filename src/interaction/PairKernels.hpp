@@ -0,0 +1,77 @@
+/*
+  Copyright (C) 2016
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+// ESPP_CLASS
+#ifndef _INTERACTION_PAIRKERNELS_HPP
+#define _INTERACTION_PAIRKERNELS_HPP
+
+#include "types.hpp"
+
+namespace espressopp {
+  namespace interaction {
+    /** Batched force kernels of the standard pair potentials.
+
+        Each kernel computes for n squared distances the force factor
+        ffactor[i], such that the force on the first particle of pair i
+        is dist[i] * ffactor[i], and 0 beyond the cutoff. The kernels
+        for charged potentials take the charge products qq[i] of the
+        pairs. They are straight loops over plain arrays which the
+        compiler vectorises; on x86-64 every kernel is compiled for
+        AVX-512, AVX2 and the baseline ISA, the best version is selected
+        at runtime for the CPU the program runs on.
+    */
+    namespace kernels {
+
+      /// Lennard-Jones, ffactor = (ff1/r^12 - ff2/r^6) / r^2
+      void forceFactorsLennardJones(long n, const real *distSqr, real *ffactor,
+                                    real ff1, real ff2, real cutoffSqr);
+
+      /// generic Lennard-Jones, ffactor = 4 eps (ff1/r^(a+2) - ff2/r^(b+2))
+      void forceFactorsLennardJonesGeneric(long n, const real *distSqr, real *ffactor,
+                                           real epsilon, real ff1, real ff2,
+                                           int a, int b, real cutoffSqr);
+
+      /// Morse, ffactor = 2 eps alpha (exp(-2 alpha (r-rMin)) - exp(-alpha (r-rMin))) / r
+      void forceFactorsMorse(long n, const real *distSqr, real *ffactor,
+                             real epsilon, real alpha, real rMin, real cutoffSqr);
+
+      /// LJcos, repulsive Lennard-Jones below rMin, cosine tail above
+      void forceFactorsLJcos(long n, const real *distSqr, real *ffactor,
+                             real auxCoef, real ff1, real ff2, real sqrRMin,
+                             real alphaPhi, real alpha, real beta, real cutoffSqr);
+
+      /// truncated Coulomb, ffactor = prefactor qq / r^3 (the cutoff is left to the pair list)
+      void forceFactorsCoulombTruncated(long n, const real *distSqr, const real *qq,
+                                        real *ffactor, real prefactor);
+
+      /// generalized reaction field, ffactor = prefactor qq (1/r^3 + B1)
+      void forceFactorsReactionField(long n, const real *distSqr, const real *qq,
+                                     real *ffactor, real prefactor, real B1, real rc2);
+
+      /// tabulated, ffactor = force polynomial of a CubicTable in r^2 (coeff, x0, invdx, nIntervals)
+      void forceFactorsTabulated(long n, const real *distSqr, real *ffactor,
+                                 const real *coeff, real x0, real invdx,
+                                 long nIntervals, real cutoffSqr);
+    }
+  }
+}
+
+#endif
@@ -28,6 +28,7 @@
 #include "Real3D.hpp"
 #include "Particle.hpp"
 #include "logging.hpp"
+#include "PairKernels.hpp"
 
 namespace espressopp {
   namespace interaction {
@@ -100,6 +101,16 @@ namespace espressopp {
 			 const Real3D& dist) const;
       bool _computeForce(Real3D& force,
                          const Particle &p1, const Particle &p2, const Real3D& dist) const;
+
+      // Batched interface (used by the Verlet list force loops): force
+      // factors for n pairs of one type pair, force_i = dist_i * ffactor[i],
+      // 0 beyond the cutoff. qq holds the charge products of the pairs.
+      // The default loops over _computeForceRaw, which is only valid for
+      // central potentials; Derived classes with a vectorised kernel
+      // override it and set hasBatchKernel.
+      void _computeForceFactors(long n, const real *distSqr, const real *qq,
+                                real *ffactor) const;
+      static const bool hasBatchKernel = false;
       
       //bool _computeForce(CellList realcells) const;
       
@@ -322,6 +333,23 @@ namespace espressopp {
       return _computeForce(force, dist);
     }
 
+    template < class Derived >
+    inline void
+    PotentialTemplate< Derived >::
+    _computeForceFactors(long n, const real *distSqr, const real *qq,
+                         real *ffactor) const {
+      // a unit vector as distance yields the factor of a central force
+      const Real3D unit(1.0, 0.0, 0.0);
+      for (long i = 0; i < n; ++i) {
+        Real3D force(0.0);
+        if (distSqr[i] > cutoffSqr ||
+            !derived_this()->_computeForceRaw(force, unit, distSqr[i])) {
+          force = 0.0;
+        }
+        ffactor[i] = force[0];
+      }
+    }
+
     template < class Derived > 
     inline bool
     PotentialTemplate< Derived >::
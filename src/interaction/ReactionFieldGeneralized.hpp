@@ -202,6 +202,12 @@ namespace espressopp {
                     }*/
 
                 }
+
+                static const bool hasBatchKernel = true;
+                void _computeForceFactors(long n, const real *distSqr, const real *qq,
+                                          real *ffactor) const {
+                    kernels::forceFactorsReactionField(n, distSqr, qq, ffactor, prefactor, B1, rc2);
+                }
                 
                 real _computeEnergySqrRaw(real distSqr) const {
                         cout << "_computeEnergySqrRaw not possible for reaction field, no particle information" << endl;
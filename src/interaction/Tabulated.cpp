@@ -41,6 +41,25 @@
 namespace espressopp {
   namespace interaction {
 
+    namespace {
+      // energy and force/r of an interpolation as functions of r^2
+      struct SquaredDistanceSource {
+        const Interpolation& table;
+        real rMin, rMax;
+        SquaredDistanceSource(const Interpolation& _table) : table(_table) {
+          // stay inside the table, and away from r = 0
+          real range = table.getOuter() - table.getInner();
+          rMin = std::max(table.getInner(), 1.0e-6 * range);
+          rMax = table.getOuter() - 1.0e-9 * range;
+        }
+        void operator()(real distSqr, real& energy, real& force) const {
+          real r = std::min(std::max(sqrt(distSqr), rMin), rMax);
+          energy = table.getEnergy(r);
+          force = table.getForce(r) / r;
+        }
+      };
+    }
+
 
     void Tabulated::setFilename(int itype, const char* _filename) {
         boost::mpi::communicator world;
@@ -60,6 +79,21 @@ namespace espressopp {
             table = make_shared <InterpolationCubic> ();
             table->read(world, _filename);
         }
+
+        if (table) {
+            // an interval of r^2 spans dr = d(r^2) / 2r, so the grid is
+            // coarsest at the inner end. Choose it such that there an
+            // interval spans at most a quarter of the spacing of the file,
+            // but resolve tables that start close to r = 0 only down to
+            // outer/8, which bounds the table to 18 times the file.
+            real inner = table->getInner(), outer = table->getOuter();
+            real dr = 0.25 * (outer - inner) / (table->getN() - 1);
+            real rRes = std::max(inner, 0.125 * outer);
+            int n = std::max(4 * (table->getN() - 1),
+                             (int)ceil((outer * outer - inner * inner) / (2.0 * rRes * dr)));
+            r2table = make_shared <CubicTable> ();
+            r2table->build(inner * inner, outer * outer, n, SquaredDistanceSource(*table));
+        }
     }
 
     typedef class VerletListInteractionTemplate <Tabulated> VerletListTabulated;
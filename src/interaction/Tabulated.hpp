@@ -27,6 +27,8 @@
 //#include <stdexcept>
 #include "Potential.hpp"
 #include "Interpolation.hpp"
+#include "CubicTable.hpp"
+#include "PairKernels.hpp"
 
 namespace espressopp {
 
@@ -37,6 +39,11 @@ namespace espressopp {
 
         The potential and forces must be provided in a file.
 
+        The interpolation read from the file is resampled to a CubicTable
+        in r^2 with the force divided by r, so the force loops need neither
+        sqrt nor division; the batched Verlet list loops evaluate it with
+        a vectorised kernel.
+
         Be careful: default and copy constructor of this class are used.
     */
 
@@ -46,6 +53,8 @@ namespace espressopp {
             std::string filename;
             shared_ptr <Interpolation> table;
             int interpolationType;
+            // energy and force/r of table in r^2, shared by the copies
+            shared_ptr <CubicTable> r2table;
 
         public:
             static void registerPython();
@@ -89,25 +98,32 @@ namespace espressopp {
             real _computeEnergySqrRaw(real distSqr) const {
                 // make an interpolation
                 if (interpolationType!=0) {
-                  return table->getEnergy(sqrt(distSqr));
+                  return r2table->getEnergy(distSqr);
                 } else {
                   return 0;
                 }
             }
          
             bool _computeForceRaw(Real3D& force, const Real3D& dist, real distSqr) const {
-                real ffactor = 0.0;
-                if (interpolationType!=0){ 
-                   real distrt = sqrt(distSqr);
-                   ffactor = table->getForce(distrt);
-                   ffactor /= distrt;
-                } else {
+                if (interpolationType==0) {
                     return false;
                 }
-                force = dist * ffactor;
+                force = dist * r2table->getForce(distSqr);
                 return true;
             }
 
+            static const bool hasBatchKernel = true;
+            void _computeForceFactors(long n, const real *distSqr, const real *qq,
+                                      real *ffactor) const {
+                if (interpolationType==0) {
+                    std::fill(ffactor, ffactor + n, 0.0);
+                    return;
+                }
+                kernels::forceFactorsTabulated(n, distSqr, ffactor,
+                    r2table->getCoefficients(), r2table->getX0(), r2table->getInvDelta(),
+                    r2table->getNIntervals(), cutoffSqr);
+            }
+
     };//class
 
     // provide pickle support
@@ -26,6 +26,10 @@ r"""
 espressopp.interaction.Tabulated
 ********************************
 
+The table read from the file (itype 1: linear, 2: Akima, 3: cubic spline)
+is resampled once to cubic polynomials on a uniform grid in r^2 with 4 times
+as many intervals, which the force loops evaluate without a square root.
+TabulatedAngular and TabulatedDihedral do the same in the cosine of the angle.
 
 .. function:: espressopp.interaction.Tabulated(itype, filename, cutoff)
 
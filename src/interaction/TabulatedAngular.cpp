@@ -34,7 +34,26 @@
 
 namespace espressopp {
     namespace interaction {
-        
+
+        namespace {
+            // energy and force of an interpolation in the angle
+            struct AngleSource {
+                const Interpolation& table;
+                real thetaMin, thetaMax;
+                AngleSource(const Interpolation& _table) : table(_table) {
+                    // stay inside the table and inside [0, pi]
+                    real range = table.getOuter() - table.getInner();
+                    thetaMin = std::max(table.getInner(), 0.0) + 1.0e-9 * range;
+                    thetaMax = std::min(table.getOuter(), M_PI) - 1.0e-9 * range;
+                }
+                void operator()(real theta, real& energy, real& force) const {
+                    theta = std::min(std::max(theta, thetaMin), thetaMax);
+                    energy = table.getEnergy(theta);
+                    force = table.getForce(theta);
+                }
+            };
+        }
+
         void TabulatedAngular::setFilename(int itype, const char* _filename) {
             boost::mpi::communicator world;
             filename = _filename;
@@ -53,6 +72,15 @@ namespace espressopp {
                 table = make_shared <InterpolationCubic> ();
                 table->read(world, _filename);
             }
+
+            if (table) {
+                // 4 intervals in theta per interval of the file; a uniform
+                // grid in cos(theta) would be coarse next to 0 and pi
+                AngleSource source(*table);
+                ctable = make_shared <CubicTable> ();
+                ctable->build(source.thetaMin, source.thetaMax,
+                              4 * (table->getN() - 1), source);
+            }
         }
 
         typedef class FixedTripleListInteractionTemplate <TabulatedAngular>
@@ -28,6 +28,7 @@
 
 #include "AngularPotential.hpp"
 #include "Interpolation.hpp"
+#include "CubicTable.hpp"
 
 namespace espressopp {
     namespace interaction {
@@ -38,6 +39,8 @@ namespace espressopp {
                 std::string filename;
                 shared_ptr <Interpolation> table;
                 int interpolationType;
+                // energy and force of table in theta, shared by the copies
+                shared_ptr <CubicTable> ctable;
          
             public:
                 static void registerPython();
@@ -88,10 +91,10 @@ namespace espressopp {
                     if (interpolationType != 0) {
                         real dist12_sqr = dist12 * dist12;
                         real dist32_sqr = dist32 * dist32;
-                        real dist1232 = sqrt(dist12_sqr) * sqrt(dist32_sqr);
+                        real dist1232 = sqrt(dist12_sqr * dist32_sqr);
                         real cos_theta = dist12 * dist32 / dist1232;
 
-                        real a = table->getForce(acos(cos_theta));
+                        real a = ctable->getForce(acos(cos_theta));
                         
                         a*=1.0/(sqrt(1.0-cos_theta*cos_theta));
                         
@@ -36,7 +36,26 @@
 
 namespace espressopp {
     namespace interaction {
-        
+
+        namespace {
+            // energy and force of an interpolation in the angle
+            struct AngleSource {
+                const Interpolation& table;
+                real phiMin, phiMax;
+                AngleSource(const Interpolation& _table) : table(_table) {
+                    // stay inside the table and inside [0, pi]
+                    real range = table.getOuter() - table.getInner();
+                    phiMin = std::max(table.getInner(), 0.0) + 1.0e-9 * range;
+                    phiMax = std::min(table.getOuter(), M_PI) - 1.0e-9 * range;
+                }
+                void operator()(real phi, real& energy, real& force) const {
+                    phi = std::min(std::max(phi, phiMin), phiMax);
+                    energy = table.getEnergy(phi);
+                    force = table.getForce(phi);
+                }
+            };
+        }
+
         void TabulatedDihedral::setFilename(int itype, const char* _filename) {
             boost::mpi::communicator world;
             filename = _filename;
@@ -56,6 +75,15 @@ namespace espressopp {
                 table = make_shared <InterpolationCubic> ();
                 table->read(world, _filename);
             }
+
+            if (table) {
+                // 4 intervals in phi per interval of the file; a uniform
+                // grid in cos(phi) would be coarse next to 0 and pi
+                AngleSource source(*table);
+                ctable = make_shared <CubicTable> ();
+                ctable->build(source.phiMin, source.phiMax,
+                              4 * (table->getN() - 1), source);
+            }
         }
 
         typedef class FixedQuadrupleListInteractionTemplate <TabulatedDihedral>
@@ -28,6 +28,7 @@
 
 #include "DihedralPotential.hpp"
 #include "Interpolation.hpp"
+#include "CubicTable.hpp"
 
 namespace espressopp {
     namespace interaction {
@@ -38,6 +39,8 @@ namespace espressopp {
                 std::string filename;
                 shared_ptr <Interpolation> table;
                 int interpolationType;
+                // energy and force of table in phi, shared by the copies
+                shared_ptr <CubicTable> ctable;
          
             public:
                 static void registerPython();
@@ -127,7 +130,7 @@ namespace espressopp {
                         else if (cos_phi < -1.0) cos_phi = -1.0;
 
                         real phi = acos(cos_phi);
-                        real coef1 = -1.0*table->getForce(phi);
+                        real coef1 = -1.0*ctable->getForce(phi);
 
                         /** Calculates force in Cartesian coordinates.
                          * base on: http://www.ccp5.ac.uk/DL_POLY_CLASSIC/MANUALS/USRMAN.pdf
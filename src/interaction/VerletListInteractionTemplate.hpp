@@ -37,6 +37,7 @@
 #include "bc/BC.hpp"
 
 #include "storage/Storage.hpp"
+#include "esutil/Threads.hpp"
 
 namespace espressopp {
   namespace interaction {
@@ -70,6 +71,7 @@ namespace espressopp {
         // typeX+1 because i<ntypes
         ntypes = std::max(ntypes, std::max(type1+1, type2+1));
         potentialArray.at(type1, type2) = potential;
+        invalidateObservables();
         LOG4ESPP_INFO(_Potential::theLogger, "added potential for type1=" << type1 << " type2=" << type2);
         if (type1 != type2) { // add potential in the other direction
            potentialArray.at(type2, type1) = potential;
@@ -89,6 +91,8 @@ namespace espressopp {
 
 
       virtual void addForces();
+      virtual void addForcesInterior();
+      virtual void addForcesBoundary();
       virtual real computeEnergy();
       virtual real computeEnergyDeriv();
       virtual real computeEnergyAA();
@@ -102,10 +106,29 @@ namespace espressopp {
       virtual int bondType() { return Nonbonded; }
 
     protected:
+      void addForcesCompact();
+      void addForcesRange(long begin, long end);
+      void addForcesObserved(long begin, long end);
+      template < int which > void addForcesObservedRange(long begin, long end);
+      void addForcesThreaded(long begin, long end);
+      void addForcesCompactThreaded();
+      void addForcesBatched(long begin, long end);
+      void addForcesCompactBatched();
+      void computeForcesBatch(const Potential &potential, int n,
+                              Particle *const *p1, Particle *const *p2, Real3D *force);
+      void computeForcesBatchArrays(const Potential &potential, const storage::ParticleArrays &pa,
+                                    int i, int n, const int *idx, Real3D *force);
+      real computeEnergyCompact();
+
+      // number of pairs handed to the batched kernels at once
+      static const int batchSize = 64;
+
       int ntypes;
       shared_ptr<VerletList> verletList;
       esutil::Array2D<Potential, esutil::enlarge> potentialArray;
       // not needed esutil::Array2D<shared_ptr<Potential>, esutil::enlarge> potentialArrayPtr;
+      // pair forces computed by the threads, applied afterwards in list order
+      std::vector<Real3D> pairForces;
     };
 
     //////////////////////////////////////////////////
@@ -116,9 +139,158 @@ namespace espressopp {
     addForces() {
       LOG4ESPP_DEBUG(_Potential::theLogger, "loop over verlet list pairs and add forces");
 
-      for (PairList::Iterator it(verletList->getPairs()); it.isValid(); ++it) {
-        Particle &p1 = *it->first;
-        Particle &p2 = *it->second;
+      if (observablesRequested) {
+        beginObserved();
+        addForcesObserved(0, verletList->getPairs().size());
+        observablesComputed = observablesRequested;
+        return;
+      }
+
+      if (verletList->isCompact()) {
+        addForcesCompact();
+        return;
+      }
+
+      addForcesRange(0, verletList->getPairs().size());
+    }
+
+    template < typename _Potential > inline void
+    VerletListInteractionTemplate < _Potential >::
+    addForcesInterior() {
+      LOG4ESPP_DEBUG(_Potential::theLogger, "loop over interior verlet list pairs and add forces");
+
+      // the compact kernels do not separate the pairs
+      if (verletList->isCompact()) return;
+
+      if (observablesRequested) {
+        beginObserved();
+        addForcesObserved(0, verletList->getNumInteriorPairs());
+        return;
+      }
+
+      // the ghost update runs meanwhile, let it progress between chunks
+      storage::Storage &storage = *verletList->getSystemRef().storage;
+      const long nInterior = verletList->getNumInteriorPairs();
+      const long chunk = 16384;
+      for (long begin = 0; begin < nInterior; begin += chunk) {
+        addForcesRange(begin, std::min(begin + chunk, nInterior));
+        storage.progressGhostUpdate();
+      }
+    }
+
+    template < typename _Potential > inline void
+    VerletListInteractionTemplate < _Potential >::
+    addForcesBoundary() {
+      LOG4ESPP_DEBUG(_Potential::theLogger, "loop over boundary verlet list pairs and add forces");
+
+      if (observablesRequested) {
+        // the interior phase has started the sums, except in compact mode
+        if (verletList->isCompact()) {
+          beginObserved();
+          addForcesObserved(0, 0);
+        } else {
+          addForcesObserved(verletList->getNumInteriorPairs(), verletList->getPairs().size());
+        }
+        observablesComputed = observablesRequested;
+        return;
+      }
+
+      if (verletList->isCompact()) {
+        addForcesCompact();
+        return;
+      }
+
+      addForcesRange(verletList->getNumInteriorPairs(), verletList->getPairs().size());
+    }
+
+    /* On analysed steps the force loop also sums up the requested
+       observables. It runs serially and unbatched, with the same
+       potential calls as computeEnergy() and computeVirial(), so the
+       results equal theirs. In compact mode all rows are visited and
+       begin and end are ignored. */
+    template < typename _Potential > inline void
+    VerletListInteractionTemplate < _Potential >::
+    addForcesObserved(long begin, long end) {
+      switch (observablesRequested & ALL_OBSERVABLES) {
+        case ENERGY:
+          addForcesObservedRange< ENERGY >(begin, end); break;
+        case VIRIAL:
+          addForcesObservedRange< VIRIAL >(begin, end); break;
+        case ENERGY | VIRIAL:
+          addForcesObservedRange< ENERGY | VIRIAL >(begin, end); break;
+        case VIRIAL_TENSOR:
+          addForcesObservedRange< VIRIAL_TENSOR >(begin, end); break;
+        case ENERGY | VIRIAL_TENSOR:
+          addForcesObservedRange< ENERGY | VIRIAL_TENSOR >(begin, end); break;
+        case VIRIAL | VIRIAL_TENSOR:
+          addForcesObservedRange< VIRIAL | VIRIAL_TENSOR >(begin, end); break;
+        default:
+          addForcesObservedRange< ALL_OBSERVABLES >(begin, end); break;
+      }
+    }
+
+    template < typename _Potential >
+    template < int which > inline void
+    VerletListInteractionTemplate < _Potential >::
+    addForcesObservedRange(long begin, long end) {
+      typedef PairObservables< which > Sums;
+      Sums sums;
+
+      if (verletList->isCompact()) {
+        storage::ParticleArrays &pa = verletList->getParticleArrays();
+        const std::vector<int> &offsets = verletList->getNeighborOffsets();
+        const std::vector<int> &neighbors = verletList->getNeighborIndices();
+        const int nRows = offsets.size() - 1;
+        for (int i = 0; i < nRows; ++i) {
+          Particle &p1 = pa.getParticle(i);
+          for (int k = offsets[i]; k < offsets[i+1]; ++k) {
+            Particle &p2 = pa.getParticle(neighbors[k]);
+            const Potential &potential = getPotential(p1.type(), p2.type());
+            Real3D force(0.0);
+            if (potential._computeForce(force, p1, p2)) {
+              p1.force() += force;
+              p2.force() -= force;
+              if (Sums::withVirial) sums.addVirial(p1.position() - p2.position(), force);
+            }
+            if (Sums::withEnergy) sums.energy += potential._computeEnergy(p1, p2);
+          }
+        }
+      } else {
+        PairList &pairs = verletList->getPairs();
+        for (long k = begin; k < end; ++k) {
+          Particle &p1 = *pairs[k].first;
+          Particle &p2 = *pairs[k].second;
+          const Potential &potential = getPotential(p1.type(), p2.type());
+          Real3D force(0.0);
+          if (potential._computeForce(force, p1, p2)) {
+            p1.force() += force;
+            p2.force() -= force;
+            if (Sums::withVirial) sums.addVirial(p1.position() - p2.position(), force);
+          }
+          if (Sums::withEnergy) sums.energy += potential._computeEnergy(p1, p2);
+        }
+      }
+
+      addObserved(sums);
+    }
+
+    template < typename _Potential > inline void
+    VerletListInteractionTemplate < _Potential >::
+    addForcesRange(long begin, long end) {
+      if (esutil::Threads::getNumThreads() > 1) {
+        addForcesThreaded(begin, end);
+        return;
+      }
+
+      if (Potential::hasBatchKernel) {
+        addForcesBatched(begin, end);
+        return;
+      }
+
+      PairList &pairs = verletList->getPairs();
+      for (long k = begin; k < end; ++k) {
+        Particle &p1 = *pairs[k].first;
+        Particle &p2 = *pairs[k].second;
         int type1 = p1.type();
         int type2 = p2.type();
         const Potential &potential = getPotential(type1, type2);
@@ -140,6 +312,16 @@ namespace espressopp {
     computeEnergy() {
       LOG4ESPP_DEBUG(_Potential::theLogger, "loop over verlet list pairs and sum up potential energies");
 
+      if (observablesComputed & ENERGY) {
+        real esum;
+        boost::mpi::all_reduce(*getVerletList()->getSystem()->comm, observedEnergy, esum, std::plus<real>());
+        return esum;
+      }
+
+      if (verletList->isCompact()) {
+        return computeEnergyCompact();
+      }
+
       real e = 0.0;
       real es = 0.0;
       for (PairList::Iterator it(verletList->getPairs()); it.isValid(); ++it) {
@@ -161,6 +343,274 @@ namespace espressopp {
       return esum;
     }
 
+    template < typename _Potential > inline void
+    VerletListInteractionTemplate < _Potential >::
+    addForcesCompact() {
+      if (esutil::Threads::getNumThreads() > 1) {
+        addForcesCompactThreaded();
+        return;
+      }
+
+      if (Potential::hasBatchKernel) {
+        addForcesCompactBatched();
+        return;
+      }
+
+      // neighbours of particle i are stored contiguously, so the force on i
+      // is accumulated locally and written back once
+      storage::ParticleArrays &pa = verletList->getParticleArrays();
+      const std::vector<int> &offsets = verletList->getNeighborOffsets();
+      const std::vector<int> &neighbors = verletList->getNeighborIndices();
+      const int nRows = offsets.size() - 1;
+
+      for (int i = 0; i < nRows; ++i) {
+        Particle &p1 = pa.getParticle(i);
+        int type1 = p1.type();
+        Real3D f1(0.0);
+        for (int k = offsets[i]; k < offsets[i+1]; ++k) {
+          Particle &p2 = pa.getParticle(neighbors[k]);
+          const Potential &potential = getPotential(type1, p2.type());
+
+          Real3D force(0.0);
+          if(potential._computeForce(force, p1, p2)) {
+            f1 += force;
+            p2.force() -= force;
+            LOG4ESPP_TRACE(_Potential::theLogger, "id1=" << p1.id() << " id2=" << p2.id() << " force=" << force);
+          }
+        }
+        p1.force() += f1;
+      }
+    }
+
+    /* The batched variants hand runs of up to batchSize consecutive pairs
+       with the same types to the vectorised kernel of the potential and
+       add the forces in list order. */
+    template < typename _Potential > inline void
+    VerletListInteractionTemplate < _Potential >::
+    computeForcesBatch(const Potential &potential, int n,
+                       Particle *const *p1, Particle *const *p2, Real3D *force) {
+      real dx[batchSize], dy[batchSize], dz[batchSize];
+      real distSqr[batchSize], qq[batchSize], ffactor[batchSize];
+
+      for (int j = 0; j < n; ++j) {
+        Real3D dist = p1[j]->position() - p2[j]->position();
+        dx[j] = dist[0];
+        dy[j] = dist[1];
+        dz[j] = dist[2];
+        distSqr[j] = dist.sqr();
+        qq[j] = p1[j]->q() * p2[j]->q();
+      }
+
+      potential._computeForceFactors(n, distSqr, qq, ffactor);
+
+      for (int j = 0; j < n; ++j) {
+        force[j] = Real3D(dx[j] * ffactor[j], dy[j] * ffactor[j], dz[j] * ffactor[j]);
+      }
+    }
+
+    template < typename _Potential > inline void
+    VerletListInteractionTemplate < _Potential >::
+    addForcesBatched(long begin, long end) {
+      PairList &pairs = verletList->getPairs();
+      Particle *p1[batchSize], *p2[batchSize];
+      Real3D force[batchSize];
+
+      long k = begin;
+      while (k < end) {
+        int type1 = pairs[k].first->type();
+        int type2 = pairs[k].second->type();
+        int n = 0;
+        while (k < end && n < batchSize &&
+               pairs[k].first->type() == type1 && pairs[k].second->type() == type2) {
+          p1[n] = pairs[k].first;
+          p2[n] = pairs[k].second;
+          ++n;
+          ++k;
+        }
+
+        computeForcesBatch(getPotential(type1, type2), n, p1, p2, force);
+
+        for (int j = 0; j < n; ++j) {
+          p1[j]->force() += force[j];
+          p2[j]->force() -= force[j];
+        }
+      }
+    }
+
+    /* The compact batched variant reads positions, charges and types
+       from the particle arrays only and accumulates the forces in the
+       force arrays, which are added to the particles at the end. */
+    template < typename _Potential > inline void
+    VerletListInteractionTemplate < _Potential >::
+    computeForcesBatchArrays(const Potential &potential, const storage::ParticleArrays &pa,
+                             int i, int n, const int *idx, Real3D *force) {
+      real dx[batchSize], dy[batchSize], dz[batchSize];
+      real distSqr[batchSize], qq[batchSize], ffactor[batchSize];
+      const real xi = pa.x[i], yi = pa.y[i], zi = pa.z[i], qi = pa.q[i];
+
+      for (int j = 0; j < n; ++j) {
+        const int jj = idx[j];
+        dx[j] = xi - pa.x[jj];
+        dy[j] = yi - pa.y[jj];
+        dz[j] = zi - pa.z[jj];
+        distSqr[j] = dx[j]*dx[j] + dy[j]*dy[j] + dz[j]*dz[j];
+        qq[j] = qi * pa.q[jj];
+      }
+
+      potential._computeForceFactors(n, distSqr, qq, ffactor);
+
+      for (int j = 0; j < n; ++j) {
+        force[j] = Real3D(dx[j] * ffactor[j], dy[j] * ffactor[j], dz[j] * ffactor[j]);
+      }
+    }
+
+    template < typename _Potential > inline void
+    VerletListInteractionTemplate < _Potential >::
+    addForcesCompactBatched() {
+      storage::ParticleArrays &pa = verletList->getParticleArrays();
+      const std::vector<int> &offsets = verletList->getNeighborOffsets();
+      const std::vector<int> &neighbors = verletList->getNeighborIndices();
+      const int nRows = offsets.size() - 1;
+      Real3D force[batchSize];
+
+      pa.ensureContents();
+      pa.zeroForces();
+
+      for (int i = 0; i < nRows; ++i) {
+        const int type1 = pa.type[i];
+        Real3D f1(0.0);
+        int k = offsets[i];
+        while (k < offsets[i+1]) {
+          const int first = k;
+          const int type2 = pa.type[neighbors[k]];
+          while (k < offsets[i+1] && k - first < batchSize &&
+                 pa.type[neighbors[k]] == type2) ++k;
+          const int n = k - first;
+
+          computeForcesBatchArrays(getPotential(type1, type2), pa, i, n, &neighbors[first], force);
+
+          for (int j = 0; j < n; ++j) {
+            const int jj = neighbors[first + j];
+            f1 += force[j];
+            pa.fx[jj] -= force[j][0];
+            pa.fy[jj] -= force[j][1];
+            pa.fz[jj] -= force[j][2];
+          }
+        }
+        pa.fx[i] += f1[0];
+        pa.fy[i] += f1[1];
+        pa.fz[i] += f1[2];
+      }
+
+      pa.addForcesToParticles();
+    }
+
+    /* The threaded variants compute the force of every pair concurrently
+       and add them to the particles in a second, serial sweep in the
+       same order as the serial loops, so the forces are bitwise
+       independent of the number of threads. The sweep stays serial, two
+       vector additions per pair, and bounds the speedup for cheap
+       potentials; the all-pairs cell list interactions avoid it by
+       colouring the cells (CellTasks). The potentials are looked up with
+       the read-only Array2D::get(). */
+    template < typename _Potential > inline void
+    VerletListInteractionTemplate < _Potential >::
+    addForcesThreaded(long begin, long end) {
+      PairList &pairs = verletList->getPairs();
+      const long n = end - begin;
+      pairForces.resize(n);
+
+      #pragma omp parallel for schedule(static)
+      for (long k = 0; k < n; ++k) {
+        const Particle &p1 = *pairs[begin + k].first;
+        const Particle &p2 = *pairs[begin + k].second;
+        const Potential &potential = potentialArray.get(p1.type(), p2.type());
+        Real3D force(0.0);
+        if (!potential._computeForce(force, p1, p2)) force = 0.0;
+        pairForces[k] = force;
+      }
+
+      for (long k = 0; k < n; ++k) {
+        pairs[begin + k].first->force() += pairForces[k];
+        pairs[begin + k].second->force() -= pairForces[k];
+      }
+    }
+
+    template < typename _Potential > inline void
+    VerletListInteractionTemplate < _Potential >::
+    addForcesCompactThreaded() {
+      storage::ParticleArrays &pa = verletList->getParticleArrays();
+      const std::vector<int> &offsets = verletList->getNeighborOffsets();
+      const std::vector<int> &neighbors = verletList->getNeighborIndices();
+      const int nRows = offsets.size() - 1;
+      pairForces.resize(neighbors.size());
+
+      // rows have very different lengths at interfaces, balance dynamically;
+      // potentials with a batch kernel only need the particle arrays
+      if (Potential::hasBatchKernel) {
+        pa.ensureContents();
+        #pragma omp parallel for schedule(dynamic, 64)
+        for (int i = 0; i < nRows; ++i) {
+          const int type1 = pa.type[i];
+          int k = offsets[i];
+          while (k < offsets[i+1]) {
+            const int first = k;
+            const int type2 = pa.type[neighbors[k]];
+            while (k < offsets[i+1] && k - first < batchSize &&
+                   pa.type[neighbors[k]] == type2) ++k;
+            computeForcesBatchArrays(potentialArray.get(type1, type2), pa, i, k - first,
+                                     &neighbors[first], &pairForces[first]);
+          }
+        }
+      } else {
+        #pragma omp parallel for schedule(dynamic, 64)
+        for (int i = 0; i < nRows; ++i) {
+          const Particle &p1 = pa.getParticle(i);
+          int type1 = p1.type();
+          for (int k = offsets[i]; k < offsets[i+1]; ++k) {
+            const Particle &p2 = pa.getParticle(neighbors[k]);
+            const Potential &potential = potentialArray.get(type1, p2.type());
+            Real3D force(0.0);
+            if (!potential._computeForce(force, p1, p2)) force = 0.0;
+            pairForces[k] = force;
+          }
+        }
+      }
+
+      for (int i = 0; i < nRows; ++i) {
+        Real3D f1(0.0);
+        for (int k = offsets[i]; k < offsets[i+1]; ++k) {
+          f1 += pairForces[k];
+          pa.getParticle(neighbors[k]).force() -= pairForces[k];
+        }
+        pa.getParticle(i).force() += f1;
+      }
+    }
+
+    template < typename _Potential > inline real
+    VerletListInteractionTemplate < _Potential >::
+    computeEnergyCompact() {
+      storage::ParticleArrays &pa = verletList->getParticleArrays();
+      const std::vector<int> &offsets = verletList->getNeighborOffsets();
+      const std::vector<int> &neighbors = verletList->getNeighborIndices();
+      const int nRows = offsets.size() - 1;
+
+      real es = 0.0;
+      for (int i = 0; i < nRows; ++i) {
+        Particle &p1 = pa.getParticle(i);
+        int type1 = p1.type();
+        for (int k = offsets[i]; k < offsets[i+1]; ++k) {
+          Particle &p2 = pa.getParticle(neighbors[k]);
+          const Potential &potential = getPotential(type1, p2.type());
+          es += potential._computeEnergy(p1, p2);
+        }
+      }
+
+      real esum;
+      boost::mpi::all_reduce(*getVerletList()->getSystem()->comm, es, esum, std::plus<real>());
+      return esum;
+    }
+
     template < typename _Potential > inline real
     VerletListInteractionTemplate < _Potential >::
     computeEnergyDeriv() {
@@ -194,6 +644,12 @@ namespace espressopp {
     computeVirial() {
       LOG4ESPP_DEBUG(_Potential::theLogger, "loop over verlet list pairs and sum up virial");
       
+      if (observablesComputed & VIRIAL) {
+        real wsum;
+        boost::mpi::all_reduce(*mpiWorld, observedVirial, wsum, std::plus<real>());
+        return wsum;
+      }
+
       real w = 0.0;
       for (PairList::Iterator it(verletList->getPairs());                
            it.isValid(); ++it) {                                         
@@ -223,6 +679,13 @@ namespace espressopp {
     computeVirialTensor(Tensor& w) {
       LOG4ESPP_DEBUG(_Potential::theLogger, "loop over verlet list pairs and sum up virial tensor");
 
+      if (observablesComputed & VIRIAL_TENSOR) {
+        Tensor wsum(0.0);
+        boost::mpi::all_reduce(*mpiWorld, (double*)&observedVirialTensor, 6, (double*)&wsum, std::plus<double>());
+        w += wsum;
+        return;
+      }
+
       Tensor wlocal(0.0);
       for (PairList::Iterator it(verletList->getPairs());
            it.isValid(); ++it) {
@@ -100,6 +100,8 @@ public:
   virtual int bondType() { return Nonbonded; }
 
 protected:
+  bool computeScaledForce(Real3D &force, Particle &p1, Particle &p2, const bc::BC &bc);
+
   int ntypes;
   shared_ptr<VerletList> verletList;
   esutil::Array2D<Potential, esutil::enlarge> potentialArray;
@@ -108,35 +110,64 @@ protected:
   shared_ptr<esutil::ParticlePairScaling> pair_scaling_;
 };
 
+template <typename _Potential> inline bool
+VerletListScaleInteractionTemplate<_Potential>::
+computeScaledForce(Real3D &force, Particle &p1, Particle &p2, const bc::BC &bc) {
+  const Potential &potential = getPotential(p1.type(), p2.type());
+
+  Real3D dist;
+  bc.getMinimumImageVectorBox(dist, p1.position(), p2.position());
+  if(!potential._computeForce(force, p1, p2, dist)) return false;
+
+  real pair_scaling = pair_scaling_->getPairScaling(p1.id(), p2.id());
+  if (has_max_force_ && pair_scaling < 1.0) {
+    if (force.isNaNInf()) {
+      force = (dist / dist.abs()) * max_force_;
+    } else {
+      real abs_force = force.abs();
+      if (abs_force > max_force_) {
+        force = (force / abs_force) * max_force_;
+      }
+    }
+  }
+  force *= pair_scaling;
+  return true;
+}
+
 template <typename _Potential> inline void
 VerletListScaleInteractionTemplate<_Potential>::
 addForces() {
   LOG4ESPP_DEBUG(_Potential::theLogger, "loop over verlet list pairs and add forces");
   const bc::BC& bc = *(verletList->getSystemRef()).bc;  // boundary conditions
+
+  if (verletList->isCompact()) {
+    storage::ParticleArrays &pa = verletList->getParticleArrays();
+    const std::vector<int> &offsets = verletList->getNeighborOffsets();
+    const std::vector<int> &neighbors = verletList->getNeighborIndices();
+    const int nRows = offsets.size() - 1;
+    for (int i = 0; i < nRows; ++i) {
+      Particle &p1 = pa.getParticle(i);
+      Real3D f1(0.0);
+      for (int k = offsets[i]; k < offsets[i+1]; ++k) {
+        Particle &p2 = pa.getParticle(neighbors[k]);
+        Real3D force(0.0);
+        if (computeScaledForce(force, p1, p2, bc)) {
+          f1 += force;
+          p2.force() -= force;
+        }
+      }
+      p1.force() += f1;
+    }
+    return;
+  }
+
   for (PairList::Iterator it(verletList->getPairs()); it.isValid(); ++it) {
     Particle &p1 = *it->first;
     Particle &p2 = *it->second;
-    int type1 = p1.type();
-    int type2 = p2.type();
-    const Potential &potential = getPotential(type1, type2);
-
     Real3D force(0.0);
-    Real3D dist;
-    bc.getMinimumImageVectorBox(dist, p1.position(), p2.position());
-    if(potential._computeForce(force, p1, p2, dist)) {
-      real pair_scaling = pair_scaling_->getPairScaling(p1.id(), p2.id());
-      if (has_max_force_ && pair_scaling < 1.0) {
-        if (force.isNaNInf()) {
-          force = (dist / dist.abs()) * max_force_;
-        } else {
-          real abs_force = force.abs();
-          if (abs_force > max_force_) {
-            force = (force / abs_force) * max_force_;
-          }
-        }
-      }
-      p1.force() += pair_scaling*force;
-      p2.force() -= pair_scaling*force;
+    if (computeScaledForce(force, p1, p2, bc)) {
+      p1.force() += force;
+      p2.force() -= force;
     }
   }
 }
@@ -0,0 +1,541 @@
+/*
+  Copyright (C) 2016
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "python.hpp"
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include "Checkpoint.hpp"
+#include "MPIIOTypes.hpp"
+#include "storage/Storage.hpp"
+#include "iterator/CellListIterator.hpp"
+#include "integrator/Extension.hpp"
+#include "bc/BC.hpp"
+#include "esutil/RNG.hpp"
+#include "esutil/CounterRNG.hpp"
+#include "esutil/Error.hpp"
+#include "esutil/Profiler.hpp"
+
+namespace espressopp {
+  namespace io {
+
+    LOG4ESPP_LOGGER(Checkpoint::logger, "Checkpoint");
+
+    namespace {
+      const char MAGIC[8] = { 'E', 'S', 'P', 'P', 'C', 'K', 'P', '1' };
+      const int VERSION = 1;
+
+      template < typename T >
+      inline char *put(char *dst, T value) {
+        std::memcpy(dst, &value, sizeof(T));
+        return dst + sizeof(T);
+      }
+
+      template < typename T >
+      inline const char *get(const char *src, T &value) {
+        std::memcpy(&value, src, sizeof(T));
+        return src + sizeof(T);
+      }
+
+      /** tuples of particle ids as int64 records */
+      void packIds(const std::vector< longint > &ids, std::vector< char > &buf) {
+        buf.resize(ids.size() * sizeof(boost::int64_t));
+        char *dst = buf.empty() ? 0 : &buf[0];
+        for (size_t i = 0; i < ids.size(); ++i) dst = put(dst, (boost::int64_t)ids[i]);
+      }
+
+      void unpackIds(const std::vector< char > &buf, std::vector< longint > &ids) {
+        ids.resize(buf.size() / sizeof(boost::int64_t));
+        const char *src = buf.empty() ? 0 : &buf[0];
+        for (size_t i = 0; i < ids.size(); ++i) {
+          boost::int64_t id;
+          src = get(src, id);
+          ids[i] = id;
+        }
+      }
+
+      /** the headers are stored field by field, without padding */
+      const size_t HEADER_SIZE = 8 + 4 * sizeof(boost::int32_t)
+                               + 2 * sizeof(boost::int64_t) + 4 * sizeof(double);
+      const size_t SECTION_HEADER_SIZE = 2 * sizeof(boost::int32_t) + sizeof(boost::int64_t);
+
+      void packHeader(const Checkpoint::Header &header, char *dst) {
+        std::memcpy(dst, header.magic, 8);
+        dst = put(dst + 8, header.version);
+        dst = put(dst, header.nSections);
+        dst = put(dst, header.nRanks);
+        dst = put(dst, header.recordSize);
+        dst = put(dst, header.step);
+        dst = put(dst, header.seed);
+        dst = put(dst, header.dt);
+        for (int d = 0; d < 3; ++d) dst = put(dst, header.box[d]);
+      }
+
+      void unpackHeader(const char *src, Checkpoint::Header &header) {
+        std::memcpy(header.magic, src, 8);
+        src = get(src + 8, header.version);
+        src = get(src, header.nSections);
+        src = get(src, header.nRanks);
+        src = get(src, header.recordSize);
+        src = get(src, header.step);
+        src = get(src, header.seed);
+        src = get(src, header.dt);
+        for (int d = 0; d < 3; ++d) src = get(src, header.box[d]);
+      }
+    }
+
+    Checkpoint::Checkpoint(shared_ptr< System > system,
+                           shared_ptr< integrator::MDIntegrator > _integrator,
+                           std::string _file_name)
+      : ParticleAccess(system), integrator(_integrator), file_name(_file_name)
+    {
+      if (!system->storage) {
+        throw std::runtime_error("system has no storage");
+      }
+    }
+
+    int Checkpoint::numSections() {
+      // particles, the lists, RNG sizes and states, extensions
+      return 1 + pairLists.size() + tripleLists.size() + quadrupleLists.size()
+               + verletLists.size() + 3;
+    }
+
+    void Checkpoint::writeSection(MPI_File fh, MPI_Offset &offset, int kind, int width,
+                                  const std::vector< char > &local) {
+      mpi::communicator &comm = *getSystem()->comm;
+
+      // the parts of the processes follow each other in rank order
+      boost::int64_t mine = local.size(), upto = 0, total = 0;
+      mpi::scan(comm, mine, upto, std::plus< boost::int64_t >());
+      mpi::all_reduce(comm, mine, total, std::plus< boost::int64_t >());
+
+      if (comm.rank() == 0) {
+        char header[SECTION_HEADER_SIZE];
+        char *dst = put(header, (boost::int32_t)kind);
+        dst = put(dst, (boost::int32_t)width);
+        put(dst, (boost::int64_t)(total / width));
+        MPI_File_write_at(fh, offset, header, SECTION_HEADER_SIZE, MPI_BYTE, MPI_STATUS_IGNORE);
+      }
+      // a part may exceed the int count of MPI_BYTEs
+      MPI_Datatype bytesType = createBytesType(local.size());
+      MPI_File_write_at_all(fh, offset + SECTION_HEADER_SIZE + (upto - mine),
+                            local.empty() ? 0 : const_cast< char* >(&local[0]),
+                            1, bytesType, MPI_STATUS_IGNORE);
+      MPI_Type_free(&bytesType);
+      offset += SECTION_HEADER_SIZE + total;
+    }
+
+    boost::int64_t Checkpoint::readSection(MPI_File fh, MPI_Offset &offset, int kind, int width) {
+      char buf[SECTION_HEADER_SIZE];
+      MPI_File_read_at_all(fh, offset, buf, SECTION_HEADER_SIZE, MPI_BYTE, MPI_STATUS_IGNORE);
+      SectionHeader header;
+      const char *src = get(buf, header.kind);
+      src = get(src, header.width);
+      get(src, header.count);
+      // all processes read the same header and fail together
+      if (header.kind != kind || header.width != width) {
+        std::stringstream msg;
+        msg << "Checkpoint: expected section " << kind << " of width " << width
+            << " but found section " << header.kind << " of width " << header.width
+            << "; register the same lists as for writing";
+        throw std::runtime_error(msg.str());
+      }
+      offset += SECTION_HEADER_SIZE;
+      return header.count;
+    }
+
+    void Checkpoint::checkAdded(const char *what, boost::int64_t count, longint added) {
+      // every tuple must be added by the process of its key particle; a
+      // tuple whose other particles are not there is silently dropped
+      longint total = 0;
+      mpi::all_reduce(*getSystem()->comm, added, total, std::plus< longint >());
+      if (total != count) {
+        std::stringstream msg;
+        msg << "Checkpoint: " << count - total << " of " << count << " " << what
+            << "s were not restored; their particles are not within the ghost layer";
+        throw std::runtime_error(msg.str());
+      }
+    }
+
+    void Checkpoint::readAll(MPI_File fh, MPI_Offset offset, std::vector< char > &buf) {
+      MPI_Datatype bytesType = createBytesType(buf.size());
+      MPI_File_read_at_all(fh, offset, buf.empty() ? 0 : &buf[0], 1, bytesType, MPI_STATUS_IGNORE);
+      MPI_Type_free(&bytesType);
+    }
+
+    void Checkpoint::writeParticles(MPI_File fh, MPI_Offset &offset) {
+      System &system = getSystemRef();
+      const size_t recordSize = Particle::stateSize();
+
+      std::vector< char > buf(system.storage->getNRealParticles() * recordSize);
+      char *dst = buf.empty() ? 0 : &buf[0];
+      CellList realCells = system.storage->getRealCells();
+      for (iterator::CellListIterator cit(realCells); !cit.isDone(); ++cit) {
+        dst = cit->packState(dst);
+      }
+      writeSection(fh, offset, PARTICLES, recordSize, buf);
+    }
+
+    void Checkpoint::readParticles(MPI_File fh, MPI_Offset &offset) {
+      System &system = getSystemRef();
+      const size_t recordSize = Particle::stateSize();
+      boost::int64_t n = readSection(fh, offset, PARTICLES, recordSize);
+
+      // an equal block for every process, decompose() sorts them out
+      int rank = system.comm->rank(), size = system.comm->size();
+      boost::int64_t begin = n * rank / size, end = n * (rank + 1) / size;
+      std::vector< char > buf((end - begin) * recordSize);
+      readAll(fh, offset + begin * recordSize, buf);
+      offset += n * recordSize;
+
+      std::vector< Particle > parts(end - begin);
+      const char *src = buf.empty() ? 0 : &buf[0];
+      for (size_t i = 0; i < parts.size(); ++i) {
+        src = parts[i].unpackState(src);
+        parts[i].ghost() = false;
+      }
+      system.storage->appendParticles(parts);
+      system.storage->decompose();
+
+      LOG4ESPP_INFO(logger, "read " << parts.size() << " of " << n << " particles");
+    }
+
+    void Checkpoint::writeRNG(MPI_File fh, MPI_Offset &offset) {
+      System &system = getSystemRef();
+      std::string state = system.rng ? system.rng->getState() : std::string();
+
+      std::vector< char > size(sizeof(boost::int64_t));
+      put(&size[0], (boost::int64_t)state.size());
+      writeSection(fh, offset, RNG_SIZES, sizeof(boost::int64_t), size);
+      writeSection(fh, offset, RNG_STATES, 1, std::vector< char >(state.begin(), state.end()));
+    }
+
+    void Checkpoint::readRNG(MPI_File fh, MPI_Offset &offset, const Header &header) {
+      System &system = getSystemRef();
+      boost::int64_t nRanks = readSection(fh, offset, RNG_SIZES, sizeof(boost::int64_t));
+      std::vector< char > buf(nRanks * sizeof(boost::int64_t));
+      readAll(fh, offset, buf);
+      offset += buf.size();
+      std::vector< longint > sizes;
+      unpackIds(buf, sizes);
+
+      boost::int64_t bytes = readSection(fh, offset, RNG_STATES, 1);
+      int rank = system.comm->rank();
+      if (nRanks == system.comm->size()) {
+        // every process continues its own sequence
+        MPI_Offset before = 0;
+        for (int r = 0; r < rank; ++r) before += sizes[r];
+        std::vector< char > state(sizes[rank]);
+        readAll(fh, offset + before, state);
+        if (system.rng && !state.empty()) {
+          system.rng->setState(std::string(state.begin(), state.end()));
+        }
+      } else {
+        std::vector< char > none;
+        readAll(fh, offset, none);
+        if (system.rng) {
+          // a seed of its own for every step, so that restarts from
+          // different checkpoints do not repeat the same numbers
+          esutil::CounterRNG::uint32 r[4];
+          esutil::CounterRNG(header.seed).raw(esutil::CounterRNG::CHECKPOINT, header.step, 0, 0, r);
+          long seed = (long)(r[0] & 0x3fffffff);
+          LOG4ESPP_WARN(logger, "checkpoint written by " << nRanks << " processes, "
+                        "the RNG is reseeded with seed " << seed);
+          system.rng->seed(seed);
+        }
+      }
+      offset += bytes;
+    }
+
+    void Checkpoint::writeExtensions(MPI_File fh, MPI_Offset &offset) {
+      // the states are the same on all processes, rank 0 writes them
+      std::vector< char > buf;
+      if (getSystem()->comm->rank() == 0) {
+        int n = integrator->getNumberOfExtensions();
+        std::vector< std::string > states(n);
+        size_t bytes = sizeof(boost::int64_t);
+        for (int k = 0; k < n; ++k) {
+          states[k] = integrator->getExtension(k)->getState();
+          bytes += sizeof(boost::int64_t) + states[k].size();
+        }
+        buf.resize(bytes);
+        char *dst = put(&buf[0], (boost::int64_t)n);
+        for (int k = 0; k < n; ++k) {
+          dst = put(dst, (boost::int64_t)states[k].size());
+          std::memcpy(dst, states[k].data(), states[k].size());
+          dst += states[k].size();
+        }
+      }
+      writeSection(fh, offset, EXTENSIONS, 1, buf);
+    }
+
+    void Checkpoint::readExtensions(MPI_File fh, MPI_Offset &offset) {
+      boost::int64_t bytes = readSection(fh, offset, EXTENSIONS, 1);
+      std::vector< char > buf(bytes);
+      readAll(fh, offset, buf);
+      offset += bytes;
+
+      boost::int64_t n = 0;
+      const char *src = buf.empty() ? 0 : get(&buf[0], n);
+      if (n != integrator->getNumberOfExtensions()) {
+        std::stringstream msg;
+        msg << "Checkpoint: checkpoint has " << n << " extensions, the integrator has "
+            << integrator->getNumberOfExtensions();
+        throw std::runtime_error(msg.str());
+      }
+      for (int k = 0; k < n; ++k) {
+        boost::int64_t len;
+        src = get(src, len);
+        if (len > 0) {
+          integrator->getExtension(k)->setState(std::string(src, len));
+        }
+        src += len;
+      }
+    }
+
+    void Checkpoint::write(std::string filename) {
+      esutil::Profiler::Scope profile("checkpoint");
+      System &system = getSystemRef();
+      shared_ptr< mpi::communicator > comm = system.comm;
+      esutil::Error err(comm);
+
+      std::string tmpName = filename + ".tmp";
+      MPI_File fh;
+      int rc = MPI_File_open(*comm, const_cast< char* >(tmpName.c_str()),
+                             MPI_MODE_WRONLY | MPI_MODE_CREATE, MPI_INFO_NULL, &fh);
+      if (rc != MPI_SUCCESS) {
+        std::stringstream msg;
+        msg << "Checkpoint: cannot open file " << tmpName;
+        err.setException(msg.str());
+      }
+      err.checkException();
+      MPI_File_set_size(fh, 0);
+
+      if (comm->rank() == 0) {
+        Header header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.nSections = numSections();
+        header.nRanks = comm->size();
+        header.recordSize = Particle::stateSize();
+        header.step = integrator->getStep();
+        header.seed = system.rng ? system.rng->get_seed() : 0;
+        header.dt = integrator->getTimeStep();
+        Real3D L = system.bc->getBoxL();
+        for (int d = 0; d < 3; ++d) header.box[d] = L[d];
+        char buf[HEADER_SIZE];
+        packHeader(header, buf);
+        MPI_File_write_at(fh, 0, buf, HEADER_SIZE, MPI_BYTE, MPI_STATUS_IGNORE);
+      }
+      MPI_Offset offset = HEADER_SIZE;
+
+      writeParticles(fh, offset);
+
+      // every tuple is stored by the owner of its key particle
+      std::vector< char > buf;
+      for (size_t i = 0; i < pairLists.size(); ++i) {
+        packIds(pairLists[i]->getPairList(), buf);
+        writeSection(fh, offset, PAIRS, 2 * sizeof(boost::int64_t), buf);
+      }
+      for (size_t i = 0; i < tripleLists.size(); ++i) {
+        packIds(tripleLists[i]->getTripleList(), buf);
+        writeSection(fh, offset, TRIPLES, 3 * sizeof(boost::int64_t), buf);
+      }
+      for (size_t i = 0; i < quadrupleLists.size(); ++i) {
+        packIds(quadrupleLists[i]->getQuadrupleList(), buf);
+        writeSection(fh, offset, QUADRUPLES, 4 * sizeof(boost::int64_t), buf);
+      }
+      // the exclusions are the same on all processes
+      for (size_t i = 0; i < verletLists.size(); ++i) {
+        std::vector< longint > ids;
+        if (comm->rank() == 0) {
+          const ExcludeList &exList = *verletLists[i]->getExcludeList();
+          for (ExcludeList::const_iterator it = exList.begin(); it != exList.end(); ++it) {
+            if (it->first < it->second) {
+              ids.push_back(it->first);
+              ids.push_back(it->second);
+            }
+          }
+        }
+        packIds(ids, buf);
+        writeSection(fh, offset, EXCLUSIONS, 2 * sizeof(boost::int64_t), buf);
+      }
+
+      writeRNG(fh, offset);
+      writeExtensions(fh, offset);
+
+      MPI_File_close(&fh);
+
+      // replace the previous checkpoint only by a complete one
+      if (comm->rank() == 0 && std::rename(tmpName.c_str(), filename.c_str()) != 0) {
+        std::stringstream msg;
+        msg << "Checkpoint: cannot rename " << tmpName << " to " << filename;
+        err.setException(msg.str());
+      }
+      err.checkException();
+
+      LOG4ESPP_INFO(logger, "wrote checkpoint " << filename << " of step "
+                    << integrator->getStep() << ", " << offset << " bytes");
+    }
+
+    void Checkpoint::read(std::string filename) {
+      esutil::Profiler::Scope profile("checkpoint");
+      System &system = getSystemRef();
+      shared_ptr< mpi::communicator > comm = system.comm;
+      esutil::Error err(comm);
+
+      longint nLocal = system.storage->getNRealParticles(), nTotal = 0;
+      mpi::all_reduce(*comm, nLocal, nTotal, std::plus< longint >());
+      if (nTotal > 0) {
+        throw std::runtime_error("Checkpoint: the system must not have particles before read()");
+      }
+
+      MPI_File fh;
+      int rc = MPI_File_open(*comm, const_cast< char* >(filename.c_str()),
+                             MPI_MODE_RDONLY, MPI_INFO_NULL, &fh);
+      if (rc != MPI_SUCCESS) {
+        std::stringstream msg;
+        msg << "Checkpoint: cannot open file " << filename;
+        err.setException(msg.str());
+      }
+      err.checkException();
+
+      Header header;
+      char headerBuf[HEADER_SIZE];
+      MPI_File_read_at_all(fh, 0, headerBuf, HEADER_SIZE, MPI_BYTE, MPI_STATUS_IGNORE);
+      unpackHeader(headerBuf, header);
+      std::stringstream msg;
+      if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION) {
+        msg << "Checkpoint: " << filename << " is not a checkpoint of version " << VERSION;
+      } else if (header.recordSize != (boost::int32_t)Particle::stateSize()) {
+        msg << "Checkpoint: " << filename << " has particle records of "
+            << header.recordSize << " bytes, this build uses " << Particle::stateSize();
+      } else if (header.nSections != numSections()) {
+        msg << "Checkpoint: " << filename << " has " << header.nSections
+            << " sections, expected " << numSections() << "; register the same lists as for writing";
+      }
+      if (!msg.str().empty()) {
+        MPI_File_close(&fh);
+        throw std::runtime_error(msg.str());
+      }
+
+      // the box may have changed, e.g. by a barostat
+      Real3D L = system.bc->getBoxL();
+      Real3D boxL(header.box[0], header.box[1], header.box[2]);
+      if (boxL != L) {
+        system.scaleVolume(Real3D(boxL[0] / L[0], boxL[1] / L[1], boxL[2] / L[2]), false);
+      }
+
+      MPI_Offset offset = HEADER_SIZE;
+      readParticles(fh, offset);
+
+      // every process reads all tuples and keeps those of its particles
+      std::vector< char > buf;
+      std::vector< longint > ids;
+      for (size_t i = 0; i < pairLists.size(); ++i) {
+        buf.resize(readSection(fh, offset, PAIRS, 2 * sizeof(boost::int64_t)) * 2 * sizeof(boost::int64_t));
+        readAll(fh, offset, buf);
+        offset += buf.size();
+        unpackIds(buf, ids);
+        longint added = 0;
+        try {
+          for (size_t k = 0; k < ids.size(); k += 2)
+            if (pairLists[i]->iadd(ids[k], ids[k+1])) ++added;
+        } catch (std::exception &e) {
+          err.setException(e.what());
+        }
+        err.checkException();
+        checkAdded("pair", ids.size() / 2, added);
+      }
+      for (size_t i = 0; i < tripleLists.size(); ++i) {
+        buf.resize(readSection(fh, offset, TRIPLES, 3 * sizeof(boost::int64_t)) * 3 * sizeof(boost::int64_t));
+        readAll(fh, offset, buf);
+        offset += buf.size();
+        unpackIds(buf, ids);
+        longint added = 0;
+        try {
+          for (size_t k = 0; k < ids.size(); k += 3)
+            if (tripleLists[i]->iadd(ids[k], ids[k+1], ids[k+2])) ++added;
+        } catch (std::exception &e) {
+          err.setException(e.what());
+        }
+        err.checkException();
+        checkAdded("triple", ids.size() / 3, added);
+      }
+      for (size_t i = 0; i < quadrupleLists.size(); ++i) {
+        buf.resize(readSection(fh, offset, QUADRUPLES, 4 * sizeof(boost::int64_t)) * 4 * sizeof(boost::int64_t));
+        readAll(fh, offset, buf);
+        offset += buf.size();
+        unpackIds(buf, ids);
+        longint added = 0;
+        try {
+          for (size_t k = 0; k < ids.size(); k += 4)
+            if (quadrupleLists[i]->iadd(ids[k], ids[k+1], ids[k+2], ids[k+3])) ++added;
+        } catch (std::exception &e) {
+          err.setException(e.what());
+        }
+        err.checkException();
+        checkAdded("quadruple", ids.size() / 4, added);
+      }
+      for (size_t i = 0; i < verletLists.size(); ++i) {
+        buf.resize(readSection(fh, offset, EXCLUSIONS, 2 * sizeof(boost::int64_t)) * 2 * sizeof(boost::int64_t));
+        readAll(fh, offset, buf);
+        offset += buf.size();
+        unpackIds(buf, ids);
+        for (size_t k = 0; k < ids.size(); k += 2)
+          verletLists[i]->exclude(ids[k], ids[k+1]);
+        // the list was built by decompose() before the exclusions were known
+        verletLists[i]->rebuild();
+      }
+
+      readRNG(fh, offset, header);
+      readExtensions(fh, offset);
+
+      MPI_File_close(&fh);
+
+      integrator->setTimeStep(header.dt);
+      integrator->setStep(header.step);
+
+      LOG4ESPP_INFO(logger, "read checkpoint " << filename << " of step " << header.step
+                    << " written by " << header.nRanks << " processes");
+    }
+
+    // Python wrapping
+    void Checkpoint::registerPython() {
+
+      using namespace espressopp::python;
+
+      class_< Checkpoint, bases< ParticleAccess >, boost::noncopyable >
+      ("io_Checkpoint", init< shared_ptr< System >,
+                              shared_ptr< integrator::MDIntegrator >,
+                              std::string >())
+        .add_property("filename", &Checkpoint::getFilename,
+                                  &Checkpoint::setFilename)
+        .def("add_pair_list", &Checkpoint::addPairList)
+        .def("add_triple_list", &Checkpoint::addTripleList)
+        .def("add_quadruple_list", &Checkpoint::addQuadrupleList)
+        .def("add_verlet_list", &Checkpoint::addVerletList)
+        .def("write", &Checkpoint::write)
+        .def("read", &Checkpoint::read)
+      ;
+    }
+  }
+}
@@ -0,0 +1,152 @@
+/*
+  Copyright (C) 2016
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ESPP_CLASS
+#ifndef _IO_CHECKPOINT_HPP
+#define _IO_CHECKPOINT_HPP
+
+#include "mpi.hpp"
+#include "types.hpp"
+#include "System.hpp"
+#include "integrator/MDIntegrator.hpp"
+#include "ParticleAccess.hpp"
+#include "FixedPairList.hpp"
+#include "FixedTripleList.hpp"
+#include "FixedQuadrupleList.hpp"
+#include "VerletList.hpp"
+#include "log4espp.hpp"
+#include <boost/cstdint.hpp>
+#include <string>
+#include <vector>
+
+namespace espressopp {
+  namespace io {
+
+    /** Binary checkpoint of the dynamical state of a simulation, written
+        and read with collective MPI-IO.
+
+        A checkpoint holds the particles (properties, position, momentum
+        and local data, i.e. the image), the registered fixed pair,
+        triple and quadruple lists, the exclusions of the registered
+        Verlet lists, the state of the random number generator of the
+        system, the step, the time step and the box of the integrator
+        and the state of the extensions (Extension::getState()).
+
+        The objects themselves, i.e. interactions, lists and extensions,
+        are not stored: a restart script builds the same system without
+        particles and bonds, registers the same lists in the same order
+        and calls read(). The particles are read in equal blocks by all
+        processes and distributed by decompose(), so a checkpoint can be
+        read on any number of processes. With a different number of
+        processes the generator of the system is reseeded with a seed
+        derived from its original seed and the step instead of restoring
+        its state.
+    */
+    class Checkpoint : public ParticleAccess {
+
+    public:
+
+      /** File header, written by rank 0 field by field. */
+      struct Header {
+        char magic[8];             // "ESPPCKP1"
+        boost::int32_t version;
+        boost::int32_t nSections;
+        boost::int32_t nRanks;     // processes that wrote the file
+        boost::int32_t recordSize; // Particle::stateSize() of the writer
+        boost::int64_t step;
+        boost::int64_t seed;       // seed of the system RNG
+        double dt;
+        double box[3];
+      };
+
+      /** Header of a section, followed by count * width bytes. */
+      struct SectionHeader {
+        boost::int32_t kind;
+        boost::int32_t width;
+        boost::int64_t count;
+      };
+
+      enum SectionKind {
+        PARTICLES = 1,
+        PAIRS = 2,
+        TRIPLES = 3,
+        QUADRUPLES = 4,
+        EXCLUSIONS = 5,
+        RNG_SIZES = 6,
+        RNG_STATES = 7,
+        EXTENSIONS = 8
+      };
+
+      Checkpoint(shared_ptr< System > system,
+                 shared_ptr< integrator::MDIntegrator > _integrator,
+                 std::string _file_name);
+
+      /** write to the file name of the checkpoint, e.g. from ExtAnalyze */
+      void perform_action() { write(file_name); }
+
+      void addPairList(shared_ptr< FixedPairList > fpl) { pairLists.push_back(fpl); }
+      void addTripleList(shared_ptr< FixedTripleList > ftl) { tripleLists.push_back(ftl); }
+      void addQuadrupleList(shared_ptr< FixedQuadrupleList > fql) { quadrupleLists.push_back(fql); }
+      void addVerletList(shared_ptr< VerletList > vl) { verletLists.push_back(vl); }
+
+      /** Write a checkpoint. The file is written under a temporary name
+          and renamed when it is complete. Collective. */
+      void write(std::string filename);
+
+      /** Restore the state from a checkpoint into a system without
+          particles. Collective. */
+      void read(std::string filename);
+
+      std::string getFilename() { return file_name; }
+      void setFilename(std::string v) { file_name = v; }
+
+      static void registerPython();
+
+    private:
+      void writeParticles(MPI_File fh, MPI_Offset &offset);
+      void readParticles(MPI_File fh, MPI_Offset &offset);
+      void writeRNG(MPI_File fh, MPI_Offset &offset);
+      void readRNG(MPI_File fh, MPI_Offset &offset, const Header &header);
+      void writeExtensions(MPI_File fh, MPI_Offset &offset);
+      void readExtensions(MPI_File fh, MPI_Offset &offset);
+
+      void writeSection(MPI_File fh, MPI_Offset &offset, int kind, int width,
+                        const std::vector< char > &local);
+      boost::int64_t readSection(MPI_File fh, MPI_Offset &offset, int kind, int width);
+      void readAll(MPI_File fh, MPI_Offset offset, std::vector< char > &buf);
+      /** throws on all processes unless count tuples were added */
+      void checkAdded(const char *what, boost::int64_t count, longint added);
+
+      int numSections();
+
+      shared_ptr< integrator::MDIntegrator > integrator;
+      std::string file_name;
+
+      std::vector< shared_ptr< FixedPairList > > pairLists;
+      std::vector< shared_ptr< FixedTripleList > > tripleLists;
+      std::vector< shared_ptr< FixedQuadrupleList > > quadrupleLists;
+      std::vector< shared_ptr< VerletList > > verletLists;
+
+      static LOG4ESPP_DECL_LOGGER(logger);
+    };
+  }
+}
+
+#endif
@@ -0,0 +1,138 @@
+#  Copyright (C) 2016
+#      Max Planck Institute for Polymer Research
+#  
+#  This file is part of ESPResSo++.
+#  
+#  ESPResSo++ is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#  
+#  ESPResSo++ is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#  
+#  You should have received a copy of the GNU General Public License
+#  along with this program.  If not, see <http://www.gnu.org/licenses/>. 
+
+
+
+r"""
+*************************
+espressopp.io.Checkpoint
+*************************
+
+Binary checkpoints of the dynamical state of a simulation, written and
+read in parallel with collective MPI-IO.
+
+A checkpoint stores the particles with all their properties, positions,
+velocities and images, the bonds of the registered fixed pair, triple and
+quadruple lists, the exclusions of the registered Verlet lists, the state
+of the random number generator of the system, the step, time step and box
+of the integrator and the state of the extensions that have one (e.g. the
+volume momentum of `LangevinBarostat`).
+
+Interactions, lists and extensions are not stored. To restart, the script
+builds the same system, integrator and extensions as before, but adds no
+particles and no bonds, registers the same lists in the same order and
+calls `read()`. The file can be read on a different number of processes;
+then the random number generator is reseeded with a seed derived from
+its original seed and the step instead of continuing its sequence. The counter based noise of the
+thermostats (``counterRNG``) only depends on the seed and the step and is
+continued exactly in either case.
+
+* `write(filename)`
+
+  write a checkpoint; it is written to ``filename.tmp`` first and renamed
+  when it is complete, so an interrupted write keeps the previous one
+
+* `read(filename)`
+
+  restore the state from a checkpoint into a system without particles
+
+* `add_pair_list(fpl)`, `add_triple_list(ftl)`, `add_quadruple_list(fql)`
+
+  store the bonds, angles or dihedrals of a fixed list
+
+* `add_verlet_list(vl)`
+
+  store the exclusions of a Verlet list
+
+* `filename`
+
+  file written when the checkpoint is used as an analysis extension
+
+usage:
+
+>>> chk = espressopp.io.Checkpoint(system, integrator, filename='state.chk')
+>>> chk.add_pair_list(fpl)
+>>> chk.add_triple_list(ftl)
+>>> chk.add_verlet_list(vl)
+>>> integrator.addExtension(espressopp.integrator.ExtAnalyze(chk, 100000))
+>>> integrator.run(10000000)
+
+restart, with the same setup but without particles and bonds:
+
+>>> chk = espressopp.io.Checkpoint(system, integrator)
+>>> chk.add_pair_list(fpl)
+>>> chk.add_triple_list(ftl)
+>>> chk.add_verlet_list(vl)
+>>> chk.read('state.chk')
+>>> integrator.run(10000000)
+
+.. function:: espressopp.io.Checkpoint(system, integrator, filename='checkpoint.chk')
+
+	:param system:
+	:param integrator:
+	:param filename:
+"""
+
+from espressopp.esutil import cxxinit
+from espressopp import pmi
+
+from espressopp.ParticleAccess import *
+from _espressopp import io_Checkpoint
+
+class CheckpointLocal(ParticleAccessLocal, io_Checkpoint):
+
+  def __init__(self, system, integrator, filename='checkpoint.chk'):
+    cxxinit(self, io_Checkpoint, system, integrator, filename)
+
+  def _isWorker(self):
+    return not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup()
+
+  def add_pair_list(self, fpl):
+    if self._isWorker():
+      self.cxxclass.add_pair_list(self, fpl)
+
+  def add_triple_list(self, ftl):
+    if self._isWorker():
+      self.cxxclass.add_triple_list(self, ftl)
+
+  def add_quadruple_list(self, fql):
+    if self._isWorker():
+      self.cxxclass.add_quadruple_list(self, fql)
+
+  def add_verlet_list(self, vl):
+    if self._isWorker():
+      self.cxxclass.add_verlet_list(self, vl)
+
+  def write(self, filename=None):
+    if self._isWorker():
+      self.cxxclass.write(self, filename if filename is not None else self.filename)
+
+  def read(self, filename=None):
+    if self._isWorker():
+      self.cxxclass.read(self, filename if filename is not None else self.filename)
+
+
+if pmi.isController :
+  class Checkpoint(ParticleAccess):
+    __metaclass__ = pmi.Proxy
+    pmiproxydefs = dict(
+      cls =  'espressopp.io.CheckpointLocal',
+      pmicall = [ 'add_pair_list', 'add_triple_list', 'add_quadruple_list', 'add_verlet_list',
+                  'write', 'read' ],
+      pmiproperty = ['filename']
+    )
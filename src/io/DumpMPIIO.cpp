@@ -0,0 +1,328 @@
+/*
+  Copyright (C) 2016
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "python.hpp"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include "DumpMPIIO.hpp"
+#include "io/FileBackup.hpp"
+#include "io/MPIIOTypes.hpp"
+#include "storage/Storage.hpp"
+#include "iterator/CellListIterator.hpp"
+#include "bc/BC.hpp"
+#include "esutil/Error.hpp"
+
+namespace espressopp {
+  namespace io {
+
+    LOG4ESPP_LOGGER(DumpMPIIO::logger, "DumpMPIIO");
+
+    namespace {
+      const char MAGIC[8] = { 'E', 'S', 'P', 'P', 'T', 'R', 'J', '1' };
+      const int FLAG_VELOCITIES = 1;
+      const int FLAG_FIXEDPOINT = 2;
+
+      struct IdLess {
+        bool operator()(const Particle *p1, const Particle *p2) const {
+          return p1->id() < p2->id();
+        }
+      };
+
+      template < typename T >
+      inline char *put(char *dst, T value) {
+        std::memcpy(dst, &value, sizeof(T));
+        return dst + sizeof(T);
+      }
+    }
+
+    DumpMPIIO::DumpMPIIO(shared_ptr< System > system,
+                         shared_ptr< integrator::MDIntegrator > _integrator,
+                         std::string _file_name,
+                         bool _unfolded,
+                         bool _store_velocities,
+                         real _precision,
+                         bool _append)
+      : ParticleAccess(system), integrator(_integrator), file_name(_file_name),
+        unfolded(_unfolded), store_velocities(_store_velocities),
+        precision(_precision), append(_append), isOpen(false),
+        nFrames(0), current(0),
+        pending(MPI_REQUEST_NULL), pendingType(MPI_DATATYPE_NULL),
+        pendingMemType(MPI_DATATYPE_NULL)
+    {
+      if (!system->storage) {
+        throw std::runtime_error("system has no storage");
+      }
+
+      // the records are indexed by the particle id
+      longint myMaxId = -1, maxId = -1;
+      CellList realCells = system->storage->getRealCells();
+      for (iterator::CellListIterator cit(realCells); !cit.isDone(); ++cit) {
+        myMaxId = std::max(myMaxId, (longint)cit->id());
+      }
+      mpi::all_reduce(*system->comm, myMaxId, maxId, mpi::maximum< longint >());
+      if (maxId < 0)
+        throw std::runtime_error("Dumper: No particles found in the system - make sure particles are added first before Dumper is initialized");
+
+      // the fixed point values of the box must fit into an int32
+      if (precision > 0.0) {
+        Real3D L = system->bc->getBoxL();
+        real Lmax = std::max(L[0], std::max(L[1], L[2]));
+        if (Lmax / precision >= INT_MAX) {
+          std::stringstream msg;
+          msg << "DumpMPIIO: box length " << Lmax << " / precision " << precision
+              << " exceeds the int32 range of the fixed point positions";
+          throw std::invalid_argument(msg.str());
+        }
+      }
+
+      nSlots = maxId + 1;
+      recordSize = (precision > 0.0 ? 3 * sizeof(boost::int32_t) : 3 * sizeof(double))
+                 + (store_velocities ? 3 * sizeof(double) : 0);
+      frameSize = sizeof(FrameHeader) + (MPI_Offset)nSlots * recordSize;
+
+      if (system->comm->rank() == 0 && !append)
+        FileBackup backup(file_name);
+      system->comm->barrier();
+
+      open();
+    }
+
+    DumpMPIIO::~DumpMPIIO() {
+      close();
+    }
+
+    void DumpMPIIO::open() {
+      shared_ptr< mpi::communicator > comm = getSystem()->comm;
+      esutil::Error err(comm);
+
+      int rc = MPI_File_open(*comm, const_cast< char* >(file_name.c_str()),
+                             MPI_MODE_WRONLY | MPI_MODE_CREATE, MPI_INFO_NULL, &fh);
+      if (rc != MPI_SUCCESS) {
+        std::stringstream msg;
+        msg << "DumpMPIIO: cannot open file " << file_name;
+        err.setException(msg.str());
+      }
+      err.checkException();
+      isOpen = true;
+
+      MPI_Offset size = 0;
+      MPI_File_get_size(fh, &size);
+      if (size % frameSize != 0) {
+        std::stringstream msg;
+        msg << "DumpMPIIO: size of " << file_name
+            << " is not a multiple of the frame size " << frameSize;
+        err.setException(msg.str());
+      }
+      err.checkException();
+      nFrames = size / frameSize;
+
+      LOG4ESPP_INFO(logger, "opened " << file_name << " with " << nFrames
+                    << " frames of " << nSlots << " particle slots");
+    }
+
+    void DumpMPIIO::waitPending() {
+      if (pending != MPI_REQUEST_NULL) {
+        MPI_Wait(&pending, MPI_STATUS_IGNORE);
+      }
+      if (pendingType != MPI_DATATYPE_NULL) {
+        MPI_Type_free(&pendingType);
+      }
+      if (pendingMemType != MPI_DATATYPE_NULL) {
+        MPI_Type_free(&pendingMemType);
+      }
+    }
+
+    void DumpMPIIO::pack(std::vector< char > &buf, std::vector< longint > &ids) {
+      System &system = getSystemRef();
+      esutil::Error err(system.comm);
+
+      // id-sorted slice of the local particles
+      std::vector< Particle* > parts;
+      CellList realCells = system.storage->getRealCells();
+      for (iterator::CellListIterator cit(realCells); !cit.isDone(); ++cit) {
+        if (cit->id() >= nSlots) {
+          std::stringstream msg;
+          msg << "DumpMPIIO: particle id " << cit->id()
+              << " exceeds the number of slots of " << file_name;
+          err.setException(msg.str());
+        }
+        parts.push_back(&(*cit));
+      }
+      err.checkException();
+      std::sort(parts.begin(), parts.end(), IdLess());
+      ids.resize(parts.size());
+      for (size_t i = 0; i < parts.size(); ++i) ids[i] = parts[i]->id();
+
+      bool isRoot = (system.comm->rank() == 0);
+      size_t headerSize = isRoot ? sizeof(FrameHeader) : 0;
+      buf.resize(headerSize + parts.size() * recordSize);
+      char *dst = buf.empty() ? 0 : &buf[0];
+
+      Real3D L = system.bc->getBoxL();
+      if (isRoot) {
+        FrameHeader header;
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.step = integrator->getStep();
+        header.nSlots = nSlots;
+        header.flags = (store_velocities ? FLAG_VELOCITIES : 0)
+                     | (precision > 0.0 ? FLAG_FIXEDPOINT : 0);
+        header.recordSize = recordSize;
+        header.time = integrator->getStep() * integrator->getTimeStep();
+        for (int d = 0; d < 3; ++d) header.box[d] = L[d];
+        header.precision = precision;
+        dst = put(dst, header);
+      }
+
+      real invPrecision = precision > 0.0 ? 1.0 / precision : 0.0;
+      // unfolded positions may leave the range that the box fits into
+      bool outOfRange = false;
+      for (size_t i = 0; i < parts.size(); ++i) {
+        const Particle &p = *parts[i];
+        Real3D pos = p.position();
+        if (unfolded) {
+          const Int3D &img = p.image();
+          for (int d = 0; d < 3; ++d) pos[d] += img[d] * L[d];
+        }
+        if (precision > 0.0) {
+          for (int d = 0; d < 3; ++d) {
+            real q = floor(pos[d] * invPrecision + 0.5);
+            if (q < INT_MIN || q > INT_MAX) {
+              outOfRange = true;
+              q = 0.0;
+            }
+            dst = put(dst, (boost::int32_t)q);
+          }
+        } else {
+          for (int d = 0; d < 3; ++d) dst = put(dst, (double)pos[d]);
+        }
+        if (store_velocities) {
+          const Real3D &vel = p.velocity();
+          for (int d = 0; d < 3; ++d) dst = put(dst, (double)vel[d]);
+        }
+      }
+      if (outOfRange) {
+        std::stringstream msg;
+        msg << "DumpMPIIO: a position exceeds the int32 range of the fixed point"
+            << " positions with precision " << precision << ", no frame was written";
+        err.setException(msg.str());
+      }
+      err.checkException();
+    }
+
+    void DumpMPIIO::dump() {
+      if (!isOpen)
+        throw std::runtime_error("DumpMPIIO: file " + file_name + " is closed");
+
+      // pack into the free buffer while the previous frame may still be written
+      std::vector< char > &buf = buffer[current];
+      std::vector< longint > ids;
+      pack(buf, ids);
+
+      // file view: the header (rank 0) and runs of consecutive ids,
+      // a run is at most INT_MAX bytes long
+      std::vector< int > lens;
+      std::vector< MPI_Aint > disps;
+      if (getSystem()->comm->rank() == 0) {
+        lens.push_back(sizeof(FrameHeader));
+        disps.push_back(0);
+      }
+      size_t nHeader = lens.size();
+      const int maxRun = INT_MAX - recordSize;
+      for (size_t i = 0; i < ids.size(); ++i) {
+        if (i > 0 && ids[i] == ids[i-1] + 1 && lens.size() > nHeader
+            && lens.back() <= maxRun) {
+          lens.back() += recordSize;
+        } else {
+          lens.push_back(recordSize);
+          disps.push_back(sizeof(FrameHeader) + (MPI_Aint)ids[i] * recordSize);
+        }
+      }
+
+      // the view must not change while a write is pending
+      waitPending();
+
+      MPI_Offset frameOffset = (MPI_Offset)nFrames * frameSize;
+      if (lens.empty()) {
+        MPI_File_set_view(fh, frameOffset, MPI_BYTE, MPI_BYTE,
+                          const_cast< char* >("native"), MPI_INFO_NULL);
+      } else {
+        MPI_Type_create_hindexed(lens.size(), &lens[0], &disps[0], MPI_BYTE, &pendingType);
+        MPI_Type_commit(&pendingType);
+        MPI_File_set_view(fh, frameOffset, MPI_BYTE, pendingType,
+                          const_cast< char* >("native"), MPI_INFO_NULL);
+      }
+      // collective, so that the MPI-IO layer can aggregate the scattered
+      // runs of all ranks into large contiguous file accesses
+      pendingMemType = createBytesType(buf.size());
+#if MPI_VERSION > 3 || (MPI_VERSION == 3 && MPI_SUBVERSION >= 1)
+      MPI_File_iwrite_all(fh, buf.empty() ? 0 : &buf[0], 1, pendingMemType, &pending);
+#else
+      MPI_File_write_all(fh, buf.empty() ? 0 : &buf[0], 1, pendingMemType, MPI_STATUS_IGNORE);
+#endif
+
+      LOG4ESPP_DEBUG(logger, "frame " << nFrames << ": posted " << buf.size()
+                     << " bytes in " << lens.size() << " blocks");
+
+      ++nFrames;
+      current = 1 - current;
+    }
+
+    void DumpMPIIO::flush() {
+      if (!isOpen) return;
+      waitPending();
+      MPI_File_sync(fh);
+    }
+
+    void DumpMPIIO::close() {
+      if (!isOpen) return;
+      waitPending();
+      MPI_File_close(&fh);
+      isOpen = false;
+    }
+
+    // Python wrapping
+    void DumpMPIIO::registerPython() {
+
+      using namespace espressopp::python;
+
+      class_< DumpMPIIO, bases< ParticleAccess >, boost::noncopyable >
+      ("io_DumpMPIIO", init< shared_ptr< System >,
+                             shared_ptr< integrator::MDIntegrator >,
+                             std::string,
+                             bool,
+                             bool,
+                             real,
+                             bool >())
+        .add_property("filename", &DumpMPIIO::getFilename)
+        .add_property("unfolded", &DumpMPIIO::getUnfolded,
+                                  &DumpMPIIO::setUnfolded)
+        .add_property("store_velocities", &DumpMPIIO::getStoreVelocities)
+        .add_property("precision", &DumpMPIIO::getPrecision)
+        .add_property("num_frames", &DumpMPIIO::getNumFrames)
+        .def("dump", &DumpMPIIO::dump)
+        .def("flush", &DumpMPIIO::flush)
+        .def("close", &DumpMPIIO::close)
+      ;
+    }
+  }
+}
@@ -0,0 +1,135 @@
+/*
+  Copyright (C) 2016
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ESPP_CLASS
+#ifndef _IO_DUMPMPIIO_HPP
+#define _IO_DUMPMPIIO_HPP
+
+#include "mpi.hpp"
+#include "types.hpp"
+#include "System.hpp"
+#include "integrator/MDIntegrator.hpp"
+#include "ParticleAccess.hpp"
+#include "log4espp.hpp"
+#include <boost/cstdint.hpp>
+#include <string>
+#include <vector>
+
+namespace espressopp {
+  namespace io {
+
+    /** Binary trajectory writer using collective MPI-IO.
+
+        Every frame consists of a fixed size header followed by one
+        record per particle id slot, 0 .. maxId; a record holds the
+        position and optionally the velocity. The offset of a particle in
+        the file therefore only depends on its id, and every rank writes
+        the records of its own real particles directly into the file, no
+        data is funnelled through rank 0.
+
+        Snapshots are double buffered: dump() packs the current frame
+        into one buffer while the previous frame may still be written
+        from the other one by a non-blocking collective write,
+        MPI_File_iwrite_all (MPI_File_write_all before MPI 3.1); it only
+        waits for that write before it starts the next one. dump() is
+        therefore collective over the ranks of the system.
+
+        With precision > 0 positions are stored as 32-bit fixed point
+        integers, round(x / precision), instead of doubles. The box
+        must fit into that range, and a frame with an (unfolded)
+        position outside of it throws instead of being written.
+    */
+    class DumpMPIIO : public ParticleAccess {
+
+    public:
+
+      /** Frame header, written by rank 0 at the start of every frame. */
+      struct FrameHeader {
+        char magic[8];          // "ESPPTRJ1"
+        boost::int64_t step;
+        boost::int64_t nSlots;  // number of particle records, maxId + 1
+        boost::int32_t flags;   // bit 0: velocities, bit 1: fixed point positions
+        boost::int32_t recordSize;
+        double time;
+        double box[3];
+        double precision;
+      };
+
+      DumpMPIIO(shared_ptr< System > system,
+                shared_ptr< integrator::MDIntegrator > _integrator,
+                std::string _file_name,
+                bool _unfolded,
+                bool _store_velocities,
+                real _precision,
+                bool _append);
+      ~DumpMPIIO();
+
+      void perform_action() { dump(); }
+
+      /** Write the current configuration (asynchronously). Collective. */
+      void dump();
+      /** Wait until all frames are in the file. Collective. */
+      void flush();
+      /** Flush and close the file. Collective. */
+      void close();
+
+      std::string getFilename() { return file_name; }
+      bool getUnfolded() { return unfolded; }
+      void setUnfolded(bool v) { unfolded = v; }
+      bool getStoreVelocities() { return store_velocities; }
+      real getPrecision() { return precision; }
+      long getNumFrames() { return nFrames; }
+
+      static void registerPython();
+
+    private:
+      void open();
+      void pack(std::vector< char > &buf, std::vector< longint > &ids);
+      void waitPending();
+
+      shared_ptr< integrator::MDIntegrator > integrator;
+
+      std::string file_name;
+      bool unfolded;
+      bool store_velocities;
+      real precision;
+      bool append;
+
+      MPI_File fh;
+      bool isOpen;
+
+      longint nSlots;
+      int recordSize;
+      MPI_Offset frameSize;
+      long nFrames;
+
+      // double buffered snapshots, one of them may be in flight
+      std::vector< char > buffer[2];
+      int current;
+      MPI_Request pending;
+      MPI_Datatype pendingType;     // file view of the pending write
+      MPI_Datatype pendingMemType;  // its buffer, may exceed 2 GB
+
+      static LOG4ESPP_DECL_LOGGER(logger);
+    };
+  }
+}
+
+#endif
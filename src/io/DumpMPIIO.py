@@ -0,0 +1,165 @@
+#  Copyright (C) 2016
+#      Max Planck Institute for Polymer Research
+#  
+#  This file is part of ESPResSo++.
+#  
+#  ESPResSo++ is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#  
+#  ESPResSo++ is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#  
+#  You should have received a copy of the GNU General Public License
+#  along with this program.  If not, see <http://www.gnu.org/licenses/>. 
+
+
+r"""
+************************
+espressopp.io.DumpMPIIO
+************************
+
+* `dump()`
+
+  write the current configuration to a binary trajectory file. Every rank
+  writes the records of its own particles directly into the file with
+  collective MPI-IO; nothing is gathered on rank 0. The write is
+  non-blocking: the integrator continues while the frame is written, the
+  next `dump()` waits for it.
+
+* `flush()`
+
+  wait until all frames are in the file
+
+* `close()`
+
+  flush and close the file; further dumps are not possible
+
+  **File format**
+
+  Every frame has the same size: a 72 byte header (magic ``ESPPTRJ1``,
+  int64 step, int64 number of slots, int32 flags, int32 record size,
+  double time, 3 doubles box size, double precision) followed by one
+  record per particle id ``0 .. maxId`` (the largest id when the dumper
+  was created). A record holds the position and, with
+  ``store_velocities``, the velocity (3 doubles). Positions are stored as
+  3 doubles, or as 3 int32 ``round(x / precision)`` if ``precision > 0``.
+  Slots of ids without particle are zero. `readDumpMPIIO` reads such
+  files.
+
+  **Properties**
+
+* `filename`
+  Name of trajectory file (read only). By default ``out.trj``
+
+* `unfolded`
+  False if coordinates are folded, True if unfolded. By default - False
+
+* `store_velocities`
+  True if velocities are stored (read only). Default: False
+
+* `precision`
+  Resolution of the fixed point position codec (read only). 0 stores
+  positions as doubles. The box length divided by the precision must
+  fit into an int32; a dump with an unfolded position beyond that range
+  raises an error. Default: 0
+
+* `append`
+  True if frames are appended to an existing file of the same layout.
+  Default: False
+
+* `num_frames`
+  Number of frames in the file (read only)
+
+usage:
+
+>>> dump = espressopp.io.DumpMPIIO(system, integrator, filename='traj.trj', precision=0.001)
+>>> ext_analyze = espressopp.integrator.ExtAnalyze(dump, 1000)
+>>> integrator.addExtension(ext_analyze)
+>>> integrator.run(100000)
+>>> dump.close()
+
+>>> frames = espressopp.io.readDumpMPIIO('traj.trj')
+>>> header, pos, vel = frames[-1]
+
+.. function:: espressopp.io.DumpMPIIO(system, integrator, filename='out.trj', unfolded=False,\
+                                      store_velocities=False, precision=0.0, append=False)
+
+	:param system:
+	:param integrator:
+	:param filename:
+	:param bool unfolded:
+	:param bool store_velocities:
+	:param real precision:
+	:param bool append:
+
+.. function:: espressopp.io.readDumpMPIIO(filename)
+
+	:param filename:
+	:rtype: list of (header dict, list of positions, list of velocities or None)
+"""
+
+import struct
+from espressopp.esutil import cxxinit
+from espressopp import pmi
+
+from espressopp.ParticleAccess import *
+from _espressopp import io_DumpMPIIO
+
+_HEADER = struct.Struct('=8sqqii5d')
+
+def readDumpMPIIO(filename):
+  frames = []
+  with open(filename, 'rb') as f:
+    while True:
+      raw = f.read(_HEADER.size)
+      if len(raw) < _HEADER.size:
+        break
+      magic, step, nslots, flags, recsize, time, lx, ly, lz, precision = _HEADER.unpack(raw)
+      if magic != 'ESPPTRJ1':
+        raise IOError('%s: not a DumpMPIIO trajectory' % filename)
+      header = dict(step=step, time=time, box=(lx, ly, lz), precision=precision, flags=flags)
+      data = f.read(nslots * recsize)
+      posfmt = '=3i' if flags & 2 else '=3d'
+      poslen = struct.calcsize(posfmt)
+      pos, vel = [], ([] if flags & 1 else None)
+      for i in xrange(nslots):
+        rec = data[i * recsize:(i + 1) * recsize]
+        p = struct.unpack(posfmt, rec[:poslen])
+        if flags & 2:
+          p = tuple(x * precision for x in p)
+        pos.append(p)
+        if flags & 1:
+          vel.append(struct.unpack('=3d', rec[poslen:poslen + 24]))
+      frames.append((header, pos, vel))
+  return frames
+
+class DumpMPIIOLocal(ParticleAccessLocal, io_DumpMPIIO):
+
+  def __init__(self, system, integrator, filename='out.trj', unfolded=False, store_velocities=False, precision=0.0, append=False):
+    cxxinit(self, io_DumpMPIIO, system, integrator, filename, unfolded, store_velocities, precision, append)
+
+  def dump(self):
+    if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+      self.cxxclass.dump(self)
+
+  def flush(self):
+    if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+      self.cxxclass.flush(self)
+
+  def close(self):
+    if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+      self.cxxclass.close(self)
+
+
+if pmi.isController :
+  class DumpMPIIO(ParticleAccess):
+    __metaclass__ = pmi.Proxy
+    pmiproxydefs = dict(
+      cls =  'espressopp.io.DumpMPIIOLocal',
+      pmicall = [ 'dump', 'flush', 'close' ],
+      pmiproperty = ['filename', 'unfolded', 'store_velocities', 'precision', 'num_frames']
+    )
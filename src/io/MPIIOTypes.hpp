@@ -0,0 +1,59 @@
+/*
+  Copyright (C) 2016
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _IO_MPIIOTYPES_HPP
+#define _IO_MPIIOTYPES_HPP
+
+#include <mpi.h>
+#include <cstddef>
+
+namespace espressopp {
+  namespace io {
+
+    /** Committed datatype of n contiguous bytes.
+
+        MPI counts are int, so buffers of 2 GB and more cannot be passed
+        as n MPI_BYTEs. Pass count 1 of this type instead; it is built
+        from blocks of 1 GB and the remainder. Free it with MPI_Type_free
+        once the operation has completed.
+    */
+    inline MPI_Datatype createBytesType(size_t n) {
+      const size_t block = size_t(1) << 30;
+      const size_t nBlocks = n / block;
+      const size_t rest = n % block;
+
+      MPI_Datatype blockType, blocksType, bytesType;
+      MPI_Type_contiguous((int)block, MPI_BYTE, &blockType);
+      MPI_Type_contiguous((int)nBlocks, blockType, &blocksType);
+
+      int lens[2] = { 1, (int)rest };
+      MPI_Aint disps[2] = { 0, (MPI_Aint)(nBlocks * block) };
+      MPI_Datatype types[2] = { blocksType, MPI_BYTE };
+      MPI_Type_create_struct(2, lens, disps, types, &bytesType);
+      MPI_Type_commit(&bytesType);
+
+      MPI_Type_free(&blocksType);
+      MPI_Type_free(&blockType);
+      return bytesType;
+    }
+  }
+}
+
+#endif
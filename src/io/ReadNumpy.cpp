@@ -102,6 +102,70 @@ bool ReadNumpy::LoadPosition(PyObject *ids, PyObject *data) {
   return true;
 }
 
+const void* ReadNumpy::LoadArray(PyObject *data, const char *format, long size,  // NOLINT
+                                 const char *name, std::vector<Py_buffer> &held) {
+  if (data == Py_None) {
+    return 0;
+  }
+  held.push_back(LoadBuffer(data));
+  const Py_buffer &view_data = held.back();
+
+  if (strcmp(view_data.format, format) != 0) {
+    std::stringstream msg;
+    msg << name << ": expected an array of "
+        << (strcmp(format, "d") == 0 ? "doubles" : "integers");
+    throw std::runtime_error(msg.str());
+  }
+  if (size >= 0 && (view_data.len / view_data.itemsize) != size) {
+    std::stringstream msg;
+    msg << name << ": wrong number of elements, expected " << size;
+    throw std::runtime_error(msg.str());
+  }
+  return view_data.buf;
+}
+
+namespace {
+// releases the buffers of ReadNumpy::LoadArray, also on errors
+struct HeldBuffers {
+  HeldBuffers() { views.reserve(6); }
+  ~HeldBuffers() {
+    for (size_t i = 0; i < views.size(); i++) {
+      PyBuffer_Release(&views[i]);
+    }
+  }
+  std::vector<Py_buffer> views;
+};
+}  // namespace
+
+long ReadNumpy::AddParticles(PyObject *ids, PyObject *pos, PyObject *type,  // NOLINT
+                             PyObject *mass, PyObject *q, PyObject *v, bool filter) {
+  if (ids == Py_None || pos == Py_None) {
+    throw std::runtime_error("ids and pos are mandatory");
+  }
+
+  HeldBuffers held;
+  const long *id_buf = static_cast<const long*>(  // NOLINT
+      LoadArray(ids, "l", -1, "ids", held.views));
+  if (held.views.back().ndim != 1) {
+    throw std::runtime_error("ids: expected a 1-d array");
+  }
+  long num_particles = held.views.back().len / held.views.back().itemsize;  // NOLINT
+
+  const long *type_buf = static_cast<const long*>(  // NOLINT
+      LoadArray(type, "l", num_particles, "type", held.views));
+  const double *pos_buf = static_cast<const double*>(
+      LoadArray(pos, "d", 3*num_particles, "pos", held.views));
+  const double *mass_buf = static_cast<const double*>(
+      LoadArray(mass, "d", num_particles, "mass", held.views));
+  const double *q_buf = static_cast<const double*>(
+      LoadArray(q, "d", num_particles, "q", held.views));
+  const double *v_buf = static_cast<const double*>(
+      LoadArray(v, "d", 3*num_particles, "v", held.views));
+
+  return getSystemRef().storage->addParticles(
+      num_particles, id_buf, pos_buf, type_buf, mass_buf, q_buf, v_buf, filter);
+}
+
 // Python wrapping
 void ReadNumpy::registerPython() {
   using namespace espressopp::python;  // NOLINT
@@ -110,7 +174,8 @@ void ReadNumpy::registerPython() {
 
   class_< ReadNumpy>
       ("io_ReadNumpy", init<shared_ptr<System> >())
-          .def("load_position", &ReadNumpy::LoadPosition);
+          .def("load_position", &ReadNumpy::LoadPosition)
+          .def("add_particles", &ReadNumpy::AddParticles);
 }
 
 }  // end namespace io
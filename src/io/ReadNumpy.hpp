@@ -23,6 +23,7 @@
 
 #include <algorithm>
 #include <string>
+#include <vector>
 #include "boost/python/numeric.hpp"
 
 #include "esutil/Error.hpp"
@@ -40,6 +41,14 @@ class ReadNumpy: public SystemAccess {
   ~ReadNumpy() {
   }
 
+  /** Add the particles of contiguous NumPy arrays with one call of
+      Storage::addParticles: ids (int64, n), pos (float64, n x 3) and
+      the optional type (int64, n), mass, q (float64, n) and v
+      (float64, n x 3), None if not given. See Storage::addParticles
+      for filter. Returns the number of particles stored here. */
+  long AddParticles(PyObject *ids, PyObject *pos, PyObject *type,  // NOLINT
+                    PyObject *mass, PyObject *q, PyObject *v, bool filter);
+
   static void registerPython();
  protected:
   static LOG4ESPP_DECL_LOGGER(logger);
@@ -48,6 +57,10 @@ class ReadNumpy: public SystemAccess {
   bool LoadPosition(PyObject *ids, PyObject *data);
 
   Py_buffer LoadBuffer(PyObject *data);
+  // buffer of an array of size values (any if size < 0) of the given
+  // format, 0 for None; the caller releases the buffers collected in held
+  const void* LoadArray(PyObject *data, const char *format, long size,  // NOLINT
+                        const char *name, std::vector<Py_buffer> &held);
 };
 }  // end namespace io
 }  // end namespace espressopp
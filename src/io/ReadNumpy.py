@@ -21,13 +21,60 @@ r"""
 *********************************************
 **ReadNumpy** - IO Object
 *********************************************
+
+Bulk loading of particles from NumPy arrays or H5MD files. Unlike
+:py:meth:`espressopp.storage.Storage.addParticles`, which loops over the
+particles in Python on every process, the particles are filtered and
+inserted into the cells in C++ in one pass.
+
+.. function:: espressopp.io.ReadNumpy.add_particles(ids, pos, type=None, mass=None, q=None, v=None)
+
+  Adds the particles of the arrays; every process keeps the ones of its
+  domain. Returns the number of added particles.
+
+  :param ids: particle ids, n integers
+  :param pos: positions, n x 3 floats
+  :param type: optional types, n integers
+  :param mass: optional masses, n floats
+  :param q: optional charges, n floats
+  :param v: optional velocities, n x 3 floats
+  :rtype: int
+
+.. function:: espressopp.io.ReadNumpy.add_particles_h5md(filename, group='atoms', frame=-1)
+
+  Adds the particles of a frame of an H5MD file, e.g. written by
+  :py:class:`espressopp.io.DumpH5MD`. Every process reads its own
+  hyperslab of the particle group, so the arrays are never held or sent
+  as a whole; species, mass, charge and velocity are read if present,
+  positions are unfolded with the images if present. The particles are
+  stored where they were read, call ``system.storage.decompose()``
+  before using them. Returns the number of added particles.
+
+  :param str filename: the H5MD file
+  :param str group: the particle group below /particles
+  :param int frame: the time frame
+  :rtype: int
+
+Example:
+
+>>> reader = espressopp.io.ReadNumpy(system)
+>>> reader.add_particles(ids, pos, type=types, mass=masses)
+>>> system.storage.decompose()
 """
 
+import numpy as np
 from _espressopp import io_ReadNumpy
 from espressopp import pmi
 from espressopp.esutil import cxxinit
 
 
+def _array(data, dtype, ncols=None):
+    if data is None:
+        return None
+    data = np.ascontiguousarray(data, dtype=dtype)
+    return data.reshape(-1, ncols) if ncols else data.reshape(-1)
+
+
 class ReadNumpyLocal(io_ReadNumpy):
     def __init__(self, system):
         cxxinit(self, io_ReadNumpy, system)
@@ -36,6 +83,48 @@ class ReadNumpyLocal(io_ReadNumpy):
         if pmi.workerIsActive():
             self.cxxclass.load_position(self, ids, input_ndarray)
 
+    def add_particles(self, ids, pos, type=None, mass=None, q=None, v=None, filter=True):
+        if pmi.workerIsActive():
+            return self.cxxclass.add_particles(
+                self, _array(ids, np.int64), _array(pos, np.float64, 3),
+                _array(type, np.int64), _array(mass, np.float64),
+                _array(q, np.float64), _array(v, np.float64, 3), filter)
+        return 0
+
+    def add_particles_h5md(self, filename, group='atoms', frame=-1):
+        if not pmi.workerIsActive():
+            return 0
+        import h5py
+        comm = pmi._MPIcomm
+        with h5py.File(filename, 'r') as h5:
+            part = h5['/particles/{}'.format(group)]
+            n = part['id/value'].shape[1]
+            # the hyperslab of this process
+            first = n * comm.rank // comm.size
+            last = n * (comm.rank + 1) // comm.size
+
+            def read(name):
+                if name not in part:
+                    return None
+                return part['{}/value'.format(name)][frame, first:last]
+
+            ids = read('id')
+            # DumpH5MD pads the frames with id -1
+            valid = ids >= 0
+            data = dict(
+                pos=read('position'), type=read('species'), mass=read('mass'),
+                q=read('charge'), v=read('velocity'))
+            image = read('image')
+            if image is not None:
+                edges = part['box/edges']
+                if 'value' in edges:
+                    edges = edges['value'][frame]
+                data['pos'] = data['pos'] + image * np.asarray(edges)
+            for k, d in data.items():
+                if d is not None:
+                    data[k] = d[valid]
+        return self.add_particles(ids[valid], filter=False, **data)
+
 
 if pmi.isController:
     class ReadNumpy():
@@ -44,3 +133,11 @@ if pmi.isController:
             cls='espressopp.io.ReadNumpyLocal',
             pmicall=['load_position'],
         )
+
+        def add_particles(self, ids, pos, type=None, mass=None, q=None, v=None):
+            return pmi.reduce(pmi.SUM, self.pmiobject, 'add_particles',
+                              ids, pos, type, mass, q, v)
+
+        def add_particles_h5md(self, filename, group='atoms', frame=-1):
+            return pmi.reduce(pmi.SUM, self.pmiobject, 'add_particles_h5md',
+                              filename, group, frame)
@@ -27,6 +27,8 @@ pmiimport('espressopp.io')
 from espressopp.io.DumpGRO import *
 from espressopp.io.DumpGROAdress import *
 from espressopp.io.DumpXYZ import *
+from espressopp.io.DumpMPIIO import *
+from espressopp.io.Checkpoint import *
 from espressopp.io.ReadNumpy import *
 
 try:
@@ -22,6 +22,8 @@
 
 #include "bindings.hpp"
 #include "DumpXYZ.hpp"
+#include "DumpMPIIO.hpp"
+#include "Checkpoint.hpp"
 #include "DumpGRO.hpp"
 #include "DumpGROAdress.hpp"
 #include "DumpH5MD.hpp"
@@ -37,6 +39,8 @@ namespace espressopp {
   namespace io{
     void registerPython() {
       DumpXYZ::registerPython();
+      DumpMPIIO::registerPython();
+      Checkpoint::registerPython();
       DumpGRO::registerPython();
       DumpGROAdress::registerPython();
       DumpH5MD::registerPython();
@@ -0,0 +1,74 @@
+/*
+  Copyright (C) 2016
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "CellTasks.hpp"
+#include "Storage.hpp"
+
+namespace espressopp {
+  namespace storage {
+
+    LOG4ESPP_LOGGER(CellTasks::logger, "CellTasks");
+
+    CellList &CellTasks::getRealCells() {
+      return storage.getRealCells();
+    }
+
+    void CellTasks::colour() {
+      CellList &realCells = storage.getRealCells();
+      colours.clear();
+      coloured = true;
+      if (realCells.empty()) return;
+
+      const Cell *first = storage.getFirstCell();
+      const size_t nCells = storage.getLocalCells().size();
+      // per colour, the cells written by the cells of that colour
+      std::vector< std::vector< char > > written;
+      std::vector< size_t > writeSet;
+
+      for (size_t i = 0; i < realCells.size(); ++i) {
+        Cell *cell = realCells[i];
+        writeSet.clear();
+        writeSet.push_back(cell - first);
+        for (NeighborCellList::Iterator it(cell->neighborCells); it.isValid(); ++it) {
+          // the half shell, as CellListAllPairsIterator visits it
+          if (!it->useForAllPairs) writeSet.push_back(it->cell - first);
+        }
+
+        size_t c = 0;
+        for (; c < colours.size(); ++c) {
+          bool free = true;
+          for (size_t k = 0; k < writeSet.size() && free; ++k) {
+            free = !written[c][writeSet[k]];
+          }
+          if (free) break;
+        }
+        if (c == colours.size()) {
+          colours.push_back(std::vector< longint >());
+          written.push_back(std::vector< char >(nCells, 0));
+        }
+        colours[c].push_back(i);
+        for (size_t k = 0; k < writeSet.size(); ++k) written[c][writeSet[k]] = 1;
+      }
+
+      LOG4ESPP_DEBUG(logger, realCells.size() << " real cells in "
+                     << colours.size() << " colours");
+    }
+  }
+}
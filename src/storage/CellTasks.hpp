@@ -0,0 +1,124 @@
+/*
+  Copyright (C) 2016
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ESPP_CLASS
+#ifndef _STORAGE_CELLTASKS_HPP
+#define _STORAGE_CELLTASKS_HPP
+
+#include <vector>
+#include "types.hpp"
+#include "log4espp.hpp"
+#include "Cell.hpp"
+#include "esutil/Threads.hpp"
+
+namespace espressopp {
+  namespace storage {
+
+    class Storage;
+
+    /** Runs per-cell work of a storage on the threads of the process.
+
+        forEachCell() hands blocks of cellBlock cells to the threads as
+        they become idle (OpenMP dynamic schedule), so cells with many
+        particles do not stall the others. The work must only write to
+        the particles of its own cell.
+
+        forEachColouredCell() is for work that also writes to the
+        neighbour cells, e.g. pair forces with Newton's third law over
+        the half shell of neighbour cells that the all-pairs loops use.
+        The real cells are coloured such that two cells of one colour
+        never write to the same cell (own cell plus half shell, ghosts
+        included). The colours run one after the other, the cells of a
+        colour in parallel. The colouring is redone lazily after the
+        particles or cells of the storage changed.
+
+        With one thread, or without OpenMP, both are plain loops in
+        list order. For a given number of threads greater than one, the
+        order in which forces are added to a particle is fixed by the
+        colouring, so the results do not depend on the thread timing.
+    */
+    class CellTasks {
+    public:
+      /// number of cells a thread takes at once
+      static const int cellBlock = 4;
+
+      CellTasks(Storage &_storage) : storage(_storage), coloured(false) {}
+
+      /** Call f(cell, i) for every cell = *cells[i]. */
+      template < class Function >
+      void forEachCell(CellList &cells, Function f);
+
+      /** Call f(cell, i) for every real cell = *realCells[i], such that
+          concurrent calls never share a cell of their half shells. */
+      template < class Function >
+      void forEachColouredCell(Function f);
+
+      /// number of colours of the current colouring, 0 if outdated
+      int getNColours() const { return coloured ? colours.size() : 0; }
+
+      /** Mark the colouring as outdated; connected to onParticlesChanged. */
+      void invalidate() { coloured = false; }
+
+    private:
+      void colour();
+      CellList &getRealCells();
+
+      Storage &storage;
+      bool coloured;
+      // per colour, the indices of its cells in realCells
+      std::vector< std::vector< longint > > colours;
+
+      static LOG4ESPP_DECL_LOGGER(logger);
+    };
+
+    //////////////////////////////////////////////////
+    // INLINE IMPLEMENTATION
+    //////////////////////////////////////////////////
+    template < class Function >
+    inline void CellTasks::forEachCell(CellList &cells, Function f) {
+      const long n = cells.size();
+      if (esutil::Threads::getNumThreads() > 1) {
+        #pragma omp parallel for schedule(dynamic, cellBlock)
+        for (long i = 0; i < n; ++i) f(*cells[i], i);
+      } else {
+        for (long i = 0; i < n; ++i) f(*cells[i], i);
+      }
+    }
+
+    template < class Function >
+    inline void CellTasks::forEachColouredCell(Function f) {
+      CellList &realCells = getRealCells();
+      if (esutil::Threads::getNumThreads() == 1) {
+        for (long i = 0; i < (long)realCells.size(); ++i) f(*realCells[i], i);
+        return;
+      }
+
+      if (!coloured) colour();
+      for (size_t c = 0; c < colours.size(); ++c) {
+        const std::vector< longint > &cells = colours[c];
+        const long n = cells.size();
+        #pragma omp parallel for schedule(dynamic, cellBlock)
+        for (long k = 0; k < n; ++k) f(*realCells[cells[k]], cells[k]);
+      }
+    }
+  }
+}
+
+#endif
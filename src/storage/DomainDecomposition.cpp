@@ -34,6 +34,7 @@
 #include "bc/BC.hpp"
 #include "Int3D.hpp"
 #include "Buffer.hpp"
+#include "esutil/Profiler.hpp"
 
 #include "iterator/CellListIterator.hpp"
 #include "esutil/Error.hpp"
@@ -48,6 +49,9 @@ namespace espressopp {
 
 
   const int DD_COMM_TAG = 0xab;
+  // header of the ghost data for a neighbor on the same node, plus the direction
+  const int DD_SHM_TAG = 0xc0;
+  // DomainDecompositionNonBlocking uses DD_GHOST_TAG = 0xb0 and 0xb1
 
   LOG4ESPP_LOGGER(DomainDecomposition::logger, "DomainDecomposition");
 
@@ -69,7 +73,7 @@ namespace espressopp {
   DomainDecomposition(shared_ptr< System > _system,
           const Int3D& _nodeGrid,
           const Int3D& _cellGrid)
-    : Storage(_system), exchangeBufferSize(0) {
+    : Storage(_system), exchangeBufferSize(0), sharedPacketSize(0) {
     LOG4ESPP_INFO(logger, "node grid = "
           << _nodeGrid[0] << "x" << _nodeGrid[1] << "x" << _nodeGrid[2]
           << " cell grid = "
@@ -82,9 +86,6 @@ namespace espressopp {
   }
 
   void DomainDecomposition:: createCellGrid(const Int3D& _nodeGrid, const Int3D& _cellGrid) {
-    real myLeft[3];
-    real myRight[3];
-
     nodeGrid = NodeGrid(_nodeGrid, getSystem()->comm->rank(), getSystem()->bc->getBoxL());
 
     if (nodeGrid.getNumberOfCells() != getSystem()->comm->size()) {
@@ -105,6 +106,13 @@ namespace espressopp {
            << nodeGrid.getNodeNeighborIndex(4) << "<->"
            << nodeGrid.getNodeNeighborIndex(5));
 
+    initCellGrid(_cellGrid);
+  }
+
+  void DomainDecomposition::initCellGrid(const Int3D& _cellGrid) {
+    real myLeft[3];
+    real myRight[3];
+
     for (int i = 0; i < 3; ++i) {
       myLeft[i] = nodeGrid.getMyLeft(i);
       myRight[i] = nodeGrid.getMyRight(i);
@@ -229,29 +237,111 @@ namespace espressopp {
                 );
   }
 
+  int DomainDecomposition::getAdjustedCellGridSize(int axis) {
+    real rc_skin = getSystem()->maxCutoff + getSystem()->getSkin();
+    int n = std::max(1, (int)(nodeGrid.getLocalBoxSize(axis) / rc_skin));
+    if (nodeGrid.getGridSize(axis) == 1) {
+      n = std::max(2, n);
+    }
+    return n;
+  }
+
+  Int3D DomainDecomposition::getAdjustedCellGrid() {
+    return Int3D(getAdjustedCellGridSize(0),
+                 getAdjustedCellGridSize(1),
+                 getAdjustedCellGridSize(2));
+  }
+
   void DomainDecomposition::cellAdjust(){
-    // create an appropriate cell grid
+    // the node boundaries are kept, e.g. those of the load balancer,
+    // they only follow a change of the box size
     Real3D box_sizeL = getSystem() -> bc -> getBoxL();
-    real skinL = getSystem() -> getSkin();
-    real maxCutoffL = getSystem() -> maxCutoff;
-            
-    // nodeGrid is already defined
-    Int3D _nodeGrid(nodeGrid.getGridSize());
+    Real3D s;
+    for (int i = 0; i < 3; ++i) {
+      s[i] = box_sizeL[i] / nodeGrid.getNodeBoundaries(i).back();
+    }
+    if (s != Real3D(1.0)) {
+      nodeGrid.scaleVolume(s);
+    }
+
     // new cellGrid
-    real rc_skin = maxCutoffL + skinL;
-    int ix = (int)(box_sizeL[0] / (rc_skin * _nodeGrid[0]));
-    int iy = (int)(box_sizeL[1] / (rc_skin * _nodeGrid[1]));
-    int iz = (int)(box_sizeL[2] / (rc_skin * _nodeGrid[2]));
-    Int3D _newCellGrid(ix, iy, iz);
+    Int3D _newCellGrid = getAdjustedCellGrid();
 
     // save all particles to temporary vector
     std::vector<ParticleList> tmp_pl;
-    size_t _N = realCells.size();
-    tmp_pl.reserve( _N );
+    clearCells(tmp_pl);
+    
+    // creating new grids
+    initCellGrid(_newCellGrid);
+    initCellInteractions();
+    prepareGhostCommunication();
+    
+    // pushing the particles back to the empty cells, clipped into the
+    // local box, and moving them to the nodes that own them
+    refillCells(tmp_pl);
+    decompose();
+  }
+
+  void DomainDecomposition::setNodeBoundaries(const std::vector<real>& bx,
+                                              const std::vector<real>& by,
+                                              const std::vector<real>& bz) {
+    const std::vector<real> *bounds[3] = { &bx, &by, &bz };
+    real rc_skin = getSystem()->maxCutoff + getSystem()->getSkin();
+
+    // check before touching the grids, the cells must not become smaller than the cutoff
+    esutil::Error err(getSystemRef().comm);
+    for (int i = 0; i < 3; ++i) {
+      const std::vector<real>& b = *bounds[i];
+      int pos = nodeGrid.getNodePosition(i);
+      if (b.size() != nodeGrid.getNodeBoundaries(i).size()) {
+        err.setException("number of node boundaries does not match the node grid");
+      } else if (b[pos + 1] - b[pos] < rc_skin) {
+        stringstream msg;
+        msg << "local box size " << b[pos + 1] - b[pos] << " along axis " << i
+            << " smaller than cutoff+skin " << rc_skin;
+        err.setException(msg.str());
+      }
+    }
+    err.checkException();
+
+    Int3D _newCellGrid;
+    for (int i = 0; i < 3; ++i) {
+      real oldSize = nodeGrid.getLocalBoxSize(i);
+      nodeGrid.setNodeBoundaries(i, *bounds[i]);
+      real newSize = nodeGrid.getLocalBoxSize(i);
+      if (newSize == oldSize) {
+        // all nodes of this slab keep their cells along this axis
+        _newCellGrid[i] = cellGrid.getGridSize(i);
+      } else {
+        // same rule as cellAdjust, the neighbors of the slab get the same count
+        _newCellGrid[i] = getAdjustedCellGridSize(i);
+      }
+    }
+
+    LOG4ESPP_INFO(logger, "new node boundaries, local box "
+          << nodeGrid.getMyLeft(0) << "-" << nodeGrid.getMyRight(0) << ", "
+          << nodeGrid.getMyLeft(1) << "-" << nodeGrid.getMyRight(1) << ", "
+          << nodeGrid.getMyLeft(2) << "-" << nodeGrid.getMyRight(2));
+
+    std::vector<ParticleList> tmp_pl;
+    clearCells(tmp_pl);
+
+    initCellGrid(_newCellGrid);
+    initCellInteractions();
+    prepareGhostCommunication();
+
+    // the particles are clipped into the new local box and then
+    // migrate to the nodes that own them now
+    refillCells(tmp_pl);
+    decompose();
+  }
+
+  void DomainDecomposition::clearCells(std::vector<ParticleList> &tmp_pl) {
+    tmp_pl.reserve(realCells.size());
     for(CellList::Iterator it(realCells); it.isValid(); ++it) {
       tmp_pl.push_back((*it)->particles);
     }
-    
+
     // reset all cells info
     invalidateGhosts();
     cells.clear();
@@ -262,14 +352,10 @@ namespace espressopp {
       commCells[i].reals.clear();
       commCells[i].ghosts.clear();
     }
-    
-    // creating new grids
-    createCellGrid(_nodeGrid, _newCellGrid);
-    initCellInteractions();
-    prepareGhostCommunication();
-    
-    // pushing the particles back to the empty cell ("do we have to check particles?")
-    for(int i=0; i<tmp_pl.size(); i++){
+  }
+
+  void DomainDecomposition::refillCells(std::vector<ParticleList> &tmp_pl) {
+    for(size_t i=0; i<tmp_pl.size(); i++){
       for (size_t p = 0; p < tmp_pl[i].size(); ++p) {
         Particle& part = tmp_pl[i][p];
         const Real3D& pos = part.position();
@@ -281,9 +367,6 @@ namespace espressopp {
     for(CellList::Iterator it(realCells); it.isValid(); ++it) {
       updateLocalParticles((*it)->particles);
     }
-    
-    exchangeGhosts();
-    onParticlesChanged();
   }
 
   void DomainDecomposition::initCellInteractions() {
@@ -383,6 +466,7 @@ namespace espressopp {
       //std::cout << getSystem()->comm->rank() << ": " << " decomposeRealParticles\n";
 
     LOG4ESPP_DEBUG(logger, "starting, expected comm buffer size " << exchangeBufferSize);
+    esutil::Profiler::Scope profile("exchangeReals");
 
     // allocate send/recv buffers. We use the size as we need maximally so far, to avoid reallocation
     // TODO: This might be a problem when all particles are created on a single node initially!
@@ -546,7 +630,9 @@ namespace espressopp {
   void DomainDecomposition::exchangeGhosts() {
 
     LOG4ESPP_DEBUG(logger, "exchangeGhosts -> ghost communication sizes first, real->ghost");
+    sharedPacketSize = 0;
     doGhostCommunication(true, true, dataOfExchangeGhosts);
+    if (sharedGhosts.isOpen()) fitSharedGhosts();
   }
 
   void DomainDecomposition::updateGhosts() {
@@ -649,6 +735,69 @@ namespace espressopp {
     }
   }
   
+  void DomainDecomposition::setSharedGhosts(bool enabled) {
+    if (enabled == sharedGhosts.isOpen()) return;
+    if (enabled) {
+      std::vector<longint> neighbors;
+      for (int dir = 0; dir < 6; ++dir) {
+        neighbors.push_back(nodeGrid.getNodeNeighborIndex(dir));
+      }
+      sharedGhosts.open(getSystem()->comm, neighbors);
+      sharedPacketSize = 0;
+    } else {
+      sharedGhosts.close();
+    }
+  }
+
+  void DomainDecomposition::fitSharedGhosts() {
+    // the exchange of the ghosts carries the properties and is the
+    // largest; the updates until the next one fit if it does
+    int needed = 0;
+    mpi::all_reduce(*getSystem()->comm, sharedPacketSize, needed, mpi::maximum<int>());
+    if (needed > sharedGhosts.getCapacity()) {
+      sharedGhosts.resize(needed + needed / 2);
+    }
+  }
+
+  void DomainDecomposition::sendGhostData(longint receiver, int dir) {
+    if (!sharedGhosts.reaches(receiver)) {
+      outBuffer.send(receiver, DD_COMM_TAG);
+      return;
+    }
+    sharedPacketSize = std::max(sharedPacketSize, (int)outBuffer.getSize());
+    // the size of the data in the slot, or -1 if it follows as message
+    int size = outBuffer.isAttached() ? outBuffer.getSize() : -1;
+    if (size >= 0) sharedGhosts.sync();
+    getSystem()->comm->send(receiver, DD_SHM_TAG + dir, size);
+    if (size < 0) outBuffer.send(receiver, DD_COMM_TAG);
+    outBuffer.detach();
+    sharedGhosts.expectAck(receiver, dir);
+  }
+
+  void DomainDecomposition::recvGhostData(longint sender, int dir) {
+    if (!sharedGhosts.reaches(sender)) {
+      inBuffer.recv(sender, DD_COMM_TAG);
+      return;
+    }
+    int size;
+    getSystem()->comm->recv(sender, DD_SHM_TAG + dir, size);
+    if (size < 0) {
+      inBuffer.recv(sender, DD_COMM_TAG);
+    } else {
+      sharedGhosts.sync();
+      inBuffer.attach(sharedGhosts.getRecvSlot(sender, dir), size, size);
+    }
+  }
+
+  void DomainDecomposition::releaseGhostData(longint sender, int dir) {
+    if (!sharedGhosts.reaches(sender)) return;
+    if (inBuffer.isAttached()) {
+      inBuffer.detach();
+      sharedGhosts.sync();
+    }
+    sharedGhosts.ack(sender, dir);
+  }
+
   void DomainDecomposition::
   doGhostCommunication(bool sizesFirst, bool realToGhosts, int extradata) {
     LOG4ESPP_DEBUG(logger, "do ghost communication " << (sizesFirst ? "with sizes " : "")
@@ -681,6 +830,7 @@ namespace espressopp {
 
         if (nodeGrid.getGridSize(coord) == 1) {
           LOG4ESPP_DEBUG(logger, "local communication");
+          esutil::Profiler::Scope prof("copy");
 
           // copy operation, we have to receive as many cells as we send
           if (commCells[dir].ghosts.size() != commCells[dir].reals.size()) {
@@ -699,6 +849,7 @@ namespace espressopp {
           // exchange size information, if necessary
           if (sizesFirst) {
             LOG4ESPP_DEBUG(logger, "exchanging ghost cell sizes");
+            esutil::Profiler::Scope prof("sizes");
 
             // prepare buffers
             std::vector<longint> sendSizes, recvSizes;
@@ -731,32 +882,42 @@ namespace espressopp {
 
           // prepare send and receive buffers
           longint receiver, sender;
-          outBuffer.reset();
-          if (realToGhosts) {
-            receiver = nodeGrid.getNodeNeighborIndex(dir);
-            sender = nodeGrid.getNodeNeighborIndex(oppositeDir);
-            for (int i = 0, end = commCells[dir].reals.size(); i < end; ++i) {
-              packPositionsEtc(outBuffer, *commCells[dir].reals[i], extradata, shift);
+          {
+            esutil::Profiler::Scope prof("pack");
+            outBuffer.reset();
+            receiver = nodeGrid.getNodeNeighborIndex(realToGhosts ? dir : oppositeDir);
+            sender = nodeGrid.getNodeNeighborIndex(realToGhosts ? oppositeDir : dir);
+            // pack directly into the shared slot for a receiver on this node
+            if (sharedGhosts.hasWindow() && sharedGhosts.reaches(receiver)) {
+              outBuffer.attach(sharedGhosts.acquireSendSlot(dir), 0, sharedGhosts.getCapacity());
             }
-          }
-          else {
-            receiver = nodeGrid.getNodeNeighborIndex(oppositeDir);
-            sender = nodeGrid.getNodeNeighborIndex(dir);
-            for (int i = 0, end = commCells[dir].ghosts.size(); i < end; ++i) {
-              packForces(outBuffer, *commCells[dir].ghosts[i]);
+            if (realToGhosts) {
+              for (int i = 0, end = commCells[dir].reals.size(); i < end; ++i) {
+                packPositionsEtc(outBuffer, *commCells[dir].reals[i], extradata, shift);
+              }
+            }
+            else {
+              for (int i = 0, end = commCells[dir].ghosts.size(); i < end; ++i) {
+                packForces(outBuffer, *commCells[dir].ghosts[i]);
+              }
             }
           }
 
           // exchange particles, odd-even rule
-          if (nodeGrid.getNodePosition(coord) % 2 == 0) {
-            outBuffer.send(receiver, DD_COMM_TAG);
-            inBuffer.recv(sender, DD_COMM_TAG);
-          } else {
-            inBuffer.recv(sender, DD_COMM_TAG);
-            outBuffer.send(receiver, DD_COMM_TAG);
+          {
+            esutil::Profiler::Scope prof("mpi");
+            esutil::Profiler::addBytes(outBuffer.getSize());
+            if (nodeGrid.getNodePosition(coord) % 2 == 0) {
+              sendGhostData(receiver, dir);
+              recvGhostData(sender, dir);
+            } else {
+              recvGhostData(sender, dir);
+              sendGhostData(receiver, dir);
+            }
           }
 
           // unpack received data
+          esutil::Profiler::Scope prof("unpack");
           if (realToGhosts) {
             for (int i = 0, end = commCells[dir].reals.size(); i < end; ++i) {
               unpackPositionsEtc(*commCells[dir].ghosts[i], inBuffer, extradata);
@@ -767,6 +928,7 @@ namespace espressopp {
               unpackAndAddForces(*commCells[dir].reals[i], inBuffer);
             }
           }
+          releaseGhostData(sender, dir);
         }
       }
     }
@@ -776,6 +938,28 @@ namespace espressopp {
   //////////////////////////////////////////////////
   // REGISTRATION WITH PYTHON
   //////////////////////////////////////////////////
+  static python::list wrapGetNodeBoundaries(DomainDecomposition &dd) {
+    python::list ret;
+    for (int i = 0; i < 3; ++i) {
+      const std::vector<real>& b = dd.getNodeGrid().getNodeBoundaries(i);
+      python::list axis;
+      for (size_t j = 0; j < b.size(); ++j) axis.append(b[j]);
+      ret.append(axis);
+    }
+    return ret;
+  }
+
+  static void wrapSetNodeBoundaries(DomainDecomposition &dd, python::object bounds) {
+    std::vector<real> b[3];
+    for (int i = 0; i < 3; ++i) {
+      python::object axis = bounds[i];
+      for (long j = 0, n = python::len(axis); j < n; ++j) {
+        b[i].push_back(python::extract<real>(axis[j]));
+      }
+    }
+    dd.setNodeBoundaries(b[0], b[1], b[2]);
+  }
+
   void DomainDecomposition::registerPython() {
     using namespace espressopp::python;
     class_< DomainDecomposition, bases< Storage >, boost::noncopyable >
@@ -784,6 +968,10 @@ namespace espressopp {
     .def("getCellGrid", &DomainDecomposition::getInt3DCellGrid)
     .def("getNodeGrid", &DomainDecomposition::getInt3DNodeGrid)
     .def("cellAdjust", &DomainDecomposition::cellAdjust)
+    .def("getNodeBoundaries", &wrapGetNodeBoundaries)
+    .def("setNodeBoundaries", &wrapSetNodeBoundaries)
+    .add_property("sharedGhosts", &DomainDecomposition::getSharedGhosts,
+                  &DomainDecomposition::setSharedGhosts)
     ;
   }
 
@@ -27,6 +27,7 @@
 #include "types.hpp"
 #include "CellGrid.hpp"
 #include "NodeGrid.hpp"
+#include "SharedGhostBuffers.hpp"
 
 
 namespace espressopp {
@@ -54,8 +55,20 @@ namespace espressopp {
       Int3D getInt3DNodeGrid();
 
       // it modifies the cell structure if the cell size becomes smaller then cutoff+skin
-      // as a consequence of the system resizing
+      // as a consequence of the system resizing. The node boundaries are kept
+      // (scaled to the box) and the particles migrate to the nodes that own them.
       virtual void cellAdjust();
+      /// the cell grid that cellAdjust() creates for the current local box, cutoff and skin
+      Int3D getAdjustedCellGrid();
+
+      /** Move the node boundaries, e.g. for load balancing. bx, by and bz
+          are the new boundaries along each axis, see NodeGrid; they must be
+          the same on all nodes. The cell grid is rebuilt and the particles
+          migrate to their new nodes. Collective. The cell grid of an axis
+          whose local box changed is chosen like in cellAdjust(). */
+      void setNodeBoundaries(const std::vector<real>& bx,
+                             const std::vector<real>& by,
+                             const std::vector<real>& bz);
 
       virtual Cell *mapPositionToCell(const Real3D& pos);
       virtual Cell *mapPositionToCellClipped(const Real3D& pos);
@@ -77,6 +90,14 @@ namespace espressopp {
       virtual void updateGhostsV();
       virtual void collectGhostForces();
 
+      /** Exchange the ghosts with neighbors on the same node through
+          shared memory (see SharedGhostBuffers) instead of messages.
+          The buffers are sized in every decompose(). Collective;
+          disabling it is the only place where the shared memory is
+          freed, so do so before the storage is deleted. */
+      void setSharedGhosts(bool enabled);
+      bool getSharedGhosts() const { return sharedGhosts.isOpen(); }
+
       static void registerPython();
 
     protected:
@@ -90,10 +111,27 @@ namespace espressopp {
 
       void prepareGhostCommunication();
 
+      /// send outBuffer, packed for direction dir, to receiver
+      void sendGhostData(longint receiver, int dir);
+      /// receive the data of sender for direction dir into inBuffer
+      void recvGhostData(longint sender, int dir);
+      /// done with the data in inBuffer received from sender
+      void releaseGhostData(longint sender, int dir);
+      /// size the shared buffers for the largest ghost exchange
+      void fitSharedGhosts();
+
       /// init global Verlet list
       void initCellInteractions();
       /// set the grids and allocate space accordingly
       void createCellGrid(const Int3D& nodeGrid, const Int3D& cellGrid);
+      /// set the cell grid on the current node grid and allocate space accordingly
+      void initCellGrid(const Int3D& cellGrid);
+      /// number of cells along an axis that fits the local box, cutoff and skin
+      int getAdjustedCellGridSize(int axis);
+      /// move the real particles out and reset all cells
+      void clearCells(std::vector<ParticleList> &);
+      /// put particles saved by clearCells back into the (new) cells, clipped to the local box
+      void refillCells(std::vector<ParticleList> &);
       /// sort cells into local/ghost cell arrays
       void markCells();
       /// fill a list of cells with the cells from a certain region of the domain grid
@@ -129,6 +167,11 @@ namespace espressopp {
       */
       CommCells commCells[6];
 
+      /// ghost buffers shared with the neighbors on this node
+      SharedGhostBuffers sharedGhosts;
+      /// largest data sent to a neighbor on this node in the current exchangeGhosts()
+      int sharedPacketSize;
+
       static LOG4ESPP_DECL_LOGGER(logger);
     };
   }
@@ -41,6 +41,43 @@ espressopp.storage.DomainDecomposition
 .. function:: espressopp.storage.DomainDecomposition.getNodeGrid()
 
 		:rtype: 
+
+.. function:: espressopp.storage.DomainDecomposition.getNodeBoundaries()
+
+		Boundaries of the nodes along x, y and z; for a node grid of
+		n nodes along an axis there are n+1 values from 0 to the box
+		length. Equidistant unless they were moved, e.g. by
+		espressopp.integrator.LoadBalancer.
+
+		:rtype: list of three lists of floats
+
+.. function:: espressopp.storage.DomainDecomposition.setNodeBoundaries(bounds)
+
+		Move the node boundaries and migrate the particles accordingly.
+		The first and last value of each axis must stay the same and no
+		local box may become smaller than cutoff + skin.
+
+		:param bounds: new boundaries along x, y and z
+		:type bounds: list of three lists of floats
+
+.. attribute:: espressopp.storage.DomainDecomposition.sharedGhosts
+
+		If True, the ghost data for neighbor processes on the same
+		node is exchanged through an MPI-3 shared memory window: the
+		sender packs into its part of the window and the receiver
+		unpacks from there, only a small header goes through MPI.
+		Neighbors on other nodes keep using messages. The window is
+		sized at every decompose(), so the shared path is used from
+		the second decompose() on. Default is False.
+
+		Setting it to False frees the window collectively. Do so
+		before the storage is deleted; the window is not freed when
+		the storage is destroyed, as the processes need not do that
+		at the same time.
+
+		>>> system.storage.sharedGhosts = True
+		>>> integrator.run(1000)
+		>>> system.storage.sharedGhosts = False
 """
 from espressopp import pmi
 from espressopp.esutil import cxxinit
@@ -65,12 +102,22 @@ class DomainDecompositionLocal(StorageLocal, storage_DomainDecomposition):
     def getNodeGrid(self):
         if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
             return self.cxxclass.getNodeGrid(self)
+
+    def getNodeBoundaries(self):
+        if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+            return self.cxxclass.getNodeBoundaries(self)
+
+    def setNodeBoundaries(self, bounds):
+        if not (pmi._PMIComm and pmi._PMIComm.isActive()) or pmi._MPIcomm.rank in pmi._PMIComm.getMPIcpugroup():
+            self.cxxclass.setNodeBoundaries(self, bounds)
           
 if pmi.isController:
     class DomainDecomposition(Storage):
         pmiproxydefs = dict(
           cls = 'espressopp.storage.DomainDecompositionLocal',  
-          pmicall = ['getCellGrid', 'getNodeGrid', 'cellAdjust', 'mapPositionToNodeClipped']
+          pmicall = ['getCellGrid', 'getNodeGrid', 'cellAdjust', 'mapPositionToNodeClipped',
+                     'getNodeBoundaries', 'setNodeBoundaries'],
+          pmiproperty = ['sharedGhosts']
         )
         def __init__(self, system, 
                      nodeGrid='auto', 
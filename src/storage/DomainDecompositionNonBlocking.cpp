@@ -33,6 +33,7 @@
 #include "bc/BC.hpp"
 #include "Int3D.hpp"
 #include "Buffer.hpp"
+#include "esutil/Profiler.hpp"
 #include "iterator/CellListIterator.hpp"
 
 using namespace boost;
@@ -43,6 +44,9 @@ namespace espressopp {
 
 
   const int DD_COMM_TAG = 0xab;
+  // split-phase ghost update, one tag per direction (left/right);
+  // 0xac is taken by AssociationReaction
+  const int DD_GHOST_TAG = 0xb0;
 
   DomainDecompositionNonBlocking::
   DomainDecompositionNonBlocking(shared_ptr< System > _system,
@@ -54,7 +58,8 @@ namespace espressopp {
       outBufferL(*_system->comm),
       outBufferR(*_system->comm),
       inBufferG(*_system->comm),
-      outBufferG(*_system->comm) {}
+      outBufferG(*_system->comm),
+      ghostReqsPending(false) {}
 
   void DomainDecompositionNonBlocking::decomposeRealParticles() {
 
@@ -339,8 +344,12 @@ namespace espressopp {
             reqs[0]=inBufferG.irecv(sender, DD_COMM_TAG);
             reqs[1]=outBufferG.isend(receiver, DD_COMM_TAG);
           }
+          esutil::Profiler::addBytes(outBufferG.getSize());
 
-          mpi::wait_all(reqs, reqs + 2);
+          {
+            esutil::Profiler::Scope prof("mpi");
+            mpi::wait_all(reqs, reqs + 2);
+          }
 
           // unpack received data
           if (realToGhosts) {
@@ -359,6 +368,104 @@ namespace espressopp {
     LOG4ESPP_DEBUG(logger, "ghost communication finished");
   }
 
+  void DomainDecompositionNonBlocking::updateGhostsBegin() {
+    LOG4ESPP_DEBUG(logger, "updateGhostsBegin -> post ghost positions in x-direction");
+    postGhostUpdate(0);
+  }
+
+  void DomainDecompositionNonBlocking::progressGhostUpdate() {
+    if (ghostReqsPending) {
+      ghostReqsPending = !mpi::test_all(ghostReqs, ghostReqs + 4);
+    }
+  }
+
+  void DomainDecompositionNonBlocking::updateGhostsEnd() {
+    LOG4ESPP_DEBUG(logger, "updateGhostsEnd -> complete ghost communication");
+    finishGhostUpdate(0);
+    // the layers of y and z contain the ghosts of the previous
+    // directions, so they can only be sent now
+    for (int coord = 1; coord < 3; ++coord) {
+      postGhostUpdate(coord);
+      finishGhostUpdate(coord);
+    }
+  }
+
+  int DomainDecompositionNonBlocking::ghostUpdateSize(int dir) {
+    int particleSize = sizeof(ParticlePosition);
+    if (dataOfUpdateGhosts & DATA_PROPERTIES) particleSize += sizeof(ParticleProperties);
+    if (dataOfUpdateGhosts & DATA_MOMENTUM) particleSize += sizeof(ParticleMomentum);
+    if (dataOfUpdateGhosts & DATA_LOCAL) particleSize += sizeof(ParticleLocal);
+
+    longint n = 0;
+    for (int i = 0, end = commCells[dir].ghosts.size(); i < end; ++i) {
+      n += commCells[dir].ghosts[i]->particles.size();
+    }
+    return n * particleSize;
+  }
+
+  void DomainDecompositionNonBlocking::postGhostUpdate(int coord) {
+    real curCoordBoxL = getSystem()->bc->getBoxL()[coord];
+
+    // the sizes of the ghost cells are known since exchangeGhosts(), so the
+    // receives are posted without probing and progress before the wait
+    if (nodeGrid.getGridSize(coord) > 1) {
+      for (int lr = 0; lr < 2; ++lr) {
+        int dir = 2 * coord + lr;
+        int oppositeDir = 2 * coord + (1 - lr);
+        InBuffer &inBuffer = (lr == 0) ? inBufferL : inBufferR;
+        ghostReqs[2 + lr] = inBuffer.irecv(nodeGrid.getNodeNeighborIndex(oppositeDir),
+                                           DD_GHOST_TAG + lr, ghostUpdateSize(dir));
+      }
+    }
+
+    for (int lr = 0; lr < 2; ++lr) {
+      int dir = 2 * coord + lr;
+
+      Real3D shift(0, 0, 0);
+      shift[coord] = nodeGrid.getBoundary(dir) * curCoordBoxL;
+
+      if (nodeGrid.getGridSize(coord) == 1) {
+        LOG4ESPP_DEBUG(logger, "local ghost update in direction " << dir);
+        if (commCells[dir].ghosts.size() != commCells[dir].reals.size()) {
+          throw std::runtime_error("DomainDecompositionNonBlocking::postGhostUpdate: send/recv cell structure mismatch during local copy");
+        }
+        for (int i = 0, end = commCells[dir].ghosts.size(); i < end; ++i) {
+          copyRealsToGhosts(*commCells[dir].reals[i], *commCells[dir].ghosts[i], dataOfUpdateGhosts, shift);
+        }
+      }
+      else {
+        LOG4ESPP_DEBUG(logger, "post ghost update to node " << nodeGrid.getNodeNeighborIndex(dir));
+        OutBuffer &outBuffer = (lr == 0) ? outBufferL : outBufferR;
+        outBuffer.reset();
+        for (int i = 0, end = commCells[dir].reals.size(); i < end; ++i) {
+          packPositionsEtc(outBuffer, *commCells[dir].reals[i], dataOfUpdateGhosts, shift);
+        }
+        ghostReqs[lr] = outBuffer.isend(nodeGrid.getNodeNeighborIndex(dir), DD_GHOST_TAG + lr);
+        esutil::Profiler::addBytes(outBuffer.getSize());
+        ghostReqsPending = true;
+      }
+    }
+  }
+
+  void DomainDecompositionNonBlocking::finishGhostUpdate(int coord) {
+    if (nodeGrid.getGridSize(coord) == 1) return;
+
+    if (ghostReqsPending) {
+      esutil::Profiler::Scope prof("mpi");
+      mpi::wait_all(ghostReqs, ghostReqs + 4);
+      ghostReqsPending = false;
+    }
+
+    for (int lr = 0; lr < 2; ++lr) {
+      int dir = 2 * coord + lr;
+      InBuffer &inBuffer = (lr == 0) ? inBufferL : inBufferR;
+      for (int i = 0, end = commCells[dir].ghosts.size(); i < end; ++i) {
+        unpackPositionsEtc(*commCells[dir].ghosts[i], inBuffer, dataOfUpdateGhosts);
+      }
+    }
+    LOG4ESPP_DEBUG(logger, "ghost update in direction " << coord << " finished");
+  }
+
   mpi::request DomainDecompositionNonBlocking::isendParticles(OutBuffer &data, ParticleList &list, longint node)
   {
     LOG4ESPP_DEBUG(logger, "initiate non blocking isend " << list.size() << " particles to " << node);
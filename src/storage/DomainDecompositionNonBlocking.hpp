@@ -34,6 +34,16 @@ namespace espressopp {
               const Int3D& _nodeGrid,
 			  const Int3D& _cellGrid);
       virtual ~DomainDecompositionNonBlocking() {}
+
+      /** The x-layer of the ghost update is sent and its receives are
+          posted in updateGhostsBegin(); progressGhostUpdate() tests
+          them. updateGhostsEnd() completes it and then exchanges the
+          y- and z-layers, which contain the ghosts of the previous
+          directions. */
+      virtual void updateGhostsBegin();
+      virtual void updateGhostsEnd();
+      virtual void progressGhostUpdate();
+
       static void registerPython();
     protected:
       virtual void decomposeRealParticles();
@@ -41,6 +51,10 @@ namespace espressopp {
       mpi::request isendParticles(OutBuffer &data, ParticleList &list, longint node);
       mpi::request irecvParticles_initiate(InBuffer &data, longint node);
       void irecvParticles_finish(InBuffer &data, ParticleList &list);
+      void postGhostUpdate(int coord);
+      void finishGhostUpdate(int coord);
+      /// size of the ghost update received for the layer of direction dir
+      int ghostUpdateSize(int dir);
     private:
       InBuffer inBufferL;
       InBuffer inBufferR;
@@ -48,6 +62,8 @@ namespace espressopp {
       OutBuffer outBufferR;
       InBuffer inBufferG;   // used for ghost communication
       OutBuffer outBufferG;  // used for ghost communication
+      mpi::request ghostReqs[4];  // pending split-phase ghost update
+      bool ghostReqsPending;      // ghostReqs have not all completed yet
     };
   }
 }
@@ -20,6 +20,7 @@
   along with this program.  If not, see <http://www.gnu.org/licenses/>. 
 */
 
+#include <algorithm>
 #include "log4espp.hpp"
 
 #include "Real3D.hpp"
@@ -46,6 +47,10 @@ namespace espressopp {
       for(int i = 0; i < 3; ++i) {
         localBoxSize[i] = domainSize[i]/static_cast<real>(getGridSize(i));
         invLocalBoxSize[i] = 1.0/localBoxSize[i];
+        nodeBounds[i].resize(getGridSize(i) + 1);
+        for (int j = 0; j <= getGridSize(i); ++j) {
+          nodeBounds[i][j] = j*localBoxSize[i];
+        }
       }
       smallestLocalBoxDiameter = std::min(std::min(localBoxSize[0], localBoxSize[1]), localBoxSize[2]);
 
@@ -58,17 +63,38 @@ namespace espressopp {
       Int3D cpos;
     
       for (int i = 0; i < 3; ++i) {
-        cpos[i] = static_cast< int >(pos[i]*invLocalBoxSize[i]);
-        if (cpos[i] < 0) {
-          cpos[i] = 0;
-        }
-        else if (cpos[i] >= getGridSize(i)) {
-          cpos[i] = getGridSize(i) - 1;
-        }
+        // the inner boundaries decide, positions outside the box are clipped
+        const std::vector<real>& b = nodeBounds[i];
+        cpos[i] = std::upper_bound(b.begin() + 1, b.end() - 1, pos[i]) - (b.begin() + 1);
       }
       return mapPositionToIndex(cpos);
     }
 
+    void NodeGrid::
+    setNodeBoundaries(int axis, const std::vector<real>& bounds)
+    {
+      std::vector<real>& b = nodeBounds[axis];
+      if (bounds.size() != b.size()) {
+        throw std::invalid_argument("number of node boundaries does not match the node grid");
+      }
+      if (bounds.front() != b.front() || bounds.back() != b.back()) {
+        throw std::invalid_argument("node boundaries have to span the whole box");
+      }
+      for (size_t j = 1; j < bounds.size(); ++j) {
+        if (!(bounds[j] > bounds[j-1])) {
+          throw std::invalid_argument("node boundaries have to be strictly increasing");
+        }
+      }
+      b = bounds;
+
+      localBoxSize[axis] = getMyRight(axis) - getMyLeft(axis);
+      invLocalBoxSize[axis] = 1.0/localBoxSize[axis];
+      smallestLocalBoxDiameter = std::min(std::min(localBoxSize[0], localBoxSize[1]), localBoxSize[2]);
+
+      LOG4ESPP_DEBUG(logger, "boundaries along axis " << axis << " set, local box "
+                     << getMyLeft(axis) << "-" << getMyRight(axis));
+    }
+
     void NodeGrid::calcNodeNeighbors(longint node)
     {
       Int3D nPos;
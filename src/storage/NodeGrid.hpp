@@ -29,6 +29,7 @@
 */
 
 #include <stdexcept>
+#include <vector>
 #include "types.hpp"
 #include "logging.hpp"
 #include "esutil/Grid.hpp"
@@ -45,6 +46,13 @@ namespace espressopp {
     /** Node grid point. This represents the node grid of the domain
 	decomposition, as well as the location of this processor in the
 	grid.
+
+	The node boundaries along each axis need not be equidistant: the
+	local box of the node at grid position (i,j,k) is
+	[b0[i], b0[i+1]) x [b1[j], b1[j+1]) x [b2[k], b2[k+1]), where
+	bA are the boundaries along axis A, shared by all nodes. The
+	grid stays rectilinear, so every node keeps exactly one neighbor
+	per direction.
     */
     class NodeGrid: public esutil::Grid
     {
@@ -79,17 +87,22 @@ namespace espressopp {
       real getInverseLocalBoxSize(int axis) const { return invLocalBoxSize[axis]; }
 
       /// calculate start of local box
-      real getMyLeft(int axis) const { return nodePos[axis]*localBoxSize[axis]; }
+      real getMyLeft(int axis) const { return nodeBounds[axis][nodePos[axis]]; }
       Real3D getMyLeft() const { 
         return Real3D(getMyLeft(0), getMyLeft(1), getMyLeft(2));
       }
 
       /// calculate end of local box
-      real getMyRight(int axis) const { return (nodePos[axis] + 1)*localBoxSize[axis]; }
+      real getMyRight(int axis) const { return nodeBounds[axis][nodePos[axis] + 1]; }
       Real3D getMyRight() const { 
         return Real3D(getMyRight(0), getMyRight(1), getMyRight(2));
       }
 
+      /// node boundaries along an axis, getGridSize(axis) + 1 values from 0 to the box length
+      const std::vector<real>& getNodeBoundaries(int axis) const { return nodeBounds[axis]; }
+      /** set the node boundaries along an axis. They have to be strictly increasing
+          and start and end at the same values as the current ones. */
+      void setNodeBoundaries(int axis, const std::vector<real>& bounds);
       Real3D getMyCenter() const {
         Real3D center = getMyLeft();
         center += getMyRight();
@@ -121,6 +134,7 @@ namespace espressopp {
           for (int i=0; i<3; ++i) {
             localBoxSize[i] *= s;
             invLocalBoxSize[i] /= s;
+            for (size_t j=0; j<nodeBounds[i].size(); ++j) nodeBounds[i][j] *= s;
           }
           smallestLocalBoxDiameter *= s;
         }
@@ -134,6 +148,7 @@ namespace espressopp {
           for (int i=0; i<3; ++i) {
             localBoxSize[i] *= s[i];
             invLocalBoxSize[i] /= s[i];
+            for (size_t j=0; j<nodeBounds[i].size(); ++j) nodeBounds[i][j] *= s[i];
           }
           smallestLocalBoxDiameter = std::min(std::min(localBoxSize[0], localBoxSize[1]), localBoxSize[2]);
         }
@@ -160,6 +175,8 @@ namespace espressopp {
 
       /// smallest diameter of the local box
       real smallestLocalBoxDiameter;
+      /// node boundaries along each axis
+      std::vector<real> nodeBounds[3];
 
       static LOG4ESPP_DECL_LOGGER(logger);
     };
@@ -0,0 +1,126 @@
+/*
+  Copyright (C) 2016
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "python.hpp"
+#include "ParticleArrays.hpp"
+#include "Cell.hpp"
+
+namespace espressopp {
+  namespace storage {
+
+    LOG4ESPP_LOGGER(ParticleArrays::logger, "ParticleArrays");
+
+    ParticleArrays::ParticleArrays()
+      : nReal(0), contentsValid(false)
+    {}
+
+    void ParticleArrays::clear()
+    {
+      x.clear(); y.clear(); z.clear();
+      fx.clear(); fy.clear(); fz.clear();
+      mass.clear(); q.clear(); type.clear();
+      particles.clear();
+      cellOffset.clear();
+      realCells.clear();
+      nReal = 0;
+      contentsValid = false;
+    }
+
+    inline void ParticleArrays::append(Particle &part)
+    {
+      const Real3D &pos = part.position();
+      x.push_back(pos[0]); y.push_back(pos[1]); z.push_back(pos[2]);
+      mass.push_back(part.mass());
+      q.push_back(part.q());
+      type.push_back(part.type());
+      particles.push_back(&part);
+    }
+
+    void ParticleArrays::rebuild(Cell *firstCell, longint nCells,
+                                 CellList &_realCells,
+                                 CellList &ghostCells)
+    {
+      longint nTotal = 0;
+      for (CellList::Iterator it(_realCells); it.isValid(); ++it) {
+        nTotal += (*it)->particles.size();
+      }
+      longint nRealNew = nTotal;
+      for (CellList::Iterator it(ghostCells); it.isValid(); ++it) {
+        nTotal += (*it)->particles.size();
+      }
+
+      clear();
+      x.reserve(nTotal); y.reserve(nTotal); z.reserve(nTotal);
+      mass.reserve(nTotal); q.reserve(nTotal); type.reserve(nTotal);
+      particles.reserve(nTotal);
+      cellOffset.assign(2*nCells, 0);
+      realCells = _realCells;
+
+      for (int pass = 0; pass < 2; ++pass) {
+        CellList &cellList = pass == 0 ? realCells : ghostCells;
+        for (CellList::Iterator it(cellList); it.isValid(); ++it) {
+          Cell *cell = *it;
+          longint cellIdx = cell - firstCell;
+          cellOffset[2*cellIdx] = particles.size();
+          ParticleList &plist = cell->particles;
+          for (size_t i = 0; i < plist.size(); ++i) {
+            append(plist[i]);
+          }
+          cellOffset[2*cellIdx + 1] = particles.size();
+        }
+      }
+
+      nReal = nRealNew;
+      fx.assign(nTotal, 0.0); fy.assign(nTotal, 0.0); fz.assign(nTotal, 0.0);
+      contentsValid = true;
+
+      LOG4ESPP_DEBUG(logger, "rebuilt arrays for " << nReal << " real and "
+                     << (nTotal - nReal) << " ghost particles");
+    }
+
+    void ParticleArrays::loadContents()
+    {
+      const longint n = size();
+      for (longint i = 0; i < n; ++i) {
+        const Particle &part = *particles[i];
+        const Real3D &pos = part.position();
+        x[i] = pos[0]; y[i] = pos[1]; z[i] = pos[2];
+        mass[i] = part.mass();
+        q[i] = part.q();
+        type[i] = part.type();
+      }
+      contentsValid = true;
+    }
+
+    void ParticleArrays::zeroForces()
+    {
+      std::fill(fx.begin(), fx.end(), 0.0);
+      std::fill(fy.begin(), fy.end(), 0.0);
+      std::fill(fz.begin(), fz.end(), 0.0);
+    }
+
+    void ParticleArrays::addForcesToParticles(longint begin, longint end)
+    {
+      for (longint i = begin; i < end; ++i) {
+        particles[i]->force() += Real3D(fx[i], fy[i], fz[i]);
+      }
+    }
+  }
+}
@@ -0,0 +1,125 @@
+/*
+  Copyright (C) 2016
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ESPP_CLASS
+#ifndef _STORAGE_PARTICLEARRAYS_HPP
+#define _STORAGE_PARTICLEARRAYS_HPP
+
+#include "types.hpp"
+#include "log4espp.hpp"
+#include "Cell.hpp"
+#include "esutil/AlignedAllocator.hpp"
+#include <vector>
+
+namespace espressopp {
+  namespace storage {
+
+    /** Structure-of-arrays mirror of the local particles of a storage.
+
+        Positions, forces, masses, charges and types of all local
+        particles are kept in contiguous, cache line aligned arrays.
+        Velocities are not mirrored, the kernels do not need them and
+        they change every step. The real particles come first, cell by
+        cell in the order given to rebuild() (see getRealCells()),
+        followed by the ghosts. Every entry keeps a pointer to the
+        Particle it mirrors, which stays the canonical, per-particle
+        view used by the rest of the code.
+
+        The layout is rebuilt by the storage whenever its particles
+        change (onParticlesChanged), i.e. after decomposition and
+        cell adjustment. Between rebuilds, only the contents have to
+        be synchronised: positions, charges and types are pulled in
+        lazily after each ghost update, so changes of the types or
+        charges (e.g. by ChangeParticleType, TopologyManager or from
+        Python) are seen from the next force calculation on. Forces
+        accumulated in the arrays are added back to the particles by
+        the kernels that use them.
+    */
+    class ParticleArrays {
+    public:
+      typedef std::vector< real, esutil::AlignedAllocator< real > > RealArray;
+      typedef std::vector< int, esutil::AlignedAllocator< int > > IntArray;
+
+      ParticleArrays();
+
+      /** Rebuild the layout from the cells of a storage. The real
+          particles are stored cell by cell in the order of \p realCells.
+          The cell offsets are indexed by the position of a cell
+          relative to \p firstCell, the first entry of the storage's
+          cell list. */
+      void rebuild(Cell *firstCell, longint nCells,
+                   CellList &realCells, CellList &ghostCells);
+
+      /** Drop all entries, e.g. before the cells are reallocated. */
+      void clear();
+
+      /// number of mirrored particles (reals and ghosts)
+      longint size() const { return particles.size(); }
+      /// number of mirrored real particles; these come first
+      longint getNReal() const { return nReal; }
+
+      /// the particle mirrored at index \p i
+      Particle &getParticle(longint i) const { return *particles[i]; }
+
+      /// the real cells in the order in which their particles are stored
+      CellList &getRealCells() { return realCells; }
+
+      /// index of the first particle of the cell with index \p cellIdx
+      longint cellBegin(longint cellIdx) const { return cellOffset[2*cellIdx]; }
+      /// one past the index of the last particle of cell \p cellIdx
+      longint cellEnd(longint cellIdx) const { return cellOffset[2*cellIdx + 1]; }
+
+      /** Mark the contents as outdated, e.g. after a ghost update. */
+      void invalidate() { contentsValid = false; }
+      /** Make sure the positions, charges, masses and types reflect the
+          particles. Cheap if nothing has changed since the last call. */
+      void ensureContents() { if (!contentsValid) loadContents(); }
+
+      /// copy the positions, charges, masses and types from the particles
+      void loadContents();
+      /// set all forces in the arrays to zero
+      void zeroForces();
+      /** add the forces accumulated in the arrays to the particles
+          in the index range [\p begin, \p end) */
+      void addForcesToParticles(longint begin, longint end);
+      /// add the forces of all entries to the particles
+      void addForcesToParticles() { addForcesToParticles(0, size()); }
+
+      RealArray x, y, z;
+      RealArray fx, fy, fz;
+      RealArray mass, q;
+      IntArray type;
+
+    private:
+      void append(Particle &part);
+
+      std::vector< Particle* > particles;
+      CellList realCells;
+      /// begin and end index for every cell, interleaved
+      std::vector< longint > cellOffset;
+      longint nReal;
+      bool contentsValid;
+
+      static LOG4ESPP_DECL_LOGGER(logger);
+    };
+  }
+}
+
+#endif
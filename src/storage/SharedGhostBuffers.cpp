@@ -0,0 +1,167 @@
+/*
+  Copyright (C) 2016
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "SharedGhostBuffers.hpp"
+
+namespace espressopp {
+  namespace storage {
+
+    LOG4ESPP_LOGGER(SharedGhostBuffers::logger, "SharedGhostBuffers");
+
+    namespace {
+      // tag of the acknowledgements, plus the direction
+      const int SHM_ACK_TAG = 0xc8;
+
+      bool mpiFinalized() {
+        int finalized = 0;
+        MPI_Finalized(&finalized);
+        return finalized;
+      }
+    }
+
+    SharedGhostBuffers::SharedGhostBuffers()
+      : nodeComm(MPI_COMM_NULL), win(MPI_WIN_NULL), base(0), capacity(0)
+    {
+      for (int dir = 0; dir < 6; ++dir) acks[dir] = MPI_REQUEST_NULL;
+    }
+
+    SharedGhostBuffers::~SharedGhostBuffers() {
+      // freeing the window is collective, but the processes need not
+      // destroy their storages at the same time; a window that was not
+      // closed is released by MPI_Finalize
+      if (isOpen() && !mpiFinalized()) {
+        LOG4ESPP_WARN(logger, "shared ghost buffers were not closed, "
+                      "set sharedGhosts to False before the storage is deleted");
+      }
+    }
+
+    void SharedGhostBuffers::open(shared_ptr< mpi::communicator > _comm,
+                                  const std::vector< longint > &neighbors) {
+      close();
+      comm = _comm;
+#if MPI_VERSION >= 3
+      MPI_Comm_split_type(*comm, MPI_COMM_TYPE_SHARED, comm->rank(), MPI_INFO_NULL, &nodeComm);
+
+      MPI_Group group, nodeGroup;
+      MPI_Comm_group(*comm, &group);
+      MPI_Comm_group(nodeComm, &nodeGroup);
+      for (size_t i = 0; i < neighbors.size(); ++i) {
+        int rank = neighbors[i], nodeRank;
+        MPI_Group_translate_ranks(group, 1, &rank, nodeGroup, &nodeRank);
+        if (rank != comm->rank() && nodeRank != MPI_UNDEFINED && findNeighbor(rank) < 0) {
+          ranks.push_back(rank);
+          nodeRanks.push_back(nodeRank);
+        }
+      }
+      MPI_Group_free(&group);
+      MPI_Group_free(&nodeGroup);
+#else
+      LOG4ESPP_WARN(logger, "shared memory windows need MPI-3, using messages only");
+#endif
+      neighborBase.assign(ranks.size(), (char*)0);
+      LOG4ESPP_INFO(logger, ranks.size() << " of the neighbors are on this node");
+    }
+
+    void SharedGhostBuffers::close() {
+      if (!isOpen()) return;
+      waitAcks();
+#if MPI_VERSION >= 3
+      if (win != MPI_WIN_NULL) {
+        MPI_Win_unlock_all(win);
+        MPI_Win_free(&win);
+      }
+      if (nodeComm != MPI_COMM_NULL) MPI_Comm_free(&nodeComm);
+#endif
+      win = MPI_WIN_NULL;
+      nodeComm = MPI_COMM_NULL;
+      base = 0;
+      capacity = 0;
+      ranks.clear();
+      nodeRanks.clear();
+      neighborBase.clear();
+      comm.reset();
+    }
+
+    void SharedGhostBuffers::resize(int _capacity) {
+#if MPI_VERSION >= 3
+      // the receivers must be done with the old window
+      waitAcks();
+      if (win != MPI_WIN_NULL) {
+        MPI_Win_unlock_all(win);
+        MPI_Win_free(&win);
+      }
+
+      capacity = _capacity;
+      MPI_Win_allocate_shared((MPI_Aint)6 * capacity, 1, MPI_INFO_NULL, nodeComm, &base, &win);
+      MPI_Win_lock_all(MPI_MODE_NOCHECK, win);
+      for (size_t i = 0; i < ranks.size(); ++i) {
+        MPI_Aint size;
+        int dispUnit;
+        MPI_Win_shared_query(win, nodeRanks[i], &size, &dispUnit, &neighborBase[i]);
+      }
+      LOG4ESPP_INFO(logger, "allocated slots of " << capacity << " bytes");
+#endif
+    }
+
+    bool SharedGhostBuffers::hasWindow() const {
+      return win != MPI_WIN_NULL;
+    }
+
+    int SharedGhostBuffers::findNeighbor(longint rank) const {
+      for (size_t i = 0; i < ranks.size(); ++i) {
+        if (ranks[i] == rank) return i;
+      }
+      return -1;
+    }
+
+    bool SharedGhostBuffers::reaches(longint rank) const {
+      return findNeighbor(rank) >= 0;
+    }
+
+    char *SharedGhostBuffers::acquireSendSlot(int dir) {
+      if (acks[dir] != MPI_REQUEST_NULL) {
+        MPI_Wait(&acks[dir], MPI_STATUS_IGNORE);
+      }
+      return base + (MPI_Aint)dir * capacity;
+    }
+
+    char *SharedGhostBuffers::getRecvSlot(longint rank, int dir) {
+      return neighborBase[findNeighbor(rank)] + (MPI_Aint)dir * capacity;
+    }
+
+    void SharedGhostBuffers::sync() {
+#if MPI_VERSION >= 3
+      MPI_Win_sync(win);
+#endif
+    }
+
+    void SharedGhostBuffers::expectAck(longint rank, int dir) {
+      MPI_Irecv(0, 0, MPI_BYTE, rank, SHM_ACK_TAG + dir, *comm, &acks[dir]);
+    }
+
+    void SharedGhostBuffers::ack(longint rank, int dir) {
+      MPI_Send(0, 0, MPI_BYTE, rank, SHM_ACK_TAG + dir, *comm);
+    }
+
+    void SharedGhostBuffers::waitAcks() {
+      MPI_Waitall(6, acks, MPI_STATUSES_IGNORE);
+    }
+  }
+}
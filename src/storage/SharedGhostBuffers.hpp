@@ -0,0 +1,107 @@
+/*
+  Copyright (C) 2016
+      Max Planck Institute for Polymer Research
+
+  This file is part of ESPResSo++.
+
+  ESPResSo++ is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ESPP_CLASS
+#ifndef _STORAGE_SHAREDGHOSTBUFFERS_HPP
+#define _STORAGE_SHAREDGHOSTBUFFERS_HPP
+
+#include <vector>
+#include "mpi.hpp"
+#include "types.hpp"
+#include "log4espp.hpp"
+
+namespace espressopp {
+  namespace storage {
+
+    /** Ghost communication buffers in an MPI-3 shared memory window for
+        the neighbor processes that run on the same node.
+
+        Every process owns one slot per direction in the window. The
+        sender packs its ghost data directly into its slot and only
+        sends a small header message with the size; the receiver
+        unpacks from the slot of the sender and acknowledges, after
+        which the sender may reuse the slot. The data itself does not
+        pass through MPI. Neighbors on other nodes are not reachable and
+        keep using messages.
+
+        open(), resize() and close() are collective on the communicator.
+        The destructor does not free the window, since the processes
+        need not destroy their buffers together; the owner must call
+        close() on all processes first. Without MPI-3 nothing is
+        reachable.
+    */
+    class SharedGhostBuffers {
+    public:
+      SharedGhostBuffers();
+      ~SharedGhostBuffers();
+
+      /** Find the neighbors on this node. neighbors are the ranks of
+          the 6 neighbors in comm. No window is allocated yet. */
+      void open(shared_ptr< mpi::communicator > comm, const std::vector< longint > &neighbors);
+      /** free the window and forget the neighbors. Collective. */
+      void close();
+      bool isOpen() const { return comm.get() != 0; }
+
+      /** (re)allocate the window with slots of capacity bytes */
+      void resize(int capacity);
+      int getCapacity() const { return capacity; }
+      /** true if a window is allocated */
+      bool hasWindow() const;
+
+      /** true if rank runs on the same node */
+      bool reaches(longint rank) const;
+
+      /** the slot for the data this process sends in direction dir; waits
+          until the receiver of the previous data has read it */
+      char *acquireSendSlot(int dir);
+      /** the slot of process rank for direction dir */
+      char *getRecvSlot(longint rank, int dir);
+
+      /** order the writes of this process before the reads of others */
+      void sync();
+
+      /** expect the acknowledgement of rank for slot dir */
+      void expectAck(longint rank, int dir);
+      /** acknowledge to rank that its slot dir was read */
+      void ack(longint rank, int dir);
+      /** wait for all acknowledgements */
+      void waitAcks();
+
+    private:
+      int findNeighbor(longint rank) const;
+
+      shared_ptr< mpi::communicator > comm;
+      // ranks of the neighbors on this node, in comm and in the node communicator
+      std::vector< longint > ranks;
+      std::vector< int > nodeRanks;
+      // slots of the neighbors on this node
+      std::vector< char* > neighborBase;
+      MPI_Comm nodeComm;
+      MPI_Win win;
+      char *base;
+      int capacity;
+      MPI_Request acks[6];
+
+      static LOG4ESPP_DECL_LOGGER(logger);
+    };
+  }
+}
+
+#endif
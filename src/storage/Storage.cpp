@@ -34,9 +34,14 @@
 #include "Int3D.hpp"
 #include "Particle.hpp"
 #include "Buffer.hpp"
+#include <boost/bind.hpp>
 #include "esutil/Error.hpp"
+#include "esutil/Profiler.hpp"
+#include "boost/serialization/vector.hpp"
 
 #include <iostream>
+#include <algorithm>
+#include <boost/cstdint.hpp>
 #include <boost/unordered/unordered_map.hpp>
 using namespace std;
 
@@ -56,13 +61,49 @@ namespace espressopp {
     Storage::Storage(shared_ptr< System > system)
       : SystemAccess(system),
         inBuffer(*system->comm),
-        outBuffer(*system->comm)
+        outBuffer(*system->comm),
+        particleArraysEnabled(false),
+        cellTasks(*this),
+        sortInterval(0), nDecompose(0), nSorts(0)
     {
+      connCellTasks = onParticlesChanged.connect(
+          boost::bind(&CellTasks::invalidate, &cellTasks));
       //logger.setLevel(log4espp::Logger::TRACE);
       LOG4ESPP_INFO(logger, "Created new storage object for a system, has buffers");
     }
 
-    Storage::~Storage() {}
+    Storage::~Storage() {
+      connParticleArrays.disconnect();
+      connCellTasks.disconnect();
+    }
+
+    void Storage::setParticleArraysEnabled(bool enabled) {
+      if (enabled == particleArraysEnabled) return;
+      particleArraysEnabled = enabled;
+      if (enabled) {
+        connParticleArrays = onParticlesChanged.connect(
+            boost::signals2::at_front,
+            boost::bind(&Storage::rebuildParticleArrays, this));
+        rebuildParticleArrays();
+      } else {
+        connParticleArrays.disconnect();
+        particleArrays.clear();
+      }
+    }
+
+    void Storage::rebuildParticleArrays() {
+      if (cells.empty()) {
+        particleArrays.clear();
+        return;
+      }
+      if (sortInterval > 0) {
+        CellList mortonCells;
+        getMortonOrderedRealCells(mortonCells);
+        particleArrays.rebuild(&(cells[0]), cells.size(), mortonCells, ghostCells);
+      } else {
+        particleArrays.rebuild(&(cells[0]), cells.size(), realCells, ghostCells);
+      }
+    }
 
     longint Storage::getNRealParticles() const {
       longint cnt = 0;
@@ -280,7 +321,94 @@ namespace espressopp {
 
       return &cell->particles.back();
     }
-    
+
+    longint Storage::addParticles(longint n, const long *ids, const real *pos,
+                                  const long *type, const real *mass,
+                                  const real *q, const real *v, bool filter) {
+      esutil::Profiler::Scope profile("addParticles");
+
+      {
+        // all or nothing, like the per particle front end. Every process
+        // checks all new ids against its own particles and for repeats;
+        // without filter, the parts of the other processes are gathered.
+        const mpi::communicator &comm = *getSystem()->comm;
+        std::vector< long > newIds(ids, ids + n);
+        if (!filter) {
+          std::vector< std::vector< long > > parts;
+          mpi::all_gather(comm, newIds, parts);
+          newIds.clear();
+          for (size_t r = 0; r < parts.size(); ++r) {
+            newIds.insert(newIds.end(), parts[r].begin(), parts[r].end());
+          }
+        }
+        std::sort(newIds.begin(), newIds.end());
+
+        esutil::Error err(getSystem()->comm);
+        std::vector< long >::iterator twice = std::adjacent_find(newIds.begin(), newIds.end());
+        if (twice != newIds.end()) {
+          stringstream msg;
+          msg << "particle " << *twice << " is given more than once, no particle was added";
+          err.setException(msg.str(), false);
+        }
+        for (size_t i = 0; i < newIds.size(); ++i) {
+          if (lookupRealParticle(newIds[i])) {
+            stringstream msg;
+            msg << "particle " << newIds[i] << " already exists, no particle was added";
+            err.setException(msg.str(), false);
+          }
+        }
+        err.checkException();
+      }
+
+      // a single pass over the input: fold and keep the own particles
+      const bc::BC &bc = *getSystem()->bc;
+      std::vector< Particle > added;
+      for (longint i = 0; i < n; ++i) {
+        Real3D r(pos[3*i], pos[3*i + 1], pos[3*i + 2]);
+        Int3D image(0);
+        bc.foldPosition(r, image);
+        if (filter && !checkIsRealParticle(ids[i], r)) continue;
+
+        Particle p;
+        p.init();
+        p.id() = ids[i];
+        p.position() = r;
+        p.image() = image;
+        if (type) p.type() = type[i];
+        if (mass) p.mass() = mass[i];
+        if (q) p.q() = q[i];
+        if (v) p.velocity() = Real3D(v[3*i], v[3*i + 1], v[3*i + 2]);
+        added.push_back(p);
+      }
+
+      appendParticles(added);
+
+      LOG4ESPP_DEBUG(logger, "stored " << added.size() << " of " << n << " particles");
+      return added.size();
+    }
+
+    void Storage::appendParticles(std::vector< Particle > &added) {
+      const Cell *first = getFirstCell();
+      std::vector< longint > addedCell(added.size());
+      for (size_t k = 0; k < added.size(); ++k) {
+        addedCell[k] = mapPositionToCellClipped(added[k].position()) - first;
+      }
+
+      // grow every cell once, append without indexing, then index the
+      // touched cells, whose particles may have been reallocated
+      std::vector< longint > count(cells.size(), 0);
+      for (size_t k = 0; k < addedCell.size(); ++k) ++count[addedCell[k]];
+      for (size_t c = 0; c < cells.size(); ++c) {
+        if (count[c]) cells[c].particles.reserve(cells[c].particles.size() + count[c]);
+      }
+      for (size_t k = 0; k < added.size(); ++k) {
+        appendUnindexedParticle(cells[addedCell[k]].particles, added[k]);
+      }
+      for (size_t c = 0; c < cells.size(); ++c) {
+        if (count[c]) updateLocalParticles(cells[c].particles);
+      }
+    }
+
     int Storage::removeParticle(longint id){
       Particle* p = lookupRealParticle(id);
       if(p){
@@ -553,10 +681,127 @@ namespace espressopp {
     }
 
     void Storage::decompose() {
+      esutil::Profiler::Scope profile("decompose");
       invalidateGhosts();
       decomposeRealParticles();
-      exchangeGhosts();
-      onParticlesChanged();
+      if (sortInterval > 0 && ++nDecompose % sortInterval == 0) {
+        esutil::Profiler::Scope prof("sortParticles");
+        sortRealParticles();
+      }
+      {
+        esutil::Profiler::Scope prof("exchangeGhosts");
+        exchangeGhosts();
+      }
+      {
+        esutil::Profiler::Scope prof("onParticlesChanged");
+        onParticlesChanged();
+      }
+    }
+
+    namespace {
+      // spread the lower 10 bits of x to every third bit
+      inline boost::uint32_t spreadBits(boost::uint32_t x) {
+        x &= 0x3ff;
+        x = (x | (x << 16)) & 0x030000ff;
+        x = (x | (x << 8)) & 0x0300f00f;
+        x = (x | (x << 4)) & 0x030c30c3;
+        x = (x | (x << 2)) & 0x09249249;
+        return x;
+      }
+    }
+
+    void Storage::sortRealParticles() {
+      // Morton keys on a 1024^3 grid over the local box, so that the
+      // order within a cell continues the order of the neighbour cells
+      Real3D origin(getLocalBoxXMin(), getLocalBoxYMin(), getLocalBoxZMin());
+      Real3D scale(1024.0 / (getLocalBoxXMax() - origin[0]),
+                   1024.0 / (getLocalBoxYMax() - origin[1]),
+                   1024.0 / (getLocalBoxZMax() - origin[2]));
+
+      cellTasks.forEachCell(realCells, [&](Cell& cell, long) {
+        ParticleList &pl = cell.particles;
+        size_t n = pl.size();
+        if (n < 2) return;
+
+        std::vector< std::pair< boost::uint32_t, size_t > > keys(n);
+        for (size_t i = 0; i < n; ++i) {
+          const Real3D &pos = pl[i].position();
+          boost::uint32_t key = 0;
+          for (int d = 0; d < 3; ++d) {
+            int q = int((pos[d] - origin[d]) * scale[d]);
+            key |= spreadBits(std::min(std::max(q, 0), 1023)) << d;
+          }
+          keys[i] = std::make_pair(key, i);
+        }
+        std::sort(keys.begin(), keys.end());
+
+        std::vector< Particle > sorted(n);
+        for (size_t i = 0; i < n; ++i) sorted[i] = pl[keys[i].second];
+        std::copy(sorted.begin(), sorted.end(), pl.begin());
+      });
+
+      // the index is shared by the cells, update it serially
+      for (size_t c = 0; c < realCells.size(); ++c) {
+        if (realCells[c]->particles.size() > 1) updateLocalParticles(realCells[c]->particles);
+      }
+      ++nSorts;
+    }
+
+    void Storage::getMortonOrderedRealCells(CellList &ordered) {
+      ordered.clear();
+      Int3D grid = getInt3DCellGrid();
+      Real3D origin(getLocalBoxXMin(), getLocalBoxYMin(), getLocalBoxZMin());
+      Real3D cellSize((getLocalBoxXMax() - origin[0]) / grid[0],
+                      (getLocalBoxYMax() - origin[1]) / grid[1],
+                      (getLocalBoxZMax() - origin[2]) / grid[2]);
+
+      // the cell grid is never finer than 1024 cells per axis in
+      // practice; beyond that the keys only lose some locality
+      std::vector< std::pair< boost::uint32_t, Cell* > > keys;
+      keys.reserve(realCells.size());
+      for (int i = 0; i < grid[0]; ++i) {
+        for (int j = 0; j < grid[1]; ++j) {
+          for (int k = 0; k < grid[2]; ++k) {
+            Real3D center(origin[0] + (i + 0.5) * cellSize[0],
+                          origin[1] + (j + 0.5) * cellSize[1],
+                          origin[2] + (k + 0.5) * cellSize[2]);
+            boost::uint32_t key = spreadBits(i) | spreadBits(j) << 1 | spreadBits(k) << 2;
+            keys.push_back(std::make_pair(key, mapPositionToCell(center)));
+          }
+        }
+      }
+
+      if (keys.size() != realCells.size()) {
+        // not a regular grid of real cells, keep the storage order
+        ordered = realCells;
+        return;
+      }
+      std::sort(keys.begin(), keys.end());
+      ordered.reserve(keys.size());
+      for (size_t c = 0; c < keys.size(); ++c) ordered.push_back(keys[c].second);
+    }
+
+    real Storage::getNeighborDistance() {
+      // the order of the particle arrays: the particles of every cell,
+      // with the cells along a Morton curve if sorting is enabled
+      CellList order;
+      if (sortInterval > 0) getMortonOrderedRealCells(order);
+      else order = realCells;
+
+      real sum[2] = { 0.0, 0.0 }, total[2];
+      const Particle *prev = 0;
+      for (size_t c = 0; c < order.size(); ++c) {
+        ParticleList &pl = order[c]->particles;
+        for (size_t i = 0; i < pl.size(); ++i) {
+          if (prev) {
+            sum[0] += (pl[i].position() - prev->position()).abs();
+            sum[1] += 1.0;
+          }
+          prev = &pl[i];
+        }
+      }
+      mpi::all_reduce(*getSystem()->comm, sum, 2, total, std::plus< real >());
+      return total[1] > 0.0 ? total[0] / total[1] : 0.0;
     }
 
     void Storage::packPositionsEtc(OutBuffer &buf,
@@ -765,6 +1010,12 @@ namespace espressopp {
 	    .def("decompose", &Storage::decompose)
 	    .def("getRealParticleIDs", &Storage::getRealParticleIDs)
         .add_property("system", &Storage::getSystem)
+        .add_property("particleArrays", &Storage::getParticleArraysEnabled,
+                      &Storage::setParticleArraysEnabled)
+        .add_property("sortInterval", &Storage::getSortInterval,
+                      &Storage::setSortInterval)
+        .add_property("nSorts", &Storage::getNSorts)
+        .def("getNeighborDistance", &Storage::getNeighborDistance)
 	    ;
     }
   }
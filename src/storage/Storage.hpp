@@ -37,6 +37,8 @@
 #include "Cell.hpp"
 #include "Buffer.hpp"
 #include "types.hpp"
+#include "ParticleArrays.hpp"
+#include "CellTasks.hpp"
 
 namespace espressopp {
 
@@ -81,6 +83,32 @@ namespace espressopp {
       */
       Particle* addParticle(longint id, const Real3D& pos);
 
+      /** add n particles at once from contiguous arrays. ids and pos
+	  (3n values, xyz per particle) are mandatory, type, mass, q and
+	  v (3n values) may be null. With filter, every process passes
+	  the same particles and keeps the ones of its domain; otherwise
+	  every process passes a disjoint part of the system and stores
+	  all of it, and the next decompose() moves the particles to
+	  their owners. The particles are appended to their cells in one
+	  pass and localParticles is updated once per touched cell.
+
+	  Collective. If one of the ids already exists on any process or
+	  is given more than once, no particle is added and an exception
+	  is thrown on all processes. Without filter, the ids of all
+	  parts are gathered on every process for this check. Returns the
+	  number of particles stored here.
+      */
+      longint addParticles(longint n, const long *ids, const real *pos,
+                           const long *type, const real *mass,
+                           const real *q, const real *v, bool filter);
+
+      /** append complete particles with folded positions to the cells
+	  of this process, clipping positions outside the domain to the
+	  nearest cell; the next decompose() moves them to their owners.
+	  Local operation, the ids are not checked.
+      */
+      void appendParticles(std::vector< Particle > &added);
+
       // remove particle from the system
       int removeParticle(longint id);
       
@@ -213,6 +241,21 @@ namespace espressopp {
       */
       virtual void updateGhosts() = 0;
 
+      /** Split-phase variant of updateGhosts(). updateGhostsBegin()
+	  starts the update, updateGhostsEnd() completes it; only after
+	  the latter the ghost data may be used. In between, the caller
+	  may work on the real particles, e.g. compute the forces
+	  between pairs of real particles. Storages that cannot overlap
+	  the communication do all the work in updateGhostsBegin().
+      */
+      virtual void updateGhostsBegin() { updateGhosts(); }
+      virtual void updateGhostsEnd() {}
+      /** Let the communication started by updateGhostsBegin() make
+	  progress without waiting for it; called from time to time
+	  while working on the real particles.
+      */
+      virtual void progressGhostUpdate() {}
+
 
       /**
        * Copies just velocites of real particles to their ghosts.
@@ -256,6 +299,38 @@ namespace espressopp {
       std::list<ParticleList>& getAdrATParticlesG() { return AdrATParticlesG; }
 
 
+      /** Enable or disable the structure-of-arrays mirror of the local
+          particles (see ParticleArrays). While enabled, the mirror is
+          rebuilt whenever the particles change, before any other slot
+          connected to onParticlesChanged is called. */
+      void setParticleArraysEnabled(bool enabled);
+      bool getParticleArraysEnabled() const { return particleArraysEnabled; }
+
+      /** Sort the real particles of every cell along a Morton (Z-order)
+          curve over the local box in every sortInterval-th decompose();
+          0, the default, never sorts. While sorting is enabled, the
+          particle arrays (and with them the compact Verlet lists) also
+          store the cells along a Morton curve over the cell grid, so
+          that particles that are close in space are close in memory
+          across cell boundaries as well, which helps the caches in the
+          force loops. Pointers to the particles are updated as usual
+          through onParticlesChanged at the end of decompose(). */
+      void setSortInterval(int interval) { sortInterval = interval; }
+      int getSortInterval() const { return sortInterval; }
+      /** number of sorts done so far */
+      long getNSorts() const { return nSorts; }
+
+      /** Mean distance between the real particles that follow each other
+	  in the order of the particle arrays, including the steps from
+	  one cell to the next, over all processes. Measures the locality
+	  achieved by the sorting. Collective. */
+      real getNeighborDistance();
+      ParticleArrays &getParticleArrays() { return particleArrays; }
+
+      /** Threaded per-cell work on the cells of this storage (see
+          CellTasks). */
+      CellTasks &getCellTasks() { return cellTasks; }
+
       /* variant for python that ignores the return value */
       bool pyAddParticle(longint id, const Real3D& pos);
 
@@ -433,6 +508,24 @@ namespace espressopp {
       // we need to snap shot the particle coordinates
       std::map< size_t, Real3D > savedRealPositions;
       std::map< size_t, Int3D > savedImages;
+
+      void rebuildParticleArrays();
+
+      /** sort the particles of the real cells, see setSortInterval() */
+      void sortRealParticles();
+      /** the real cells along a Morton curve over the cell grid */
+      void getMortonOrderedRealCells(CellList &ordered);
+
+      ParticleArrays particleArrays;
+      bool particleArraysEnabled;
+      boost::signals2::connection connParticleArrays;
+
+      CellTasks cellTasks;
+      boost::signals2::connection connCellTasks;
+
+      int sortInterval;
+      long nDecompose;
+      long nSorts;
     };
   }
 }
@@ -75,6 +75,10 @@ All derived classes implement at least the following methods:
 
    >>> addParticles([[id, pos, type, ... ], ...], 'id', 'pos', 'type', ...)
 
+   Every process loops over the whole list in Python. For large systems,
+   use :py:class:`espressopp.io.ReadNumpy` (``add_particles`` from NumPy
+   arrays, ``add_particles_h5md`` from an H5MD file) instead.
+
 * `modifyParticle(pid, property, value, decompose='yes')`
 
    This routine allows to modify any properties of an already existing particle.
@@ -91,6 +95,40 @@ All derived classes implement at least the following methods:
 
   The property 'system' returns the System object of the storage.
 
+* 'particleArrays':
+
+  If set to True, the storage keeps a structure-of-arrays copy of the
+  positions, forces, masses, charges and types of its local particles,
+  which is used by the vectorised force kernels. Velocities are not
+  copied. The copy is rebuilt whenever the particles are redistributed.
+  Default is False.
+
+  >>> system.storage.particleArrays = True
+
+* 'sortInterval':
+
+  If greater than 0, the real particles of every cell are sorted along a
+  Morton (Z-order) curve over the local box in every sortInterval-th
+  decompose(), so that particles that are close in space are also close
+  in memory. The particle arrays (and the compact Verlet lists) then
+  also store the cells along a Morton curve over the cell grid. This
+  helps the caches in the force loops, in particular for long runs and
+  bonded chains. Default is 0, no sorting.
+
+  >>> system.storage.sortInterval = 10
+
+* 'nSorts':
+
+  The number of sorts done so far (read only).
+
+* `getNeighborDistance()`:
+
+  Returns the mean distance between the real particles that follow each
+  other in the order of the particle arrays, including the steps from
+  one cell to the next, over all processes. It measures the locality
+  achieved by the sorting: compare it before and after setting
+  sortInterval.
+
 Examples:
 
 >>> s.storage.addParticles([[1, espressopp.Real3D(3,3,3)], [2, espressopp.Real3D(4,4,4)]],'id','pos')
@@ -420,8 +458,9 @@ if pmi.isController:
     class Storage(object):
         __metaclass__ = pmi.Proxy
         pmiproxydefs = dict(
-            pmicall = [ "decompose", "addParticles", "setFixedTuplesAdress", "removeAllParticles"],
-            pmiproperty = [ "system" ],
+            pmicall = [ "decompose", "addParticles", "setFixedTuplesAdress", "removeAllParticles",
+                        "getNeighborDistance"],
+            pmiproperty = [ "system", "particleArrays", "sortInterval", "nSorts" ],
             pmiinvoke = ["getRealParticleIDs", "printRealParticles"]
             )
 
@@ -36,7 +36,9 @@ decomp - auxiliary python functions
     
 *  `tuneSkin(system, integrator, minSkin=0.01, maxSkin=1.2, precision=0.001)`:
 
-    It tunes the skin size for the current system
+    It tunes the skin size for the current system. The integrator is rerun for
+    every candidate; espressopp.integrator.SkinTuner does the same search
+    within a production run.
     
 *  `printTimeVsSkin(system, integrator, minSkin=0.01, maxSkin=1.5, skinStep = 0.01)`:
     
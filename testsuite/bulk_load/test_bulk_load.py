@@ -0,0 +1,82 @@
+#!/usr/bin/env python2
+#  Copyright (C) 2016
+#      Max Planck Institute for Polymer Research
+#
+#  This file is part of ESPResSo++.
+#
+#  ESPResSo++ is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  ESPResSo++ is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+import espressopp
+import unittest
+import numpy as np
+from espressopp.tools import decomp
+import mpi4py.MPI as MPI
+
+class TestBulkLoad(unittest.TestCase):
+    def setUp(self):
+        system = espressopp.System()
+        system.rng = espressopp.esutil.RNG(4711)
+        box = (8.0, 8.0, 8.0)
+        system.bc = espressopp.bc.OrthorhombicBC(system.rng, box)
+        system.skin = 0.3
+        system.comm = MPI.COMM_WORLD
+        nodeGrid = decomp.nodeGrid(espressopp.MPI.COMM_WORLD.size)
+        cellGrid = decomp.cellGrid(box, nodeGrid, 1.0, 0.3)
+        system.storage = espressopp.storage.DomainDecomposition(system, nodeGrid, cellGrid)
+        self.system = system
+
+        n = 500
+        rng = np.random.RandomState(1)
+        self.ids = np.arange(n)
+        # also positions outside of the box, which are folded
+        self.pos = rng.uniform(-4.0, 12.0, (n, 3))
+        self.type = self.ids % 3
+        self.mass = rng.uniform(1.0, 2.0, n)
+        self.q = rng.uniform(-1.0, 1.0, n)
+        self.v = rng.normal(0.0, 1.0, (n, 3))
+
+    def test_add_particles(self):
+        reader = espressopp.io.ReadNumpy(self.system)
+        added = reader.add_particles(self.ids, self.pos, type=self.type, mass=self.mass,
+                                     q=self.q, v=self.v)
+        self.assertEqual(added, len(self.ids))
+        self.system.storage.decompose()
+
+        for i in self.ids:
+            p = self.system.storage.getParticle(i)
+            self.assertEqual(p.type, self.type[i])
+            self.assertAlmostEqual(p.mass, self.mass[i])
+            self.assertAlmostEqual(p.q, self.q[i])
+            for d in range(3):
+                self.assertAlmostEqual(p.v[d], self.v[i][d])
+                # the unfolded position is kept by the image
+                self.assertAlmostEqual(p.pos[d] + 8.0 * p.imageBox[d], self.pos[i][d])
+                self.assertTrue(0.0 <= p.pos[d] < 8.0)
+
+    def test_existing_ids(self):
+        reader = espressopp.io.ReadNumpy(self.system)
+        reader.add_particles(self.ids[:10], self.pos[:10])
+        # all or nothing
+        self.assertRaises(Exception, reader.add_particles, self.ids[5:20], self.pos[5:20])
+        self.assertEqual(self.system.storage.getParticle(15), None)
+
+    def test_repeated_ids(self):
+        reader = espressopp.io.ReadNumpy(self.system)
+        ids = np.concatenate((self.ids[:10], self.ids[3:4]))
+        pos = np.concatenate((self.pos[:10], self.pos[20:21]))
+        self.assertRaises(Exception, reader.add_particles, ids, pos)
+        self.assertEqual(self.system.storage.getParticle(0), None)
+
+if __name__ == '__main__':
+    unittest.main()
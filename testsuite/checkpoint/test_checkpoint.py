@@ -0,0 +1,124 @@
+#!/usr/bin/env python2
+#  Copyright (C) 2016
+#      Max Planck Institute for Polymer Research
+#
+#  This file is part of ESPResSo++.
+#
+#  ESPResSo++ is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  ESPResSo++ is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+import espressopp
+import unittest
+import os
+import struct
+import numpy as np
+from espressopp.tools import decomp
+import mpi4py.MPI as MPI
+
+box = (8.0, 8.0, 8.0)
+
+def make_system():
+    system = espressopp.System()
+    system.rng = espressopp.esutil.RNG(4711)
+    system.bc = espressopp.bc.OrthorhombicBC(system.rng, box)
+    system.skin = 0.3
+    system.comm = MPI.COMM_WORLD
+    nodeGrid = decomp.nodeGrid(espressopp.MPI.COMM_WORLD.size)
+    cellGrid = decomp.cellGrid(box, nodeGrid, 1.5, 0.3)
+    system.storage = espressopp.storage.DomainDecomposition(system, nodeGrid, cellGrid)
+    integrator = espressopp.integrator.VelocityVerlet(system)
+    integrator.dt = 0.005
+    fpl = espressopp.FixedPairList(system.storage)
+    vl = espressopp.VerletList(system, cutoff=1.5)
+    chk = espressopp.io.Checkpoint(system, integrator, filename='test_checkpoint.chk')
+    chk.add_pair_list(fpl)
+    chk.add_verlet_list(vl)
+    return system, integrator, fpl, vl, chk
+
+class TestCheckpoint(unittest.TestCase):
+    def setUp(self):
+        self.system, self.integrator, self.fpl, self.vl, self.chk = make_system()
+        n = 200
+        rng = np.random.RandomState(1)
+        self.pos = rng.uniform(0.0, 8.0, (n, 3))
+        props = ['id', 'type', 'mass', 'q', 'pos', 'v', 'img']
+        parts = [[i, i % 2, 1.0 + 0.01 * i, 0.5 - (i % 2), espressopp.Real3D(*self.pos[i]),
+                  espressopp.Real3D(0.1 * i, -0.1, 0.2), espressopp.Int3D(i % 3 - 1, 0, 1)]
+                 for i in range(n)]
+        self.system.storage.addParticles(parts, *props)
+        self.system.storage.decompose()
+        self.bonds = [(i, i + 1) for i in range(0, n - 1, 2)]
+        self.fpl.addBonds(self.bonds)
+        self.vl.exclude(self.bonds)
+        self.integrator.step = 1234
+        self.n = n
+
+    def tearDown(self):
+        if MPI.COMM_WORLD.rank == 0 and os.path.exists('test_checkpoint.chk'):
+            os.remove('test_checkpoint.chk')
+
+    def test_round_trip(self):
+        self.chk.write()
+        system, integrator, fpl, vl, chk = make_system()
+        chk.read('test_checkpoint.chk')
+
+        self.assertEqual(integrator.step, 1234)
+        self.assertAlmostEqual(integrator.dt, 0.005)
+        self.assertEqual(fpl.totalSize(), len(self.bonds))
+        self.assertEqual(sum(vl.excludeListSize()), sum(self.vl.excludeListSize()))
+        for i in range(self.n):
+            p = system.storage.getParticle(i)
+            q = self.system.storage.getParticle(i)
+            self.assertEqual(p.type, q.type)
+            self.assertEqual(p.mass, q.mass)
+            self.assertEqual(p.q, q.q)
+            for d in range(3):
+                self.assertEqual(p.pos[d], q.pos[d])
+                self.assertEqual(p.v[d], q.v[d])
+                self.assertEqual(p.imageBox[d], q.imageBox[d])
+
+        # the generator continues where it was written
+        self.assertEqual(system.rng(), self.system.rng())
+
+    def test_normal_variates(self):
+        # an odd number of normal variates leaves the second one of a
+        # Box-Muller pair cached in the distribution
+        self.system.rng.normal()
+        self.chk.write()
+        system, integrator, fpl, vl, chk = make_system()
+        chk.read('test_checkpoint.chk')
+        for i in range(3):
+            self.assertEqual(system.rng.normal(), self.system.rng.normal())
+
+    def test_layout(self):
+        # fixed width fields without padding, independent of the structs
+        self.chk.write()
+        with open('test_checkpoint.chk', 'rb') as f:
+            data = f.read(72 + 16)
+        magic, version, nSections, nRanks, recordSize, step, seed, dt = struct.unpack('<8s4i2qd', data[:48])
+        self.assertEqual(magic, 'ESPPCKP1')
+        self.assertEqual(version, 1)
+        self.assertEqual(nRanks, MPI.COMM_WORLD.size)
+        self.assertEqual(recordSize, 2 * 8 + 6 * 4 + 14 * 8)
+        self.assertEqual(step, 1234)
+        self.assertEqual(seed, 4711)
+        self.assertEqual(dt, 0.005)
+        self.assertEqual(struct.unpack('<3d', data[48:72]), box)
+        self.assertEqual(struct.unpack('<2iq', data[72:88]), (1, recordSize, self.n))
+
+    def test_needs_empty_system(self):
+        self.chk.write()
+        self.assertRaises(Exception, self.chk.read, 'test_checkpoint.chk')
+
+if __name__ == '__main__':
+    unittest.main()
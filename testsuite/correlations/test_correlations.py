@@ -0,0 +1,127 @@
+#!/usr/bin/env python2
+#  Copyright (C) 2016
+#      Max Planck Institute for Polymer Research
+#
+#  This file is part of ESPResSo++.
+#
+#  ESPResSo++ is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  ESPResSo++ is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+import espressopp
+import random
+import unittest
+
+L      = 6.
+box    = (L, L, L)
+nside  = 5
+npart  = nside**3
+
+def makeSystem(temperature, interacting):
+    system, integrator = espressopp.standard_system.Default(box, dt=0.005, temperature=temperature)
+    random.seed(9753)
+    x, y, z, Lx, Ly, Lz = espressopp.tools.lattice.createCubic(npart, npart / L**3)
+    props = []
+    for pid in xrange(npart):
+        vel = espressopp.Real3D(random.gauss(0., 1.), random.gauss(0., 1.), random.gauss(0., 1.))
+        props.append([pid, espressopp.Real3D(x[pid], y[pid], z[pid]), vel])
+    system.storage.addParticles(props, 'id', 'pos', 'v')
+    system.storage.decompose()
+    if interacting:
+        vl = espressopp.VerletList(system, cutoff=1.12246)
+        interLJ = espressopp.interaction.VerletListLennardJones(vl)
+        interLJ.setPotential(type1=0, type2=0, potential=espressopp.interaction.LennardJones(epsilon=1.0, sigma=1.0, cutoff=1.12246, shift='auto'))
+        system.addInteraction(interLJ)
+    return system, integrator, [p[2] for p in props]
+
+class TestCorrelations(unittest.TestCase):
+    def test_direct_sums(self):
+        # the FFT based and the multiple-tau results against the sums over
+        # all time origins of the stored trajectory
+        system, integrator, vel = makeSystem(1.0, True)
+        msd = espressopp.analysis.MeanSquareDispl(system)
+        vacf = espressopp.analysis.VelocityAutocorrelation(system)
+        acf = espressopp.analysis.Autocorrelation(system)
+        p = 16
+        mtMSD = espressopp.analysis.MultipleTauCorrelation(system, 'unfolded', p, 2)
+        mtVACF = espressopp.analysis.MultipleTauCorrelation(system, 'velocity', p, 2)
+
+        M = 40
+        pos, vel, val = [], [], []
+        for n in xrange(M):
+            integrator.run(10)
+            msd.gather()
+            vacf.gather()
+            mtMSD.sample()
+            mtVACF.sample()
+            parts = [system.storage.getParticle(pid) for pid in xrange(npart)]
+            pos.append([system.bc.getUnfoldedPosition(q.pos, q.imageBox) for q in parts])
+            vel.append([q.v for q in parts])
+            val.append(parts[0].v)
+            acf.gather(parts[0].v)
+
+        resMSD, resVACF, resACF = msd.compute(), vacf.compute(), acf.compute()
+        self.assertEqual(len(resMSD), M)
+        for m in xrange(M):
+            dsum = vsum = 0.
+            for n in xrange(M - m):
+                for i in xrange(npart):
+                    d = pos[n + m][i] - pos[n][i]
+                    dsum += d.sqr()
+                    vsum += vel[n + m][i] * vel[n][i]
+            asum = sum(val[n + m] * val[n] for n in xrange(M - m))
+            self.assertAlmostEqual(resMSD[m], dsum / (6. * npart * (M - m)), places=8)
+            self.assertAlmostEqual(resVACF[m], vsum / (3. * npart * (M - m)), places=8)
+            self.assertAlmostEqual(resACF[m], asum / (3. * (M - m)), places=8)
+
+        # the multiple-tau lags below p are exact, without the 1/6 and 1/3
+        for (lag, value), ref in zip(mtMSD.compute()[:p], resMSD):
+            self.assertAlmostEqual(value, 6. * ref, places=8)
+        for (lag, value), ref in zip(mtVACF.compute()[:p], resVACF):
+            self.assertAlmostEqual(value, 3. * ref, places=8)
+
+    def test_multiple_tau_levels(self):
+        # free particles: the block averages of a linear series are linear,
+        # so the coarse levels give the exact MSD and VACF as well
+        system, integrator, vel = makeSystem(None, False)
+        v2 = sum(v.sqr() for v in vel) / npart
+        p, m = 8, 2
+        mtMSD = espressopp.analysis.MultipleTauCorrelation(system, 'unfolded', p, m)
+        mtVACF = espressopp.analysis.MultipleTauCorrelation(system, 'velocity', p, m)
+        T = 200
+        for n in xrange(T):
+            mtMSD.sample()
+            mtVACF.sample()
+            integrator.run(1)
+        self.assertEqual(mtMSD.num_samples, T)
+
+        # lags 0 .. p-1, then j m^k for j = p/m .. p-1
+        allowed = set(range(p))
+        k = 1
+        while m**k * (p / m) < T:
+            allowed.update(j * m**k for j in xrange(p / m, p))
+            k += 1
+        resMSD = mtMSD.compute()
+        lags = [lag for lag, value in resMSD]
+        self.assertEqual(lags[:p], range(p))
+        self.assertEqual(lags, sorted(set(lags)))
+        self.assertTrue(set(lags) <= allowed)
+        self.assertGreater(max(lags), 4 * p)
+        for lag, value in resMSD:
+            tau = lag * integrator.dt
+            self.assertAlmostEqual(value, v2 * tau * tau, delta=1e-9 * max(1., v2 * tau * tau))
+        for lag, value in mtVACF.compute():
+            self.assertAlmostEqual(value, v2, places=9)
+
+if __name__ == '__main__':
+    unittest.main()
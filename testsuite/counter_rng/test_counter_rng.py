@@ -0,0 +1,97 @@
+#!/usr/bin/env python2
+#  Copyright (C) 2016
+#      Max Planck Institute for Polymer Research
+#
+#  This file is part of ESPResSo++.
+#
+#  ESPResSo++ is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  ESPResSo++ is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+import espressopp
+import unittest
+from espressopp.tools import decomp
+import mpi4py.MPI as MPI
+
+class TestCounterRNG(unittest.TestCase):
+    def test_philox(self):
+        # known answers of Philox4x32-10 (Random123)
+        rng = espressopp.esutil.CounterRNG(0)
+        self.assertEqual(rng.raw(0, 0, 0, 0),
+                         (0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8))
+        rng.seed(0x299f31d0a4093822)
+        self.assertEqual(rng.raw(0x03707344, 0x13198a2e, 0x243f6a88, -0x7a5cf72d),
+                         (0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1))
+
+    def test_moments(self):
+        rng = espressopp.esutil.CounterRNG(7)
+        u = [x for i in range(2500) for x in rng.uniform(1, 3, i, 0)]
+        n = [x for i in range(2500) for x in rng.normal(1, 3, i, 0)]
+        mean = sum(u) / len(u)
+        self.assertAlmostEqual(mean, 0.5, delta=0.01)
+        self.assertAlmostEqual(sum((x - mean)**2 for x in u) / len(u), 1.0 / 12, delta=0.003)
+        self.assertAlmostEqual(sum(n) / len(n), 0.0, delta=0.03)
+        self.assertAlmostEqual(sum(x * x for x in n) / len(n), 1.0, delta=0.04)
+
+    def langevin_system(self, order):
+        system = espressopp.System()
+        system.rng = espressopp.esutil.RNG(4711)
+        box = (6.0, 6.0, 6.0)
+        system.bc = espressopp.bc.OrthorhombicBC(system.rng, box)
+        system.skin = 0.3
+        system.comm = MPI.COMM_WORLD
+        nodeGrid = decomp.nodeGrid(espressopp.MPI.COMM_WORLD.size)
+        cellGrid = decomp.cellGrid(box, nodeGrid, 1.0, 0.3)
+        system.storage = espressopp.storage.DomainDecomposition(system, nodeGrid, cellGrid)
+        for pid in order:
+            pos = espressopp.Real3D(0.5 + pid % 5, 0.5 + (pid / 5) % 5, 0.5 + pid / 25)
+            system.storage.addParticle(pid, pos)
+        system.storage.decompose()
+
+        integrator = espressopp.integrator.VelocityVerlet(system)
+        integrator.dt = 0.005
+        langevin = espressopp.integrator.LangevinThermostat(system)
+        langevin.gamma = 1.0
+        langevin.temperature = 1.0
+        # opt-in, the default keeps the sequential noise of system.rng
+        self.assertFalse(langevin.counter_rng)
+        langevin.counter_rng = True
+        integrator.addExtension(langevin)
+        return system, integrator
+
+    def langevin_run(self, order):
+        system, integrator = self.langevin_system(order)
+        integrator.run(20)
+        integrator.run(20)
+        return [system.storage.getParticle(pid).pos for pid in range(50)]
+
+    def test_repeated_step(self):
+        # the forces of a step computed again by a second run must get
+        # new noise; the particles are at rest, the force is only noise
+        system, integrator = self.langevin_system(range(50))
+        integrator.run(0)
+        first = [system.storage.getParticle(pid).f for pid in range(50)]
+        integrator.run(0)
+        second = [system.storage.getParticle(pid).f for pid in range(50)]
+        self.assertNotEqual([(f[0], f[1], f[2]) for f in first],
+                            [(f[0], f[1], f[2]) for f in second])
+
+    def test_order_independent(self):
+        # the noise must not depend on the order in which the particles are stored
+        forward = self.langevin_run(range(50))
+        backward = self.langevin_run(range(49, -1, -1))
+        for a, b in zip(forward, backward):
+            for d in range(3):
+                self.assertEqual(a[d], b[d])
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,104 @@
+#!/usr/bin/env python2
+#  Copyright (C) 2016
+#      Max Planck Institute for Polymer Research
+#
+#  This file is part of ESPResSo++.
+#
+#  ESPResSo++ is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  ESPResSo++ is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+import espressopp
+import os
+import random
+import unittest
+
+L     = 6.
+box   = (L, L, L)
+npart = 100
+fname = 'test_dump_mpiio.trj'
+
+class TestDumpMPIIO(unittest.TestCase):
+    def setUp(self):
+        system, integrator = espressopp.standard_system.Default(box, rc=1.12246, skin=0.3, dt=0.001)
+        random.seed(42)
+        props = []
+        for pid in xrange(npart):
+            pos = espressopp.Real3D(L * random.random(), L * random.random(), L * random.random())
+            vel = espressopp.Real3D(random.random() - 0.5, random.random() - 0.5, random.random() - 0.5)
+            props.append([pid, pos, vel])
+        system.storage.addParticles(props, 'id', 'pos', 'v')
+        system.storage.decompose()
+        self.system = system
+        self.integrator = integrator
+
+    def tearDown(self):
+        if os.path.exists(fname):
+            os.remove(fname)
+
+    def particles(self):
+        return [self.system.storage.getParticle(pid) for pid in xrange(npart)]
+
+    def test_positions_velocities(self):
+        dump = espressopp.io.DumpMPIIO(self.system, self.integrator, filename=fname, store_velocities=True)
+        dump.dump()
+        self.integrator.run(10)
+        dump.dump()
+        self.assertEqual(dump.num_frames, 2)
+        dump.close()
+
+        frames = espressopp.io.readDumpMPIIO(fname)
+        self.assertEqual(len(frames), 2)
+        header, pos, vel = frames[1]
+        self.assertEqual(header['step'], 10)
+        self.assertAlmostEqual(header['time'], 0.01, places=12)
+        self.assertEqual(header['box'], box)
+        for p in self.particles():
+            for d in xrange(3):
+                self.assertEqual(pos[p.id][d], p.pos[d])
+                self.assertEqual(vel[p.id][d], p.v[d])
+
+    def test_fixed_point(self):
+        precision = 0.001
+        dump = espressopp.io.DumpMPIIO(self.system, self.integrator, filename=fname, precision=precision)
+        dump.dump()
+        dump.close()
+
+        header, pos, vel = espressopp.io.readDumpMPIIO(fname)[0]
+        self.assertEqual(vel, None)
+        for p in self.particles():
+            for d in xrange(3):
+                self.assertAlmostEqual(pos[p.id][d], p.pos[d], delta=0.5*precision + 1e-12)
+
+    def test_append(self):
+        dump = espressopp.io.DumpMPIIO(self.system, self.integrator, filename=fname)
+        dump.dump()
+        dump.close()
+        dump = espressopp.io.DumpMPIIO(self.system, self.integrator, filename=fname, append=True)
+        self.assertEqual(dump.num_frames, 1)
+        dump.dump()
+        dump.close()
+        self.assertEqual(len(espressopp.io.readDumpMPIIO(fname)), 2)
+
+    def test_fixed_point_range(self):
+        # L / precision does not fit into an int32
+        self.assertRaises(Exception, espressopp.io.DumpMPIIO, self.system, self.integrator,
+                          filename=fname, precision=1e-9)
+        # unfolded positions far outside the box
+        dump = espressopp.io.DumpMPIIO(self.system, self.integrator, filename=fname,
+                                       unfolded=True, precision=1e-8)
+        self.system.storage.modifyParticle(0, 'img', espressopp.Int3D(10, 0, 0))
+        self.assertRaises(Exception, dump.dump)
+        dump.close()
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,130 @@
+#!/usr/bin/env python2
+#  Copyright (C) 2016
+#      Max Planck Institute for Polymer Research
+#
+#  This file is part of ESPResSo++.
+#
+#  ESPResSo++ is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  ESPResSo++ is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+import espressopp
+import unittest
+import os
+import tempfile
+from espressopp.tools import decomp
+import mpi4py.MPI as MPI
+
+class TestFusedObservables(unittest.TestCase):
+    def setUp(self):
+        system = espressopp.System()
+        system.rng = espressopp.esutil.RNG(4711)
+        box = (8.0, 8.0, 8.0)
+        system.bc = espressopp.bc.OrthorhombicBC(system.rng, box)
+        system.skin = 0.3
+        system.comm = MPI.COMM_WORLD
+        nodeGrid = decomp.nodeGrid(espressopp.MPI.COMM_WORLD.size)
+        cellGrid = decomp.cellGrid(box, nodeGrid, 2.5, 0.3)
+        system.storage = espressopp.storage.DomainDecomposition(system, nodeGrid, cellGrid)
+
+        # chains of 8 beads along z on a lattice
+        particles = []
+        bonds = []
+        for pid in range(512):
+            pos = espressopp.Real3D(0.5 + pid / 64, 0.5 + (pid / 8) % 8, 0.5 + pid % 8)
+            pos += espressopp.Real3D(system.rng() - 0.5, system.rng() - 0.5, system.rng() - 0.5) * 0.2
+            particles.append([pid, pos, 0, 1.0])
+            if pid % 8:
+                bonds.append((pid - 1, pid))
+        system.storage.addParticles(particles, 'id', 'pos', 'type', 'mass')
+        system.storage.decompose()
+
+        vl = espressopp.VerletList(system, cutoff=2.5)
+        lj = espressopp.interaction.VerletListLennardJones(vl)
+        lj.setPotential(type1=0, type2=0, potential=espressopp.interaction.LennardJones(
+            epsilon=1.0, sigma=1.0, cutoff=2.5, shift='auto'))
+        system.addInteraction(lj)
+        fpl = espressopp.FixedPairList(system.storage)
+        fpl.addBonds(bonds)
+        fene = espressopp.interaction.FixedPairListFENE(system, fpl, potential=espressopp.interaction.FENE(
+            K=30.0, r0=0.0, rMax=1.5))
+        system.addInteraction(fene)
+
+        integrator = espressopp.integrator.VelocityVerlet(system)
+        integrator.dt = 0.001
+        langevin = espressopp.integrator.LangevinThermostat(system)
+        langevin.gamma = 1.0
+        langevin.temperature = 1.0
+        integrator.addExtension(langevin)
+
+        self.system = system
+        self.integrator = integrator
+        self.lj = lj
+        self.fene = fene
+
+    def test_monitored_values(self):
+        # the values measured in the force pass of step 10 must equal
+        # the ones computed afterwards by walking the lists
+        filename = os.path.join(tempfile.mkdtemp(), 'monitor.csv')
+        monitor = espressopp.analysis.SystemMonitor(
+            self.system, self.integrator, espressopp.analysis.SystemMonitorOutputCSV(filename, '\t'))
+        monitor.add_observable('lj', espressopp.analysis.PotentialEnergy(self.system, self.lj))
+        monitor.add_observable('fene', espressopp.analysis.PotentialEnergy(self.system, self.fene))
+        self.integrator.addExtension(espressopp.integrator.ExtAnalyze(monitor, 10))
+        pressure_tensor = espressopp.analysis.PressureTensor(self.system)
+        self.integrator.addExtension(espressopp.integrator.ExtAnalyze(pressure_tensor, 10))
+
+        self.integrator.run(10)
+
+        e_lj = espressopp.analysis.PotentialEnergy(self.system, self.lj).compute()
+        e_fene = espressopp.analysis.PotentialEnergy(self.system, self.fene).compute()
+        p_ref = pressure_tensor.compute()
+        p_measured = pressure_tensor.getAverageValue()[:6]
+        for a, b in zip(p_measured, p_ref):
+            self.assertAlmostEqual(a, b, places=10)
+
+        if MPI.COMM_WORLD.rank == 0:
+            with open(filename) as f:
+                rows = [line.split('\t') for line in f.read().splitlines()]
+            values = dict(zip(rows[0], rows[-1]))
+            self.assertEqual(int(float(values['step'])), 10)
+            self.assertAlmostEqual(float(values['lj']) / e_lj, 1.0, places=4)
+            self.assertAlmostEqual(float(values['fene']) / e_fene, 1.0, places=4)
+
+    def test_after_run(self):
+        # an observable used once makes the last step of every run
+        # accumulate what it reads
+        pressure = espressopp.analysis.Pressure(self.system)
+        energy = espressopp.analysis.PotentialEnergy(self.system, self.lj)
+        pressure.compute()
+        energy.compute()
+
+        self.integrator.run(10)
+        self.assertEqual(self.lj.getComputedObservables() & 3, 3)
+        self.assertEqual(self.fene.getComputedObservables() & 2, 2)
+        p_cached = pressure.compute()
+        e_cached = energy.compute()
+
+        # changing the particles drops the cache, the lists are walked again
+        self.system.storage.decompose()
+        self.assertEqual(self.lj.getComputedObservables(), 0)
+        self.assertAlmostEqual(pressure.compute(), p_cached, places=10)
+        self.assertAlmostEqual(energy.compute(), e_cached, places=10)
+
+        # so does changing a potential
+        self.integrator.run(10)
+        self.lj.setPotential(type1=0, type2=0, potential=espressopp.interaction.LennardJones(
+            epsilon=1.0, sigma=1.0, cutoff=2.5, shift='auto'))
+        self.assertEqual(self.lj.getComputedObservables(), 0)
+
+if __name__ == '__main__':
+    unittest.main()
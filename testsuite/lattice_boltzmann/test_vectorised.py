@@ -0,0 +1,77 @@
+#!/usr/bin/env python2
+#  Copyright (C) 2016
+#      Max Planck Institute for Polymer Research
+#
+#  This file is part of ESPResSo++.
+#
+#  ESPResSo++ is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  ESPResSo++ is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+import espressopp
+from espressopp import Int3D
+from espressopp import Real3D
+
+import unittest
+
+runSteps = 50
+Ni = 6
+halo = 1
+
+def runLB(vectorised, temperature, force):
+    system, integrator = espressopp.standard_system.LennardJones(0, box=(Ni, Ni, Ni), temperature=0.)
+    system.rng.seed(4711)
+    nodeGrid = espressopp.tools.decomp.nodeGrid(espressopp.MPI.COMM_WORLD.size)
+
+    lb = espressopp.integrator.LatticeBoltzmann(system, nodeGrid)
+    lb.vectorised = vectorised
+    lb.lbTemp = temperature
+    integrator.addExtension(lb)
+
+    # a shear wave, so that the stress moments relax as well
+    initPop = espressopp.integrator.LBInitPopWave(system, lb)
+    initPop.createDenVel(1., Real3D(0., 0., 0.01))
+    if force:
+        lbforce = espressopp.integrator.LBInitPeriodicForce(system, lb)
+        lbforce.setForce(Real3D(0., 0., 0.0001))
+
+    integrator.run(runSteps)
+
+    myNi = lb.getMyNi
+    pops = []
+    for i in range(halo, myNi[0] - halo):
+        for j in range(halo, myNi[1] - halo):
+            for k in range(halo, myNi[2] - halo):
+                for l in range(19):
+                    pops.append(lb.getPops(Int3D(i, j, k), l))
+    return pops
+
+class TestVectorisedLB(unittest.TestCase):
+    def compare(self, temperature, force):
+        ref = runLB(False, temperature, force)
+        rows = runLB(True, temperature, force)
+        self.assertEqual(len(ref), len(rows))
+        for a, b in zip(ref, rows):
+            self.assertAlmostEqual(a, b, places=10)
+
+    def test_athermal(self):
+        self.compare(0., False)
+
+    def test_fluctuations(self):
+        self.compare(1., False)
+
+    def test_extforce(self):
+        self.compare(1., True)
+
+if __name__ == '__main__':
+    unittest.main()
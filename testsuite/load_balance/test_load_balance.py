@@ -0,0 +1,154 @@
+#!/usr/bin/env python2
+#  Copyright (C) 2016
+#      Max Planck Institute for Polymer Research
+#
+#  This file is part of ESPResSo++.
+#
+#  ESPResSo++ is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  ESPResSo++ is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+import espressopp
+import random
+import unittest
+from espressopp.tools import decomp
+import mpi4py.MPI as MPI
+
+# initial parameters of the simulation
+L      = 12.
+box    = (L, L, L)
+rc     = 2.5
+skin   = 0.3
+nside  = 6
+npart  = nside**3
+
+class makeConf(unittest.TestCase):
+    def setUp(self):
+        system = espressopp.System()
+        system.rng = espressopp.esutil.RNG()
+        system.bc = espressopp.bc.OrthorhombicBC(system.rng, box)
+        system.skin = skin
+        nodeGrid = decomp.nodeGrid(MPI.COMM_WORLD.size)
+        cellGrid = decomp.cellGrid(box, nodeGrid, rc, skin)
+        system.storage = espressopp.storage.DomainDecomposition(system, nodeGrid, cellGrid)
+
+        # all particles in the lower half along x, an unbalanced system
+        random.seed(4321)
+        a = 0.5 * L / nside
+        props = []
+        pid = 0
+        for i in xrange(nside):
+            for j in xrange(nside):
+                for k in xrange(nside):
+                    pos = espressopp.Real3D((i + 0.5 + 0.1*random.random()) * a,
+                                            (2*j + 0.5 + 0.1*random.random()) * a,
+                                            (2*k + 0.5 + 0.1*random.random()) * a)
+                    props.append([pid, pos])
+                    pid += 1
+        system.storage.addParticles(props, 'id', 'pos')
+        system.storage.decompose()
+
+        vl = espressopp.VerletList(system, cutoff=rc)
+        interLJ = espressopp.interaction.VerletListLennardJones(vl)
+        interLJ.setPotential(type1=0, type2=0, potential=espressopp.interaction.LennardJones(epsilon=1.0, sigma=1.0, cutoff=rc))
+        system.addInteraction(interLJ)
+        cellLJ = espressopp.interaction.CellListLennardJones(system.storage)
+        cellLJ.setPotential(type1=0, type2=0, potential=espressopp.interaction.LennardJones(epsilon=1.0, sigma=1.0, cutoff=rc))
+
+        integrator = espressopp.integrator.VelocityVerlet(system)
+        integrator.dt = 0.001
+
+        self.system = system
+        self.interLJ = interLJ
+        self.cellLJ = cellLJ
+        self.integrator = integrator
+
+    def positions(self):
+        return [self.system.storage.getParticle(pid).pos for pid in xrange(npart)]
+
+    def numRealParticles(self):
+        return sum(len(ids) for ids in self.system.storage.getRealParticleIDs())
+
+class TestLoadBalance(makeConf):
+    def test_boundaries(self):
+        bounds = self.system.storage.getNodeBoundaries()
+        nodeGrid = self.system.storage.getNodeGrid()
+        for d in xrange(3):
+            self.assertEqual(len(bounds[d]), nodeGrid[d] + 1)
+            self.assertAlmostEqual(bounds[d][0], 0.0, places=10)
+            self.assertAlmostEqual(bounds[d][-1], L, places=10)
+
+    def test_move_boundaries(self):
+        energy = self.interLJ.computeEnergy()
+        bounds = self.system.storage.getNodeBoundaries()
+        for d in xrange(3):
+            # shift the inner boundaries towards the particles
+            for j in xrange(1, len(bounds[d]) - 1):
+                bounds[d][j] -= 0.5
+        self.system.storage.setNodeBoundaries(bounds)
+        newBounds = self.system.storage.getNodeBoundaries()
+        for d in xrange(3):
+            for b, bref in zip(newBounds[d], bounds[d]):
+                self.assertAlmostEqual(b, bref, places=10)
+        self.assertEqual(self.numRealParticles(), npart)
+        self.assertAlmostEqual(self.interLJ.computeEnergy(), energy, places=8)
+
+    def test_trajectory(self):
+        self.integrator.run(40)
+        ref = self.positions()
+
+        self.setUp()
+        lb = espressopp.integrator.LoadBalancer(self.system, interval=10, threshold=1.0)
+        self.integrator.addExtension(lb)
+        self.integrator.run(40)
+        self.assertTrue(lb.imbalance >= 1.0)
+        self.assertEqual(self.numRealParticles(), npart)
+        for p, pref in zip(self.positions(), ref):
+            for d in xrange(3):
+                self.assertAlmostEqual(p[d], pref[d], places=8)
+
+    def assertAllPairs(self):
+        # every particle is on its node and the Verlet list has all pairs
+        self.assertEqual(self.numRealParticles(), npart)
+        self.assertAlmostEqual(self.interLJ.computeEnergy(), self.cellLJ.computeEnergy(), places=8)
+
+    def test_cell_adjust(self):
+        bounds = self.system.storage.getNodeBoundaries()
+        for d in xrange(3):
+            for j in xrange(1, len(bounds[d]) - 1):
+                bounds[d][j] -= 0.5
+        self.system.storage.setNodeBoundaries(bounds)
+        # a new skin changes the cell grid but not the node boundaries
+        self.system.skin = 0.8
+        self.system.storage.cellAdjust()
+        newBounds = self.system.storage.getNodeBoundaries()
+        for d in xrange(3):
+            for b, bref in zip(newBounds[d], bounds[d]):
+                self.assertAlmostEqual(b, bref, places=10)
+        self.assertAllPairs()
+
+    def test_skin_tuner(self):
+        lb = espressopp.integrator.LoadBalancer(self.system, interval=10, threshold=1.0)
+        self.integrator.addExtension(lb)
+        tuner = espressopp.integrator.SkinTuner(self.system, minSkin=0.1, maxSkin=1.0,
+                                                sampleSteps=10, precision=0.2)
+        self.integrator.addExtension(tuner)
+        for n in xrange(100):
+            self.integrator.run(10)
+            self.assertAllPairs()
+            if tuner.num_tunings > 0:
+                break
+        self.assertEqual(tuner.num_tunings, 1)
+        self.assertGreater(len(tuner.getHistory()), 2)
+
+if __name__ == '__main__':
+    unittest.main()
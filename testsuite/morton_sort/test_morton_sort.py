@@ -0,0 +1,116 @@
+#!/usr/bin/env python2
+#  Copyright (C) 2016
+#      Max Planck Institute for Polymer Research
+#
+#  This file is part of ESPResSo++.
+#
+#  ESPResSo++ is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  ESPResSo++ is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+# Storage.sortInterval reorders the particles of every cell along a
+# Morton curve, and the cells of the particle arrays along a Morton
+# curve over the cell grid. The order must not change which particles
+# a process holds nor, up to rounding, the forces and the trajectory.
+
+import espressopp
+import random
+import unittest
+
+L      = 10.
+box    = (L, L, L)
+rc     = 2.5
+skin   = 0.3
+npart  = 512
+
+class TestMortonSort(unittest.TestCase):
+    def makeSystem(self, sortInterval, compact=False):
+        system, integrator = espressopp.standard_system.Default(box, rc=rc, skin=skin, dt=0.002, temperature=None)
+        system.storage.sortInterval = sortInterval
+        random.seed(97531)
+        x, y, z, Lx, Ly, Lz = espressopp.tools.lattice.createCubic(npart, npart / L**3, perfect=False)
+        # the lattice, shuffled so that the memory order is far from the spatial one
+        pids = range(npart)
+        random.shuffle(pids)
+        props = []
+        for pid in pids:
+            vel = espressopp.Real3D(random.gauss(0., 1.), random.gauss(0., 1.), random.gauss(0., 1.))
+            props.append([pid, espressopp.Real3D(x[pid], y[pid], z[pid]), vel])
+        system.storage.addParticles(props, 'id', 'pos', 'v')
+        system.storage.decompose()
+        vl = espressopp.VerletList(system, cutoff=rc)
+        vl.compact = compact
+        interLJ = espressopp.interaction.VerletListLennardJones(vl)
+        interLJ.setPotential(type1=0, type2=0, potential=espressopp.interaction.LennardJones(epsilon=1.0, sigma=1.0, cutoff=rc))
+        system.addInteraction(interLJ)
+        self.pids = sorted(p[0] for p in props)
+        return system, integrator
+
+    def realIds(self, system):
+        return sorted(sum([list(l) for l in system.storage.getRealParticleIDs()], []))
+
+    def state(self, system):
+        parts = [system.storage.getParticle(pid) for pid in self.pids]
+        return [p.pos for p in parts], [p.f for p in parts]
+
+    def assertVectorsEqual(self, a, b, places):
+        for x, y in zip(a, b):
+            for d in xrange(3):
+                self.assertAlmostEqual(x[d], y[d], places=places)
+
+    def test_particles_and_forces(self):
+        system, integrator = self.makeSystem(0)
+        integrator.run(0)
+        pos, forces = self.state(system)
+        unsorted = system.storage.getNeighborDistance()
+
+        sortedSystem, sortedIntegrator = self.makeSystem(1)
+        sortedIntegrator.run(0)
+        self.assertGreater(sortedSystem.storage.nSorts, 0)
+        self.assertLess(sortedSystem.storage.getNeighborDistance(), unsorted)
+        # the sort neither loses nor duplicates particles
+        self.assertEqual(self.realIds(sortedSystem), self.pids)
+        spos, sforces = self.state(sortedSystem)
+        self.assertVectorsEqual(pos, spos, 12)
+        self.assertVectorsEqual(forces, sforces, 8)
+
+    def test_trajectory(self):
+        system, integrator = self.makeSystem(0)
+        integrator.run(200)
+        pos, forces = self.state(system)
+
+        sortedSystem, sortedIntegrator = self.makeSystem(1)
+        sortedIntegrator.run(200)
+        self.assertEqual(self.realIds(sortedSystem), self.pids)
+        spos, sforces = self.state(sortedSystem)
+        self.assertVectorsEqual(pos, spos, 6)
+
+    def test_compact(self):
+        # the compact list is built in the Morton order of the cells
+        system, integrator = self.makeSystem(0)
+        integrator.run(0)
+        pos, forces = self.state(system)
+
+        sortedSystem, sortedIntegrator = self.makeSystem(1, compact=True)
+        sortedIntegrator.run(0)
+        spos, sforces = self.state(sortedSystem)
+        self.assertVectorsEqual(forces, sforces, 8)
+
+        sortedIntegrator.run(200)
+        integrator.run(200)
+        pos, forces = self.state(system)
+        spos, sforces = self.state(sortedSystem)
+        self.assertVectorsEqual(pos, spos, 6)
+
+if __name__ == '__main__':
+    unittest.main()
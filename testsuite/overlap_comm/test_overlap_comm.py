@@ -0,0 +1,90 @@
+#!/usr/bin/env python2
+#  Copyright (C) 2016
+#      Max Planck Institute for Polymer Research
+#
+#  This file is part of ESPResSo++.
+#
+#  ESPResSo++ is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  ESPResSo++ is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+import espressopp
+import random
+import unittest
+from espressopp.tools import decomp
+import mpi4py.MPI as MPI
+
+# initial parameters of the simulation
+L      = 8.
+box    = (L, L, L)
+rc     = 2.5
+skin   = 0.3
+nside  = 6
+npart  = nside**3
+
+class makeConf(unittest.TestCase):
+    def setUp(self):
+        system = espressopp.System()
+        system.rng = espressopp.esutil.RNG()
+        system.bc = espressopp.bc.OrthorhombicBC(system.rng, box)
+        system.skin = skin
+        nodeGrid = decomp.nodeGrid(MPI.COMM_WORLD.size)
+        cellGrid = decomp.cellGrid(box, nodeGrid, rc, skin)
+        system.storage = espressopp.storage.DomainDecompositionNonBlocking(system, nodeGrid, cellGrid)
+
+        random.seed(1234)
+        a = L / nside
+        props = []
+        pid = 0
+        for i in xrange(nside):
+            for j in xrange(nside):
+                for k in xrange(nside):
+                    pos = espressopp.Real3D((i + 0.5 + 0.1*random.random()) * a,
+                                            (j + 0.5 + 0.1*random.random()) * a,
+                                            (k + 0.5 + 0.1*random.random()) * a)
+                    props.append([pid, pos])
+                    pid += 1
+        system.storage.addParticles(props, 'id', 'pos')
+        system.storage.decompose()
+
+        vl = espressopp.VerletList(system, cutoff=rc)
+        interLJ = espressopp.interaction.VerletListLennardJones(vl)
+        interLJ.setPotential(type1=0, type2=0, potential=espressopp.interaction.LennardJones(epsilon=1.0, sigma=1.0, cutoff=rc))
+        system.addInteraction(interLJ)
+
+        integrator = espressopp.integrator.VelocityVerlet(system)
+        integrator.dt = 0.001
+
+        self.system = system
+        self.integrator = integrator
+
+    def positions(self):
+        return [self.system.storage.getParticle(pid).pos for pid in xrange(npart)]
+
+class TestOverlapComm(makeConf):
+    def test_default(self):
+        self.assertFalse(self.integrator.overlapComm)
+
+    def test_trajectory(self):
+        self.integrator.run(50)
+        ref = self.positions()
+
+        self.setUp()
+        self.integrator.overlapComm = True
+        self.assertTrue(self.integrator.overlapComm)
+        self.integrator.run(50)
+        for p, pref in zip(self.positions(), ref):
+            for d in xrange(3):
+                self.assertAlmostEqual(p[d], pref[d], places=8)
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,167 @@
+#!/usr/bin/env python2
+#  Copyright (C) 2016
+#      Max Planck Institute for Polymer Research
+#
+#  This file is part of ESPResSo++.
+#
+#  ESPResSo++ is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  ESPResSo++ is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+import espressopp
+import os
+import pickle
+import random
+import unittest
+from espressopp.tools import decomp
+import mpi4py.MPI as MPI
+
+# initial parameters of the simulation
+L      = 10.
+box    = (L, L, L)
+rc     = 3.0
+skin   = 0.3
+npart  = 100
+alpha  = 1.0
+kmax   = 12
+mesh   = (32, 32, 32)
+P      = 7
+
+# results of the single process run, compared in the parallel run
+reference = 'p3m_reference.pickle'
+wisdom    = 'test_p3m.wisdom'
+
+class TestP3M(unittest.TestCase):
+    def setUp(self):
+        system = espressopp.System()
+        system.rng = espressopp.esutil.RNG()
+        system.bc = espressopp.bc.OrthorhombicBC(system.rng, box)
+        system.skin = skin
+        nodeGrid = decomp.nodeGrid(MPI.COMM_WORLD.size)
+        cellGrid = decomp.cellGrid(box, nodeGrid, rc, skin)
+        system.storage = espressopp.storage.DomainDecomposition(system, nodeGrid, cellGrid)
+
+        # neutral random charges
+        random.seed(4321)
+        props = [[pid, espressopp.Real3D(L*random.random(), L*random.random(), L*random.random()),
+                  espressopp.Real3D(random.gauss(0., 1.), random.gauss(0., 1.), random.gauss(0., 1.)),
+                  1.0 if pid % 2 else -1.0] for pid in xrange(npart)]
+        system.storage.addParticles(props, 'id', 'pos', 'v', 'q')
+        system.storage.decompose()
+
+        self.integrator = espressopp.integrator.VelocityVerlet(system)
+        self.integrator.dt = 0.001
+        self.system = system
+
+    def evaluate(self, interaction):
+        # energy and forces of a single k space interaction
+        self.system.addInteraction(interaction)
+        self.integrator.run(0)
+        forces = [self.system.storage.getParticle(pid).f for pid in xrange(npart)]
+        result = (interaction.computeEnergy(), forces)
+        self.system.removeInteraction(0)
+        return result
+
+    def ewald(self):
+        ewald = espressopp.interaction.CoulombKSpaceEwald(self.system, 1.0, alpha, kmax)
+        return self.evaluate(espressopp.interaction.CellListCoulombKSpaceEwald(self.system.storage, ewald))
+
+    def p3m(self, planning='measure', wisdom=''):
+        p3m = espressopp.interaction.CoulombKSpaceP3M(self.system, 1.0, alpha, mesh, P, rc)
+        p3m.fft_planning = planning
+        p3m.wisdom_file = wisdom
+        return self.evaluate(espressopp.interaction.CellListCoulombKSpaceP3M(self.system.storage, p3m))
+
+    def assertCloseToEwald(self, p3m, ewald):
+        eP, fP = p3m
+        eE, fE = ewald
+        self.assertAlmostEqual(eP / eE, 1.0, places=4)
+        fmax = max(abs(f[k]) for f in fE for k in xrange(3))
+        for a, b in zip(fP, fE):
+            for k in xrange(3):
+                self.assertLess(abs(a[k] - b[k]), 1e-3 * fmax)
+
+    def test_against_ewald(self):
+        result = self.p3m()
+        self.assertCloseToEwald(result, self.ewald())
+
+        energy, forces = result
+        if MPI.COMM_WORLD.size == 1:
+            with open(reference, 'wb') as f:
+                pickle.dump((energy, [tuple(fi) for fi in forces]), f)
+        elif os.path.exists(reference):
+            # the distributed mesh gives the result of a single process
+            with open(reference, 'rb') as f:
+                energyRef, forcesRef = pickle.load(f)
+            self.assertAlmostEqual(energy / energyRef, 1.0, places=10)
+            for a, b in zip(forces, forcesRef):
+                for k in xrange(3):
+                    self.assertAlmostEqual(a[k], b[k], places=8)
+
+    def test_dynamics(self):
+        # the brick layout is kept between decompositions, the particles
+        # move and are redistributed several times here
+        p3m = espressopp.interaction.CoulombKSpaceP3M(self.system, 1.0, alpha, mesh, P, rc)
+        self.system.addInteraction(espressopp.interaction.CellListCoulombKSpaceP3M(self.system.storage, p3m))
+        self.integrator.run(300)
+        self.system.removeInteraction(0)
+        self.assertCloseToEwald(self.p3m(), self.ewald())
+
+    def test_brick_growth(self):
+        # a particle that moved farther than the skin without a decomposition
+        # makes all CPUs renew their bricks
+        p3m = espressopp.interaction.CoulombKSpaceP3M(self.system, 1.0, alpha, mesh, P, rc)
+        interaction = espressopp.interaction.CellListCoulombKSpaceP3M(self.system.storage, p3m)
+        self.system.addInteraction(interaction)
+        self.integrator.run(0)
+        pos = self.system.storage.getParticle(0).pos
+        shift = 4 * skin if pos[0] < 0.5 * L else -4 * skin
+        self.system.storage.modifyParticle(0, 'pos', espressopp.Real3D(pos[0] + shift, pos[1], pos[2]))
+        self.integrator.run(0)
+        forces = [self.system.storage.getParticle(pid).f for pid in xrange(npart)]
+        result = (interaction.computeEnergy(), forces)
+        self.system.removeInteraction(0)
+        self.assertCloseToEwald(result, self.ewald())
+
+    def assertSameResult(self, result, other):
+        self.assertAlmostEqual(result[0], other[0], places=10)
+        for a, b in zip(result[1], other[1]):
+            for k in xrange(3):
+                self.assertAlmostEqual(a[k], b[k], places=10)
+
+    def test_wisdom(self):
+        if MPI.COMM_WORLD.rank == 0 and os.path.exists(wisdom):
+            os.remove(wisdom)
+        plain = self.p3m(planning='patient')
+
+        # the first run exports the wisdom of its plans
+        exported = self.p3m(planning='patient', wisdom=wisdom)
+        self.assertTrue(os.path.exists(wisdom))
+        with open(wisdom) as f:
+            self.assertTrue(f.read().startswith('(fftw-'))
+        self.assertSameResult(plain, exported)
+
+        # the second one imports it and plans the same transforms
+        imported = self.p3m(planning='patient', wisdom=wisdom)
+        self.assertSameResult(plain, imported)
+
+        # a broken file is ignored with a warning
+        if MPI.COMM_WORLD.rank == 0:
+            with open(wisdom, 'w') as f:
+                f.write('no wisdom')
+        self.assertSameResult(plain, self.p3m(planning='patient', wisdom=wisdom))
+        if MPI.COMM_WORLD.rank == 0:
+            os.remove(wisdom)
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,81 @@
+#!/usr/bin/env python2
+#  Copyright (C) 2016
+#      Max Planck Institute for Polymer Research
+#
+#  This file is part of ESPResSo++.
+#
+#  ESPResSo++ is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  ESPResSo++ is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+import espressopp
+import random
+import unittest
+
+# dense LJ liquid, NVE
+nside  = 8
+npart  = nside**3
+L      = nside / 0.85**(1./3.)
+box    = (L, L, L)
+rc     = 2.5
+skin   = 0.3
+
+class TestPairDisplacementResort(unittest.TestCase):
+    def run_system(self, pairCriterion, nsteps, check):
+        # no thermostat, its random forces follow the order of the particles
+        # in the cells, which depends on when they were resorted
+        system, integrator = espressopp.standard_system.Default(box, rc=rc, skin=skin, dt=0.005)
+        integrator.pairDisplacementResort = pairCriterion
+        random.seed(1234)
+        x, y, z, Lx, Ly, Lz = espressopp.tools.lattice.createCubic(npart, 0.85)
+        props = []
+        for pid in xrange(npart):
+            vel = espressopp.Real3D(random.gauss(0., 1.5), random.gauss(0., 1.5), random.gauss(0., 1.5))
+            props.append([pid, espressopp.Real3D(x[pid], y[pid], z[pid]), vel])
+        system.storage.addParticles(props, 'id', 'pos', 'v')
+        system.storage.decompose()
+
+        vl = espressopp.VerletList(system, cutoff=rc)
+        pot = espressopp.interaction.LennardJones(epsilon=1.0, sigma=1.0, cutoff=rc)
+        interLJ = espressopp.interaction.VerletListLennardJones(vl)
+        interLJ.setPotential(type1=0, type2=0, potential=pot)
+        system.addInteraction(interLJ)
+        # all pairs of the cells, independent of the Verlet list
+        cellLJ = espressopp.interaction.CellListLennardJones(system.storage)
+        cellLJ.setPotential(type1=0, type2=0, potential=pot)
+
+        for n in xrange(nsteps / check):
+            integrator.run(check)
+            # a missing pair would change the energy
+            self.assertAlmostEqual(interLJ.computeEnergy(), cellLJ.computeEnergy(), places=8)
+        forces = [system.storage.getParticle(pid).f for pid in xrange(npart)]
+        positions = [system.storage.getParticle(pid).pos for pid in xrange(npart)]
+        return forces, positions, integrator.resorts
+
+    def test_same_trajectory(self):
+        forces, positions, resorts = self.run_system(False, 200, 10)
+        iforces, ipositions, iresorts = self.run_system(True, 200, 10)
+        self.assertLessEqual(iresorts, resorts)
+        for f, fi in zip(forces, iforces):
+            for d in xrange(3):
+                self.assertAlmostEqual(f[d], fi[d], places=6)
+        for x, xi in zip(positions, ipositions):
+            for d in xrange(3):
+                self.assertAlmostEqual(x[d], xi[d], places=8)
+
+    def test_lists_stay_valid(self):
+        # check the energy every step, right before the resorts
+        self.run_system(True, 100, 1)
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,152 @@
+#!/usr/bin/env python2
+#  Copyright (C) 2016
+#      Max Planck Institute for Polymer Research
+#
+#  This file is part of ESPResSo++.
+#
+#  ESPResSo++ is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  ESPResSo++ is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+# The serial Verlet list loops hand runs of pairs to the batched kernels
+# of interaction/PairKernels.cpp. Check them against interactions that
+# compute one pair at a time: the cell list, and for CoulombTruncated a
+# typed fixed pair list of all pairs within the cutoff.
+
+import espressopp
+import math
+import os
+import random
+import unittest
+
+L      = 8.
+box    = (L, L, L)
+rc     = 2.5
+skin   = 0.3
+npart  = 216
+tablefile = 'test_pair_kernels.tab'
+
+def writeTable():
+    # LJ table, r energy force
+    with open(tablefile, 'w') as f:
+        r = 0.5
+        while r <= rc + 0.1:
+            sr6 = (1. / r)**6
+            f.write('%.10f %.15e %.15e\n' % (r, 4. * (sr6 * sr6 - sr6), 24. * (2. * sr6 * sr6 - sr6) / r))
+            r += 0.001
+
+def potential(name, type1, type2):
+    k = type1 + type2
+    if name == 'LennardJones':
+        return espressopp.interaction.LennardJones(epsilon=1.0 + 0.1 * k, sigma=1.0 - 0.05 * k, cutoff=rc)
+    if name == 'LennardJonesGeneric':
+        return espressopp.interaction.LennardJonesGeneric(epsilon=1.0 + 0.1 * k, sigma=1.0, a=12 - 3 * (k % 2), b=6, cutoff=rc)
+    if name == 'Morse':
+        return espressopp.interaction.Morse(epsilon=1.0 + 0.1 * k, alpha=2.0, rMin=1.2, cutoff=rc)
+    if name == 'LJcos':
+        return espressopp.interaction.LJcos(phi=0.5 + 0.25 * k)
+    if name == 'Tabulated':
+        return espressopp.interaction.Tabulated(itype=3, filename=tablefile, cutoff=rc)
+    if name == 'CoulombTruncated':
+        return espressopp.interaction.CoulombTruncated(prefactor=1.0 + 0.5 * k, cutoff=rc)
+    if name == 'ReactionFieldGeneralized':
+        return espressopp.interaction.ReactionFieldGeneralized(prefactor=1.0 + 0.5 * k, kappa=0.5,
+                                                               epsilon1=1.0, epsilon2=80.0, cutoff=rc)
+
+class TestPairKernels(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls):
+        writeTable()
+
+    @classmethod
+    def tearDownClass(cls):
+        if os.path.exists(tablefile):
+            os.remove(tablefile)
+
+    def makeSystem(self):
+        system, integrator = espressopp.standard_system.Default(box, rc=rc, skin=skin, dt=0.002, temperature=None)
+        random.seed(1357)
+        x, y, z, Lx, Ly, Lz = espressopp.tools.lattice.createCubic(npart, npart / L**3, perfect=False)
+        props = []
+        for pid in xrange(npart):
+            pos = espressopp.Real3D(x[pid], y[pid], z[pid])
+            # runs of equal types of random length, so that batches break up
+            props.append([pid, int(random.random() < 0.4), pos, random.choice([-1., 1.])])
+        system.storage.addParticles(props, 'id', 'type', 'pos', 'q')
+        system.storage.decompose()
+        return system, integrator, props
+
+    def allPairs(self, system, props):
+        pairs = []
+        for i in xrange(npart):
+            for j in xrange(i + 1, npart):
+                d = props[i][2] - props[j][2]
+                d2 = sum((d[k] - L * round(d[k] / L))**2 for k in xrange(3))
+                if d2 < rc * rc:
+                    pairs.append((i, j))
+        return pairs
+
+    def state(self, name, mode):
+        system, integrator, props = self.makeSystem()
+        if mode == 'pairs':
+            fpl = espressopp.FixedPairList(system.storage)
+            fpl.addBonds(self.allPairs(system, props))
+            inter = getattr(espressopp.interaction, 'FixedPairListTypes' + name)(system, fpl)
+        elif mode == 'cells':
+            inter = getattr(espressopp.interaction, 'CellList' + name)(system.storage)
+        else:
+            vl = espressopp.VerletList(system, cutoff=rc)
+            vl.compact = (mode == 'compact')
+            inter = getattr(espressopp.interaction, 'VerletList' + name)(vl)
+        for type1 in xrange(2):
+            for type2 in xrange(2):
+                inter.setPotential(type1=type1, type2=type2, potential=potential(name, type1, type2))
+        system.addInteraction(inter)
+        integrator.run(0)
+        forces = [system.storage.getParticle(pid).f for pid in xrange(npart)]
+        return forces, inter.computeEnergy(), inter.computeVirial()
+
+    def compare(self, name, reference='cells'):
+        forces, energy, virial = self.state(name, reference)
+        self.assertNotEqual(energy, 0.)
+        for mode in ['verlet', 'compact']:
+            bforces, benergy, bvirial = self.state(name, mode)
+            self.assertAlmostEqual(energy, benergy, places=8)
+            self.assertAlmostEqual(virial, bvirial, places=8)
+            for f, bf in zip(forces, bforces):
+                for d in xrange(3):
+                    self.assertAlmostEqual(f[d], bf[d], places=8)
+
+    def test_lennard_jones(self):
+        self.compare('LennardJones')
+
+    def test_lennard_jones_generic(self):
+        self.compare('LennardJonesGeneric')
+
+    def test_morse(self):
+        self.compare('Morse')
+
+    def test_ljcos(self):
+        self.compare('LJcos')
+
+    def test_tabulated(self):
+        self.compare('Tabulated')
+
+    def test_coulomb_truncated(self):
+        self.compare('CoulombTruncated', reference='pairs')
+
+    def test_reaction_field(self):
+        self.compare('ReactionFieldGeneralized')
+
+if __name__ == '__main__':
+    unittest.main()
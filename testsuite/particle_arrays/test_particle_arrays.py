@@ -0,0 +1,87 @@
+#!/usr/bin/env python2
+#  Copyright (C) 2016
+#      Max Planck Institute for Polymer Research
+#
+#  This file is part of ESPResSo++.
+#
+#  ESPResSo++ is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  ESPResSo++ is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+import espressopp
+import random
+import unittest
+
+# initial parameters of the simulation
+L      = 8.
+box    = (L, L, L)
+rc     = 2.5
+skin   = 0.3
+npart  = 216
+
+def makeSystem(arrays, compact):
+    system, integrator = espressopp.standard_system.Default(box, rc=rc, skin=skin, dt=0.002, temperature=None)
+    random.seed(1234)
+    x, y, z, Lx, Ly, Lz = espressopp.tools.lattice.createCubic(npart, npart / L**3, perfect=False)
+    props = []
+    for pid in xrange(npart):
+        vel = espressopp.Real3D(random.gauss(0., 1.), random.gauss(0., 1.), random.gauss(0., 1.))
+        props.append([pid, pid % 2, espressopp.Real3D(x[pid], y[pid], z[pid]), vel])
+    system.storage.addParticles(props, 'id', 'type', 'pos', 'v')
+    system.storage.decompose()
+    system.storage.particleArrays = arrays
+
+    vl = espressopp.VerletList(system, cutoff=rc)
+    vl.compact = compact
+    interLJ = espressopp.interaction.VerletListLennardJones(vl)
+    interLJ.setPotential(type1=0, type2=0, potential=espressopp.interaction.LennardJones(epsilon=1.0, sigma=1.0, cutoff=rc))
+    interLJ.setPotential(type1=0, type2=1, potential=espressopp.interaction.LennardJones(epsilon=0.5, sigma=1.1, cutoff=rc))
+    interLJ.setPotential(type1=1, type2=1, potential=espressopp.interaction.LennardJones(epsilon=0.8, sigma=0.9, cutoff=rc))
+    system.addInteraction(interLJ)
+    return system, integrator
+
+def state(system):
+    return [(system.storage.getParticle(pid).pos, system.storage.getParticle(pid).v,
+             system.storage.getParticle(pid).f) for pid in xrange(npart)]
+
+class TestParticleArrays(unittest.TestCase):
+    def assertSameState(self, ref, other):
+        for (r, v, f), (ro, vo, fo) in zip(ref, other):
+            for d in xrange(3):
+                self.assertAlmostEqual(r[d], ro[d], places=8)
+                self.assertAlmostEqual(v[d], vo[d], places=8)
+                self.assertAlmostEqual(f[d], fo[d], places=6)
+
+    def test_enable_keeps_particles(self):
+        system, integrator = makeSystem(False, False)
+        ref = state(system)
+        system.storage.particleArrays = True
+        self.assertTrue(system.storage.particleArrays)
+        system.storage.decompose()
+        ids = sum([list(l) for l in system.storage.getRealParticleIDs()], [])
+        self.assertEqual(sorted(ids), range(npart))
+        self.assertSameState(ref, state(system))
+
+    def test_trajectory(self):
+        # several rebuilds happen within the run, the velocities are
+        # integrated on the particles and must not be overwritten
+        system, integrator = makeSystem(False, False)
+        integrator.run(200)
+        ref = state(system)
+        for compact in (False, True):
+            system, integrator = makeSystem(True, compact)
+            integrator.run(200)
+            self.assertSameState(ref, state(system))
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,122 @@
+#!/usr/bin/env python2
+#  Copyright (C) 2016
+#      Max Planck Institute for Polymer Research
+#
+#  This file is part of ESPResSo++.
+#
+#  ESPResSo++ is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  ESPResSo++ is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+import espressopp
+import json
+import os
+import random
+import tempfile
+import unittest
+from espressopp.tools import decomp
+import mpi4py.MPI as MPI
+
+L      = 8.
+box    = (L, L, L)
+rc     = 2.5
+skin   = 0.3
+nside  = 6
+
+class TestProfiler(unittest.TestCase):
+    def setUp(self):
+        system = espressopp.System()
+        system.rng = espressopp.esutil.RNG()
+        system.bc = espressopp.bc.OrthorhombicBC(system.rng, box)
+        system.skin = skin
+        nodeGrid = decomp.nodeGrid(MPI.COMM_WORLD.size)
+        cellGrid = decomp.cellGrid(box, nodeGrid, rc, skin)
+        system.storage = espressopp.storage.DomainDecomposition(system, nodeGrid, cellGrid)
+
+        random.seed(1234)
+        a = L / nside
+        props = []
+        pid = 0
+        for i in xrange(nside):
+            for j in xrange(nside):
+                for k in xrange(nside):
+                    pos = espressopp.Real3D((i + 0.5 + 0.1*random.random()) * a,
+                                            (j + 0.5 + 0.1*random.random()) * a,
+                                            (k + 0.5 + 0.1*random.random()) * a)
+                    props.append([pid, pos])
+                    pid += 1
+        system.storage.addParticles(props, 'id', 'pos')
+        system.storage.decompose()
+
+        vl = espressopp.VerletList(system, cutoff=rc)
+        interLJ = espressopp.interaction.VerletListLennardJones(vl)
+        interLJ.setPotential(type1=0, type2=0, potential=espressopp.interaction.LennardJones(epsilon=1.0, sigma=1.0, cutoff=rc))
+        system.addInteraction(interLJ)
+
+        integrator = espressopp.integrator.VelocityVerlet(system)
+        integrator.dt = 0.001
+
+        self.system = system
+        self.integrator = integrator
+
+    def tearDown(self):
+        espressopp.esutil.profilerDisable()
+        espressopp.esutil.profilerReset()
+
+    def phases(self):
+        return dict((p['path'], p) for p in espressopp.esutil.profilerReport())
+
+    def test_disabled(self):
+        espressopp.esutil.profilerReset()
+        self.integrator.run(5)
+        self.assertEqual(self.phases().keys(), ['run'])
+
+    def test_tree(self):
+        espressopp.esutil.profilerReset()
+        espressopp.esutil.profilerEnable()
+        self.integrator.run(10)
+        phases = self.phases()
+
+        steps = phases['run/integrate/integrate1']['calls']
+        self.assertEqual(steps, (10, 10, 10))
+        # one recalc before the steps
+        self.assertEqual(phases['run/integrate/updateForces']['calls'][2], 11)
+        self.assertIn('run/integrate/updateForces/force/interaction[0]', phases)
+
+        # a phase does not take longer than its parent
+        for path, p in phases.items():
+            if path == 'run':
+                continue
+            parent = phases[path.rsplit('/', 1)[0]]
+            self.assertLessEqual(p['time'][1], parent['time'][1] + 1e-9)
+
+        if MPI.COMM_WORLD.size > 1:
+            self.assertGreater(phases['run/integrate/updateForces/commF/mpi']['bytes'][2], 0)
+
+    def test_chrome_trace(self):
+        espressopp.esutil.profilerReset()
+        espressopp.esutil.profilerEnable(trace=True)
+        self.integrator.run(3)
+        fd, filename = tempfile.mkstemp(suffix='.json')
+        os.close(fd)
+        espressopp.esutil.profilerWriteChromeTrace(filename)
+        with open(filename) as f:
+            trace = json.load(f)
+        os.remove(filename)
+
+        events = [e for e in trace['traceEvents'] if e['ph'] == 'X']
+        self.assertEqual(len([e for e in events if e['name'] == 'integrate2']), 3 * MPI.COMM_WORLD.size)
+        for e in events:
+            self.assertGreaterEqual(e['dur'], 0.0)
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,113 @@
+#!/usr/bin/env python2
+#  Copyright (C) 2016
+#      Max Planck Institute for Polymer Research
+#
+#  This file is part of ESPResSo++.
+#
+#  ESPResSo++ is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  ESPResSo++ is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+import espressopp
+import math
+import random
+import unittest
+from espressopp.tools import decomp
+import mpi4py.MPI as MPI
+
+# initial parameters of the simulation
+L      = 10.
+box    = (L, L, L)
+rc     = 2.5
+skin   = 0.3
+npart  = 300
+nbins  = 20
+
+class makeConf(unittest.TestCase):
+    def setUp(self):
+        system = espressopp.System()
+        system.rng = espressopp.esutil.RNG()
+        system.bc = espressopp.bc.OrthorhombicBC(system.rng, box)
+        system.skin = skin
+        nodeGrid = decomp.nodeGrid(MPI.COMM_WORLD.size)
+        cellGrid = decomp.cellGrid(box, nodeGrid, rc, skin)
+        system.storage = espressopp.storage.DomainDecomposition(system, nodeGrid, cellGrid)
+
+        random.seed(1234)
+        self.pos = [(L*random.random(), L*random.random(), L*random.random()) for pid in xrange(npart)]
+        props = [[pid, espressopp.Real3D(*self.pos[pid])] for pid in xrange(npart)]
+        system.storage.addParticles(props, 'id', 'pos')
+        system.storage.decompose()
+
+        self.vl = espressopp.VerletList(system, cutoff=rc)
+        self.system = system
+
+    def reference(self, rmax):
+        # all pairs with the minimum image convention
+        dr = rmax / nbins
+        hist = [0.0] * nbins
+        for i in xrange(npart):
+            for j in xrange(i + 1, npart):
+                d2 = 0.0
+                for k in xrange(3):
+                    d = self.pos[i][k] - self.pos[j][k]
+                    d -= L * round(d / L)
+                    d2 += d * d
+                if d2 < rmax * rmax:
+                    hist[int(math.sqrt(d2) / dr)] += 1.0
+        ideal = 0.5 * npart * (npart - 1) / L**3
+        return [hist[b] / (ideal * 4.0 / 3.0 * math.pi * (((b + 1) * dr)**3 - (b * dr)**3))
+                for b in xrange(nbins)]
+
+class TestRDFCellList(makeConf):
+    def check(self, rdf, rmax):
+        g = rdf.compute()
+        ref = self.reference(rmax)
+        self.assertEqual(len(g), nbins)
+        for gb, refb in zip(g, ref):
+            self.assertAlmostEqual(gb, refb, places=8)
+
+    def test_storage_cells(self):
+        self.check(espressopp.analysis.RDFCellList(self.system, 2.0, nbins), 2.0)
+
+    def test_halo(self):
+        self.check(espressopp.analysis.RDFCellList(self.system, 4.5, nbins), 4.5)
+
+    def test_verlet_list(self):
+        self.check(espressopp.analysis.RDFCellList(self.system, 2.0, nbins, self.vl), 2.0)
+
+    def test_verlet_list_exclusions(self):
+        # excluded pairs are still pairs of the RDF
+        self.vl.exclude([(pid, pid + 1) for pid in xrange(0, npart - 1, 2)])
+        g = espressopp.analysis.RDFCellList(self.system, 2.0, nbins, self.vl).compute()
+        gCells = espressopp.analysis.RDFCellList(self.system, 2.0, nbins).compute()
+        for gb, cb in zip(g, gCells):
+            self.assertAlmostEqual(gb, cb, places=10)
+        self.check(espressopp.analysis.RDFCellList(self.system, 2.0, nbins, self.vl), 2.0)
+
+    def test_average(self):
+        rdf = espressopp.analysis.RDFCellList(self.system, 4.5, nbins)
+        rdf.performMeasurement()
+        rdf.performMeasurement()
+        self.assertEqual(rdf.getNumberOfMeasurements(), 2)
+        ref = self.reference(4.5)
+        for gb, refb in zip(rdf.getAverageValue(), ref):
+            self.assertAlmostEqual(gb, refb, places=8)
+        radii = rdf.getRadii()
+        self.assertAlmostEqual(radii[0], 0.5 * 4.5 / nbins, places=10)
+
+    def test_rmax_too_large(self):
+        rdf = espressopp.analysis.RDFCellList(self.system, 0.6 * L, nbins)
+        self.assertRaises(Exception, rdf.compute)
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,129 @@
+#!/usr/bin/env python2
+#  Copyright (C) 2016
+#      Max Planck Institute for Polymer Research
+#
+#  This file is part of ESPResSo++.
+#
+#  ESPResSo++ is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  ESPResSo++ is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+# With sharedGhosts the ghosts of neighbors on the same node pass through
+# a shared memory window instead of messages. On a 2x2x1 grid of 4
+# processes the forces and the trajectory must be the same as without.
+
+import espressopp
+import random
+import unittest
+from espressopp.tools import decomp
+
+L      = 12.
+box    = (L, L, L)
+rc     = 2.5
+skin   = 0.3
+a      = 1.5
+nside  = int(L / a)
+
+def lattice(z0, z1, pid0):
+    # particles on a lattice in z0 <= z < z1, with small random velocities
+    props = []
+    pid = pid0
+    for i in xrange(nside):
+        for j in xrange(nside):
+            for k in xrange(int(z0 / a), int(z1 / a)):
+                pos = espressopp.Real3D((i + 0.5 + 0.1*random.random()) * a,
+                                        (j + 0.5 + 0.1*random.random()) * a,
+                                        (k + 0.5 + 0.1*random.random()) * a)
+                vel = espressopp.Real3D(random.gauss(0., 0.5), random.gauss(0., 0.5), random.gauss(0., 0.5))
+                props.append([pid, pos, vel])
+                pid += 1
+    return props
+
+@unittest.skipUnless(espressopp.MPI.COMM_WORLD.size == 4, "needs 4 processes")
+class TestSharedGhosts(unittest.TestCase):
+    def makeSystem(self, shared):
+        system = espressopp.System()
+        system.rng = espressopp.esutil.RNG(4321)
+        system.bc = espressopp.bc.OrthorhombicBC(system.rng, box)
+        system.skin = skin
+        nodeGrid = espressopp.Int3D(2, 2, 1)
+        cellGrid = decomp.cellGrid(box, nodeGrid, rc, skin)
+        system.storage = espressopp.storage.DomainDecomposition(system, nodeGrid, cellGrid)
+        system.storage.sharedGhosts = shared
+        self.assertEqual(system.storage.sharedGhosts, shared)
+
+        random.seed(8642)
+        # the lower half of the box only, see test_slot_overflow
+        props = lattice(0., L / 2, 0)
+        system.storage.addParticles(props, 'id', 'pos', 'v')
+        system.storage.decompose()
+        self.npart = len(props)
+
+        vl = espressopp.VerletList(system, cutoff=rc)
+        interLJ = espressopp.interaction.VerletListLennardJones(vl)
+        interLJ.setPotential(type1=0, type2=0, potential=espressopp.interaction.LennardJones(epsilon=1.0, sigma=1.0, cutoff=rc))
+        system.addInteraction(interLJ)
+        integrator = espressopp.integrator.VelocityVerlet(system)
+        integrator.dt = 0.002
+        return system, integrator
+
+    def state(self, system):
+        parts = [system.storage.getParticle(pid) for pid in xrange(self.npart)]
+        return [p.pos for p in parts], [p.f for p in parts]
+
+    def assertVectorsEqual(self, a, b, places):
+        for x, y in zip(a, b):
+            for d in xrange(3):
+                self.assertAlmostEqual(x[d], y[d], places=places)
+
+    def compare(self, run):
+        states = []
+        for shared in [False, True]:
+            system, integrator = self.makeSystem(shared)
+            run(system, integrator)
+            states.append(self.state(system))
+            # the window is freed collectively here, not by the destructor
+            system.storage.sharedGhosts = False
+            self.assertFalse(system.storage.sharedGhosts)
+        (pos, forces), (spos, sforces) = states
+        self.assertVectorsEqual(pos, spos, 10)
+        self.assertVectorsEqual(forces, sforces, 10)
+
+    def test_forces(self):
+        def run(system, integrator):
+            # the window is sized by the first decompose(), used afterwards
+            integrator.run(0)
+            system.storage.decompose()
+            integrator.run(0)
+        self.compare(run)
+
+    def test_trajectory(self):
+        def run(system, integrator):
+            integrator.run(200)
+        self.compare(run)
+
+    def test_slot_overflow(self):
+        # doubling the particles doubles the ghost data, which then does
+        # not fit the slots sized for the lower half: the packets go as
+        # messages once and the window grows in that decompose()
+        def run(system, integrator):
+            integrator.run(20)
+            props = lattice(L / 2, L, self.npart)
+            system.storage.addParticles(props, 'id', 'pos', 'v')
+            system.storage.decompose()
+            self.npart += len(props)
+            integrator.run(100)
+        self.compare(run)
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,106 @@
+#!/usr/bin/env python2
+#  Copyright (C) 2016
+#      Max Planck Institute for Polymer Research
+#
+#  This file is part of ESPResSo++.
+#
+#  ESPResSo++ is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  ESPResSo++ is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+import espressopp
+import random
+import unittest
+
+nside  = 7
+npart  = nside**3
+L      = nside / 0.8**(1./3.)
+box    = (L, L, L)
+rc     = 2.5
+skin   = 0.3
+
+class TestSkinTuner(unittest.TestCase):
+    def setUp(self):
+        system, integrator = espressopp.standard_system.Default(box, rc=rc, skin=skin, dt=0.005, temperature=1.0)
+        random.seed(4242)
+        x, y, z, Lx, Ly, Lz = espressopp.tools.lattice.createCubic(npart, 0.8)
+        props = []
+        for pid in xrange(npart):
+            vel = espressopp.Real3D(random.gauss(0., 1.), random.gauss(0., 1.), random.gauss(0., 1.))
+            props.append([pid, espressopp.Real3D(x[pid], y[pid], z[pid]), vel])
+        system.storage.addParticles(props, 'id', 'pos', 'v')
+        system.storage.decompose()
+
+        self.vl = espressopp.VerletList(system, cutoff=rc)
+        pot = espressopp.interaction.LennardJones(epsilon=1.0, sigma=1.0, cutoff=rc)
+        self.interLJ = espressopp.interaction.VerletListLennardJones(self.vl)
+        self.interLJ.setPotential(type1=0, type2=0, potential=pot)
+        system.addInteraction(self.interLJ)
+        self.cellLJ = espressopp.interaction.CellListLennardJones(system.storage)
+        self.cellLJ.setPotential(type1=0, type2=0, potential=pot)
+        self.system = system
+        self.integrator = integrator
+
+    def runTuning(self, tuner):
+        self.integrator.addExtension(tuner)
+        for n in xrange(100):
+            self.integrator.run(20)
+            # the lists are valid with every skin tried
+            self.assertAlmostEqual(self.interLJ.computeEnergy(), self.cellLJ.computeEnergy(), places=8)
+            if tuner.num_tunings > 0:
+                break
+        self.assertEqual(tuner.num_tunings, 1)
+        self.assertFalse(tuner.tuning)
+
+    def test_bounds(self):
+        minSkin, maxSkin = 0.1, 0.8
+        tuner = espressopp.integrator.SkinTuner(self.system, minSkin=minSkin, maxSkin=maxSkin,
+                                                sampleSteps=20, precision=0.1)
+        builds = self.vl.builds
+        self.runTuning(tuner)
+        history = tuner.getHistory()
+        self.assertGreater(len(history), 2)
+        for s, t, rebuilds in history:
+            self.assertTrue(minSkin <= s <= maxSkin)
+            self.assertGreater(t, 0.)
+        self.assertTrue(minSkin <= self.system.skin <= maxSkin)
+        self.assertTrue(self.system.skin in [s for s, t, rebuilds in history])
+
+        # every skin change rebuilt the Verlet list with the new skin
+        self.assertGreaterEqual(self.vl.builds - builds, len(history))
+        self.assertAlmostEqual(self.vl.getVerletCutoff(), rc + self.system.skin, places=12)
+        self.integrator.run(10)
+        self.assertAlmostEqual(self.vl.getVerletCutoff(), rc + self.system.skin, places=12)
+
+    def test_box_limit(self):
+        # a cell must fit into a local box, larger skins are not tried
+        nodeGrid = espressopp.tools.decomp.nodeGrid(espressopp.MPI.COMM_WORLD.size)
+        limit = min(L / nodeGrid[i] for i in xrange(3)) - rc
+        tuner = espressopp.integrator.SkinTuner(self.system, minSkin=0.1, maxSkin=2. * L,
+                                                sampleSteps=10, precision=0.5)
+        self.runTuning(tuner)
+        for s, t, rebuilds in tuner.getHistory():
+            self.assertLessEqual(s, limit + 1e-12)
+        self.assertAlmostEqual(self.vl.getVerletCutoff(), rc + self.system.skin, places=12)
+
+    def test_narrow_bracket(self):
+        # nothing to search, the middle is taken without measurements
+        tuner = espressopp.integrator.SkinTuner(self.system, minSkin=0.3, maxSkin=0.35,
+                                                sampleSteps=10, precision=0.1)
+        self.runTuning(tuner)
+        self.assertEqual(len(tuner.getHistory()), 0)
+        self.assertAlmostEqual(self.system.skin, 0.325, places=12)
+        self.assertAlmostEqual(self.vl.getVerletCutoff(), rc + self.system.skin, places=12)
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,125 @@
+#!/usr/bin/env python2
+#  Copyright (C) 2016
+#      Max Planck Institute for Polymer Research
+#
+#  This file is part of ESPResSo++.
+#
+#  ESPResSo++ is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  ESPResSo++ is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+import espressopp
+import random
+import unittest
+from espressopp.tools import decomp
+import mpi4py.MPI as MPI
+
+# initial parameters of the simulation
+L      = 10.
+box    = (L, L, L)
+rc     = 3.0
+skin   = 0.3
+npart  = 100
+alpha  = 1.0
+kmax   = 12
+
+class makeConf(unittest.TestCase):
+    def setUp(self):
+        system = espressopp.System()
+        system.rng = espressopp.esutil.RNG()
+        system.bc = espressopp.bc.OrthorhombicBC(system.rng, box)
+        system.skin = skin
+        nodeGrid = decomp.nodeGrid(MPI.COMM_WORLD.size)
+        cellGrid = decomp.cellGrid(box, nodeGrid, rc, skin)
+        system.storage = espressopp.storage.DomainDecomposition(system, nodeGrid, cellGrid)
+
+        # neutral random charges
+        random.seed(4321)
+        props = [[pid, espressopp.Real3D(L*random.random(), L*random.random(), L*random.random()),
+                  1.0 if pid % 2 else -1.0] for pid in xrange(npart)]
+        system.storage.addParticles(props, 'id', 'pos', 'q')
+        system.storage.decompose()
+
+        self.integrator = espressopp.integrator.VelocityVerlet(system)
+        self.integrator.dt = 0.001
+        self.system = system
+
+    def evaluate(self, interaction):
+        # energy, virial and forces of a single k space interaction
+        self.system.addInteraction(interaction)
+        self.integrator.run(0)
+        forces = [self.system.storage.getParticle(pid).f for pid in xrange(npart)]
+        result = (interaction.computeEnergy(), interaction.computeVirial(), forces)
+        self.system.removeInteraction(0)
+        return result
+
+    def ewald(self):
+        ewald = espressopp.interaction.CoulombKSpaceEwald(self.system, 1.0, alpha, kmax)
+        return self.evaluate(espressopp.interaction.CellListCoulombKSpaceEwald(self.system.storage, ewald))
+
+    def spme(self):
+        spme = espressopp.interaction.CoulombKSpaceSPME(self.system, 1.0, alpha, (32, 32, 32), 6)
+        return espressopp.interaction.CellListCoulombKSpaceSPME(self.system.storage, spme)
+
+    def assertCloseToEwald(self, result, ewald):
+        eS, vS, fS = result
+        eE, vE, fE = ewald
+        self.assertAlmostEqual(eS / eE, 1.0, places=4)
+        self.assertAlmostEqual(vS / vE, 1.0, places=3)
+        fmax = max(abs(f[k]) for f in fE for k in xrange(3))
+        for a, b in zip(fS, fE):
+            for k in xrange(3):
+                self.assertLess(abs(a[k] - b[k]), 1e-3 * fmax)
+
+class TestSPME(makeConf):
+    def test_against_ewald(self):
+        self.assertCloseToEwald(self.evaluate(self.spme()), self.ewald())
+
+    def test_brick_growth(self):
+        # the brick is kept between calls and grown on all CPUs if a
+        # particle moved farther than the skin without a decomposition
+        interaction = self.spme()
+        self.system.addInteraction(interaction)
+        self.integrator.run(0)
+        pos = self.system.storage.getParticle(0).pos
+        shift = 4 * skin if pos[0] < 0.5 * L else -4 * skin
+        self.system.storage.modifyParticle(0, 'pos', espressopp.Real3D(pos[0] + shift, pos[1], pos[2]))
+        self.integrator.run(0)
+        forces = [self.system.storage.getParticle(pid).f for pid in xrange(npart)]
+        result = (interaction.computeEnergy(), interaction.computeVirial(), forces)
+        self.system.removeInteraction(0)
+        self.assertCloseToEwald(result, self.ewald())
+
+    def test_charge_change(self):
+        # the sums of the charges follow a change of charges that comes
+        # without a decomposition
+        interaction = self.spme()
+        self.system.addInteraction(interaction)
+        self.integrator.run(0)
+        self.system.storage.modifyParticle(0, 'q', -2.0)
+        self.system.storage.modifyParticle(1, 'q', 3.0)
+        energy = interaction.computeEnergy()
+        virial = interaction.computeVirial()
+        self.system.removeInteraction(0)
+        eF, vF, fF = self.evaluate(self.spme())
+        self.assertAlmostEqual(energy / eF, 1.0, places=10)
+        self.assertAlmostEqual(virial / vF, 1.0, places=10)
+
+    def test_properties(self):
+        spme = espressopp.interaction.CoulombKSpaceSPME(self.system, 2.0, alpha, (16, 16, 16))
+        self.assertEqual(spme.P, 4)
+        self.assertEqual(spme.mesh, espressopp.Int3D(16, 16, 16))
+        spme.alpha = 1.5
+        self.assertAlmostEqual(spme.alpha, 1.5)
+
+if __name__ == '__main__':
+    unittest.main()
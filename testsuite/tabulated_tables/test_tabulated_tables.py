@@ -0,0 +1,184 @@
+#!/usr/bin/env python2
+#  Copyright (C) 2016
+#      Max Planck Institute for Polymer Research
+#
+#  This file is part of ESPResSo++.
+#
+#  ESPResSo++ is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  ESPResSo++ is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+# Tabulated, TabulatedAngular and TabulatedDihedral resample the table of
+# the file to a CubicTable in r^2, theta and phi. Check the resampled
+# forces and energies against the interpolation of the file, also close
+# to the ends of the tables where the old grids were coarse: small r for
+# pairs, and theta or phi close to 0 and pi.
+
+import espressopp
+import math
+import os
+import unittest
+
+L = 50.
+pairfile = 'test_tabulated_tables.pair'
+anglefile = 'test_tabulated_tables.angle'
+dihedralfile = 'test_tabulated_tables.dihedral'
+
+def lj(r):
+    sr6 = (1. / r)**6
+    return 4. * (sr6 * sr6 - sr6), 24. * (2. * sr6 * sr6 - sr6) / r
+
+def angular(theta):
+    # E and -dE/dtheta
+    return 5. * (1. - math.cos(theta - 1.9)) + 0.5 * math.cos(3. * theta), \
+           -5. * math.sin(theta - 1.9) + 1.5 * math.sin(3. * theta)
+
+def dihedral(phi):
+    return 2. * (1. + math.cos(3. * phi)) + math.cos(phi), \
+           6. * math.sin(3. * phi) + math.sin(phi)
+
+def writeTable(filename, func, x0, x1, n):
+    with open(filename, 'w') as f:
+        for i in xrange(n + 1):
+            x = x0 + (x1 - x0) * i / n
+            e, force = func(x)
+            f.write('%.15f %.15e %.15e\n' % (x, e, force))
+
+def prod(a, b):
+    return [sum(a[j] * b[j] for j in xrange(3) if j != i) for i in xrange(3)]
+
+def d(i, j):
+    return 1. if i == j else 0.
+
+def dihedralForces(pot, r21, r32, r43):
+    # the forces of TabulatedDihedral from the interpolation of the file
+    rijjk = r21.cross(r32)
+    rjkkn = r32.cross(r43)
+    inv_rijjk = 1. / rijjk.abs()
+    inv_rjkkn = 1. / rjkkn.abs()
+    cos_phi = max(-1., min(1., (rijjk * rjkkn) * inv_rijjk * inv_rjkkn))
+    coef1 = -pot.computeForce(math.acos(cos_phi))
+    A1, A2, A3 = inv_rijjk * inv_rjkkn, inv_rijjk**2, inv_rjkkn**2
+    p3232, p3243, p2132 = prod(r32, r32), prod(r32, r43), prod(r21, r32)
+    p2143, p2121, p4343 = prod(r21, r43), prod(r21, r21), prod(r43, r43)
+    forces = []
+    for l in xrange(4):
+        f = []
+        for i in xrange(3):
+            B1 = r21[i] * (p3232[i] * (d(l, 2) - d(l, 3)) + p3243[i] * (d(l, 2) - d(l, 1))) + \
+                 r32[i] * (p2132[i] * (d(l, 3) - d(l, 2)) + p3243[i] * (d(l, 1) - d(l, 0))) + \
+                 r43[i] * (p2132[i] * (d(l, 2) - d(l, 1)) + p3232[i] * (d(l, 0) - d(l, 1))) + \
+                 2. * r32[i] * p2143[i] * (d(l, 1) - d(l, 2))
+            B2 = 2. * r21[i] * (p3232[i] * (d(l, 1) - d(l, 0)) + p2132[i] * (d(l, 1) - d(l, 2))) + \
+                 2. * r32[i] * (p2121[i] * (d(l, 2) - d(l, 1)) + p2132[i] * (d(l, 0) - d(l, 1)))
+            B3 = 2. * r43[i] * (p3232[i] * (d(l, 3) - d(l, 2)) + p3243[i] * (d(l, 1) - d(l, 2))) + \
+                 2. * r32[i] * (p4343[i] * (d(l, 2) - d(l, 1)) + p3243[i] * (d(l, 2) - d(l, 3)))
+            f.append(coef1 * (A1 * B1 - 0.5 * cos_phi * (A2 * B2 + A3 * B3)))
+        forces.append(espressopp.Real3D(*f))
+    return forces
+
+class TestTabulatedTables(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls):
+        writeTable(pairfile, lj, 0.7, 2.5, 360)
+        writeTable(anglefile, angular, 0., math.pi, 180)
+        writeTable(dihedralfile, dihedral, -math.pi, math.pi, 360)
+
+    @classmethod
+    def tearDownClass(cls):
+        for filename in [pairfile, anglefile, dihedralfile]:
+            if os.path.exists(filename):
+                os.remove(filename)
+
+    def assertClose(self, value, reference, rtol):
+        self.assertLessEqual(abs(value - reference), rtol * (1. + abs(reference)))
+
+    def assertForces(self, forces, references, rtol):
+        for f, fref in zip(forces, references):
+            for k in xrange(3):
+                self.assertClose(f[k], fref[k], rtol)
+
+    def makeSystem(self):
+        system, integrator = espressopp.standard_system.Default((L, L, L), rc=2.5, skin=0.3)
+        return system, integrator
+
+    def test_pair(self):
+        # the file samples LJ finely enough that its interpolation is the
+        # analytic potential within the tolerance, a few intervals away
+        # from the end where the spline takes its slope from the file
+        pot = espressopp.interaction.Tabulated(itype=3, filename=pairfile, cutoff=2.5)
+        for r in [0.7501, 0.7537, 0.7713, 0.8119, 0.9, 1.0, 1.1224, 1.5, 2.0, 2.4437]:
+            e, f = lj(r)
+            self.assertClose(pot.computeEnergy(r), e, 1.e-5)
+            force = pot.computeForce(espressopp.Real3D(r, 0., 0.))
+            self.assertClose(force[0], f, 1.e-5)
+            self.assertClose(force[1], 0., 1.e-12)
+
+    def test_angular(self):
+        system, integrator = self.makeSystem()
+        pot = espressopp.interaction.TabulatedAngular(itype=3, filename=anglefile)
+        angles = [0.003, 0.02, 0.1, 0.5, 1.0, 1.5707, 2.2, 2.9, 3.1, 3.135]
+        particles, triples = [], []
+        for i, theta in enumerate(angles):
+            c = espressopp.Real3D(5. + 4. * i, 25., 25.)
+            r1, r3 = 1.0, 1.3
+            particles += [[3 * i, c + espressopp.Real3D(r1, 0., 0.)],
+                          [3 * i + 1, c],
+                          [3 * i + 2, c + espressopp.Real3D(r3 * math.cos(theta), r3 * math.sin(theta), 0.)]]
+            triples.append((3 * i, 3 * i + 1, 3 * i + 2))
+        system.storage.addParticles(particles, 'id', 'pos')
+        system.storage.decompose()
+        ftl = espressopp.FixedTripleList(system.storage)
+        ftl.addTriples(triples)
+        system.addInteraction(espressopp.interaction.FixedTripleListTabulatedAngular(system, ftl, pot))
+        integrator.run(0)
+        for i, theta in enumerate(angles):
+            p1, p2, p3 = [system.storage.getParticle(pid).pos for pid in triples[i]]
+            dist12, dist32 = p1 - p2, p3 - p2
+            cos_theta = dist12 * dist32 / math.sqrt(dist12.sqr() * dist32.sqr())
+            # the force of TabulatedAngular from the interpolation of the file
+            a = pot.computeForce(math.acos(cos_theta)) / math.sqrt(1. - cos_theta * cos_theta)
+            a11 = a * cos_theta / dist12.sqr()
+            a12 = -a / math.sqrt(dist12.sqr() * dist32.sqr())
+            a22 = a * cos_theta / dist32.sqr()
+            f12 = a11 * dist12 + a12 * dist32
+            f32 = a22 * dist32 + a12 * dist12
+            forces = [system.storage.getParticle(pid).f for pid in triples[i]]
+            self.assertForces(forces, [f12, -1. * (f12 + f32), f32], 1.e-5)
+
+    def test_dihedral(self):
+        system, integrator = self.makeSystem()
+        pot = espressopp.interaction.TabulatedDihedral(itype=3, filename=dihedralfile)
+        angles = [0.005, 0.05, 0.3, 1.0, 1.5707, 2.0, 2.8, 3.09, 3.137]
+        particles, quadruples = [], []
+        for i, phi in enumerate(angles):
+            c = espressopp.Real3D(5. + 4. * i, 25., 25.)
+            particles += [[4 * i, c + espressopp.Real3D(0.8, 0., 0.3)],
+                          [4 * i + 1, c],
+                          [4 * i + 2, c + espressopp.Real3D(0., 0., 1.1)],
+                          [4 * i + 3, c + espressopp.Real3D(0.9 * math.cos(phi), 0.9 * math.sin(phi), 1.4)]]
+            quadruples.append((4 * i, 4 * i + 1, 4 * i + 2, 4 * i + 3))
+        system.storage.addParticles(particles, 'id', 'pos')
+        system.storage.decompose()
+        fql = espressopp.FixedQuadrupleList(system.storage)
+        fql.addQuadruples(quadruples)
+        system.addInteraction(espressopp.interaction.FixedQuadrupleListTabulatedDihedral(system, fql, pot))
+        integrator.run(0)
+        for i, phi in enumerate(angles):
+            p1, p2, p3, p4 = [system.storage.getParticle(pid).pos for pid in quadruples[i]]
+            references = dihedralForces(pot, p2 - p1, p3 - p2, p4 - p3)
+            forces = [system.storage.getParticle(pid).f for pid in quadruples[i]]
+            self.assertForces(forces, references, 1.e-5)
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,124 @@
+#!/usr/bin/env python2
+#  Copyright (C) 2016
+#      Max Planck Institute for Polymer Research
+#
+#  This file is part of ESPResSo++.
+#
+#  ESPResSo++ is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  ESPResSo++ is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+import espressopp
+import random
+import unittest
+
+# initial parameters of the simulation
+L      = 8.
+box    = (L, L, L)
+rc     = 2.5
+skin   = 0.3
+npart  = 216
+nthreads = 4
+
+class TestThreads(unittest.TestCase):
+    def setUp(self):
+        system, integrator = espressopp.standard_system.Default(box, rc=rc, skin=skin, dt=0.002, temperature=None)
+        random.seed(2468)
+        x, y, z, Lx, Ly, Lz = espressopp.tools.lattice.createCubic(npart, npart / L**3, perfect=False)
+        props = []
+        for pid in xrange(npart):
+            vel = espressopp.Real3D(random.gauss(0., 1.), random.gauss(0., 1.), random.gauss(0., 1.))
+            props.append([pid, pid % 2, espressopp.Real3D(x[pid], y[pid], z[pid]), vel])
+        system.storage.addParticles(props, 'id', 'type', 'pos', 'v')
+        system.storage.decompose()
+        self.system = system
+        self.integrator = integrator
+
+    def tearDown(self):
+        espressopp.esutil.setNumThreads(1)
+
+    def addVerletListLJ(self, compact=False):
+        vl = espressopp.VerletList(self.system, cutoff=rc)
+        vl.compact = compact
+        interLJ = espressopp.interaction.VerletListLennardJones(vl)
+        interLJ.setPotential(type1=0, type2=0, potential=espressopp.interaction.LennardJones(epsilon=1.0, sigma=1.0, cutoff=rc))
+        interLJ.setPotential(type1=0, type2=1, potential=espressopp.interaction.LennardJones(epsilon=0.5, sigma=1.1, cutoff=rc))
+        interLJ.setPotential(type1=1, type2=1, potential=espressopp.interaction.LennardJones(epsilon=0.8, sigma=0.9, cutoff=rc))
+        self.system.addInteraction(interLJ)
+        return interLJ
+
+    def addCellListLJ(self):
+        interLJ = espressopp.interaction.CellListLennardJones(self.system.storage)
+        interLJ.setPotential(type1=0, type2=0, potential=espressopp.interaction.LennardJones(epsilon=1.0, sigma=1.0, cutoff=rc))
+        # no potential for type 1 first, those pairs read the default
+        interLJ.setPotential(type1=0, type2=1, potential=espressopp.interaction.LennardJones(epsilon=0.5, sigma=1.1, cutoff=rc))
+        self.system.addInteraction(interLJ)
+        return interLJ
+
+    def addBonds(self):
+        fpl = espressopp.FixedPairList(self.system.storage)
+        fpl.addBonds([(pid, pid + 1) for pid in xrange(0, npart - 1, 2)])
+        interH = espressopp.interaction.FixedPairListHarmonic(self.system, fpl,
+                     potential=espressopp.interaction.Harmonic(K=10.0, r0=1.0))
+        self.system.addInteraction(interH)
+        return interH
+
+    def state(self, interactions):
+        self.integrator.run(0)
+        forces = [self.system.storage.getParticle(pid).f for pid in xrange(npart)]
+        energies = [inter.computeEnergy() for inter in interactions]
+        return forces, energies
+
+    def compareThreads(self, interactions):
+        # the threaded loops add the forces in the serial order, but one
+        # thread uses the batched kernels, so allow for rounding
+        espressopp.esutil.setNumThreads(1)
+        forces, energies = self.state(interactions)
+        espressopp.esutil.setNumThreads(nthreads)
+        tforces, tenergies = self.state(interactions)
+        for e, te in zip(energies, tenergies):
+            self.assertAlmostEqual(e, te, places=10)
+        for f, tf in zip(forces, tforces):
+            for d in xrange(3):
+                self.assertAlmostEqual(f[d], tf[d], places=8)
+
+    def test_verlet_list(self):
+        self.compareThreads([self.addVerletListLJ()])
+
+    def test_verlet_list_compact(self):
+        self.compareThreads([self.addVerletListLJ(compact=True)])
+
+    def test_cell_list(self):
+        self.compareThreads([self.addCellListLJ()])
+
+    def test_fixed_pair_list(self):
+        self.compareThreads([self.addVerletListLJ(), self.addBonds()])
+
+    def test_trajectory(self):
+        self.addVerletListLJ()
+        self.addBonds()
+        self.integrator.run(100)
+        ref = [self.system.storage.getParticle(pid).pos for pid in xrange(npart)]
+
+        self.setUp()
+        espressopp.esutil.setNumThreads(nthreads)
+        self.addVerletListLJ()
+        self.addBonds()
+        self.integrator.run(100)
+        for pid in xrange(npart):
+            pos = self.system.storage.getParticle(pid).pos
+            for d in xrange(3):
+                self.assertAlmostEqual(ref[pid][d], pos[d], places=8)
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,145 @@
+#!/usr/bin/env python2
+#  Copyright (C) 2016
+#      Max Planck Institute for Polymer Research
+#
+#  This file is part of ESPResSo++.
+#
+#  ESPResSo++ is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  ESPResSo++ is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+import espressopp
+import random
+import unittest
+
+# initial parameters of the simulation
+L      = 8.
+box    = (L, L, L)
+rc     = 2.5
+skin   = 0.3
+npart  = 200
+
+class makeConf(unittest.TestCase):
+    def setUp(self):
+        system, integrator = espressopp.standard_system.Default(box, rc=rc, skin=skin, dt=0.001, temperature=None)
+        random.seed(4321)
+        # simple cubic lattice with small random displacements
+        nside = 6
+        a = L / nside
+        pid = 0
+        props = []
+        for i in xrange(nside):
+            for j in xrange(nside):
+                for k in xrange(nside):
+                    if pid == npart:
+                        break
+                    pos = espressopp.Real3D((i + 0.5 + 0.1*random.random()) * a,
+                                            (j + 0.5 + 0.1*random.random()) * a,
+                                            (k + 0.5 + 0.1*random.random()) * a)
+                    props.append([pid, pid % 2, pos, 1.0 - 2.0 * ((pid / 2) % 2)])
+                    pid += 1
+        system.storage.addParticles(props, 'id', 'type', 'pos', 'q')
+        system.storage.decompose()
+
+        vl = espressopp.VerletList(system, cutoff=rc, exclusionlist=[(0, 1), (2, 3)])
+        interLJ = espressopp.interaction.VerletListLennardJones(vl)
+        interLJ.setPotential(type1=0, type2=0, potential=espressopp.interaction.LennardJones(epsilon=1.0, sigma=1.0, cutoff=rc))
+        interLJ.setPotential(type1=0, type2=1, potential=espressopp.interaction.LennardJones(epsilon=0.5, sigma=1.1, cutoff=rc))
+        interLJ.setPotential(type1=1, type2=1, potential=espressopp.interaction.LennardJones(epsilon=0.8, sigma=0.9, cutoff=rc))
+        system.addInteraction(interLJ)
+
+        self.system = system
+        self.integrator = integrator
+        self.vl = vl
+        self.interLJ = interLJ
+
+    def forces(self):
+        self.integrator.run(0)
+        return [self.system.storage.getParticle(pid).f for pid in xrange(npart)]
+
+class TestVerletListCompact(makeConf):
+    def test_same_pairs_energy_forces(self):
+        npairs = self.vl.totalSize()
+        energy = self.interLJ.computeEnergy()
+        forces = self.forces()
+
+        self.vl.compact = True
+        self.assertTrue(self.vl.compact)
+        self.assertEqual(self.vl.totalSize(), npairs)
+        self.assertAlmostEqual(self.interLJ.computeEnergy(), energy, places=8)
+        for f, fc in zip(forces, self.forces()):
+            for d in xrange(3):
+                self.assertAlmostEqual(f[d], fc[d], places=8)
+
+    def test_charges(self):
+        # the batched compact kernel takes the charges from the particle arrays
+        interC = espressopp.interaction.VerletListCoulombTruncated(self.vl)
+        for t1, t2 in ((0, 0), (0, 1), (1, 1)):
+            interC.setPotential(type1=t1, type2=t2, potential=espressopp.interaction.CoulombTruncated(prefactor=0.5, cutoff=rc))
+        self.system.addInteraction(interC)
+        forces = self.forces()
+
+        self.vl.compact = True
+        for f, fc in zip(forces, self.forces()):
+            for d in xrange(3):
+                self.assertAlmostEqual(f[d], fc[d], places=8)
+
+    def test_change_particle_type(self):
+        # the types changed by ChangeParticleType between two resorts have
+        # to reach the particle arrays read by the compact kernels
+        for t1 in (0, 1, 2):
+            self.interLJ.setPotential(type1=t1, type2=2, potential=espressopp.interaction.LennardJones(epsilon=1.5, sigma=1.2, cutoff=rc))
+        self.vl.compact = True
+        self.integrator.run(0)
+        change_type = espressopp.integrator.ChangeParticleType(self.system, 1, npart, 1, 2)
+        self.integrator.addExtension(change_type)
+        self.integrator.run(1)
+        change_type.disconnect()
+        self.assertEqual(self.system.storage.getParticle(1).type, 2)
+        forces = [self.system.storage.getParticle(pid).f for pid in xrange(npart)]
+
+        self.vl.compact = False
+        for f, fc in zip(self.forces(), forces):
+            for d in xrange(3):
+                self.assertAlmostEqual(f[d], fc[d], places=8)
+
+    def test_modify_charges(self):
+        # the same for charges set from Python
+        interC = espressopp.interaction.VerletListCoulombTruncated(self.vl)
+        for t1, t2 in ((0, 0), (0, 1), (1, 1)):
+            interC.setPotential(type1=t1, type2=t2, potential=espressopp.interaction.CoulombTruncated(prefactor=0.5, cutoff=rc))
+        self.system.addInteraction(interC)
+        self.vl.compact = True
+        self.forces()
+        for pid in xrange(0, npart, 3):
+            self.system.storage.modifyParticle(pid, 'q', 2.0)
+        forces = self.forces()
+
+        self.vl.compact = False
+        for f, fc in zip(self.forces(), forces):
+            for d in xrange(3):
+                self.assertAlmostEqual(f[d], fc[d], places=8)
+
+    def test_trajectory(self):
+        self.integrator.run(50)
+        ref = [self.system.storage.getParticle(pid).pos for pid in xrange(npart)]
+
+        self.setUp()
+        self.vl.compact = True
+        self.integrator.run(50)
+        for pid in xrange(npart):
+            pos = self.system.storage.getParticle(pid).pos
+            for d in xrange(3):
+                self.assertAlmostEqual(ref[pid][d], pos[d], places=6)
+
+if __name__ == '__main__':
+    unittest.main()